@@ -0,0 +1,119 @@
+#include "BackgroundSaver.h"
+#include "LazyChunkFile.h"
+#include "../Map.h"
+#include "../Utils/Logger.h"
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <utility>
+
+namespace TilelandWorld {
+
+    BackgroundSaver::BackgroundSaver(std::string saveName, std::string directory, bool keepTlwf)
+        : saveName(std::move(saveName)), directory(std::move(directory)), keepTlwf(keepTlwf) {}
+
+    BackgroundSaver::~BackgroundSaver() {
+        if (pendingSave.valid()) pendingSave.wait();
+    }
+
+    bool BackgroundSaver::readsFromSaveTlwf(const Map& map) const {
+        LazyChunkFile* source = map.getSavedChunkSource();
+        const std::string tlwfPath = MapSerializer::getTlwfPath(saveName, directory);
+        std::error_code ec;
+        return source && !source->isCompressed() && std::filesystem::exists(tlwfPath, ec)
+               && std::filesystem::equivalent(source->getPath(), tlwfPath, ec);
+    }
+
+    bool BackgroundSaver::schedule(const Map& map, TaskSystem& taskSystem, const std::unordered_set<ChunkCoord, ChunkCoordHash>* modifiedChunks) {
+        if (saving) return false;
+        if (pendingSave.valid()) pendingSave.get(); // 上一次的结果已记入统计
+
+        // 修改区块集合覆盖 .tlwf 上次提交以来的全部修改时才能增量追加；没有集合时只能整体保存
+        if (modifiedChunks) unsavedChunks.insert(modifiedChunks->begin(), modifiedChunks->end());
+        const bool useJournal = modifiedChunks && readsFromSaveTlwf(map);
+        std::unordered_set<ChunkCoord, ChunkCoordHash> journalChunks;
+        if (useJournal) journalChunks = unsavedChunks;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<const Map> snapshot = MapSerializer::createSaveSnapshot(map);
+        const double snapshotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            ++stats.scheduledCount;
+            stats.lastSnapshotSeconds = snapshotSeconds;
+        }
+
+        saving = true;
+        TaskSystem* tasks = &taskSystem;
+        pendingSave = taskSystem.submitFuture([this, snapshot, start, useJournal, chunks = std::move(journalChunks), tasks]() {
+            MapSerializer::SaveStats saveStats{};
+            bool ok = false;
+            bool journaled = false;
+            try {
+                if (useJournal && !journal) {
+                    try {
+                        journal = std::make_unique<SaveJournal>(MapSerializer::getTlwfPath(saveName, directory));
+                    } catch (const std::exception& e) {
+                        // 例如旧格式的 .tlwf：这次整体保存会以当前格式重写它，下一次即可追加
+                        LOG_WARNING("Cannot journal '" + saveName + "', doing a full save: " + std::string(e.what()));
+                    }
+                }
+                if (useJournal && journal) {
+                    ok = journal->append(*snapshot, chunks);
+                    if (ok) journal->scheduleCompaction(*tasks);
+                    journaled = true;
+                } else {
+                    // 整体保存会重写 .tlwf，已打开的日志随之失效
+                    if (journal) {
+                        journal->waitForCompaction();
+                        journal.reset();
+                    }
+                    ok = MapSerializer::saveCompressedMap(*snapshot, saveName, directory, !keepTlwf, nullptr, &saveStats);
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Background save of '" + saveName + "' threw: " + std::string(e.what()));
+            }
+            if (ok) unsavedChunks.clear();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                stats.lastSaveSeconds = seconds;
+                if (ok) {
+                    ++stats.completedCount;
+                    if (journaled) ++stats.journaledCount;
+                    else stats.lastSave = saveStats;
+                } else {
+                    ++stats.failedCount;
+                }
+            }
+            if (!ok) LOG_ERROR("Background save of '" + saveName + "' failed; the previous save file is unchanged.");
+            saving = false;
+            return ok;
+        });
+
+        std::ostringstream line;
+        line << "Background save of '" << saveName << "' scheduled: " << map.getLoadedChunkCount() << " chunks snapshotted in "
+             << std::fixed << std::setprecision(2) << snapshotSeconds * 1000.0 << " ms.";
+        LOG_INFO(line.str());
+        return true;
+    }
+
+    bool BackgroundSaver::isSaving() const {
+        return saving;
+    }
+
+    bool BackgroundSaver::wait() {
+        bool ok = true;
+        if (pendingSave.valid()) ok = pendingSave.get();
+        if (journal) journal->waitForCompaction();
+        return ok;
+    }
+
+    BackgroundSaver::Stats BackgroundSaver::getStats() const {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        return stats;
+    }
+
+} // namespace TilelandWorld
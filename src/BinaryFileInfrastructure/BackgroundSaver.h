@@ -0,0 +1,95 @@
+#pragma once
+#ifndef TILELANDWORLD_BACKGROUNDSAVER_H
+#define TILELANDWORLD_BACKGROUNDSAVER_H
+
+#include "MapSerializer.h"
+#include "SaveJournal.h"
+#include "../Coordinates.h"
+#include "../Utils/TaskSystem.h"
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <atomic>
+#include <unordered_set>
+
+namespace TilelandWorld {
+
+    class Map;
+
+    /**
+     * @brief 不阻塞游戏循环的后台存档 (写出 .tlwz)。
+     *
+     * schedule 在调用线程上 (持有地图锁) 只做 MapSerializer::createSaveSnapshot：复制已加载区块的对象，
+     * 索引数组以写时复制共享，开销为 O(区块数) 的小块复制，不编码也不做 I/O。编码、压缩、落盘与替换
+     * (先写临时文件，fsync 后 rename，见 saveCompressedMap) 都在 TaskSystem 的一个工作线程上完成，
+     * 期间主线程可以照常修改地图：被修改的区块先复制出自己的索引数组，快照内容不变。
+     *
+     * 地图从本存档的 .tlwf 按需读取区块、且调用方提供修改过的区块时，改为经 SaveJournal 把这些区块追加到 .tlwf
+     * (loadMapFromSave 优先读取它)，开销与修改量成正比而与世界大小无关；垃圾比例达到阈值时在同一个 TaskSystem 上后台压缩。
+     * 此时 .tlwz 不再更新，只作为 .tlwf 损坏时的旧备份。
+     *
+     * 同一时间只进行一次保存；上一次尚未完成时 schedule 直接返回 false，由调用方稍后重试。
+     * 后台任务持有快照 (及其共享的后备存储与存档源)，但本对象析构时会等待它完成，
+     * 因此本对象应先于 TaskSystem 停止与地图销毁之前销毁 (或先调用 wait)。
+     */
+    class BackgroundSaver {
+    public:
+        struct Stats {
+            size_t scheduledCount{0};       // 提交的保存次数
+            size_t completedCount{0};       // 成功完成的保存次数
+            size_t failedCount{0};
+            double lastSnapshotSeconds{0.0}; // 最近一次快照耗时 (调用线程实际被占用的时间)
+            double lastSaveSeconds{0.0};     // 最近一次后台保存耗时 (从提交到替换完成)
+            size_t journaledCount{0};       // 其中以日志追加方式完成的次数
+            MapSerializer::SaveStats lastSave{}; // 最近一次成功保存的统计
+        };
+
+        // keepTlwf 为 true 时同时写出 .tlwf (见 saveCompressedMap 的 deleteTlwfAfterwards)。
+        BackgroundSaver(std::string saveName, std::string directory, bool keepTlwf = false);
+        // 等待尚未完成的保存。
+        ~BackgroundSaver();
+
+        /**
+         * @brief 为 map 创建快照并把保存提交到 taskSystem。调用方需持有保护地图的锁，调用返回后即可释放。
+         * @param modifiedChunks 上一次成功提交以来修改过的区块 (可选)。提供时才可能以日志方式增量保存；
+         *        保存失败时这些区块保留在本对象中，随下一次保存重新写出。
+         * @return 提交了新的保存时返回 true；上一次保存尚未完成时返回 false。
+         * @note 保存任务内部串行压缩 (不向同一个 TaskSystem 提交子任务)，不会与其他任务互相等待。
+         */
+        bool schedule(const Map& map, TaskSystem& taskSystem, const std::unordered_set<ChunkCoord, ChunkCoordHash>* modifiedChunks = nullptr);
+
+        // 是否有尚未完成的保存。
+        bool isSaving() const;
+
+        // 等待后台保存 (及日志的后台压缩) 完成并返回保存结果；没有后台保存时返回 true。
+        bool wait();
+
+        Stats getStats() const;
+        const std::string& getSaveName() const { return saveName; }
+
+    private:
+        std::string saveName;
+        std::string directory;
+        bool keepTlwf;
+
+        std::future<bool> pendingSave;
+        std::atomic<bool> saving{false};
+
+        // 以下两项只由保存任务或 saving 为 false 时的调用线程访问，无需加锁
+        std::unique_ptr<SaveJournal> journal;                         // 首次以日志方式保存时打开
+        std::unordered_set<ChunkCoord, ChunkCoordHash> unsavedChunks; // 尚未成功写出的修改区块
+
+        // 地图是否正从本存档的 .tlwf 按需读取区块。
+        bool readsFromSaveTlwf(const Map& map) const;
+
+        mutable std::mutex statsMutex; // 保护 stats (后台任务完成时写入)
+        Stats stats;
+
+        BackgroundSaver(const BackgroundSaver&) = delete;
+        BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_BACKGROUNDSAVER_H
@@ -1,17 +1,29 @@
 #include "BinaryReader.h"
 #include "../Utils/Logger.h" // <-- 包含 Logger
 #include <stdexcept> // For potential exceptions
+#include <algorithm> // For std::min
 #include <vector>    // For reading string
+#include <cstring>   // For memcpy
 
 namespace TilelandWorld {
 
     BinaryReader::BinaryReader(const std::string& filepath) : filepath(filepath) {
+        std::string mapError;
+        try {
+            mapping = std::make_unique<MappedFile>(filepath);
+            streamSize = static_cast<std::streamoff>(mapping->size());
+            return;
+        } catch (const std::exception& e) {
+            mapError = e.what(); // 文件不存在时流后端同样会失败，由下面抛出
+        }
+
         // 启用异常：当 failbit 或 badbit 被设置时，流将抛出 std::ios_base::failure
         stream.exceptions(std::ios::failbit | std::ios::badbit);
         try {
             stream.open(filepath, std::ios::binary | std::ios::ate); // 二进制模式，初始定位到末尾以获取大小
             streamSize = stream.tellg(); // 获取文件大小
             stream.seekg(0, std::ios::beg); // 重置到文件开头
+            LOG_WARNING("BinaryReader: Memory mapping unavailable, using stream reads: " + mapError);
         } catch (const std::ios_base::failure& e) {
             // 包装底层异常，提供更清晰的上下文
             throw std::runtime_error("BinaryReader: Failed to open or setup file for reading: " + filepath + " - " + e.what());
@@ -25,17 +37,51 @@ namespace TilelandWorld {
     }
 
     bool BinaryReader::good() const {
+        if (mapping) return !mappedEof;
         // good() 仍然有用，但异常机制提供了更主动的错误处理
         return stream.good();
     }
 
     bool BinaryReader::eof() const {
+        if (mapping) return mappedEof;
         // eof() 检查 eofbit，它通常不包含在 exceptions() 中，所以需要单独检查
         return stream.eof();
     }
 
+    bool BinaryReader::readMapped(void* out, size_t size) {
+        const size_t remaining = mapping->size() - position;
+        if (remaining == 0) {
+            mappedEof = true;
+            return false;
+        }
+        if (size > remaining) {
+            mappedEof = true;
+            LOG_ERROR("BinaryReader::read<T> failed due to unexpected EOF. Read "
+                      + std::to_string(remaining) + "/" + std::to_string(size) + " bytes.");
+            position = mapping->size();
+            return false;
+        }
+        std::memcpy(out, mapping->data() + position, size);
+        position += size;
+        return true;
+    }
+
+    const uint8_t* BinaryReader::readView(size_t size) {
+        if (!mapping) return nullptr;
+        const uint8_t* view = mapping->span(position, size);
+        if (view) position += size;
+        return view;
+    }
+
     size_t BinaryReader::readBytes(char* buffer, size_t size) {
         if (!buffer || size == 0) return 0;
+        if (mapping) {
+            const size_t count = std::min(size, mapping->size() - position);
+            if (count < size) mappedEof = true;
+            if (count > 0) std::memcpy(buffer, mapping->data() + position, count);
+            position += count;
+            return count;
+        }
         // 在读取前检查 EOF，因为 peek() 不会设置 failbit/badbit
         if (stream.peek() == EOF) {
             // 如果已经到文件末尾，不尝试读取，返回 0
@@ -103,10 +149,18 @@ namespace TilelandWorld {
     }
 
     std::streampos BinaryReader::tell() {
+        if (mapping) return static_cast<std::streamoff>(position);
         return stream.tellg();
     }
 
     bool BinaryReader::seek(std::streampos pos) {
+        if (mapping) {
+            std::streamoff target = pos;
+            if (target < 0 || static_cast<uint64_t>(target) > mapping->size()) return false;
+            position = static_cast<size_t>(target);
+            mappedEof = false;
+            return true;
+        }
         // 清除状态位，特别是 eofbit，否则 seekg 可能失败
         stream.clear();
         try {
@@ -119,6 +173,12 @@ namespace TilelandWorld {
     }
 
     bool BinaryReader::seek(std::streamoff off, std::ios_base::seekdir way) {
+        if (mapping) {
+            std::streamoff origin = way == std::ios::beg ? 0
+                                  : way == std::ios::cur ? static_cast<std::streamoff>(position)
+                                  : static_cast<std::streamoff>(mapping->size());
+            return seek(std::streampos(origin + off));
+        }
         stream.clear();
         try {
             stream.seekg(off, way);
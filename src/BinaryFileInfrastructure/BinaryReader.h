@@ -9,12 +9,16 @@
 #include <stdexcept>   // For std::runtime_error
 #include <iostream>    // For std::cerr
 #include "../Utils/Logger.h" // <-- 包含 Logger
+#include "MappedFile.h"
+#include <memory>
+#include <cstdint>
 
 namespace TilelandWorld {
 
     class BinaryReader {
     public:
         // 构造函数：打开指定文件用于二进制读取。
+        // 优先以只读内存映射方式打开 (见 MappedFile)，读取直接从映射中复制；映射失败时退回 std::ifstream。
         explicit BinaryReader(const std::string& filepath);
 
         // 析构函数：关闭文件流。
@@ -31,6 +35,9 @@ namespace TilelandWorld {
         template <typename T,
                   typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
         bool read(T& data) {
+            if (mapping) {
+                return readMapped(&data, sizeof(T));
+            }
             // 在读取前检查 EOF，因为 peek() 不会设置 failbit/badbit
             if (stream.peek() == EOF) {
                  return false; // 已经到文件末尾，无法读取
@@ -77,11 +84,32 @@ namespace TilelandWorld {
         // 获取文件大小。
         std::streampos fileSize();
 
+        // 是否以内存映射方式读取。
+        bool isMapped() const { return mapping != nullptr; }
+
+        /**
+         * @brief 零拷贝读取：返回当前位置起 size 字节的只读视图并前移读取位置。
+         * @return 未映射或剩余数据不足时返回 nullptr (读取位置不变)，调用方应退回 readBytes。
+         *         视图在 BinaryReader 析构前有效。
+         */
+        const uint8_t* readView(size_t size);
+
+        // 底层映射 (未映射时为 nullptr)，可用 MappedFile::span/readAt 按偏移量直接访问。
+        const MappedFile* getMapping() const { return mapping.get(); }
+
     private:
         std::ifstream stream;
         std::string filepath;
         std::streampos streamSize = -1; // 缓存文件大小
 
+        // 内存映射后端 (优先使用)；映射时 stream 不打开
+        std::unique_ptr<MappedFile> mapping;
+        size_t position = 0;
+        bool mappedEof = false;
+
+        // 与流后端一致：位于末尾时静默失败，数据不足时记录错误并失败
+        bool readMapped(void* out, size_t size);
+
         // 禁用拷贝构造和赋值
         BinaryReader(const BinaryReader&) = delete;
         BinaryReader& operator=(const BinaryReader&) = delete;
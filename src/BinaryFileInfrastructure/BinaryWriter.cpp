@@ -2,13 +2,27 @@
 #include "../Utils/Logger.h" // <-- 包含 Logger
 #include <stdexcept> // For potential exceptions
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace TilelandWorld {
 
-    BinaryWriter::BinaryWriter(const std::string& filepath) : filepath(filepath) {
+    BinaryWriter::BinaryWriter(const std::string& filepath, bool truncate) : filepath(filepath) {
         // 启用异常：当 failbit 或 badbit 被设置时，流将抛出 std::ios_base::failure
         stream.exceptions(std::ios::failbit | std::ios::badbit);
         try {
-            stream.open(filepath, std::ios::binary | std::ios::trunc); // 二进制模式，覆盖写入
+            if (truncate) {
+                stream.open(filepath, std::ios::binary | std::ios::trunc); // 二进制模式，覆盖写入
+            } else {
+                stream.open(filepath, std::ios::binary | std::ios::in | std::ios::out); // 更新模式，不截断
+            }
         } catch (const std::ios_base::failure& e) {
             // 包装底层异常
             throw std::runtime_error("BinaryWriter: Failed to open file for writing: " + filepath + " - " + e.what());
@@ -80,4 +94,37 @@ namespace TilelandWorld {
          }
     }
 
+    bool BinaryWriter::flush() {
+        try {
+            stream.flush();
+            return true;
+        } catch (const std::ios_base::failure& e) {
+            LOG_ERROR("BinaryWriter::flush failed: " + std::string(e.what()));
+            return false;
+        }
+    }
+
+    bool BinaryWriter::syncToDisk(const std::string& filepath) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            LOG_ERROR("BinaryWriter::syncToDisk failed to open: " + filepath);
+            return false;
+        }
+        const bool synced = FlushFileBuffers(file) != 0;
+        CloseHandle(file);
+#else
+        const int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG_ERROR("BinaryWriter::syncToDisk failed to open: " + filepath);
+            return false;
+        }
+        const bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+#endif
+        if (!synced) LOG_ERROR("BinaryWriter::syncToDisk failed: " + filepath);
+        return synced;
+    }
+
 } // namespace TilelandWorld
@@ -14,8 +14,8 @@ namespace TilelandWorld {
     class BinaryWriter {
     public:
         // 构造函数：打开指定文件用于二进制写入。
-        // 如果文件已存在，默认会覆盖。
-        explicit BinaryWriter(const std::string& filepath);
+        // 如果文件已存在，默认会覆盖；truncate 为 false 时以更新方式打开已存在的文件 (保留原内容，文件必须存在)。
+        explicit BinaryWriter(const std::string& filepath, bool truncate = true);
 
         // 析构函数：关闭文件流。
         ~BinaryWriter();
@@ -51,6 +51,12 @@ namespace TilelandWorld {
         bool seek(std::streampos pos);
         bool seek(std::streamoff off, std::ios_base::seekdir way);
 
+        // 将缓冲区中的数据交给操作系统 (不保证落盘)。
+        bool flush();
+
+        // 把已关闭 (或已 flush) 文件的内容强制写入磁盘 (fsync / FlushFileBuffers)，用于替换存档前确保临时文件完整。
+        static bool syncToDisk(const std::string& filepath);
+
     private:
         std::ofstream stream;
         std::string filepath;
@@ -0,0 +1,210 @@
+#include "Checksum.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TILELANDWORLD_CRC32_PCLMUL 1
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TILELANDWORLD_PCLMUL_TARGET
+#else
+#include <cpuid.h>
+#define TILELANDWORLD_PCLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+#endif
+#endif
+
+namespace TilelandWorld {
+
+    namespace {
+        constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320; // IEEE 802.3, reversed
+
+        // tables[0] 为逐字节表；tables[k][i] 为字节 i 之后再经过 k 个零字节的余数
+        struct CRC32Tables {
+            uint32_t tables[8][256];
+            constexpr CRC32Tables() : tables{} {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t crc = i;
+                    for (int j = 0; j < 8; ++j) crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLYNOMIAL : crc >> 1;
+                    tables[0][i] = crc;
+                }
+                for (uint32_t i = 0; i < 256; ++i) {
+                    for (int k = 1; k < 8; ++k) tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+                }
+            }
+        };
+        constexpr CRC32Tables CRC32_TABLES{};
+
+        // GF(2) 上 a * b mod P (位反转表示，最高位为 x^0)
+        uint32_t multiplyModP(uint32_t a, uint32_t b) {
+            uint32_t product = 0;
+            for (uint32_t m = 1u << 31; m != 0; m >>= 1) {
+                if (a & m) {
+                    product ^= b;
+                    if ((a & (m - 1)) == 0) break;
+                }
+                b = (b & 1) ? (b >> 1) ^ CRC32_POLYNOMIAL : b >> 1;
+            }
+            return product;
+        }
+
+        // X2N[k] = x^(2^k) mod P
+        struct PowerTable {
+            uint32_t x2n[32];
+            PowerTable() {
+                uint32_t p = 1u << 30; // x^1
+                x2n[0] = p;
+                for (int k = 1; k < 32; ++k) x2n[k] = p = multiplyModP(p, p);
+            }
+        };
+
+        // x^(n * 2^k) mod P
+        uint32_t powerModP(uint64_t n, unsigned k) {
+            static const PowerTable powers;
+            uint32_t p = 1u << 31; // x^0
+            for (; n != 0; n >>= 1, ++k) {
+                if (n & 1) p = multiplyModP(powers.x2n[k & 31], p);
+            }
+            return p;
+        }
+
+#ifdef TILELANDWORLD_CRC32_PCLMUL
+        bool cpuSupportsPclmul() {
+#if defined(_MSC_VER)
+            int info[4] = {};
+            __cpuid(info, 1);
+            const unsigned ecx = static_cast<unsigned>(info[2]);
+#else
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+#endif
+            const bool pclmul = (ecx & (1u << 1)) != 0;
+            const bool sse41 = (ecx & (1u << 19)) != 0;
+            return pclmul && sse41;
+        }
+
+        inline __m128i load(const uint8_t* p) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        // x 的高低 64 位分别乘以 k 的高低 64 位 (即 x^(n+64) 与 x^n mod P)，向后移动 n 位后与 next 合并
+        TILELANDWORLD_PCLMUL_TARGET
+        inline __m128i fold(__m128i x, __m128i k, __m128i next) {
+            const __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+            const __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+            return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+        }
+#endif
+
+        // 折叠每次处理 64 字节，短数据直接查表更快
+        constexpr size_t PCLMUL_MIN_SIZE = 64;
+    }
+
+    namespace Detail {
+
+        uint32_t crc32Bytewise(uint32_t crc, const uint8_t* data, size_t size) {
+            for (size_t i = 0; i < size; ++i) {
+                crc = (crc >> 8) ^ CRC32_TABLES.tables[0][(crc ^ data[i]) & 0xFF];
+            }
+            return crc;
+        }
+
+        uint32_t crc32SliceBy8(uint32_t crc, const uint8_t* data, size_t size) {
+            const auto& t = CRC32_TABLES.tables;
+            // 按小端读取 (存档格式本身也假定小端)
+            while (size >= 8) {
+                uint32_t lo = 0, hi = 0;
+                std::memcpy(&lo, data, sizeof(lo));
+                std::memcpy(&hi, data + 4, sizeof(hi));
+                lo ^= crc;
+                crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+                    ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+                data += 8;
+                size -= 8;
+            }
+            return crc32Bytewise(crc, data, size);
+        }
+
+#ifdef TILELANDWORLD_CRC32_PCLMUL
+        // 进位无关乘法折叠 (Intel, "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ")：
+        // 4 个 128 位累加器每轮折叠 64 字节，再依次折叠为 128、64、32 位，最后 Barrett 约减。
+        TILELANDWORLD_PCLMUL_TARGET
+        uint32_t crc32Pclmul(uint32_t crc, const uint8_t* data, size_t size) {
+            if (size < PCLMUL_MIN_SIZE) return crc32SliceBy8(crc, data, size);
+
+            const size_t folded = size & ~static_cast<size_t>(15);
+            const uint8_t* end = data + folded;
+
+            __m128i x0 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+            __m128i x1 = load(data + 16);
+            __m128i x2 = load(data + 32);
+            __m128i x3 = load(data + 48);
+            data += 64;
+
+            // x^(512+64) 与 x^512 mod P
+            const __m128i k1k2 = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+            while (end - data >= 64) {
+                x0 = fold(x0, k1k2, load(data));
+                x1 = fold(x1, k1k2, load(data + 16));
+                x2 = fold(x2, k1k2, load(data + 32));
+                x3 = fold(x3, k1k2, load(data + 48));
+                data += 64;
+            }
+
+            // x^(128+64) 与 x^128 mod P
+            const __m128i k3k4 = _mm_set_epi64x(0x0ccaa009e, 0x1751997d0);
+            x0 = fold(x0, k3k4, x1);
+            x0 = fold(x0, k3k4, x2);
+            x0 = fold(x0, k3k4, x3);
+            for (; data < end; data += 16) x0 = fold(x0, k3k4, load(data));
+
+            // 128 -> 64 位 (同时补上 32 个零位)
+            const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+            x0 = _mm_xor_si128(_mm_clmulepi64_si128(k3k4, x0, 0x01), _mm_srli_si128(x0, 8));
+            // 64 -> 32 位
+            const __m128i k5 = _mm_set_epi64x(0, 0x163cd6124);
+            x0 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x0, mask32), k5, 0x00), _mm_srli_si128(x0, 4));
+            // Barrett 约减：P' = 0x1DB710641，mu = 0x1F7011641
+            const __m128i poly = _mm_set_epi64x(0x1F7011641, 0x1DB710641);
+            __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x0, mask32), poly, 0x10);
+            t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), poly, 0x00);
+            crc = static_cast<uint32_t>(_mm_extract_epi32(_mm_xor_si128(x0, t), 1));
+
+            return crc32SliceBy8(crc, data, size - folded);
+        }
+#else
+        uint32_t crc32Pclmul(uint32_t crc, const uint8_t* data, size_t size) {
+            return crc32SliceBy8(crc, data, size);
+        }
+#endif
+
+    } // namespace Detail
+
+    CRC32Implementation activeCRC32Implementation() {
+#ifdef TILELANDWORLD_CRC32_PCLMUL
+        static const CRC32Implementation active = cpuSupportsPclmul() ? CRC32Implementation::Pclmul : CRC32Implementation::SliceBy8;
+        return active;
+#else
+        return CRC32Implementation::SliceBy8;
+#endif
+    }
+
+    uint32_t updateCRC32(uint32_t crc, const void* data, size_t size) {
+        if (!data || size == 0) return crc;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+        if (size >= PCLMUL_MIN_SIZE && activeCRC32Implementation() == CRC32Implementation::Pclmul) {
+            crc = Detail::crc32Pclmul(crc, bytes, size);
+        } else {
+            crc = Detail::crc32SliceBy8(crc, bytes, size);
+        }
+        return ~crc;
+    }
+
+    uint32_t combineCRC32(uint32_t crcA, uint32_t crcB, uint64_t sizeB) {
+        // 在 A 后追加 sizeB 个字节相当于 A 的余数乘以 x^(8 * sizeB)
+        return multiplyModP(powerModP(sizeB, 3), crcA) ^ crcB;
+    }
+
+} // namespace TilelandWorld
@@ -4,7 +4,6 @@
 
 #include <cstdint>
 #include <cstddef> // For size_t
-#include <array>   // For std::array
 
 namespace TilelandWorld {
 
@@ -57,62 +56,48 @@ namespace TilelandWorld {
         return checksum;
     }
 
-    // --- CRC32 Calculation with Lookup Table ---
+    // --- CRC32 (IEEE 802.3, reflected polynomial 0xEDB88320) ---
 
-    namespace Detail {
-        // CRC32 polynomial (IEEE 802.3) - reversed
-        constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
-
-        // Function to generate the CRC32 lookup table
-        inline std::array<uint32_t, 256> generateCRC32Table() {
-            std::array<uint32_t, 256> table = {};
-            for (uint32_t i = 0; i < 256; ++i) {
-                uint32_t crc = i;
-                for (int j = 0; j < 8; ++j) {
-                    if (crc & 1) {
-                        crc = (crc >> 1) ^ CRC32_POLYNOMIAL;
-                    } else {
-                        crc >>= 1;
-                    }
-                }
-                table[i] = crc;
-            }
-            return table;
-        }
+    enum class CRC32Implementation {
+        SliceBy8, // 可移植实现：每次查 8 张表处理 8 字节
+        Pclmul    // x86 PCLMULQDQ 进位无关乘法折叠，每次处理 64 字节
+    };
 
-        // Helper function to get the initialized table (thread-safe since C++11)
-        inline const std::array<uint32_t, 256>& getCRC32TableInstance() {
-            // Static local variable initialization is guaranteed to happen only once.
-            static const std::array<uint32_t, 256> crcTable = generateCRC32Table();
-            return crcTable;
-        }
-    } // namespace Detail
+    /**
+     * @brief 继续计算 CRC32：crc 为已处理数据的 CRC32 (初始为 0)，返回追加 data 之后的 CRC32。
+     * @note 与 zlib 的 crc32() 语义一致。首次调用时检测 CPU，支持 PCLMULQDQ 与 SSE4.1 时使用折叠实现，否则使用 slicing-by-8。
+     */
+    uint32_t updateCRC32(uint32_t crc, const void* data, size_t size);
 
     /**
      * @brief 计算给定数据块的 CRC32 校验和 (IEEE 802.3 polynomial)。
      * @param data 指向数据块的指针。
      * @param size 数据块的大小（字节）。
      * @return 计算出的 32 位 CRC32 校验和。
-     * @note 使用查找表优化。
      */
     inline uint32_t calculateCRC32(const void* data, size_t size) {
         if (!data || size == 0) {
             return 0;
         }
+        return updateCRC32(0, data, size);
+    }
 
-        const uint8_t* bytes = static_cast<const uint8_t*>(data);
-        uint32_t crc = 0xFFFFFFFF; // Initial value
-
-        // Get the precomputed lookup table
-        const auto& table = Detail::getCRC32TableInstance();
+    /**
+     * @brief 合并两段相邻数据的 CRC32：crcA 为前一段的 CRC32，crcB 为长度 sizeB 的后一段的 CRC32，
+     *        返回两段拼接后的 CRC32。各段可以在不同线程上分别计算。
+     * @note 耗时与 log2(sizeB) 成正比，与数据量无关。
+     */
+    uint32_t combineCRC32(uint32_t crcA, uint32_t crcB, uint64_t sizeB);
 
-        // Process data byte by byte using the lookup table
-        for (size_t i = 0; i < size; ++i) {
-            crc = (crc >> 8) ^ table[(crc ^ bytes[i]) & 0xFF];
-        }
+    // 当前 CPU 上 updateCRC32 使用的实现
+    CRC32Implementation activeCRC32Implementation();
 
-        return ~crc; // Final bit inversion
-    }
+    namespace Detail {
+        // 各实现的入口，供测试与基准对照。crc 为未取反的寄存器值 (初始 0xFFFFFFFF)
+        uint32_t crc32Bytewise(uint32_t crc, const uint8_t* data, size_t size);  // 逐字节查表 (旧实现)
+        uint32_t crc32SliceBy8(uint32_t crc, const uint8_t* data, size_t size);
+        uint32_t crc32Pclmul(uint32_t crc, const uint8_t* data, size_t size);    // 仅在 activeCRC32Implementation() == Pclmul 时可调用
+    } // namespace Detail
 
 } // namespace TilelandWorld
 
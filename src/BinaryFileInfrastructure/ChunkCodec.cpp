@@ -0,0 +1,314 @@
+#include "ChunkCodec.h"
+#include "FileFormat.h"
+#include "../Constants.h"
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILELANDWORLD_CHUNKCODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace TilelandWorld {
+
+    namespace {
+        constexpr size_t TILE_COUNT = static_cast<size_t>(CHUNK_VOLUME);
+        constexpr size_t BITMAP_BYTES = TILE_COUNT / 8;
+        constexpr size_t SIMD_GROUP = 16; // 每组 16 个 Tile：4 个打包寄存器 -> 1 个字节寄存器
+        static_assert(TILE_COUNT % SIMD_GROUP == 0, "CHUNK_VOLUME must be a multiple of 16");
+        static_assert(TILE_COUNT <= 0xFFFF, "Run lengths and run counts are stored as uint16");
+        // 稀疏位图每个置位 2 字节，少于该数量时比逐位保存更小
+        constexpr size_t SPARSE_BITMAP_LIMIT = (BITMAP_BYTES - sizeof(uint16_t)) / sizeof(uint16_t);
+
+        // 按字段拆开的 Tile 平面 (位图中第 i 位对应第 i 个 Tile)
+        struct TilePlanes {
+            std::array<uint16_t, TILE_COUNT> terrain;
+            std::array<uint8_t, TILE_COUNT> light;
+            std::array<uint8_t, BITMAP_BYTES> explored;
+            std::array<uint8_t, BITMAP_BYTES> overridden;
+        };
+
+        // 位图字节 -> 8 个 0/1 字节，解码时展开位图用
+        struct BitExpandTable {
+            uint8_t bytes[256][8];
+            constexpr BitExpandTable() : bytes{} {
+                for (int v = 0; v < 256; ++v)
+                    for (int bit = 0; bit < 8; ++bit) bytes[v][bit] = static_cast<uint8_t>((v >> bit) & 1);
+            }
+        };
+        constexpr BitExpandTable BIT_EXPAND{};
+
+        void splitPlanes(const uint32_t* packed, TilePlanes& planes) {
+            size_t i = 0;
+#ifdef TILELANDWORLD_CHUNKCODEC_SSE2
+            const __m128i lowByte = _mm_set1_epi32(0xFF);
+            const __m128i flagBits = _mm_set1_epi32(0x03);
+            for (; i < TILE_COUNT; i += SIMD_GROUP) {
+                __m128i p[4];
+                for (int k = 0; k < 4; ++k) p[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed + i + k * 4));
+
+                // 地形：低 16 位。先符号扩展，使有符号饱和打包保持原位模式
+                __m128i t[4];
+                for (int k = 0; k < 4; ++k) t[k] = _mm_srai_epi32(_mm_slli_epi32(p[k], 16), 16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(planes.terrain.data() + i), _mm_packs_epi32(t[0], t[1]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(planes.terrain.data() + i + 8), _mm_packs_epi32(t[2], t[3]));
+
+                // 光照：位 16-23
+                __m128i l[4];
+                for (int k = 0; k < 4; ++k) l[k] = _mm_and_si128(_mm_srli_epi32(p[k], 16), lowByte);
+                const __m128i light = _mm_packus_epi16(_mm_packs_epi32(l[0], l[1]), _mm_packs_epi32(l[2], l[3]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(planes.light.data() + i), light);
+
+                // 标志：位 24 (已探索)、位 25 (覆盖)。移到每个字节的最高位后用 movemask 收集
+                __m128i f[4];
+                for (int k = 0; k < 4; ++k) f[k] = _mm_and_si128(_mm_srli_epi32(p[k], 24), flagBits);
+                const __m128i flags = _mm_packus_epi16(_mm_packs_epi32(f[0], f[1]), _mm_packs_epi32(f[2], f[3]));
+                const int exploredMask = _mm_movemask_epi8(_mm_slli_epi16(flags, 7));
+                const int overrideMask = _mm_movemask_epi8(_mm_slli_epi16(flags, 6));
+                planes.explored[i / 8] = static_cast<uint8_t>(exploredMask);
+                planes.explored[i / 8 + 1] = static_cast<uint8_t>(exploredMask >> 8);
+                planes.overridden[i / 8] = static_cast<uint8_t>(overrideMask);
+                planes.overridden[i / 8 + 1] = static_cast<uint8_t>(overrideMask >> 8);
+            }
+#endif
+            for (; i < TILE_COUNT; i += 8) {
+                uint8_t exploredByte = 0, overrideByte = 0;
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    const uint32_t value = packed[i + bit];
+                    planes.terrain[i + bit] = static_cast<uint16_t>(value & 0xFFFFu);
+                    planes.light[i + bit] = static_cast<uint8_t>((value >> 16) & 0xFFu);
+                    exploredByte |= static_cast<uint8_t>(((value >> 24) & 1u) << bit);
+                    overrideByte |= static_cast<uint8_t>(((value >> 25) & 1u) << bit);
+                }
+                planes.explored[i / 8] = exploredByte;
+                planes.overridden[i / 8] = overrideByte;
+            }
+        }
+
+        void mergePlanes(const TilePlanes& planes, uint32_t* packed) {
+            size_t i = 0;
+#ifdef TILELANDWORLD_CHUNKCODEC_SSE2
+            for (; i < TILE_COUNT; i += SIMD_GROUP) {
+                alignas(16) uint8_t flagBytes[SIMD_GROUP];
+                for (size_t half = 0; half < 2; ++half) {
+                    const uint8_t* e = BIT_EXPAND.bytes[planes.explored[i / 8 + half]];
+                    const uint8_t* o = BIT_EXPAND.bytes[planes.overridden[i / 8 + half]];
+                    for (size_t bit = 0; bit < 8; ++bit) flagBytes[half * 8 + bit] = static_cast<uint8_t>(e[bit] | (o[bit] << 1));
+                }
+                const __m128i flags = _mm_load_si128(reinterpret_cast<const __m128i*>(flagBytes));
+                const __m128i light = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.light.data() + i));
+                // 高 16 位 = 光照 | 标志 << 8
+                const __m128i highLo = _mm_unpacklo_epi8(light, flags);
+                const __m128i highHi = _mm_unpackhi_epi8(light, flags);
+                const __m128i t0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.terrain.data() + i));
+                const __m128i t1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.terrain.data() + i + 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i), _mm_unpacklo_epi16(t0, highLo));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i + 4), _mm_unpackhi_epi16(t0, highLo));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i + 8), _mm_unpacklo_epi16(t1, highHi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i + 12), _mm_unpackhi_epi16(t1, highHi));
+            }
+#endif
+            for (; i < TILE_COUNT; ++i) {
+                const uint32_t explored = (planes.explored[i / 8] >> (i % 8)) & 1u;
+                const uint32_t overridden = (planes.overridden[i / 8] >> (i % 8)) & 1u;
+                packed[i] = static_cast<uint32_t>(planes.terrain[i]) | (static_cast<uint32_t>(planes.light[i]) << 16)
+                          | (explored << 24) | (overridden << 25);
+            }
+        }
+
+        // 从 start 开始与 terrain[start] 相同的连续元素个数
+        size_t runLength(const uint16_t* terrain, size_t start) {
+            const uint16_t value = terrain[start];
+            size_t end = start + 1;
+#ifdef TILELANDWORLD_CHUNKCODEC_SSE2
+            // 整组相同时 8 个一跳，遇到不同的组再逐个定位
+            const __m128i needle = _mm_set1_epi16(static_cast<short>(value));
+            while (end + 8 <= TILE_COUNT) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(terrain + end));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(block, needle)) != 0xFFFF) break;
+                end += 8;
+            }
+#endif
+            while (end < TILE_COUNT && terrain[end] == value) ++end;
+            return end - start;
+        }
+
+        bool allBytesEqual(const uint8_t* data, size_t count, uint8_t value) {
+            size_t i = 0;
+#ifdef TILELANDWORLD_CHUNKCODEC_SSE2
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+            for (; i + 16 <= count; i += 16) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)) != 0xFFFF) return false;
+            }
+#endif
+            for (; i < count; ++i) {
+                if (data[i] != value) return false;
+            }
+            return true;
+        }
+
+        void appendBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+
+        void appendBitmap(std::vector<uint8_t>& out, const std::array<uint8_t, BITMAP_BYTES>& bitmap) {
+            if (allBytesEqual(bitmap.data(), bitmap.size(), 0x00)) {
+                out.push_back(TILE_PLANE_ZERO);
+                return;
+            }
+            if (allBytesEqual(bitmap.data(), bitmap.size(), 0xFF)) {
+                out.push_back(TILE_PLANE_ONE);
+                return;
+            }
+
+            // 置位很少时 (例如个别覆盖 Tile) 只存下标
+            std::vector<uint16_t> indices;
+            for (size_t byte = 0; byte < bitmap.size() && indices.size() < SPARSE_BITMAP_LIMIT; ++byte) {
+                if (bitmap[byte] == 0) continue;
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    if ((bitmap[byte] >> bit) & 1) indices.push_back(static_cast<uint16_t>(byte * 8 + bit));
+                }
+            }
+            if (indices.size() < SPARSE_BITMAP_LIMIT) {
+                const uint16_t count = static_cast<uint16_t>(indices.size());
+                out.push_back(TILE_PLANE_SPARSE);
+                appendBytes(out, &count, sizeof(count));
+                appendBytes(out, indices.data(), indices.size() * sizeof(uint16_t));
+            } else {
+                out.push_back(TILE_PLANE_RAW);
+                appendBytes(out, bitmap.data(), bitmap.size());
+            }
+        }
+
+        // 顺序读取并检查剩余长度
+        class PlaneReader {
+        public:
+            PlaneReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+            const uint8_t* take(size_t count, const char* what) {
+                if (count > size - offset) {
+                    throw std::runtime_error(std::string("Compact chunk data truncated in ") + what + ".");
+                }
+                const uint8_t* p = data + offset;
+                offset += count;
+                return p;
+            }
+            uint8_t takeByte(const char* what) { return *take(1, what); }
+            size_t consumed() const { return offset; }
+
+        private:
+            const uint8_t* data;
+            size_t size;
+            size_t offset = 0;
+        };
+
+        void readBitmap(PlaneReader& reader, std::array<uint8_t, BITMAP_BYTES>& bitmap, const char* what) {
+            const uint8_t mode = reader.takeByte(what);
+            if (mode == TILE_PLANE_ZERO) {
+                bitmap.fill(0x00);
+            } else if (mode == TILE_PLANE_ONE) {
+                bitmap.fill(0xFF);
+            } else if (mode == TILE_PLANE_RAW) {
+                std::memcpy(bitmap.data(), reader.take(bitmap.size(), what), bitmap.size());
+            } else if (mode == TILE_PLANE_SPARSE) {
+                uint16_t count = 0;
+                std::memcpy(&count, reader.take(sizeof(count), what), sizeof(count));
+                const uint8_t* indices = reader.take(static_cast<size_t>(count) * sizeof(uint16_t), what);
+                bitmap.fill(0x00);
+                int previous = -1;
+                for (uint16_t k = 0; k < count; ++k) {
+                    uint16_t index = 0;
+                    std::memcpy(&index, indices + k * sizeof(uint16_t), sizeof(index));
+                    if (index >= TILE_COUNT || static_cast<int>(index) <= previous) {
+                        throw std::runtime_error(std::string("Invalid tile index ") + std::to_string(index) + " in " + what + ".");
+                    }
+                    bitmap[index / 8] |= static_cast<uint8_t>(1u << (index % 8));
+                    previous = index;
+                }
+            } else {
+                throw std::runtime_error(std::string("Unknown plane mode ") + std::to_string(mode) + " in " + what + ".");
+            }
+        }
+    }
+
+    size_t ChunkCodec::encodeTiles(const Tile* tiles, std::vector<uint8_t>& out) {
+        std::vector<uint32_t> packed(TILE_COUNT);
+        for (size_t i = 0; i < TILE_COUNT; ++i) packed[i] = tiles[i].toPacked();
+        auto planes = std::make_unique<TilePlanes>();
+        splitPlanes(packed.data(), *planes);
+
+        const size_t start = out.size();
+
+        // 地形游程 (游程数先占位)
+        const size_t countOffset = out.size();
+        out.resize(out.size() + sizeof(uint16_t));
+        uint16_t runCount = 0;
+        for (size_t i = 0; i < TILE_COUNT;) {
+            const size_t length = runLength(planes->terrain.data(), i);
+            CompactTerrainRun run{planes->terrain[i], static_cast<uint16_t>(length)};
+            appendBytes(out, &run, sizeof(run));
+            ++runCount;
+            i += length;
+        }
+        std::memcpy(out.data() + countOffset, &runCount, sizeof(runCount));
+
+        // 光照平面
+        if (allBytesEqual(planes->light.data(), TILE_COUNT, planes->light[0])) {
+            out.push_back(TILE_PLANE_UNIFORM);
+            out.push_back(planes->light[0]);
+        } else {
+            out.push_back(TILE_PLANE_RAW);
+            appendBytes(out, planes->light.data(), TILE_COUNT);
+        }
+
+        appendBitmap(out, planes->explored);
+        appendBitmap(out, planes->overridden);
+        return out.size() - start;
+    }
+
+    size_t ChunkCodec::decodeTiles(const uint8_t* data, size_t size, Tile* tiles) {
+        PlaneReader reader(data, size);
+        auto planes = std::make_unique<TilePlanes>();
+
+        uint16_t runCount = 0;
+        std::memcpy(&runCount, reader.take(sizeof(runCount), "terrain runs"), sizeof(runCount));
+        const uint8_t* runs = reader.take(static_cast<size_t>(runCount) * sizeof(CompactTerrainRun), "terrain runs");
+        size_t filled = 0;
+        for (uint16_t r = 0; r < runCount; ++r) {
+            CompactTerrainRun run{};
+            std::memcpy(&run, runs + r * sizeof(CompactTerrainRun), sizeof(run));
+            if (run.length == 0 || run.length > TILE_COUNT - filled) {
+                throw std::runtime_error("Invalid terrain run length " + std::to_string(run.length) + " at tile " + std::to_string(filled) + ".");
+            }
+            std::fill_n(planes->terrain.data() + filled, run.length, run.terrain);
+            filled += run.length;
+        }
+        if (filled != TILE_COUNT) {
+            throw std::runtime_error("Terrain runs cover " + std::to_string(filled) + " of " + std::to_string(TILE_COUNT) + " tiles.");
+        }
+
+        const uint8_t lightMode = reader.takeByte("light plane");
+        if (lightMode == TILE_PLANE_UNIFORM) {
+            planes->light.fill(reader.takeByte("light plane"));
+        } else if (lightMode == TILE_PLANE_RAW) {
+            std::memcpy(planes->light.data(), reader.take(TILE_COUNT, "light plane"), TILE_COUNT);
+        } else {
+            throw std::runtime_error("Unknown plane mode " + std::to_string(lightMode) + " in light plane.");
+        }
+
+        readBitmap(reader, planes->explored, "explored bitmap");
+        readBitmap(reader, planes->overridden, "override bitmap");
+
+        std::vector<uint32_t> packed(TILE_COUNT);
+        mergePlanes(*planes, packed.data());
+        for (size_t i = 0; i < TILE_COUNT; ++i) tiles[i] = Tile::fromPacked(packed[i]);
+        return reader.consumed();
+    }
+
+} // namespace TilelandWorld
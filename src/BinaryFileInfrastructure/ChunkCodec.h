@@ -0,0 +1,36 @@
+#pragma once
+#ifndef TILELANDWORLD_CHUNKCODEC_H
+#define TILELANDWORLD_CHUNKCODEC_H
+
+#include "../Tile.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 区块 Tile 的紧凑平面编码 (CHUNK_RECORD_COMPACT 的 Tile 部分，布局见 FileFormat.h)。
+     *
+     * 打包 Tile 被拆成按字段存放的平面：地形 ID 沿 X 行做游程编码，光照为单独的字节平面 (均匀时只存 1 字节)，
+     * 已探索位与覆盖位各为一张位图 (全 0/全 1 时不存数据，置位很少时只存下标)。编码只依赖 Tile::toPacked 的位布局，与编译器的结构体填充无关；
+     * 同一字段的字节相邻，zlib 也更容易压缩。
+     *
+     * 平面拆分/合并与位图打包在支持 SSE2 的平台上按 16 个 Tile 一组向量化，其余平台使用等价的标量实现。
+     */
+    class ChunkCodec {
+    public:
+        // 把 CHUNK_VOLUME 个 Tile (按 localCoordsToIndex 顺序) 编码后追加到 out，返回追加的字节数。
+        static size_t encodeTiles(const Tile* tiles, std::vector<uint8_t>& out);
+
+        /**
+         * @brief 从 data 解码 CHUNK_VOLUME 个 Tile。
+         * @return 消耗的字节数 (data 之后可以跟随其他数据)。
+         * @throws std::runtime_error 数据截断、游程长度合计不符或平面模式未知时抛出。
+         */
+        static size_t decodeTiles(const uint8_t* data, size_t size, Tile* tiles);
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_CHUNKCODEC_H
@@ -0,0 +1,124 @@
+#include "ChunkSwapFile.h"
+#include "MapSerializer.h"
+#include "Checksum.h"
+#include "../Chunk.h"
+#include "../Utils/Logger.h"
+#include <filesystem>
+#include <stdexcept>
+
+namespace TilelandWorld {
+
+    ChunkSwapFile::ChunkSwapFile(const std::string& path) : filepath(path) {
+        std::filesystem::path parent = std::filesystem::path(filepath).parent_path();
+        if (!parent.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(parent, ec);
+        }
+
+        stream.open(filepath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            throw std::runtime_error("Failed to open chunk swap file: " + filepath);
+        }
+        LOG_INFO("Chunk swap file opened: " + filepath);
+    }
+
+    ChunkSwapFile::~ChunkSwapFile() {
+        stream.close();
+        std::error_code ec;
+        std::filesystem::remove(filepath, ec);
+    }
+
+    bool ChunkSwapFile::storeChunk(const Chunk& chunk) {
+        // 编码与校验在锁外完成
+        std::vector<uint8_t> record;
+        MapSerializer::encodeChunkRecord(chunk, record);
+        const uint32_t size = static_cast<uint32_t>(record.size());
+        const uint32_t checksum = calculateCRC32(record.data(), record.size());
+        const ChunkCoord coord{chunk.getChunkX(), chunk.getChunkY(), chunk.getChunkZ()};
+
+        std::lock_guard<std::mutex> lock(fileMutex);
+        auto it = slots.find(coord);
+        Slot slot{};
+        if (it != slots.end() && size <= it->second.capacity) {
+            slot = it->second; // 原地覆盖
+        } else {
+            slot.offset = fileEnd;
+            slot.capacity = size;
+        }
+        slot.size = size;
+        slot.checksum = checksum;
+
+        stream.clear();
+        stream.seekp(static_cast<std::streamoff>(slot.offset));
+        stream.write(reinterpret_cast<const char*>(record.data()), record.size());
+        stream.flush();
+        if (!stream) {
+            stream.clear();
+            LOG_ERROR("Failed to write chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ") to swap file.");
+            return false;
+        }
+
+        if (slot.offset == fileEnd) fileEnd += size;
+        slots[coord] = slot;
+        return true;
+    }
+
+    std::unique_ptr<Chunk> ChunkSwapFile::loadChunk(const ChunkCoord& coord) {
+        std::vector<uint8_t> record;
+        Slot slot{};
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            auto it = slots.find(coord);
+            if (it == slots.end()) return nullptr;
+            slot = it->second;
+
+            record.resize(slot.size);
+            stream.clear();
+            stream.seekg(static_cast<std::streamoff>(slot.offset));
+            stream.read(reinterpret_cast<char*>(record.data()), record.size());
+            if (!stream) {
+                stream.clear();
+                LOG_ERROR("Failed to read chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ") from swap file.");
+                return nullptr;
+            }
+        }
+
+        if (calculateCRC32(record.data(), record.size()) != slot.checksum) {
+            LOG_ERROR("Swap file checksum mismatch for chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ").");
+            return nullptr;
+        }
+
+        try {
+            auto chunk = std::make_unique<Chunk>(coord.cx, coord.cy, coord.cz);
+            MapSerializer::decodeChunkRecord(record.data(), record.size(), *chunk);
+            return chunk;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to decode swapped chunk: " + std::string(e.what()));
+            return nullptr;
+        }
+    }
+
+    bool ChunkSwapFile::contains(const ChunkCoord& coord) const {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        return slots.find(coord) != slots.end();
+    }
+
+    std::vector<ChunkCoord> ChunkSwapFile::storedChunks() const {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        std::vector<ChunkCoord> coords;
+        coords.reserve(slots.size());
+        for (const auto& pair : slots) coords.push_back(pair.first);
+        return coords;
+    }
+
+    size_t ChunkSwapFile::getStoredCount() const {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        return slots.size();
+    }
+
+    uint64_t ChunkSwapFile::getFileSize() const {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        return fileEnd;
+    }
+
+} // namespace TilelandWorld
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef TILELANDWORLD_CHUNKSWAPFILE_H
+#define TILELANDWORLD_CHUNKSWAPFILE_H
+
+#include "../ChunkStore.h"
+#include "../Coordinates.h"
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 基于临时文件的区块后备存储 (交换文件)。
+     *
+     * 区块记录使用 MapSerializer::encodeChunkRecord 编码 (与 .tlwf 相同的区块数据格式，总是完整记录)，
+     * 追加写入文件，内存中只保留坐标到 (偏移, 大小, CRC32) 的索引。
+     * 同一区块再次写入时，新记录不超过原槽位容量则原地覆盖，否则追加到文件末尾。
+     * 交换文件仅在进程内有效：构造时截断，析构时删除。
+     */
+    class ChunkSwapFile : public ChunkStore {
+    public:
+        // 打开 (并截断) 交换文件，失败时抛出 std::runtime_error。
+        explicit ChunkSwapFile(const std::string& filepath);
+        ~ChunkSwapFile() override;
+
+        std::unique_ptr<Chunk> loadChunk(const ChunkCoord& coord) override;
+        bool storeChunk(const Chunk& chunk) override;
+        bool contains(const ChunkCoord& coord) const override;
+        std::vector<ChunkCoord> storedChunks() const override;
+
+        size_t getStoredCount() const;
+        // 交换文件当前大小 (字节)。
+        uint64_t getFileSize() const;
+
+    private:
+        struct Slot {
+            uint64_t offset;
+            uint32_t capacity; // 槽位可容纳的字节数 (首次写入时的记录大小)
+            uint32_t size;     // 当前记录大小
+            uint32_t checksum;
+        };
+
+        std::string filepath;
+        mutable std::mutex fileMutex; // 保护 stream、slots 与 fileEnd
+        std::fstream stream;
+        std::unordered_map<ChunkCoord, Slot, ChunkCoordHash> slots;
+        uint64_t fileEnd = 0;
+
+        ChunkSwapFile(const ChunkSwapFile&) = delete;
+        ChunkSwapFile& operator=(const ChunkSwapFile&) = delete;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_CHUNKSWAPFILE_H
@@ -10,11 +10,17 @@ namespace TilelandWorld {
     // 魔数 (Magic Number) for compressed file: "TLWZ"
     constexpr uint32_t COMPRESSED_MAGIC_NUMBER = 0x544C575A; // ASCII for 'T','L','W','Z' in little-endian
     constexpr uint16_t COMPRESSED_FORMAT_VERSION_MAJOR = 0;
-    constexpr uint16_t COMPRESSED_FORMAT_VERSION_MINOR = 1;
+    constexpr uint16_t COMPRESSED_FORMAT_VERSION_MINOR_FRONT_METADATA = 4; // 0.4: 元数据块紧跟文件头，概要信息位于文件开头的固定位置
+    constexpr uint16_t COMPRESSED_FORMAT_VERSION_MINOR = COMPRESSED_FORMAT_VERSION_MINOR_FRONT_METADATA; // 当前写出的版本
+    constexpr uint16_t COMPRESSED_FORMAT_VERSION_MINOR_DICTIONARY = 3; // 0.3: 文件头之后存放区块记录共用的 zlib 预设字典
+    constexpr uint16_t COMPRESSED_FORMAT_VERSION_MINOR_CHUNKED = 2; // 0.2: 区块逐个独立压缩 + 未压缩索引，支持随机读取
+    constexpr uint16_t COMPRESSED_FORMAT_VERSION_MINOR_WHOLE_FILE = 1; // 0.1: 整个 .tlwf 压缩为单个 zlib 流
 
     // 压缩类型标识 (为未来可能支持多种压缩算法预留)
     constexpr uint8_t COMPRESSION_TYPE_ZLIB = 0x01;
 
+    // --- 0.1 布局 ---
+    // [CompressedFileHeader] [压缩后的完整 .tlwf 文件]
     #pragma pack(push, 1)
     struct CompressedFileHeader {
         uint32_t magicNumber;           // 魔数，用于文件类型验证 (COMPRESSED_MAGIC_NUMBER)
@@ -32,6 +38,60 @@ namespace TilelandWorld {
 
     static_assert(std::is_trivially_copyable_v<CompressedFileHeader>, "CompressedFileHeader must be trivially copyable");
 
+    // --- 0.2 布局 ---
+    // [CompressedFileHeaderV2] [压缩区块记录 x N] [uint64 条目数] [CompressedChunkIndexEntry x N] [MetadataBlock]
+    // 每个区块记录 (格式同 .tlwf 区块数据) 单独压缩为一个 zlib 流；索引与元数据不压缩，
+    // 读取概要或单个区块时无需解压其他数据。前 8 字节 (魔数与版本号) 与 0.1 相同，用于区分版本。
+    // 多个索引条目可以指向同一个压缩记录 (offset 相同)：内容相同的区块记录只写出一份。
+    //
+    // 0.3 在文件头与第一个区块记录之间插入预设字典 (dataOffset 指向字典之后)：
+    // [CompressedFileHeaderV2] [CompressionDictionaryHeader] [字典字节 x size] [压缩区块记录 x N] ...
+    // 区块记录压缩时可载入该字典 (deflateSetDictionary)，zlib 流头部记录了字典的 Adler-32，解压时按需载入；
+    // 未使用字典的记录照常解压，因此可以与原样复制自 0.2 文件的记录混存。size 为 0 表示没有字典。
+    //
+    // 0.4 把元数据块 (MetadataBlock，定长、未压缩) 从文件末尾移到文件头之后 (metadataOffset 固定为文件头大小)：
+    // [CompressedFileHeaderV2] [MetadataBlock] [CompressionDictionaryHeader] [字典字节] [压缩区块记录 x N] [uint64 条目数] [索引]
+    // 存档列表只需读取开头这两个定长结构即可得到区块数与世界参数，修改元数据只需原地改写这一块。
+    #pragma pack(push, 1)
+    struct CompressedFileHeaderV2 {
+        uint32_t magicNumber;           // COMPRESSED_MAGIC_NUMBER
+        uint16_t versionMajor;
+        uint16_t versionMinor;          // COMPRESSED_FORMAT_VERSION_MINOR
+        uint8_t  compressionType;       // 见 COMPRESSION_TYPE_*
+        uint8_t  generatorVersion;      // 写入时地形生成器的版本 (同 FileHeader::generatorVersion)，0 表示未记录
+        uint16_t recordVersionMinor;    // 区块记录格式对应的 .tlwf 次版本号 (FORMAT_VERSION_MINOR)
+        uint64_t chunkCount;            // 区块数量 (与索引条目数相同)
+        uint64_t dataOffset;            // 第一个压缩区块记录的偏移量
+        uint64_t indexOffset;           // 索引区域的偏移量
+        uint64_t metadataOffset;        // 元数据块的偏移量
+        uint32_t indexChecksum;         // 索引区域 (含条目数) 的 CRC32
+        uint32_t headerChecksum;        // 文件头自身的 CRC32 (不包括此字段本身)
+    };
+    #pragma pack(pop)
+    static_assert(std::is_trivially_copyable_v<CompressedFileHeaderV2>, "CompressedFileHeaderV2 must be trivially copyable");
+
+    #pragma pack(push, 1)
+    struct CompressionDictionaryHeader {
+        uint32_t size;                  // 字典字节数 (不超过 MAX_COMPRESSION_DICTIONARY_SIZE)
+        uint32_t checksum;              // 字典字节的 CRC32
+    };
+    #pragma pack(pop)
+    static_assert(std::is_trivially_copyable_v<CompressionDictionaryHeader>, "CompressionDictionaryHeader must be trivially copyable");
+
+    constexpr uint32_t MAX_COMPRESSION_DICTIONARY_SIZE = 32 * 1024; // zlib 窗口大小，更长的部分不会被引用
+
+    #pragma pack(push, 1)
+    struct CompressedChunkIndexEntry {
+        int32_t cx, cy, cz;
+        uint64_t offset;                // 压缩记录在文件中的偏移量
+        uint32_t compressedSize;        // 压缩记录大小 (字节)
+        uint32_t compressedChecksum;    // 压缩记录的 CRC32，解压前校验
+        uint32_t uncompressedSize;      // 解压后区块记录大小
+        uint32_t uncompressedChecksum;  // 解压后区块记录的 CRC32 (与 .tlwf 索引中的 checksum 相同)
+    };
+    #pragma pack(pop)
+    static_assert(std::is_trivially_copyable_v<CompressedChunkIndexEntry>, "CompressedChunkIndexEntry must be trivially copyable");
+
 } // namespace TilelandWorld
 
 #endif // TILELANDWORLD_COMPRESSEDFILEFORMAT_H
@@ -0,0 +1,95 @@
+#include "CompressionDictionary.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace TilelandWorld {
+
+    namespace {
+        constexpr size_t KEY_LENGTH = 6;        // 打分用的子串长度 (略长于 deflate 的最短匹配 3 字节)
+        constexpr size_t SEGMENT_LENGTH = 32;   // 候选片段长度，候选起点每半个片段一个
+        constexpr size_t MIN_SAMPLES = 4;
+        constexpr size_t MIN_DICTIONARY = 64;   // 更短的字典得不偿失
+        constexpr size_t MAX_SAMPLE_BYTES = 4096; // 每个样本只看开头部分，限制构建耗时
+
+        uint64_t keyAt(const uint8_t* p) {
+            uint64_t key = 0;
+            std::memcpy(&key, p, KEY_LENGTH);
+            return key;
+        }
+
+        struct Candidate {
+            size_t sample;
+            size_t start;
+            size_t length;
+            uint64_t score;
+        };
+    }
+
+    std::vector<uint8_t> CompressionDictionary::build(const std::vector<std::vector<uint8_t>>& samples, size_t maxSize) {
+        if (samples.size() < MIN_SAMPLES || maxSize < MIN_DICTIONARY) return {};
+        auto sampleLength = [](const std::vector<uint8_t>& s) { return std::min(s.size(), MAX_SAMPLE_BYTES); };
+
+        // 每个子串出现在多少个样本中
+        std::unordered_map<uint64_t, uint32_t> frequency;
+        std::unordered_set<uint64_t> seen;
+        for (const auto& sample : samples) {
+            const size_t length = sampleLength(sample);
+            seen.clear();
+            for (size_t i = 0; i + KEY_LENGTH <= length; ++i) {
+                const uint64_t key = keyAt(sample.data() + i);
+                if (seen.insert(key).second) ++frequency[key];
+            }
+        }
+
+        // 片段得分：其中 (去重后) 每个子串的额外出现次数之和；covered 中的子串不再计分
+        auto scoreOf = [&](const Candidate& c, const std::unordered_set<uint64_t>* covered) {
+            std::unordered_set<uint64_t> counted;
+            uint64_t score = 0;
+            const uint8_t* base = samples[c.sample].data() + c.start;
+            for (size_t i = 0; i + KEY_LENGTH <= c.length; ++i) {
+                const uint64_t key = keyAt(base + i);
+                if ((covered && covered->count(key)) || !counted.insert(key).second) continue;
+                score += frequency[key] - 1;
+            }
+            return score;
+        };
+
+        std::vector<Candidate> candidates;
+        for (size_t s = 0; s < samples.size(); ++s) {
+            const size_t length = sampleLength(samples[s]);
+            for (size_t start = 0; start + KEY_LENGTH <= length; start += SEGMENT_LENGTH / 2) {
+                Candidate c{s, start, std::min(SEGMENT_LENGTH, length - start), 0};
+                c.score = scoreOf(c, nullptr);
+                if (c.score > 0) candidates.push_back(c);
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+        // 贪心选取：重新计分后仍保留大部分价值的片段才收入
+        std::unordered_set<uint64_t> covered;
+        std::vector<const Candidate*> selected;
+        size_t total = 0;
+        for (const Candidate& c : candidates) {
+            if (total + c.length > maxSize) continue;
+            const uint64_t score = scoreOf(c, &covered);
+            if (score == 0 || score * 2 < c.score) continue;
+            const uint8_t* base = samples[c.sample].data() + c.start;
+            for (size_t i = 0; i + KEY_LENGTH <= c.length; ++i) covered.insert(keyAt(base + i));
+            selected.push_back(&c);
+            total += c.length;
+            if (maxSize - total < KEY_LENGTH) break;
+        }
+        if (total < MIN_DICTIONARY) return {};
+
+        std::vector<uint8_t> dictionary;
+        dictionary.reserve(total);
+        for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+            const uint8_t* base = samples[(*it)->sample].data() + (*it)->start;
+            dictionary.insert(dictionary.end(), base, base + (*it)->length);
+        }
+        return dictionary;
+    }
+
+} // namespace TilelandWorld
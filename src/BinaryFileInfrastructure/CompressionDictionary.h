@@ -0,0 +1,34 @@
+#pragma once
+#ifndef TILELANDWORLD_COMPRESSIONDICTIONARY_H
+#define TILELANDWORLD_COMPRESSIONDICTIONARY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 为区块记录构建 zlib 预设字典。
+     *
+     * 区块记录很小且彼此相似 (相同的地形 ID、光照值与标志模式)，单独压缩时 zlib 的窗口里没有可引用的历史数据。
+     * 预设字典收集样本记录中在多个记录里重复出现的片段，压缩与解压每个记录前载入，使第一个字节起就能引用这些片段。
+     *
+     * 片段按 6 字节子串的出现记录数打分，贪心选取覆盖新子串最多的片段；得分最高的片段放在字典末尾
+     * (距离越近，deflate 的距离编码越短)。
+     */
+    class CompressionDictionary {
+    public:
+        static constexpr size_t DEFAULT_SIZE = 4096;
+
+        /**
+         * @brief 从样本记录构建字典。
+         * @param maxSize 字典大小上限 (zlib 只使用最后 32 KiB)。
+         * @return 字典字节；样本太少或没有跨记录重复的内容时为空 (此时不应使用字典)。
+         */
+        static std::vector<uint8_t> build(const std::vector<std::vector<uint8_t>>& samples, size_t maxSize = DEFAULT_SIZE);
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_COMPRESSIONDICTIONARY_H
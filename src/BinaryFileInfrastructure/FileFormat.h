@@ -12,7 +12,10 @@ namespace TilelandWorld {
     // 例如 "TLWF" (TileLand World File)
     constexpr uint32_t MAGIC_NUMBER = 0x544C5746; // ASCII for 'T','L','W','F' in little-endian
     constexpr uint16_t FORMAT_VERSION_MAJOR = 0;
-    constexpr uint16_t FORMAT_VERSION_MINOR = 3; // 版本提升，因为文件头结构改变
+    constexpr uint16_t FORMAT_VERSION_MINOR = 6; // 0.6: 完整区块记录改为紧凑平面编码 (CHUNK_RECORD_COMPACT)
+    constexpr uint16_t FORMAT_VERSION_MINOR_DELTA_RECORD = 5; // 0.5: 区块记录带编码标记，可相对生成器结果差异编码；文件头记录生成器版本
+    constexpr uint16_t FORMAT_VERSION_MINOR_UNTAGGED_RECORD = 4; // 0.4: Tile 改为 4 字节打包形式 + 区块覆盖表 (记录无编码标记)
+    constexpr uint16_t FORMAT_VERSION_MINOR_LEGACY_TILE = 3; // 0.3 及更早：区块数据为原始 16 字节 Tile 数组
 
     // --- 字节序标识 ---
     constexpr uint8_t ENDIANNESS_LITTLE = 0x01; // 小端字节序 (例如 x86, ARM little-endian)
@@ -32,7 +35,8 @@ namespace TilelandWorld {
         uint16_t versionMinor;      // 次版本号
         uint8_t  endianness;        // 写入文件的系统的字节序 (见 ENDIANNESS_*)
         uint8_t  checksumType;      // 文件头和区块数据使用的校验和类型 (见 CHECKSUM_TYPE_*)
-        uint16_t reserved;          // 保留字段，用于未来扩展或对齐 (凑齐到偶数字节)
+        uint8_t  generatorVersion;  // 0.5 起：写入时地形生成器的版本 (TerrainGenerator::getVersion)，0 表示未记录
+        uint8_t  reserved;          // 保留字段，用于未来扩展或对齐 (凑齐到偶数字节)
         uint64_t metadataOffset;    // 元数据区域的文件偏移量 (如果需要)
         uint64_t indexOffset;       // 区块索引区域的文件偏移量
         uint64_t dataOffset;        // 实际区块数据区域的起始偏移量
@@ -56,6 +60,73 @@ namespace TilelandWorld {
     #pragma pack(pop) // 恢复默认对齐
     static_assert(std::is_trivially_copyable_v<ChunkIndexEntry>, "ChunkIndexEntry must be trivially copyable");
 
+    // --- 区块数据记录 (0.4 起) ---
+    // [uint32 打包 Tile x CHUNK_VOLUME] [uint32 覆盖条目数] [TileOverrideRecord x 覆盖条目数]
+    // 打包 Tile 的位布局见 Tile::toPacked。
+    //
+    // 0.5 起记录以 1 字节编码标记开头：
+    // CHUNK_RECORD_FULL:  [标记] [同 0.4 的完整记录]
+    // CHUNK_RECORD_DELTA: [标记] [uint32 差异条目数] [TileDeltaRecord x 差异条目数] [uint32 覆盖条目数] [TileOverrideRecord x 覆盖条目数]
+    //   差异记录只保存与地形生成器结果不同的 Tile，加载时先生成区块再套用差异；覆盖表总是完整保存。
+    //   生成器未修改过的区块不写入存档，加载时直接重新生成。
+    //
+    // 0.6 起新增紧凑平面编码 (不依赖结构体内存布局，见 ChunkCodec)，取代 CHUNK_RECORD_FULL 写出 (仍可读取)：
+    // CHUNK_RECORD_COMPACT: [标记] [地形游程] [光照平面] [已探索位图] [覆盖位图] [uint32 覆盖条目数] [TileOverrideRecord x 覆盖条目数]
+    //   地形游程：[uint16 游程数] [CompactTerrainRun x 游程数]，沿 X 行 (X 最快，然后 Y，然后 Z) 展开，游程可跨行，长度合计为 CHUNK_VOLUME；
+    //   光照平面：[uint8 TILE_PLANE_*] 均匀时 [uint8 值]，否则 [uint8 x CHUNK_VOLUME]；
+    //   位图：[uint8 TILE_PLANE_*] 全 0/全 1 时无数据；置位很少时 [uint16 置位数] [uint16 Tile 下标 x 置位数] (严格递增)；
+    //         否则 [CHUNK_VOLUME / 8 字节]，第 i 位 (字节 i/8 的第 i%8 位) 对应第 i 个 Tile。
+    //   写出时在紧凑、差异与完整编码中选择最小者。
+    constexpr uint8_t CHUNK_RECORD_FULL    = 0x00;
+    constexpr uint8_t CHUNK_RECORD_DELTA   = 0x01;
+    constexpr uint8_t CHUNK_RECORD_COMPACT = 0x02;
+
+    constexpr uint8_t TILE_PLANE_RAW     = 0x00; // 逐 Tile 保存
+    constexpr uint8_t TILE_PLANE_UNIFORM = 0x01; // 光照平面：所有 Tile 相同
+    constexpr uint8_t TILE_PLANE_ZERO    = 0x02; // 位图：全部为 0
+    constexpr uint8_t TILE_PLANE_ONE     = 0x03; // 位图：全部为 1
+    constexpr uint8_t TILE_PLANE_SPARSE  = 0x04; // 位图：只存置位的 Tile 下标
+
+    constexpr uint8_t TILE_OVERRIDE_FLAG_ENTER_SAME_LEVEL = 0x01;
+    constexpr uint8_t TILE_OVERRIDE_FLAG_STAND_ON_TOP     = 0x02;
+
+    #pragma pack(push, 1)
+    struct TileOverrideRecord {
+        uint16_t localIndex;   // 区块内一维索引 (X 最快，然后 Y，然后 Z)
+        uint8_t  flags;        // TILE_OVERRIDE_FLAG_*
+        uint8_t  reserved;
+        int32_t  movementCost;
+    };
+    #pragma pack(pop)
+    static_assert(sizeof(TileOverrideRecord) == 8, "TileOverrideRecord must be 8 bytes");
+
+    #pragma pack(push, 1)
+    struct TileDeltaRecord {
+        uint16_t localIndex;   // 区块内一维索引，严格升序
+        uint32_t packedTile;   // Tile::toPacked
+    };
+    #pragma pack(pop)
+    static_assert(sizeof(TileDeltaRecord) == 6, "TileDeltaRecord must be 6 bytes");
+
+    #pragma pack(push, 1)
+    struct CompactTerrainRun {
+        uint16_t terrain;      // TerrainType
+        uint16_t length;       // 1..CHUNK_VOLUME
+    };
+    #pragma pack(pop)
+    static_assert(sizeof(CompactTerrainRun) == 4, "CompactTerrainRun must be 4 bytes");
+
+    // 0.3 及更早版本中 Tile 的内存布局 (按默认对齐直接写盘)，仅用于读取旧存档。
+    struct LegacyTileV3 {
+        int32_t terrain;
+        bool canEnterSameLevel;
+        bool canStandOnTop;
+        int32_t movementCost;
+        uint8_t lightLevel;
+        bool isExplored;
+    };
+    static_assert(sizeof(LegacyTileV3) == 16, "LegacyTileV3 must match the 16-byte on-disk layout of 0.3 saves");
+
 
 } // namespace TilelandWorld
 
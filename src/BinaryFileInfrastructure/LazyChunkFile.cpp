@@ -0,0 +1,239 @@
+#include "LazyChunkFile.h"
+#include "MapSerializer.h"
+#include "Checksum.h"
+#include "../Chunk.h"
+#include "../ZipFuncInfrastructure/zlib_wrapper.h"
+#include "../Utils/Logger.h"
+#include <stdexcept>
+#include <filesystem>
+
+namespace TilelandWorld {
+
+    namespace {
+        std::string coordString(const ChunkCoord& coord) {
+            return "(" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ")";
+        }
+    }
+
+    LazyChunkFile::LazyChunkFile(const std::string& path, uint16_t minor, const std::vector<ChunkIndexEntry>& index)
+        : filepath(path), versionMinor(minor), compressed(false), reader(std::make_unique<BinaryReader>(path)) {
+        setIndex(index);
+    }
+
+    LazyChunkFile::LazyChunkFile(const std::string& path, uint16_t minor, const std::vector<CompressedChunkIndexEntry>& index)
+        : filepath(path), versionMinor(minor), compressed(true), reader(std::make_unique<BinaryReader>(path)) {
+        setIndex(index);
+    }
+
+    void LazyChunkFile::setIndex(const std::vector<ChunkIndexEntry>& index) {
+        compressed = false;
+        entries.clear();
+        entries.reserve(index.size());
+        for (const auto& entry : index) {
+            CompressedChunkIndexEntry unified{};
+            unified.cx = entry.cx;
+            unified.cy = entry.cy;
+            unified.cz = entry.cz;
+            unified.offset = entry.offset;
+            unified.compressedSize = unified.uncompressedSize = entry.size;
+            unified.compressedChecksum = unified.uncompressedChecksum = entry.checksum;
+            entries.emplace(ChunkCoord{entry.cx, entry.cy, entry.cz}, unified);
+        }
+    }
+
+    void LazyChunkFile::setIndex(const std::vector<CompressedChunkIndexEntry>& index) {
+        compressed = true;
+        entries.clear();
+        entries.reserve(index.size());
+        for (const auto& entry : index) {
+            entries.emplace(ChunkCoord{entry.cx, entry.cy, entry.cz}, entry);
+        }
+    }
+
+    bool LazyChunkFile::readStoredLocked(const ChunkCoord& coord, std::vector<uint8_t>& out, CompressedChunkIndexEntry& outEntry) {
+        if (!reader) return false;
+        auto it = entries.find(coord);
+        if (it == entries.end()) return false;
+        outEntry = it->second;
+
+        try {
+            if (!reader->seek(static_cast<std::streamoff>(outEntry.offset))) return false;
+            out.resize(outEntry.compressedSize);
+            return reader->readBytes(reinterpret_cast<char*>(out.data()), out.size()) == out.size();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to read chunk " + coordString(coord) + " from " + filepath + ": " + e.what());
+            return false;
+        }
+    }
+
+    bool LazyChunkFile::unpackRecord(const ChunkCoord& coord, std::vector<uint8_t>& stored, const CompressedChunkIndexEntry& entry,
+                                     bool isCompressed, const std::vector<uint8_t>* dictionary, std::vector<uint8_t>& out) const {
+        if (calculateCRC32(stored.data(), stored.size()) != entry.compressedChecksum) {
+            LOG_ERROR("Chunk data checksum mismatch for chunk " + coordString(coord) + " in " + filepath + ".");
+            return false;
+        }
+        if (!isCompressed) {
+            out.swap(stored);
+            return true;
+        }
+
+        SimpZlib::Status status = SimpZlib::uncompress(stored, out, entry.uncompressedSize, dictionary);
+        if (status != SimpZlib::Status::OK || out.size() != entry.uncompressedSize) {
+            LOG_ERROR("Failed to decompress chunk " + coordString(coord) + " in " + filepath + " (status "
+                      + std::to_string(static_cast<int>(status)) + ").");
+            return false;
+        }
+        if (calculateCRC32(out.data(), out.size()) != entry.uncompressedChecksum) {
+            LOG_ERROR("Uncompressed chunk checksum mismatch for chunk " + coordString(coord) + " in " + filepath + ".");
+            return false;
+        }
+        return true;
+    }
+
+    bool LazyChunkFile::readRecord(const ChunkCoord& coord, std::vector<uint8_t>& out, ChunkIndexEntry& outEntry) {
+        std::vector<uint8_t> stored;
+        CompressedChunkIndexEntry entry{};
+        bool isCompressedSource = false;
+        std::shared_ptr<const std::vector<uint8_t>> dict;
+        {
+            std::lock_guard<std::mutex> lock(readerMutex);
+            if (!readStoredLocked(coord, stored, entry)) return false;
+            isCompressedSource = compressed;
+            dict = dictionary;
+        }
+        if (!unpackRecord(coord, stored, entry, isCompressedSource, dict.get(), out)) return false;
+
+        outEntry = {};
+        outEntry.cx = entry.cx;
+        outEntry.cy = entry.cy;
+        outEntry.cz = entry.cz;
+        outEntry.offset = entry.offset;
+        outEntry.size = entry.uncompressedSize;
+        outEntry.checksum = entry.uncompressedChecksum;
+        return true;
+    }
+
+    bool LazyChunkFile::readCompressedRecord(const ChunkCoord& coord, std::vector<uint8_t>& out, CompressedChunkIndexEntry& outEntry) {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        if (!compressed) return false;
+        return readStoredLocked(coord, out, outEntry);
+    }
+
+    std::unique_ptr<Chunk> LazyChunkFile::loadChunk(const ChunkCoord& coord) {
+        std::vector<uint8_t> stored;
+        CompressedChunkIndexEntry entry{};
+        uint16_t minor = 0;
+        bool isCompressedSource = false;
+        std::shared_ptr<const TerrainGenerator> base;
+        std::shared_ptr<const std::vector<uint8_t>> dict;
+        {
+            std::lock_guard<std::mutex> lock(readerMutex);
+            if (!readStoredLocked(coord, stored, entry)) return nullptr;
+            minor = versionMinor;
+            isCompressedSource = compressed;
+            base = baseGenerator;
+            dict = dictionary;
+        }
+
+        // 校验、解压与解码在锁外完成，多个生成线程可并行处理
+        std::vector<uint8_t> record;
+        if (!unpackRecord(coord, stored, entry, isCompressedSource, dict.get(), record)) return nullptr;
+
+        try {
+            auto chunk = std::make_unique<Chunk>(coord.cx, coord.cy, coord.cz);
+            MapSerializer::decodeChunkRecord(record.data(), record.size(), *chunk, minor, base.get());
+            return chunk;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to decode chunk from " + filepath + ": " + e.what());
+            return nullptr;
+        }
+    }
+
+    void LazyChunkFile::setBaseGenerator(std::shared_ptr<const TerrainGenerator> generator) {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        baseGenerator = std::move(generator);
+    }
+
+    void LazyChunkFile::setCompressionDictionary(std::shared_ptr<const std::vector<uint8_t>> newDictionary) {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        dictionary = std::move(newDictionary);
+    }
+
+    std::shared_ptr<const std::vector<uint8_t>> LazyChunkFile::getCompressionDictionary() const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        return dictionary;
+    }
+
+    bool LazyChunkFile::contains(const ChunkCoord& coord) const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        return entries.find(coord) != entries.end();
+    }
+
+    std::vector<ChunkCoord> LazyChunkFile::storedChunks() const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        std::vector<ChunkCoord> coords;
+        coords.reserve(entries.size());
+        for (const auto& pair : entries) coords.push_back(pair.first);
+        return coords;
+    }
+
+    uint16_t LazyChunkFile::getVersionMinor() const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        return versionMinor;
+    }
+
+    bool LazyChunkFile::isCompressed() const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        return compressed;
+    }
+
+    bool LazyChunkFile::hasFailed() const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        return failed;
+    }
+
+    size_t LazyChunkFile::getChunkCount() const {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        return entries.size();
+    }
+
+    bool LazyChunkFile::reopenLocked(const std::string& newFile) {
+        reader.reset(); // Windows 上无法替换仍被打开的文件
+
+        std::error_code ec;
+        std::filesystem::rename(newFile, filepath, ec);
+        if (ec) {
+            LOG_ERROR("Failed to replace " + filepath + " with " + newFile + ": " + ec.message());
+        }
+
+        try {
+            reader = std::make_unique<BinaryReader>(filepath);
+        } catch (const std::exception& e) {
+            // 保留原索引：保存时仍能发现这些区块读不出来，从而失败而不是丢弃它们
+            LOG_ERROR("Failed to reopen save file for lazy chunk loading: " + std::string(e.what())
+                      + ". Unloaded saved chunks are unavailable and further saves will fail.");
+            failed = true;
+            return false;
+        }
+        return !ec; // 替换失败时继续使用原文件与原索引
+    }
+
+    bool LazyChunkFile::replaceFile(const std::string& newFile, uint16_t newVersionMinor, const std::vector<ChunkIndexEntry>& newIndex) {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        if (!reopenLocked(newFile)) return false;
+        versionMinor = newVersionMinor;
+        setIndex(newIndex);
+        return true;
+    }
+
+    bool LazyChunkFile::replaceFile(const std::string& newFile, uint16_t newVersionMinor, const std::vector<CompressedChunkIndexEntry>& newIndex,
+                                    std::shared_ptr<const std::vector<uint8_t>> newDictionary) {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        if (!reopenLocked(newFile)) return false;
+        versionMinor = newVersionMinor;
+        setIndex(newIndex);
+        dictionary = std::move(newDictionary);
+        return true;
+    }
+
+} // namespace TilelandWorld
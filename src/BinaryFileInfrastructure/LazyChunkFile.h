@@ -0,0 +1,103 @@
+#pragma once
+#ifndef TILELANDWORLD_LAZYCHUNKFILE_H
+#define TILELANDWORLD_LAZYCHUNKFILE_H
+
+#include "../ChunkStore.h"
+#include "../Coordinates.h"
+#include "BinaryReader.h"
+#include "FileFormat.h"
+#include "CompressedFileFormat.h"
+#include "../MapGenInfrastructure/TerrainGenerator.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 存档 (.tlwf 或 0.2 版 .tlwz) 中区块的按需读取器。
+     *
+     * MapSerializer 加载存档时只解析文件头、索引与元数据，把索引交给本类并保持文件打开；
+     * 区块在首次被访问时 (Map::createChunkIsolated，通常在生成线程上) 才读取、校验 CRC、解压 (.tlwz) 并解码。
+     * 只读：storeChunk 始终返回 false，修改过的区块由 Map 的后备存储 (见 ChunkStore) 负责。
+     * 0.5 起区块可能以相对生成器结果的差异保存，解码时需要 setBaseGenerator 提供保存时的生成器。
+     * 0.3 版 .tlwz 的区块记录可能使用文件中的预设字典压缩，解压时需要 setCompressionDictionary 提供该字典。
+     */
+    class LazyChunkFile : public ChunkStore {
+    public:
+        // 打开文件失败时抛出 std::runtime_error。versionMinor 为区块记录格式的 .tlwf 次版本号。
+        LazyChunkFile(const std::string& filepath, uint16_t versionMinor, const std::vector<ChunkIndexEntry>& index);
+        // 0.2 版 .tlwz：每个区块记录单独压缩。
+        LazyChunkFile(const std::string& filepath, uint16_t versionMinor, const std::vector<CompressedChunkIndexEntry>& index);
+
+        std::unique_ptr<Chunk> loadChunk(const ChunkCoord& coord) override;
+        bool storeChunk(const Chunk&) override { return false; }
+        bool contains(const ChunkCoord& coord) const override;
+        std::vector<ChunkCoord> storedChunks() const override;
+
+        /**
+         * @brief 读取区块的原始记录字节 (已解压，不解码)，用于保存时原样复制未加载的区块。
+         * @param outEntry 该记录的大小与校验和 (与 .tlwf 索引条目含义相同)。
+         */
+        bool readRecord(const ChunkCoord& coord, std::vector<uint8_t>& out, ChunkIndexEntry& outEntry);
+
+        /**
+         * @brief 读取区块的压缩记录字节 (不解压)，仅 .tlwz 源可用，用于重写 .tlwz 时原样复制。
+         */
+        bool readCompressedRecord(const ChunkCoord& coord, std::vector<uint8_t>& out, CompressedChunkIndexEntry& outEntry);
+
+        // 差异编码区块的重建基准 (由存档元数据创建)；未设置时遇到差异记录加载失败
+        void setBaseGenerator(std::shared_ptr<const TerrainGenerator> generator);
+
+        // .tlwz 区块记录的预设字典 (为空表示文件没有字典)；原样复制压缩记录时新文件必须使用同一字典
+        void setCompressionDictionary(std::shared_ptr<const std::vector<uint8_t>> dictionary);
+        std::shared_ptr<const std::vector<uint8_t>> getCompressionDictionary() const;
+
+        const std::string& getPath() const { return filepath; }
+        bool isCompressed() const;
+        uint16_t getVersionMinor() const;
+        size_t getChunkCount() const;
+
+        /**
+         * @brief 用新写好的文件替换当前文件 (rename)，并切换到新文件的索引。
+         * @details 保存到正在读取的同一路径时使用：保存先写临时文件，再在持有读锁期间关闭、替换、重新打开，
+         *          期间生成线程的 loadChunk 会等待。替换失败时继续使用原文件并返回 false。
+         *          替换成功但无法重新打开时保留原索引并进入失败状态 (见 hasFailed)，返回 false。
+         */
+        bool replaceFile(const std::string& newFile, uint16_t newVersionMinor, const std::vector<ChunkIndexEntry>& newIndex);
+        bool replaceFile(const std::string& newFile, uint16_t newVersionMinor, const std::vector<CompressedChunkIndexEntry>& newIndex,
+                         std::shared_ptr<const std::vector<uint8_t>> newDictionary);
+
+        /**
+         * @brief 文件已被替换却无法重新打开：之后的读取全部失败。
+         * @details 索引仍列出所有已保存的区块，保存时据此拒绝写出 (而不是把读不到的区块当作不存在而丢弃)。
+         */
+        bool hasFailed() const;
+
+    private:
+        // 两种格式统一按压缩条目保存；.tlwf 条目的压缩大小/校验和与原始值相同
+        void setIndex(const std::vector<ChunkIndexEntry>& index);
+        void setIndex(const std::vector<CompressedChunkIndexEntry>& index);
+        bool reopenLocked(const std::string& newFile);
+        bool readStoredLocked(const ChunkCoord& coord, std::vector<uint8_t>& out, CompressedChunkIndexEntry& outEntry);
+        // 校验存储字节并在需要时解压为原始记录
+        bool unpackRecord(const ChunkCoord& coord, std::vector<uint8_t>& stored, const CompressedChunkIndexEntry& entry,
+                          bool isCompressed, const std::vector<uint8_t>* dictionary, std::vector<uint8_t>& out) const;
+
+        std::string filepath;
+        uint16_t versionMinor;
+        bool compressed;
+        mutable std::mutex readerMutex; // 保护 reader、entries 与格式字段
+        std::unique_ptr<BinaryReader> reader;
+        bool failed = false;            // 见 hasFailed
+        std::shared_ptr<const TerrainGenerator> baseGenerator;
+        std::shared_ptr<const std::vector<uint8_t>> dictionary;
+        std::unordered_map<ChunkCoord, CompressedChunkIndexEntry, ChunkCoordHash> entries;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_LAZYCHUNKFILE_H
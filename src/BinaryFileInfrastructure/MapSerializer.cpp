@@ -6,12 +6,21 @@
 #include "SaveMetadata.h"
 #include "../MapGenInfrastructure/TerrainGeneratorFactory.h"
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
 #include <cstring> // For memcpy in checksum calculation
 #include <stdexcept> // For std::runtime_error
 #include <fstream>      // For std::ifstream to read whole file
 #include <filesystem>   // For file operations like exists, remove
+#include <unordered_map>
 #include "../ZipFuncInfrastructure/zlib_wrapper.h" // 包含 zlib 封装
 #include "CompressedFileFormat.h" // For compressed header
+#include "LazyChunkFile.h"
+#include "MappedFile.h"
+#include "ChunkCodec.h"
+#include "CompressionDictionary.h"
 
 namespace TilelandWorld {
 
@@ -22,12 +31,38 @@ namespace TilelandWorld {
     }
 
     namespace {
+        // 保存失败 (含抛出异常) 时删除未完成的临时文件；替换成功后调用 release。路径为空时不做任何事
+        class TempFileGuard {
+        public:
+            explicit TempFileGuard(std::string path) : path(std::move(path)) {}
+            ~TempFileGuard() {
+                if (path.empty()) return;
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+            void release() { path.clear(); }
+
+        private:
+            std::string path;
+        };
+
         inline std::string trimNullTerminated(const char* data, size_t len) {
             size_t realLen = 0;
             while (realLen < len && data[realLen] != '\0') ++realLen;
             return std::string(data, realLen);
         }
 
+        void fromMetadataBlock(const MetadataBlock& block, WorldMetadata& meta) {
+            meta.seed = block.seed;
+            meta.frequency = block.frequency;
+            meta.noiseType = trimNullTerminated(block.noiseType, sizeof(block.noiseType));
+            meta.fractalType = trimNullTerminated(block.fractalType, sizeof(block.fractalType));
+            meta.octaves = block.octaves;
+            meta.lacunarity = block.lacunarity;
+            meta.gain = block.gain;
+            meta.latticeSpacing = block.latticeSpacing > 0 ? block.latticeSpacing : 1;
+        }
+
         bool readSummaryFromBuffer(const uint8_t* data, size_t size, MapSerializer::SaveSummary& out) {
             if (data == nullptr || size < sizeof(FileHeader)) return false;
 
@@ -40,13 +75,7 @@ namespace TilelandWorld {
 
             MetadataBlock block{};
             std::memcpy(&block, data + metaOffset, sizeof(block));
-            out.metadata.seed = block.seed;
-            out.metadata.frequency = block.frequency;
-            out.metadata.noiseType = trimNullTerminated(block.noiseType, sizeof(block.noiseType));
-            out.metadata.fractalType = trimNullTerminated(block.fractalType, sizeof(block.fractalType));
-            out.metadata.octaves = block.octaves;
-            out.metadata.lacunarity = block.lacunarity;
-            out.metadata.gain = block.gain;
+            fromMetadataBlock(block, out.metadata);
 
             out.chunkCount = 0;
             size_t indexOffset = static_cast<size_t>(header.indexOffset);
@@ -59,17 +88,7 @@ namespace TilelandWorld {
             return true;
         }
 
-        bool readSummaryFromBuffer(const std::vector<uint8_t>& buffer, MapSerializer::SaveSummary& out) {
-            return readSummaryFromBuffer(buffer.data(), buffer.size(), out);
-        }
-
-        bool applyMetadataToBuffer(std::vector<uint8_t>& buffer, const WorldMetadata& meta) {
-            if (buffer.size() < sizeof(FileHeader)) return false;
-            FileHeader header{};
-            std::memcpy(&header, buffer.data(), sizeof(header));
-            size_t metaOffset = static_cast<size_t>(header.metadataOffset);
-            if (metaOffset == 0 || metaOffset + sizeof(MetadataBlock) > buffer.size()) return false;
-
+        MetadataBlock toMetadataBlock(const WorldMetadata& meta) {
             MetadataBlock block{};
             block.seed = meta.seed;
             block.frequency = meta.frequency;
@@ -80,51 +99,333 @@ namespace TilelandWorld {
             block.octaves = meta.octaves;
             block.lacunarity = meta.lacunarity;
             block.gain = meta.gain;
+            block.latticeSpacing = meta.latticeSpacing;
+            return block;
+        }
 
+        bool applyMetadataToBuffer(std::vector<uint8_t>& buffer, const WorldMetadata& meta) {
+            if (buffer.size() < sizeof(FileHeader)) return false;
+            FileHeader header{};
+            std::memcpy(&header, buffer.data(), sizeof(header));
+            size_t metaOffset = static_cast<size_t>(header.metadataOffset);
+            if (metaOffset == 0 || metaOffset + sizeof(MetadataBlock) > buffer.size()) return false;
+
+            MetadataBlock block = toMetadataBlock(meta);
             std::memcpy(buffer.data() + metaOffset, &block, sizeof(block));
             return true;
         }
 
         bool readSummaryFromTlwf(const std::string& path, MapSerializer::SaveSummary& out) {
-            std::ifstream file(path, std::ios::binary | std::ios::ate);
-            if (!file) return false;
-            std::streamsize size = file.tellg();
-            if (size <= 0) return false;
-            file.seekg(0, std::ios::beg);
-            std::vector<uint8_t> buffer(static_cast<size_t>(size));
-            if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) return false;
+            // 直接在映射上解析文件头、索引计数与元数据块，无需读入整个文件
+            std::unique_ptr<MappedFile> file;
+            try {
+                file = std::make_unique<MappedFile>(path);
+            } catch (const std::exception&) {
+                return false;
+            }
+            if (file->size() == 0) return false;
 
-            if (!readSummaryFromBuffer(buffer, out)) return false;
+            if (!readSummaryFromBuffer(file->data(), file->size(), out)) return false;
             out.path = path;
             out.compressed = false;
-            out.fileSize = static_cast<size_t>(size);
+            out.fileSize = file->size();
             return true;
         }
 
-        bool writeBufferToFile(const std::string& path, const std::vector<uint8_t>& buffer) {
-            BinaryWriter writer(path);
-            return writer.writeBytes(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        // 原地改写 .tlwf 的元数据块：块是定长的，文件头中的偏移量与校验和都不变，无需读写区块数据
+        bool updateTlwfMetadata(const std::string& tlwfPath, const WorldMetadata& metadata) {
+            std::fstream file(tlwfPath, std::ios::binary | std::ios::in | std::ios::out);
+            if (!file) return false;
+            FileHeader header{};
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+            if (header.magicNumber != MAGIC_NUMBER || header.metadataOffset == 0) return false;
+            file.seekg(0, std::ios::end);
+            const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+            if (header.metadataOffset + sizeof(MetadataBlock) > fileSize) return false;
+
+            MetadataBlock block = toMetadataBlock(metadata);
+            file.seekp(static_cast<std::streamoff>(header.metadataOffset), std::ios::beg);
+            file.write(reinterpret_cast<const char*>(&block), sizeof(block));
+            return static_cast<bool>(file.flush());
         }
 
+        // 流式压缩：输出经固定大小的缓冲区直接写入文件，压缩数据的大小与校验和随写随算，最后回填文件头
         bool recompressBufferToTlwz(const std::vector<uint8_t>& buffer, const std::string& tlwzPath) {
-            std::vector<Bytef> source(buffer.begin(), buffer.end());
-            std::vector<Bytef> compressedData;
-            auto status = SimpZlib::compress(source, compressedData);
-            if (status != SimpZlib::Status::OK) return false;
-
             CompressedFileHeader header{};
             header.magicNumber = COMPRESSED_MAGIC_NUMBER;
             header.versionMajor = COMPRESSED_FORMAT_VERSION_MAJOR;
-            header.versionMinor = COMPRESSED_FORMAT_VERSION_MINOR;
+            header.versionMinor = COMPRESSED_FORMAT_VERSION_MINOR_WHOLE_FILE;
             header.compressionType = COMPRESSION_TYPE_ZLIB;
             header.uncompressedSize = buffer.size();
             header.uncompressedChecksum = calculateCRC32(buffer.data(), buffer.size());
-            header.compressedSize = compressedData.size();
-            header.compressedChecksum = calculateCRC32(compressedData.data(), compressedData.size());
 
             BinaryWriter writer(tlwzPath);
             if (!writer.write(header)) return false;
-            return writer.writeBytes(reinterpret_cast<const char*>(compressedData.data()), compressedData.size());
+
+            SimpZlib::Deflater deflater;
+            std::vector<Bytef> out(64 * 1024);
+            const Bytef* in = buffer.data();
+            size_t remaining = buffer.size();
+            while (!deflater.isFinished()) {
+                size_t consumed = 0, produced = 0;
+                if (deflater.push(in, remaining, out.data(), out.size(), consumed, produced, true) != SimpZlib::Status::OK) return false;
+                in += consumed;
+                remaining -= consumed;
+                if (!writer.writeBytes(reinterpret_cast<const char*>(out.data()), produced)) return false;
+                header.compressedChecksum = updateCRC32(header.compressedChecksum, out.data(), produced);
+                header.compressedSize += produced;
+            }
+
+            return writer.seek(0) && writer.write(header) && writer.flush();
+        }
+
+        // --- 0.2 版 .tlwz 辅助函数 ---
+
+        // 读取 .tlwz 的次版本号 (0.1 与 0.2 的前 8 字节布局相同)，读取后回到文件开头
+        uint16_t peekCompressedVersion(BinaryReader& reader) {
+            uint32_t magic = 0;
+            uint16_t major = 0, minor = 0;
+            if (!reader.read(magic) || !reader.read(major) || !reader.read(minor)) {
+                throw std::runtime_error("Failed to read compressed file header.");
+            }
+            if (magic != COMPRESSED_MAGIC_NUMBER) {
+                throw std::runtime_error("Invalid magic number in compressed file.");
+            }
+            if (major != COMPRESSED_FORMAT_VERSION_MAJOR || minor > COMPRESSED_FORMAT_VERSION_MINOR) {
+                throw std::runtime_error("Unsupported compressed file version.");
+            }
+            if (!reader.seek(0)) {
+                throw std::runtime_error("Failed to seek back to compressed file header.");
+            }
+            return minor;
+        }
+
+        uint32_t compressedHeaderChecksum(const CompressedFileHeaderV2& header) {
+            CompressedFileHeaderV2 temp = header;
+            temp.headerChecksum = 0;
+            return calculateCRC32(&temp, sizeof(CompressedFileHeaderV2) - sizeof(uint32_t));
+        }
+
+        void readCompressedHeaderV2(BinaryReader& reader, CompressedFileHeaderV2& header) {
+            if (!reader.read(header)) {
+                throw std::runtime_error("Failed to read compressed file header.");
+            }
+            if (header.compressionType != COMPRESSION_TYPE_ZLIB) {
+                throw std::runtime_error("Unsupported compression type in header.");
+            }
+            if (compressedHeaderChecksum(header) != header.headerChecksum) {
+                throw std::runtime_error("Compressed file header checksum mismatch.");
+            }
+            const uint64_t fileSize = static_cast<uint64_t>(reader.fileSize());
+            if (header.indexOffset < sizeof(header) || header.indexOffset >= fileSize
+                || header.metadataOffset < sizeof(header) || header.metadataOffset + sizeof(MetadataBlock) > fileSize) {
+                throw std::runtime_error("Invalid index or metadata offset in compressed file header.");
+            }
+        }
+
+        // 0.4 起元数据块紧跟文件头，开头这一段定长，读取存档概要时只需读这么多字节
+        constexpr size_t COMPRESSED_SUMMARY_SIZE = sizeof(CompressedFileHeaderV2) + sizeof(MetadataBlock);
+
+        // 预设字典头的位置：0.3 紧跟文件头，0.4 起在元数据块之后
+        uint64_t compressionDictionaryOffset(const CompressedFileHeaderV2& header) {
+            return header.versionMinor >= COMPRESSED_FORMAT_VERSION_MINOR_FRONT_METADATA ? COMPRESSED_SUMMARY_SIZE : sizeof(CompressedFileHeaderV2);
+        }
+
+        // 0.3 起：读取文件头之后的预设字典 (没有字典或旧版本时返回空指针)
+        std::shared_ptr<const std::vector<uint8_t>> readCompressionDictionary(BinaryReader& reader, const CompressedFileHeaderV2& header) {
+            if (header.versionMinor < COMPRESSED_FORMAT_VERSION_MINOR_DICTIONARY) return nullptr;
+
+            const uint64_t dictOffset = compressionDictionaryOffset(header);
+            CompressionDictionaryHeader dictHeader{};
+            if (!reader.seek(static_cast<std::streamoff>(dictOffset)) || !reader.read(dictHeader)) {
+                throw std::runtime_error("Failed to read compression dictionary header.");
+            }
+            if (dictHeader.size == 0) return nullptr;
+            if (dictHeader.size > MAX_COMPRESSION_DICTIONARY_SIZE
+                || dictOffset + sizeof(dictHeader) + dictHeader.size > header.dataOffset) {
+                throw std::runtime_error("Invalid compression dictionary size " + std::to_string(dictHeader.size) + ".");
+            }
+
+            auto dictionary = std::make_shared<std::vector<uint8_t>>(dictHeader.size);
+            if (reader.readBytes(reinterpret_cast<char*>(dictionary->data()), dictionary->size()) != dictionary->size()) {
+                throw std::runtime_error("Failed to read compression dictionary.");
+            }
+            if (calculateCRC32(dictionary->data(), dictionary->size()) != dictHeader.checksum) {
+                throw std::runtime_error("Compression dictionary checksum mismatch.");
+            }
+            return dictionary;
+        }
+
+        // 读取并校验索引，同时检查每条记录都在文件范围内
+        void readCompressedIndex(BinaryReader& reader, const CompressedFileHeaderV2& header, std::vector<CompressedChunkIndexEntry>& index) {
+            const uint64_t fileSize = static_cast<uint64_t>(reader.fileSize());
+            const uint64_t indexBytes = sizeof(uint64_t) + header.chunkCount * sizeof(CompressedChunkIndexEntry);
+            if (header.chunkCount > fileSize / sizeof(CompressedChunkIndexEntry) || header.indexOffset + indexBytes > fileSize) {
+                throw std::runtime_error("Compressed chunk index exceeds file size.");
+            }
+
+            std::vector<uint8_t> buffer(static_cast<size_t>(indexBytes));
+            if (!reader.seek(static_cast<std::streamoff>(header.indexOffset))
+                || reader.readBytes(reinterpret_cast<char*>(buffer.data()), buffer.size()) != buffer.size()) {
+                throw std::runtime_error("Failed to read compressed chunk index.");
+            }
+            if (calculateCRC32(buffer.data(), buffer.size()) != header.indexChecksum) {
+                throw std::runtime_error("Compressed chunk index checksum mismatch.");
+            }
+
+            uint64_t count = 0;
+            std::memcpy(&count, buffer.data(), sizeof(count));
+            if (count != header.chunkCount) {
+                throw std::runtime_error("Compressed chunk index count does not match header.");
+            }
+            index.resize(static_cast<size_t>(count));
+            if (count > 0) {
+                std::memcpy(index.data(), buffer.data() + sizeof(count), static_cast<size_t>(count) * sizeof(CompressedChunkIndexEntry));
+            }
+
+            for (const auto& entry : index) {
+                if (entry.offset < header.dataOffset || entry.offset + entry.compressedSize > header.indexOffset) {
+                    throw std::runtime_error("Invalid data offset or size for chunk ("
+                        + std::to_string(entry.cx) + "," + std::to_string(entry.cy) + "," + std::to_string(entry.cz) + ")");
+                }
+            }
+        }
+
+        // --- 并行批处理 ---
+
+        // 每批并行处理的区块数：批内结果按固定顺序写出/插入，输出与线程数无关；批大小同时限制了额外的内存占用
+        constexpr size_t PARALLEL_CHUNK_BATCH = 64;
+
+        // 在 taskSystem 的工作线程上执行 job(0..count-1) 并等待全部完成；taskSystem 为空时在当前线程顺序执行
+        void runParallel(TaskSystem* taskSystem, size_t count, const std::function<void(size_t)>& job) {
+            if (taskSystem == nullptr || count <= 1) {
+                for (size_t i = 0; i < count; ++i) job(i);
+                return;
+            }
+            std::vector<std::future<void>> futs;
+            futs.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                futs.push_back(taskSystem->submitFuture([&job, i]() { job(i); }));
+            }
+            for (auto& f : futs) f.get();
+        }
+
+        // 等待压缩写出的区块记录。缓冲区在批之间复用
+        struct PendingRecord {
+            std::vector<uint8_t> record;          // 未压缩记录
+            std::vector<Bytef> compressed;        // 压缩记录 (precompressed 时为从源 .tlwz 原样复制的字节)
+            CompressedChunkIndexEntry entry{};    // 坐标已填写；其余字段由 compressPendingRecord 填写
+            bool hasRecordChecksum{false};        // entry.uncompressedChecksum 已知 (来自源文件索引)
+            bool precompressed{false};
+            bool ok{false};
+            size_t sharedWith{0};                 // 与之内容相同、先写出的记录在索引中的位置 (NO_SHARED_RECORD 表示独立写出)
+        };
+
+        constexpr size_t NO_SHARED_RECORD = static_cast<size_t>(-1);
+
+        /**
+         * 保存时按内容去重区块记录：相同的记录只写出一份，后续区块的索引条目指向同一偏移量，读取端无需改动。
+         * 重复的记录几乎都是很小的均匀/少量差异记录 (例如整片被探索过的地下区块)，因此只缓存较小的记录用于逐字节比较，
+         * 缓存总量有上限，与地图大小无关。原样复制的压缩记录按源文件偏移量去重，源文件中已共享的记录继续共享。
+         */
+        class RecordDeduplicator {
+        public:
+            // 返回先前相同记录在索引中的位置；没有时登记为 position 并返回 NO_SHARED_RECORD
+            size_t findOrAdd(const std::vector<uint8_t>& record, uint32_t checksum, size_t position) {
+                if (record.size() > MAX_RECORD_SIZE) return NO_SHARED_RECORD;
+                const uint64_t key = (static_cast<uint64_t>(record.size()) << 32) | checksum;
+                auto range = records.equal_range(key);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (it->second.record == record) return it->second.position;
+                }
+                if (storedBytes + record.size() <= MAX_STORED_BYTES) {
+                    records.emplace(key, Stored{record, position});
+                    storedBytes += record.size();
+                }
+                return NO_SHARED_RECORD;
+            }
+
+            size_t findOrAddCopied(uint64_t sourceOffset, size_t position) {
+                auto inserted = copied.emplace(sourceOffset, position);
+                return inserted.second ? NO_SHARED_RECORD : inserted.first->second;
+            }
+
+            size_t memoryUsage() const {
+                return storedBytes + (records.size() + copied.size()) * (sizeof(Stored) + 2 * sizeof(uint64_t));
+            }
+
+        private:
+            static constexpr size_t MAX_RECORD_SIZE = 4096;
+            static constexpr size_t MAX_STORED_BYTES = 4 << 20;
+
+            struct Stored {
+                std::vector<uint8_t> record;
+                size_t position;
+            };
+            std::unordered_multimap<uint64_t, Stored> records; // 键：(记录大小 << 32) | CRC32
+            std::unordered_map<uint64_t, size_t> copied;
+            size_t storedBytes{0};
+        };
+
+        // 工作线程上执行：计算校验和并压缩 (precompressed 时只校验复制来的字节；共享记录无需处理)
+        void compressPendingRecord(PendingRecord& pending, const std::vector<uint8_t>* dictionary) {
+            if (pending.sharedWith != NO_SHARED_RECORD) {
+                pending.ok = true;
+                return;
+            }
+            if (pending.precompressed) {
+                pending.ok = calculateCRC32(pending.compressed.data(), pending.compressed.size()) == pending.entry.compressedChecksum;
+                return;
+            }
+            if (!pending.hasRecordChecksum) {
+                pending.entry.uncompressedChecksum = calculateCRC32(pending.record.data(), pending.record.size());
+            }
+            pending.ok = SimpZlib::compress(pending.record, pending.compressed, Z_DEFAULT_COMPRESSION, dictionary) == SimpZlib::Status::OK;
+            if (!pending.ok) return;
+            pending.entry.compressedSize = static_cast<uint32_t>(pending.compressed.size());
+            pending.entry.compressedChecksum = calculateCRC32(pending.compressed.data(), pending.compressed.size());
+            pending.entry.uncompressedSize = static_cast<uint32_t>(pending.record.size());
+        }
+
+        // 更新 .tlwz 中的元数据：0.2 起直接改写未压缩的元数据块 (0.4 起位于文件开头)，0.1 版需解压、修改后重新压缩整个文件
+        bool updateTlwzMetadata(const std::string& tlwzPath, const WorldMetadata& metadata) {
+            try {
+                std::vector<uint8_t> buffer;
+                {
+                    BinaryReader reader(tlwzPath);
+                    if (peekCompressedVersion(reader) >= COMPRESSED_FORMAT_VERSION_MINOR_CHUNKED) {
+                        CompressedFileHeaderV2 header{};
+                        readCompressedHeaderV2(reader, header);
+                        MetadataBlock block = toMetadataBlock(metadata);
+
+                        std::fstream file(tlwzPath, std::ios::binary | std::ios::in | std::ios::out);
+                        if (!file) return false;
+                        file.seekp(static_cast<std::streamoff>(header.metadataOffset), std::ios::beg);
+                        file.write(reinterpret_cast<const char*>(&block), sizeof(block));
+                        return static_cast<bool>(file.flush());
+                    }
+
+                    CompressedFileHeader header{};
+                    if (!reader.read(header)) return false;
+                    if (header.compressionType != COMPRESSION_TYPE_ZLIB) return false;
+
+                    std::vector<Bytef> compressedData(static_cast<size_t>(header.compressedSize));
+                    size_t bytesRead = reader.readBytes(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
+                    if (bytesRead != header.compressedSize) return false;
+                    if (calculateCRC32(compressedData.data(), compressedData.size()) != header.compressedChecksum) return false;
+
+                    std::vector<Bytef> decompressed;
+                    auto status = SimpZlib::uncompress(compressedData, decompressed, header.uncompressedSize);
+                    if (status != SimpZlib::Status::OK || decompressed.size() != header.uncompressedSize) return false;
+                    if (calculateCRC32(decompressed.data(), decompressed.size()) != header.uncompressedChecksum) return false;
+
+                    buffer.assign(decompressed.begin(), decompressed.end());
+                } // 关闭 reader 后再覆盖文件
+                if (!applyMetadataToBuffer(buffer, metadata)) return false;
+                return recompressBufferToTlwz(buffer, tlwzPath);
+            } catch (...) {
+                return false;
+            }
         }
     }
 
@@ -203,35 +504,216 @@ namespace TilelandWorld {
     }
 
     // --- 区块数据序列化/反序列化 ---
-    bool MapSerializer::saveChunkData(BinaryWriter& writer, const Chunk& chunk, uint32_t& outChecksum) {
-        const void* dataPtr = chunk.tiles.data();
-        size_t dataSize = sizeof(Tile) * CHUNK_VOLUME;
+    void MapSerializer::encodeChunkRecord(const Chunk& chunk, std::vector<uint8_t>& record, const TerrainGenerator* base) {
+        // 区块以调色板形式存储，写出前展开为 Tile 数组，按紧凑平面编码，再追加稀疏覆盖表
+        std::vector<Tile> tiles(CHUNK_VOLUME);
+        chunk.copyTilesTo(tiles.data());
+
+        record.clear();
+        record.push_back(CHUNK_RECORD_COMPACT);
+        size_t tileBytes = ChunkCodec::encodeTiles(tiles.data(), record);
+
+        // 紧凑编码大于打包数组时 (光照与地形都很零碎) 退回完整记录
+        const size_t fullTileBytes = sizeof(uint32_t) * CHUNK_VOLUME;
+        if (tileBytes > fullTileBytes) {
+            record.resize(1 + fullTileBytes);
+            record[0] = CHUNK_RECORD_FULL;
+            uint8_t* out = record.data() + 1;
+            for (const Tile& tile : tiles) {
+                uint32_t packed = tile.toPacked();
+                std::memcpy(out, &packed, sizeof(packed));
+                out += sizeof(packed);
+            }
+            tileBytes = fullTileBytes;
+        }
 
-        outChecksum = calculateCRC32(dataPtr, dataSize);
+        // 相对生成器结果的差异：只有比上面选出的编码更小时才使用 (差异条目 6 字节，适合零散修改)
+        if (base) {
+            Chunk generated(chunk.getChunkX(), chunk.getChunkY(), chunk.getChunkZ());
+            base->generateChunk(generated);
+            std::vector<Tile> baseTiles(CHUNK_VOLUME);
+            generated.copyTilesTo(baseTiles.data());
+
+            std::vector<TileDeltaRecord> deltas;
+            bool useDelta = true;
+            for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+                const uint32_t packed = tiles[i].toPacked();
+                if (packed == baseTiles[i].toPacked()) continue;
+                if (sizeof(uint32_t) + (deltas.size() + 1) * sizeof(TileDeltaRecord) >= tileBytes) {
+                    useDelta = false;
+                    break;
+                }
+                deltas.push_back(TileDeltaRecord{static_cast<uint16_t>(i), packed});
+            }
+
+            if (useDelta) {
+                const uint32_t deltaCount = static_cast<uint32_t>(deltas.size());
+                record.resize(1 + sizeof(deltaCount) + deltas.size() * sizeof(TileDeltaRecord));
+                record[0] = CHUNK_RECORD_DELTA;
+                std::memcpy(record.data() + 1, &deltaCount, sizeof(deltaCount));
+                if (deltaCount > 0) {
+                    std::memcpy(record.data() + 1 + sizeof(deltaCount), deltas.data(), deltas.size() * sizeof(TileDeltaRecord));
+                }
+            }
+        }
 
-        return writer.writeBytes(static_cast<const char*>(dataPtr), dataSize);
+        const uint32_t overrideCount = static_cast<uint32_t>(chunk.overrides.size());
+        const size_t overrideOffset = record.size();
+        record.resize(overrideOffset + sizeof(uint32_t) + overrideCount * sizeof(TileOverrideRecord));
+        uint8_t* out = record.data() + overrideOffset;
+        std::memcpy(out, &overrideCount, sizeof(overrideCount));
+        out += sizeof(overrideCount);
+        for (const auto& entry : chunk.overrides) {
+            TileOverrideRecord rec{};
+            rec.localIndex = entry.first;
+            rec.flags = (entry.second.canEnterSameLevel ? TILE_OVERRIDE_FLAG_ENTER_SAME_LEVEL : 0) |
+                        (entry.second.canStandOnTop ? TILE_OVERRIDE_FLAG_STAND_ON_TOP : 0);
+            rec.movementCost = entry.second.movementCost;
+            std::memcpy(out, &rec, sizeof(rec));
+            out += sizeof(rec);
+        }
     }
 
-    void MapSerializer::loadChunkData(BinaryReader& reader, Chunk& chunk, uint32_t expectedSize, uint32_t expectedChecksum) {
-        size_t requiredSize = sizeof(Tile) * CHUNK_VOLUME;
+    void MapSerializer::decodeChunkRecord(const uint8_t* data, size_t size, Chunk& chunk, uint16_t versionMinor, const TerrainGenerator* base) {
+        // 0.5 起记录以编码标记开头
+        uint8_t encoding = CHUNK_RECORD_FULL;
+        if (versionMinor > FORMAT_VERSION_MINOR_UNTAGGED_RECORD) {
+            if (size == 0) {
+                throw std::runtime_error("Chunk record is empty.");
+            }
+            encoding = *data++;
+            --size;
+            const bool compactKnown = versionMinor > FORMAT_VERSION_MINOR_DELTA_RECORD;
+            if (encoding != CHUNK_RECORD_FULL && encoding != CHUNK_RECORD_DELTA && !(compactKnown && encoding == CHUNK_RECORD_COMPACT)) {
+                throw std::runtime_error("Unknown chunk record encoding " + std::to_string(encoding) + ".");
+            }
+        }
 
-        if (expectedSize != requiredSize) {
-            throw std::runtime_error("Chunk data size mismatch. Expected " + std::to_string(requiredSize) + ", Got " + std::to_string(expectedSize));
+        const bool legacyLayout = versionMinor <= FORMAT_VERSION_MINOR_LEGACY_TILE;
+        const bool delta = encoding == CHUNK_RECORD_DELTA;
+        const bool compact = encoding == CHUNK_RECORD_COMPACT;
+        // 紧凑编码的长度在解码时确定，这里只检查固定部分
+        const size_t tileBytes = compact ? 0 : delta ? sizeof(uint32_t) : (legacyLayout ? sizeof(LegacyTileV3) : sizeof(uint32_t)) * CHUNK_VOLUME;
+        const size_t minimumSize = legacyLayout ? tileBytes : tileBytes + sizeof(uint32_t);
+
+        if (legacyLayout ? size != tileBytes : size < minimumSize) {
+            throw std::runtime_error("Chunk data size mismatch. Expected " + std::string(legacyLayout ? "" : "at least ")
+                + std::to_string(minimumSize) + ", Got " + std::to_string(size));
         }
 
-        void* dataPtr = chunk.tiles.data();
-        size_t bytesRead = reader.readBytes(static_cast<char*>(dataPtr), requiredSize);
+        std::vector<Tile> tiles(CHUNK_VOLUME);
+        std::vector<std::pair<uint16_t, TileTraits>> overrides;
+        const uint8_t* in = data;
+        const uint8_t* end = data + size;
+
+        if (legacyLayout) {
+            // 旧版逐实例保存通行性：与地形默认值不同的才转换为覆盖条目
+            for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+                LegacyTileV3 legacy{};
+                std::memcpy(&legacy, in + i * sizeof(LegacyTileV3), sizeof(legacy));
+                Tile tile(static_cast<TerrainType>(legacy.terrain));
+                tile.lightLevel = legacy.lightLevel;
+                tile.isExplored = legacy.isExplored;
+                TileTraits traits{legacy.canEnterSameLevel, legacy.canStandOnTop, legacy.movementCost};
+                if (traits != TileTraits::fromTerrain(tile.terrain)) {
+                    tile.hasOverride = 1;
+                    overrides.emplace_back(static_cast<uint16_t>(i), traits);
+                }
+                tiles[i] = tile;
+            }
+        } else {
+            if (compact) {
+                in += ChunkCodec::decodeTiles(in, static_cast<size_t>(end - in), tiles.data());
+                if (static_cast<size_t>(end - in) < sizeof(uint32_t)) {
+                    throw std::runtime_error("Compact chunk record is missing its override table.");
+                }
+            } else if (delta) {
+                // 先重新生成区块，再套用差异
+                if (!base) {
+                    throw std::runtime_error("Delta-encoded chunk record requires the terrain generator it was saved against.");
+                }
+                uint32_t deltaCount = 0;
+                std::memcpy(&deltaCount, in, sizeof(deltaCount));
+                in += sizeof(deltaCount);
+                if (deltaCount > static_cast<uint32_t>(CHUNK_VOLUME)
+                    || static_cast<size_t>(end - in) < deltaCount * sizeof(TileDeltaRecord) + sizeof(uint32_t)) {
+                    throw std::runtime_error("Chunk delta table size mismatch. Count " + std::to_string(deltaCount)
+                        + ", record size " + std::to_string(size));
+                }
+
+                base->generateChunk(chunk);
+                chunk.copyTilesTo(tiles.data());
+                int previousIndex = -1;
+                for (uint32_t i = 0; i < deltaCount; ++i) {
+                    TileDeltaRecord rec{};
+                    std::memcpy(&rec, in, sizeof(rec));
+                    in += sizeof(rec);
+                    if (rec.localIndex >= CHUNK_VOLUME || static_cast<int>(rec.localIndex) <= previousIndex) {
+                        throw std::runtime_error("Invalid chunk delta entry at local index " + std::to_string(rec.localIndex));
+                    }
+                    tiles[rec.localIndex] = Tile::fromPacked(rec.packedTile);
+                    previousIndex = rec.localIndex;
+                }
+            } else {
+                for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i) {
+                    uint32_t packed = 0;
+                    std::memcpy(&packed, in, sizeof(packed));
+                    in += sizeof(packed);
+                    tiles[i] = Tile::fromPacked(packed);
+                }
+            }
+
+            uint32_t overrideCount = 0;
+            std::memcpy(&overrideCount, in, sizeof(overrideCount));
+            in += sizeof(overrideCount);
+            if (static_cast<size_t>(end - in) != static_cast<size_t>(overrideCount) * sizeof(TileOverrideRecord)) {
+                throw std::runtime_error("Chunk override table size mismatch. Count " + std::to_string(overrideCount)
+                    + ", record size " + std::to_string(size));
+            }
 
-        if (bytesRead != requiredSize) {
-            throw std::runtime_error("Failed to read complete chunk data. Read " + std::to_string(bytesRead) + "/" + std::to_string(requiredSize));
+            overrides.reserve(overrideCount);
+            for (uint32_t i = 0; i < overrideCount; ++i) {
+                TileOverrideRecord rec{};
+                std::memcpy(&rec, in, sizeof(rec));
+                in += sizeof(rec);
+                if (rec.localIndex >= CHUNK_VOLUME || (!overrides.empty() && rec.localIndex <= overrides.back().first)) {
+                    throw std::runtime_error("Invalid chunk override entry at local index " + std::to_string(rec.localIndex));
+                }
+                overrides.emplace_back(rec.localIndex, TileTraits{
+                    (rec.flags & TILE_OVERRIDE_FLAG_ENTER_SAME_LEVEL) != 0,
+                    (rec.flags & TILE_OVERRIDE_FLAG_STAND_ON_TOP) != 0,
+                    rec.movementCost});
+            }
         }
 
-        uint32_t calculatedChecksum = calculateCRC32(dataPtr, requiredSize);
-        if (calculatedChecksum != expectedChecksum) {
-            std::stringstream ss;
-            ss << "Chunk data checksum mismatch! Expected 0x" << std::hex << expectedChecksum
-                << ", Calculated 0x" << calculatedChecksum << std::dec;
-            throw std::runtime_error(ss.str());
+        chunk.assignTiles(tiles.data());
+        chunk.overrides.swap(overrides);
+    }
+
+    bool MapSerializer::saveChunkData(BinaryWriter& writer, const Chunk& chunk, const TerrainGenerator* base, uint32_t& outChecksum) {
+        std::vector<uint8_t> record;
+        encodeChunkRecord(chunk, record, base);
+        outChecksum = calculateCRC32(record.data(), record.size());
+
+        return writer.writeBytes(reinterpret_cast<const char*>(record.data()), record.size());
+    }
+
+    void MapSerializer::loadAllChunks(Map& map, LazyChunkFile& source, const std::vector<ChunkCoord>& coords, TaskSystem* taskSystem) {
+        // 读取在 source 的锁内串行进行，校验、解压与解码在工作线程上并行；按批插入地图
+        std::vector<std::unique_ptr<Chunk>> loaded(std::min(coords.size(), PARALLEL_CHUNK_BATCH));
+        for (size_t begin = 0; begin < coords.size(); begin += PARALLEL_CHUNK_BATCH) {
+            const size_t count = std::min(PARALLEL_CHUNK_BATCH, coords.size() - begin);
+            runParallel(taskSystem, count, [&](size_t i) {
+                loaded[i] = source.loadChunk(coords[begin + i]);
+            });
+            for (size_t i = 0; i < count; ++i) {
+                const ChunkCoord& coord = coords[begin + i];
+                if (!loaded[i]) {
+                    throw std::runtime_error("Failed to load chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ")");
+                }
+                loaded[i]->shareIndices(map.chunkIndexPool);
+                map.loadedChunks.emplace(coord, std::move(loaded[i]));
+            }
         }
     }
 
@@ -254,8 +736,17 @@ namespace TilelandWorld {
         }
 
         if (count > 0) {
-            index.resize(count);
             size_t bytesToRead = count * sizeof(ChunkIndexEntry);
+            if (count > bytesToRead / sizeof(ChunkIndexEntry) || static_cast<std::streamoff>(bytesToRead) > reader.fileSize() - reader.tell()) {
+                throw std::runtime_error("Index count " + std::to_string(count) + " exceeds file size.");
+            }
+            if (const uint8_t* view = reader.readView(bytesToRead)) {
+                // 映射读取：直接从映射复制索引条目
+                index.resize(count);
+                std::memcpy(index.data(), view, bytesToRead);
+                return;
+            }
+            index.resize(count);
             size_t bytesRead = reader.readBytes(reinterpret_cast<char*>(index.data()), bytesToRead);
 
             if (bytesRead != bytesToRead) {
@@ -265,89 +756,268 @@ namespace TilelandWorld {
         }
     }
 
+    // --- 元数据块 ---
+    bool MapSerializer::writeMetadataBlock(BinaryWriter& writer, const WorldMetadata& meta) {
+        MetadataBlock metaBlock{};
+        metaBlock.seed = meta.seed;
+        metaBlock.frequency = meta.frequency;
+        std::memset(metaBlock.noiseType, 0, sizeof(metaBlock.noiseType));
+        std::memset(metaBlock.fractalType, 0, sizeof(metaBlock.fractalType));
+        std::strncpy(metaBlock.noiseType, meta.noiseType.c_str(), sizeof(metaBlock.noiseType) - 1);
+        std::strncpy(metaBlock.fractalType, meta.fractalType.c_str(), sizeof(metaBlock.fractalType) - 1);
+        metaBlock.octaves = meta.octaves;
+        metaBlock.lacunarity = meta.lacunarity;
+        metaBlock.gain = meta.gain;
+        metaBlock.latticeSpacing = meta.latticeSpacing;
+
+        return writer.write(metaBlock.seed)
+            && writer.write(metaBlock.frequency)
+            && writer.writeBytes(reinterpret_cast<const char*>(metaBlock.noiseType), sizeof(metaBlock.noiseType))
+            && writer.writeBytes(reinterpret_cast<const char*>(metaBlock.fractalType), sizeof(metaBlock.fractalType))
+            && writer.write(metaBlock.octaves)
+            && writer.write(metaBlock.lacunarity)
+            && writer.write(metaBlock.gain)
+            && writer.write(metaBlock.latticeSpacing)
+            && writer.writeBytes(reinterpret_cast<const char*>(metaBlock.reserved), sizeof(metaBlock.reserved));
+    }
+
+    void MapSerializer::readMetadataBlock(BinaryReader& reader, WorldMetadata& worldMeta) {
+        MetadataBlock metaBlock{};
+        if (!reader.read(metaBlock.seed)) {
+            throw std::runtime_error("Failed to read metadata seed.");
+        }
+        if (!reader.read(metaBlock.frequency)) {
+            throw std::runtime_error("Failed to read metadata frequency.");
+        }
+
+        size_t noiseRead = reader.readBytes(reinterpret_cast<char*>(metaBlock.noiseType), sizeof(metaBlock.noiseType));
+        if (noiseRead != sizeof(metaBlock.noiseType)) {
+            throw std::runtime_error("Failed to read metadata noiseType.");
+        }
+        size_t fractalRead = reader.readBytes(reinterpret_cast<char*>(metaBlock.fractalType), sizeof(metaBlock.fractalType));
+        if (fractalRead != sizeof(metaBlock.fractalType)) {
+            throw std::runtime_error("Failed to read metadata fractalType.");
+        }
+
+        if (!reader.read(metaBlock.octaves)) {
+            throw std::runtime_error("Failed to read metadata octaves.");
+        }
+        if (!reader.read(metaBlock.lacunarity)) {
+            throw std::runtime_error("Failed to read metadata lacunarity.");
+        }
+        if (!reader.read(metaBlock.gain)) {
+            throw std::runtime_error("Failed to read metadata gain.");
+        }
+        if (!reader.read(metaBlock.latticeSpacing)) {
+            throw std::runtime_error("Failed to read metadata lattice spacing.");
+        }
+        size_t reservedRead = reader.readBytes(reinterpret_cast<char*>(metaBlock.reserved), sizeof(metaBlock.reserved));
+        if (reservedRead != sizeof(metaBlock.reserved)) {
+            throw std::runtime_error("Failed to read metadata reserved padding.");
+        }
+
+        worldMeta.seed = metaBlock.seed;
+        worldMeta.frequency = metaBlock.frequency;
+        worldMeta.noiseType = trimNullTerminated(metaBlock.noiseType, sizeof(metaBlock.noiseType));
+        worldMeta.fractalType = trimNullTerminated(metaBlock.fractalType, sizeof(metaBlock.fractalType));
+        worldMeta.octaves = metaBlock.octaves;
+        worldMeta.lacunarity = metaBlock.lacunarity;
+        worldMeta.gain = metaBlock.gain;
+        worldMeta.latticeSpacing = metaBlock.latticeSpacing > 0 ? metaBlock.latticeSpacing : 1;
+    }
+
+    // --- 生成器基准 ---
+    std::unique_ptr<TerrainGenerator> MapSerializer::createBaseGenerator(const Map& map, bool& outSkipUntouched) {
+        auto base = createTerrainGeneratorFromMetadata(map.getWorldMetadata());
+        // 地图的生成器与元数据不一致时 (例如测试中直接指定的生成器)，未修改的区块无法在加载时重建，仍须保存
+        outSkipUntouched = map.terrainGenerator && map.terrainGenerator->generatesSameAs(*base);
+        return base;
+    }
+
+    void MapSerializer::checkGeneratorVersion(uint8_t recordedVersion, const TerrainGenerator& generator, const std::string& path) {
+        if (recordedVersion != 0 && recordedVersion != generator.getVersion()) {
+            throw std::runtime_error("Terrain generator version mismatch in " + path + ": saved with "
+                + std::to_string(recordedVersion) + ", current " + std::to_string(generator.getVersion())
+                + ". Chunks stored as differences cannot be rebuilt.");
+        }
+    }
+
+    // --- 保存区块枚举 ---
+    bool MapSerializer::forEachChunkToSave(const Map& map, const std::unordered_set<ChunkCoord, ChunkCoordHash>* modifiedChunks, bool skipUntouched,
+                                           const std::function<bool(const Chunk&)>& onChunk,
+                                           const std::function<bool(const ChunkCoord&)>& onSaved) {
+        auto skip = [modifiedChunks](const ChunkCoord& coord) {
+            // "只保存修改区块"逻辑：查找修改表，跳过不需要保存的项目
+            return modifiedChunks != nullptr && modifiedChunks->find(coord) == modifiedChunks->end();
+        };
+
+        ChunkStore* store = map.getChunkStore();
+        LazyChunkFile* source = map.getSavedChunkSource();
+        if (source && source->hasFailed()) {
+            LOG_ERROR("Save source " + source->getPath() + " could not be reopened; refusing to save without its chunks.");
+            return false;
+        }
+        for (const auto& pair : map.loadedChunks) {
+            if (skip(pair.first)) continue;
+            // 干净且不在后备存储/存档源中的区块即生成器的原始输出
+            if (skipUntouched && !pair.second->isDirty() && !(store && store->contains(pair.first))
+                && !(source && source->contains(pair.first))) {
+                continue;
+            }
+            if (!onChunk(*pair.second)) return false;
+        }
+
+        // 已卸载到后备存储的区块：逐个读回写出，不放回地图 (保存过程中内存占用保持平稳)
+        if (store) {
+            for (const ChunkCoord& coord : store->storedChunks()) {
+                if (map.loadedChunks.contains(coord) || skip(coord)) continue; // 内存中的版本更新
+
+                std::unique_ptr<Chunk> stored = store->loadChunk(coord);
+                if (!stored) {
+                    LOG_ERROR("Failed to read evicted chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ") from chunk store.");
+                    return false;
+                }
+                if (!onChunk(*stored)) return false;
+            }
+        }
+
+        // 从未加载过的已保存区块
+        if (source) {
+            for (const ChunkCoord& coord : source->storedChunks()) {
+                if (map.loadedChunks.contains(coord) || (store && store->contains(coord)) || skip(coord)) continue;
+                if (!onSaved(coord)) return false;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<Map> MapSerializer::createSaveSnapshot(const Map& map) {
+        auto snapshot = std::make_unique<Map>();
+        snapshot->worldMetadata = map.worldMetadata;
+        // 保存只用生成器判断未修改的区块能否在加载时重建 (见 createBaseGenerator)：能重建时使用元数据描述的生成器，否则不设生成器
+        bool skipUntouched = false;
+        snapshot->terrainGenerator = createBaseGenerator(map, skipUntouched);
+        if (!skipUntouched) snapshot->terrainGenerator.reset();
+        snapshot->chunkStore = map.chunkStore;
+        snapshot->savedChunkSource = map.savedChunkSource;
+
+        snapshot->loadedChunks.reserve(map.loadedChunks.size());
+        for (const auto& pair : map.loadedChunks) {
+            snapshot->loadedChunks.emplace(pair.first, std::make_unique<Chunk>(*pair.second));
+        }
+        return snapshot;
+    }
+
     // --- saveMap / loadMap 实现 ---
     bool MapSerializer::saveMap(const Map& map, const std::string& filepath, const std::unordered_set<ChunkCoord, ChunkCoordHash>* modifiedChunks) {
         try {
-            BinaryWriter writer(filepath);
+            // 先写临时文件，落盘后再替换，中途失败不会留下被截断的存档；
+            // 目标正是地图按需读取的存档文件时由 LazyChunkFile 替换，避免覆盖尚未读取的区块
+            LazyChunkFile* source = map.getSavedChunkSource();
+            std::error_code sameEc;
+            const bool replacingSource = source && std::filesystem::exists(filepath) &&
+                                         std::filesystem::equivalent(source->getPath(), filepath, sameEc);
+            const std::string writePath = filepath + ".tmp";
+            TempFileGuard tempGuard(writePath);
+
+            // 区块以加载时会使用的生成器为基准差异编码
+            bool skipUntouched = false;
+            const std::unique_ptr<TerrainGenerator> base = createBaseGenerator(map, skipUntouched);
 
-            FileHeader header = {};
-            header.magicNumber = MAGIC_NUMBER;
-            header.versionMajor = FORMAT_VERSION_MAJOR;
-            header.versionMinor = FORMAT_VERSION_MINOR;
-    header.metadataOffset = 0; // 稍后填充
-            if (!writer.seek(0)) return false;
-            writer.write(header);
-
-            header.metadataOffset = 0;
-
-            header.dataOffset = writer.tell();
             std::vector<ChunkIndexEntry> index;
-            // 预估大小，如果过滤则可能小于 loadedChunks.size()
-            index.reserve(modifiedChunks ? modifiedChunks->size() : map.loadedChunks.size());
-
-            for (const auto& pair : map.loadedChunks) {
-                // 4. "只保存修改区块"逻辑：查找修改表，跳过不需要保存的项目
-                if (modifiedChunks != nullptr) {
-                    if (modifiedChunks->find(pair.first) == modifiedChunks->end()) {
-                        continue; // 该区块未被修改，跳过保存
+            {
+                BinaryWriter writer(writePath);
+
+                FileHeader header = {};
+                header.magicNumber = MAGIC_NUMBER;
+                header.versionMajor = FORMAT_VERSION_MAJOR;
+                header.versionMinor = FORMAT_VERSION_MINOR;
+                header.generatorVersion = base->getVersion();
+                header.metadataOffset = 0; // 稍后填充
+                if (!writer.seek(0)) return false;
+                writer.write(header);
+
+                header.dataOffset = writer.tell();
+                // 预估大小，如果过滤则可能小于 loadedChunks.size()
+                index.reserve(modifiedChunks ? modifiedChunks->size() : map.loadedChunks.size());
+
+                auto writeChunk = [&](const Chunk& chunk) {
+                    ChunkIndexEntry entry = {};
+                    entry.cx = chunk.getChunkX();
+                    entry.cy = chunk.getChunkY();
+                    entry.cz = chunk.getChunkZ();
+                    entry.offset = writer.tell();
+                    if (!saveChunkData(writer, chunk, base.get(), entry.checksum)) {
+                        LOG_ERROR("Failed to save chunk (" + std::to_string(entry.cx) + "," + std::to_string(entry.cy) + "," + std::to_string(entry.cz) + ") data.");
+                        return false;
+                    }
+                    entry.size = static_cast<uint32_t>(static_cast<uint64_t>(writer.tell()) - entry.offset);
+                    index.push_back(entry);
+                    return true;
+                };
+
+                // 从未加载过的已保存区块：记录格式相同时原样复制，不解码
+                const bool sameFormat = source && source->getVersionMinor() == FORMAT_VERSION_MINOR;
+                std::vector<uint8_t> record;
+                auto copySaved = [&](const ChunkCoord& coord) {
+                    if (!sameFormat) {
+                        std::unique_ptr<Chunk> saved = source->loadChunk(coord);
+                        if (!saved) {
+                            LOG_ERROR("Failed to read saved chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ").");
+                            return false;
+                        }
+                        return writeChunk(*saved);
                     }
-                }
 
-                const Chunk& chunk = *pair.second;
-                ChunkIndexEntry entry = {};
-                entry.cx = chunk.getChunkX();
-                entry.cy = chunk.getChunkY();
-                entry.cz = chunk.getChunkZ();
+                    ChunkIndexEntry entry = {};
+                    if (!source->readRecord(coord, record, entry)) {
+                        LOG_ERROR("Failed to copy saved chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ").");
+                        return false;
+                    }
+                    entry.offset = writer.tell();
+                    if (!writer.writeBytes(reinterpret_cast<const char*>(record.data()), record.size())) return false;
+                    index.push_back(entry);
+                    return true;
+                };
 
-                entry.offset = writer.tell();
-                std::streampos startPos = entry.offset;
-                if (!saveChunkData(writer, chunk, entry.checksum)) {
-                    LOG_ERROR("Failed to save chunk (" + std::to_string(entry.cx) + "," + std::to_string(entry.cy) + "," + std::to_string(entry.cz) + ") data.");
+                if (!forEachChunkToSave(map, modifiedChunks, skipUntouched, writeChunk, copySaved)) {
                     return false;
                 }
-                std::streampos endPos = writer.tell();
-                entry.size = static_cast<uint32_t>(static_cast<uint64_t>(endPos) - static_cast<uint64_t>(startPos));
 
-                index.push_back(entry);
-            }
+                header.indexOffset = writer.tell();
+                if (!writeIndex(writer, index)) {
+                    LOG_ERROR("Failed to write chunk index.");
+                    return false;
+                }
 
-            header.indexOffset = writer.tell();
-            if (!writeIndex(writer, index)) {
-                LOG_ERROR("Failed to write chunk index.");
-                return false;
-            }
+                // 写入元数据块
+                header.metadataOffset = writer.tell();
+                if (!writeMetadataBlock(writer, map.getWorldMetadata())) {
+                    LOG_ERROR("Failed to write metadata block.");
+                    return false;
+                }
 
-            // 写入元数据块
-            header.metadataOffset = writer.tell();
-            MetadataBlock metaBlock{};
-            const WorldMetadata& meta = map.getWorldMetadata();
-            metaBlock.seed = meta.seed;
-            metaBlock.frequency = meta.frequency;
-            std::memset(metaBlock.noiseType, 0, sizeof(metaBlock.noiseType));
-            std::memset(metaBlock.fractalType, 0, sizeof(metaBlock.fractalType));
-            std::strncpy(metaBlock.noiseType, meta.noiseType.c_str(), sizeof(metaBlock.noiseType) - 1);
-            std::strncpy(metaBlock.fractalType, meta.fractalType.c_str(), sizeof(metaBlock.fractalType) - 1);
-            metaBlock.octaves = meta.octaves;
-            metaBlock.lacunarity = meta.lacunarity;
-            metaBlock.gain = meta.gain;
-
-            writer.write(metaBlock.seed);
-            writer.write(metaBlock.frequency);
-            writer.writeBytes(reinterpret_cast<const char*>(metaBlock.noiseType), sizeof(metaBlock.noiseType));
-            writer.writeBytes(reinterpret_cast<const char*>(metaBlock.fractalType), sizeof(metaBlock.fractalType));
-            writer.write(metaBlock.octaves);
-            writer.write(metaBlock.lacunarity);
-            writer.write(metaBlock.gain);
-            writer.writeBytes(reinterpret_cast<const char*>(metaBlock.reserved), sizeof(metaBlock.reserved));
-
-            std::streampos finalPos = writer.tell();
-            if (!writer.seek(0)) return false;
-            if (!writeHeader(writer, header)) {
-                LOG_ERROR("Failed to write final file header.");
-                return false;
+                if (!writer.seek(0)) return false;
+                if (!writeHeader(writer, header)) {
+                    LOG_ERROR("Failed to write final file header.");
+                    return false;
+                }
+            } // 关闭 writer
+
+            if (!BinaryWriter::syncToDisk(writePath)) return false;
+            if (replacingSource) {
+                if (!source->replaceFile(writePath, FORMAT_VERSION_MINOR, index)) return false;
+            } else {
+                std::error_code ec;
+                std::filesystem::rename(writePath, filepath, ec);
+                if (ec) {
+                    LOG_ERROR("Failed to replace " + filepath + ": " + ec.message());
+                    return false;
+                }
             }
 
-            std::cout << "Map saved successfully. Chunk count: " << index.size() << std::endl;
+            tempGuard.release();
+            LOG_INFO("Map saved successfully. Chunk count: " + std::to_string(index.size()));
             return true;
 
         } catch (const std::exception& e) {
@@ -356,7 +1026,7 @@ namespace TilelandWorld {
         }
     }
 
-    std::unique_ptr<Map> MapSerializer::loadMap(const std::string& filepath) {
+    std::unique_ptr<Map> MapSerializer::loadMap(const std::string& filepath, bool lazy, TaskSystem* taskSystem) {
         try {
             BinaryReader reader(filepath);
 
@@ -379,46 +1049,13 @@ namespace TilelandWorld {
                     throw std::runtime_error("Failed to seek to metadata offset.");
                 }
 
-                MetadataBlock metaBlock{};
-                if (!reader.read(metaBlock.seed)) {
-                    throw std::runtime_error("Failed to read metadata seed.");
-                }
-                if (!reader.read(metaBlock.frequency)) {
-                    throw std::runtime_error("Failed to read metadata frequency.");
-                }
-
-                size_t noiseRead = reader.readBytes(reinterpret_cast<char*>(metaBlock.noiseType), sizeof(metaBlock.noiseType));
-                if (noiseRead != sizeof(metaBlock.noiseType)) {
-                    throw std::runtime_error("Failed to read metadata noiseType.");
-                }
-                size_t fractalRead = reader.readBytes(reinterpret_cast<char*>(metaBlock.fractalType), sizeof(metaBlock.fractalType));
-                if (fractalRead != sizeof(metaBlock.fractalType)) {
-                    throw std::runtime_error("Failed to read metadata fractalType.");
-                }
-
-                if (!reader.read(metaBlock.octaves)) {
-                    throw std::runtime_error("Failed to read metadata octaves.");
-                }
-                if (!reader.read(metaBlock.lacunarity)) {
-                    throw std::runtime_error("Failed to read metadata lacunarity.");
-                }
-                if (!reader.read(metaBlock.gain)) {
-                    throw std::runtime_error("Failed to read metadata gain.");
-                }
-                size_t reservedRead = reader.readBytes(reinterpret_cast<char*>(metaBlock.reserved), sizeof(metaBlock.reserved));
-                if (reservedRead != sizeof(metaBlock.reserved)) {
-                    throw std::runtime_error("Failed to read metadata reserved padding.");
-                }
-
-                worldMeta.seed = metaBlock.seed;
-                worldMeta.frequency = metaBlock.frequency;
-                worldMeta.noiseType = std::string(metaBlock.noiseType);
-                worldMeta.fractalType = std::string(metaBlock.fractalType);
-                worldMeta.octaves = metaBlock.octaves;
-                worldMeta.lacunarity = metaBlock.lacunarity;
-                worldMeta.gain = metaBlock.gain;
+                readMetadataBlock(reader, worldMeta);
             }
 
+            // 差异编码的区块以同样由元数据创建的生成器为基准重建 (与地图之后是否更换生成器无关)
+            std::shared_ptr<const TerrainGenerator> base = createTerrainGeneratorFromMetadata(worldMeta);
+            checkGeneratorVersion(header.generatorVersion, *base, filepath);
+
             auto map = std::make_unique<Map>();
             map->setWorldMetadata(worldMeta);
             map->setTerrainGenerator(createTerrainGeneratorFromMetadata(worldMeta));
@@ -428,17 +1065,24 @@ namespace TilelandWorld {
                     throw std::runtime_error("Invalid data offset or size for chunk ("
                         + std::to_string(entry.cx) + "," + std::to_string(entry.cy) + "," + std::to_string(entry.cz) + ")");
                 }
-                if (!reader.seek(entry.offset)) {
-                    throw std::runtime_error("Failed to seek to data offset for chunk ("
-                        + std::to_string(entry.cx) + "," + std::to_string(entry.cy) + "," + std::to_string(entry.cz) + ")");
-                }
-
-                auto newChunk = std::make_unique<Chunk>(entry.cx, entry.cy, entry.cz);
-                loadChunkData(reader, *newChunk, entry.size, entry.checksum);
+            }
 
-                map->loadedChunks.emplace(ChunkCoord{entry.cx, entry.cy, entry.cz}, std::move(newChunk));
+            if (lazy) {
+                // 只保留索引与打开的文件，区块在首次访问时读取、校验并解码
+                auto source = std::make_shared<LazyChunkFile>(filepath, header.versionMinor, index);
+                source->setBaseGenerator(base);
+                map->setSavedChunkSource(std::move(source));
+                std::cout << "Map opened successfully. Saved chunk count: " << index.size() << std::endl;
+                return map;
             }
 
+            std::vector<ChunkCoord> coords;
+            coords.reserve(index.size());
+            for (const auto& entry : index) coords.push_back(ChunkCoord{entry.cx, entry.cy, entry.cz});
+            LazyChunkFile source(filepath, header.versionMinor, index);
+            source.setBaseGenerator(base);
+            loadAllChunks(*map, source, coords, taskSystem);
+
             std::cout << "Map loaded successfully. Loaded chunk count: " << index.size() << std::endl;
             return map;
 
@@ -473,27 +1117,35 @@ namespace TilelandWorld {
 
         try {
             BinaryReader reader(tlwzPath);
-            CompressedFileHeader header{};
-            if (!reader.read(header)) return false;
-            if (header.magicNumber != COMPRESSED_MAGIC_NUMBER) return false;
-            if (header.versionMajor != COMPRESSED_FORMAT_VERSION_MAJOR || header.versionMinor > COMPRESSED_FORMAT_VERSION_MINOR) return false;
-            if (header.compressionType != COMPRESSION_TYPE_ZLIB) return false;
+            if (peekCompressedVersion(reader) >= COMPRESSED_FORMAT_VERSION_MINOR_CHUNKED) {
+                // 0.2 起文件头与元数据均未压缩，直接读取 (0.4 起元数据紧跟文件头，只访问文件开头)
+                CompressedFileHeaderV2 header{};
+                readCompressedHeaderV2(reader, header);
+                MetadataBlock block{};
+                if (!reader.seek(static_cast<std::streamoff>(header.metadataOffset)) || !reader.read(block)) return false;
+                fromMetadataBlock(block, outSummary.metadata);
+                outSummary.chunkCount = static_cast<size_t>(header.chunkCount);
+            } else {
+                CompressedFileHeader header{};
+                if (!reader.read(header)) return false;
+                if (header.compressionType != COMPRESSION_TYPE_ZLIB) return false;
 
-            std::vector<Bytef> compressedData(static_cast<size_t>(header.compressedSize));
-            size_t bytesRead = reader.readBytes(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
-            if (bytesRead != header.compressedSize) return false;
+                std::vector<Bytef> compressedData(static_cast<size_t>(header.compressedSize));
+                size_t bytesRead = reader.readBytes(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
+                if (bytesRead != header.compressedSize) return false;
 
-            uint32_t compressedChecksum = calculateCRC32(compressedData.data(), compressedData.size());
-            if (compressedChecksum != header.compressedChecksum) return false;
+                uint32_t compressedChecksum = calculateCRC32(compressedData.data(), compressedData.size());
+                if (compressedChecksum != header.compressedChecksum) return false;
 
-            std::vector<Bytef> decompressed;
-            auto status = SimpZlib::uncompress(compressedData, decompressed, header.uncompressedSize);
-            if (status != SimpZlib::Status::OK || decompressed.size() != header.uncompressedSize) return false;
+                std::vector<Bytef> decompressed;
+                auto status = SimpZlib::uncompress(compressedData, decompressed, header.uncompressedSize);
+                if (status != SimpZlib::Status::OK || decompressed.size() != header.uncompressedSize) return false;
 
-            uint32_t uncompressedChecksum = calculateCRC32(decompressed.data(), decompressed.size());
-            if (uncompressedChecksum != header.uncompressedChecksum) return false;
+                uint32_t uncompressedChecksum = calculateCRC32(decompressed.data(), decompressed.size());
+                if (uncompressedChecksum != header.uncompressedChecksum) return false;
 
-            if (!readSummaryFromBuffer(reinterpret_cast<uint8_t*>(decompressed.data()), decompressed.size(), outSummary)) return false;
+                if (!readSummaryFromBuffer(reinterpret_cast<uint8_t*>(decompressed.data()), decompressed.size(), outSummary)) return false;
+            }
             outSummary.path = tlwzPath;
             outSummary.compressed = true;
             outSummary.fileSize = std::filesystem::file_size(tlwzPath);
@@ -508,147 +1160,282 @@ namespace TilelandWorld {
         std::string tlwzPath = getTlwzPath(saveName, directory);
         bool updated = false;
 
+        SaveSummary current{};
+        if (!readSaveSummary(saveName, directory, current)) {
+            LOG_ERROR("Cannot update metadata of '" + saveName + "': save summary unreadable.");
+            return false;
+        }
+        if (!sameGenerationParameters(current.metadata, metadata)) {
+            LOG_ERROR("Refusing to change terrain generation parameters of existing save '" + saveName + "'.");
+            return false;
+        }
+
         if (std::filesystem::exists(tlwfPath)) {
-            std::ifstream file(tlwfPath, std::ios::binary | std::ios::ate);
-            if (file) {
-                std::streamsize size = file.tellg();
-                file.seekg(0, std::ios::beg);
-                std::vector<uint8_t> buffer(static_cast<size_t>(size));
-                if (file.read(reinterpret_cast<char*>(buffer.data()), size)) {
-                    if (applyMetadataToBuffer(buffer, metadata) && writeBufferToFile(tlwfPath, buffer)) {
-                        updated = true;
-                        if (std::filesystem::exists(tlwzPath)) {
-                            recompressBufferToTlwz(buffer, tlwzPath);
-                        }
-                    }
+            if (updateTlwfMetadata(tlwfPath, metadata)) {
+                updated = true;
+                if (std::filesystem::exists(tlwzPath)) {
+                    updateTlwzMetadata(tlwzPath, metadata);
                 }
             }
         } else if (std::filesystem::exists(tlwzPath)) {
-            try {
-                BinaryReader reader(tlwzPath);
-                CompressedFileHeader header{};
-                if (!reader.read(header)) return false;
-                if (header.magicNumber != COMPRESSED_MAGIC_NUMBER || header.compressionType != COMPRESSION_TYPE_ZLIB) return false;
-
-                std::vector<Bytef> compressedData(static_cast<size_t>(header.compressedSize));
-                size_t bytesRead = reader.readBytes(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
-                if (bytesRead != header.compressedSize) return false;
-                if (calculateCRC32(compressedData.data(), compressedData.size()) != header.compressedChecksum) return false;
-
-                std::vector<Bytef> decompressed;
-                auto status = SimpZlib::uncompress(compressedData, decompressed, header.uncompressedSize);
-                if (status != SimpZlib::Status::OK || decompressed.size() != header.uncompressedSize) return false;
-                if (calculateCRC32(decompressed.data(), decompressed.size()) != header.uncompressedChecksum) return false;
-
-                std::vector<uint8_t> buffer(decompressed.begin(), decompressed.end());
-                if (!applyMetadataToBuffer(buffer, metadata)) return false;
-                updated = recompressBufferToTlwz(buffer, tlwzPath);
-            } catch (...) {
-                return false;
-            }
+            updated = updateTlwzMetadata(tlwzPath, metadata);
         }
 
         return updated;
     }
 
-    // --- saveCompressedMap Implementation (moved from MapPersistenceManager) ---
-    bool MapSerializer::saveCompressedMap(const Map& map, const std::string& saveName, const std::string& directory, bool deleteTlwfAfterwards) {
+    // --- saveCompressedMap Implementation ---
+    bool MapSerializer::saveCompressedMap(const Map& map, const std::string& saveName, const std::string& directory, bool deleteTlwfAfterwards,
+                                          TaskSystem* taskSystem, SaveStats* outStats) {
         std::string tlwfPath = getTlwfPath(saveName, directory);
         std::string tlwzPath = getTlwzPath(saveName, directory);
 
         LOG_INFO("Starting save compressed map process for '" + saveName + "'...");
 
-        // 1. Save uncompressed map to .tlwf
-        LOG_INFO("Saving uncompressed map to: " + tlwfPath);
-        if (!saveMap(map, tlwfPath)) {
-            LOG_ERROR("Failed to save uncompressed map to .tlwf file.");
-            return false;
-        }
-        LOG_INFO("Uncompressed map saved successfully.");
-
-        // 2. Read the entire .tlwf file
-        std::vector<Bytef> uncompressedData;
+        // 总是先写临时文件，落盘后再替换 (rename)：保存中途失败或进程退出时原存档保持完整。
+        // 目标正是地图按需读取的 .tlwz 时由 LazyChunkFile 完成替换并切换索引
+        LazyChunkFile* source = map.getSavedChunkSource();
+        std::error_code sameEc;
+        const bool replacingSource = source && std::filesystem::exists(tlwzPath) &&
+                                     std::filesystem::equivalent(source->getPath(), tlwzPath, sameEc);
+        const std::string writePath = tlwzPath + ".tmp";
+
+        // 1. 逐个区块压缩写出 .tlwz
+        LOG_INFO("Writing compressed chunks to: " + tlwzPath);
+        const auto startTime = std::chrono::steady_clock::now();
+        std::vector<CompressedChunkIndexEntry> index;
+        std::shared_ptr<const std::vector<uint8_t>> dictionary;
+        SaveStats stats{};
         try {
-            std::ifstream tlwfFile(tlwfPath, std::ios::binary | std::ios::ate);
-            if (!tlwfFile) {
-                throw std::runtime_error("Failed to open .tlwf file for reading.");
-            }
-            std::streamsize size = tlwfFile.tellg();
-            tlwfFile.seekg(0, std::ios::beg);
-            uncompressedData.resize(static_cast<size_t>(size)); // Resize vector
-            if (!tlwfFile.read(reinterpret_cast<char*>(uncompressedData.data()), size)) {
-                 throw std::runtime_error("Failed to read data from .tlwf file.");
-            }
-            LOG_INFO("Read " + std::to_string(uncompressedData.size()) + " bytes from " + tlwfPath);
-        } catch (const std::exception& e) {
-            LOG_ERROR("Error reading .tlwf file: " + std::string(e.what()));
-            return false;
-        }
-
-        if (uncompressedData.empty()) {
-             LOG_WARNING(".tlwf file is empty. Skipping compression.");
-             // Decide if an empty tlwz should be created or not. Let's skip for now.
-             // If deleteTlwfAfterwards is true, the empty tlwf might be deleted later.
-             return true; // Or false depending on desired behavior for empty maps
-        }
-
-        // 3. Calculate uncompressed checksum
-        uint32_t uncompressedChecksum = calculateCRC32(uncompressedData.data(), uncompressedData.size());
-        LOG_INFO("Calculated uncompressed CRC32: 0x" + std::to_string(uncompressedChecksum)); // Consider hex formatting
-
-        // 4. Compress data
-        std::vector<Bytef> compressedData;
-        LOG_INFO("Compressing data using SimpZlib...");
-        SimpZlib::Status compressStatus = SimpZlib::compress(uncompressedData, compressedData); // Use default level
-
-        if (compressStatus != SimpZlib::Status::OK) {
-            LOG_ERROR("Compression failed with status: " + std::to_string(static_cast<int>(compressStatus)));
-            return false;
-        }
-        LOG_INFO("Compression successful. Compressed size: " + std::to_string(compressedData.size()) + " bytes.");
-
-        // 5. Calculate compressed checksum (Optional but recommended)
-        uint32_t compressedChecksum = calculateCRC32(compressedData.data(), compressedData.size());
-        LOG_INFO("Calculated compressed CRC32: 0x" + std::to_string(compressedChecksum)); // Consider hex formatting
+            bool skipUntouched = false;
+            const std::unique_ptr<TerrainGenerator> base = createBaseGenerator(map, skipUntouched);
+            BinaryWriter writer(writePath);
 
-        // 6. Write .tlwz file
-        LOG_INFO("Writing compressed data to: " + tlwzPath);
-        try {
-            BinaryWriter writer(tlwzPath);
-
-            // Prepare header
-            CompressedFileHeader header = {};
+            CompressedFileHeaderV2 header{};
             header.magicNumber = COMPRESSED_MAGIC_NUMBER;
             header.versionMajor = COMPRESSED_FORMAT_VERSION_MAJOR;
             header.versionMinor = COMPRESSED_FORMAT_VERSION_MINOR;
             header.compressionType = COMPRESSION_TYPE_ZLIB;
-            header.uncompressedSize = uncompressedData.size();
-            header.uncompressedChecksum = uncompressedChecksum;
-            header.compressedSize = compressedData.size();
-            header.compressedChecksum = compressedChecksum; // Write the compressed checksum
-
-            // Write header
+            header.generatorVersion = base->getVersion();
+            header.recordVersionMinor = FORMAT_VERSION_MINOR;
             if (!writer.write(header)) {
                 throw std::runtime_error("Failed to write compressed file header.");
             }
+            // 元数据块紧跟文件头：读取概要与修改元数据都只涉及文件开头的定长部分
+            header.metadataOffset = writer.tell();
+            if (!writeMetadataBlock(writer, map.getWorldMetadata())) {
+                throw std::runtime_error("Failed to write metadata block.");
+            }
 
-            // Write compressed data
-            if (!writer.writeBytes(reinterpret_cast<const char*>(compressedData.data()), compressedData.size())) {
-                 throw std::runtime_error("Failed to write compressed data.");
+            // 预设字典：原样复制源 .tlwz 的压缩记录时沿用源文件的字典 (复制的记录依赖它)，
+            // 源文件没有字典时在第一批写出前由该批记录构建 (复制来的无字典记录不受影响)。字典写在元数据块之后、第一个区块记录之前
+            const bool sameFormat = source && source->getVersionMinor() == FORMAT_VERSION_MINOR;
+            const bool copyCompressed = sameFormat && source->isCompressed();
+            if (copyCompressed) dictionary = source->getCompressionDictionary();
+            bool dictionaryWritten = false;
+            auto writeDictionary = [&](const std::vector<PendingRecord>& firstBatch, size_t count) {
+                if (!dictionary) {
+                    std::vector<std::vector<uint8_t>> samples;
+                    for (size_t i = 0; i < count; ++i) {
+                        if (!firstBatch[i].precompressed) samples.push_back(firstBatch[i].record);
+                    }
+                    std::vector<uint8_t> built = CompressionDictionary::build(samples);
+                    if (!built.empty()) dictionary = std::make_shared<const std::vector<uint8_t>>(std::move(built));
+                }
+                CompressionDictionaryHeader dictHeader{};
+                if (dictionary) {
+                    dictHeader.size = static_cast<uint32_t>(dictionary->size());
+                    dictHeader.checksum = calculateCRC32(dictionary->data(), dictionary->size());
+                }
+                if (!writer.write(dictHeader)
+                    || (dictionary && !writer.writeBytes(reinterpret_cast<const char*>(dictionary->data()), dictionary->size()))) {
+                    return false;
+                }
+                header.dataOffset = writer.tell();
+                dictionaryWritten = true;
+                return true;
+            };
+
+            // 区块在当前线程上编码/读取后进入批次，批满时先去重，再在工作线程上并行压缩，最后按进入顺序写出
+            std::vector<PendingRecord> batch(PARALLEL_CHUNK_BATCH);
+            size_t pendingCount = 0;
+            RecordDeduplicator deduplicator;
+            auto flushBatch = [&]() {
+                if (!dictionaryWritten && !writeDictionary(batch, pendingCount)) return false;
+                for (size_t i = 0; i < pendingCount; ++i) {
+                    PendingRecord& pending = batch[i];
+                    const size_t position = index.size() + i;
+                    if (pending.precompressed) {
+                        pending.sharedWith = deduplicator.findOrAddCopied(pending.entry.offset, position);
+                        continue;
+                    }
+                    if (!pending.hasRecordChecksum) {
+                        pending.entry.uncompressedChecksum = calculateCRC32(pending.record.data(), pending.record.size());
+                        pending.hasRecordChecksum = true;
+                    }
+                    pending.sharedWith = deduplicator.findOrAdd(pending.record, pending.entry.uncompressedChecksum, position);
+                }
+                const std::vector<uint8_t>* dict = dictionary.get();
+                runParallel(taskSystem, pendingCount, [&batch, dict](size_t i) { compressPendingRecord(batch[i], dict); });
+                for (size_t i = 0; i < pendingCount; ++i) {
+                    PendingRecord& pending = batch[i];
+                    const CompressedChunkIndexEntry& e = pending.entry;
+                    if (!pending.ok) {
+                        LOG_ERROR("Failed to compress chunk (" + std::to_string(e.cx) + "," + std::to_string(e.cy) + "," + std::to_string(e.cz) + ").");
+                        return false;
+                    }
+                    if (pending.sharedWith != NO_SHARED_RECORD) {
+                        const CompressedChunkIndexEntry first = index[pending.sharedWith];
+                        pending.entry.offset = first.offset;
+                        pending.entry.compressedSize = first.compressedSize;
+                        pending.entry.compressedChecksum = first.compressedChecksum;
+                        pending.entry.uncompressedSize = first.uncompressedSize;
+                        pending.entry.uncompressedChecksum = first.uncompressedChecksum;
+                        ++stats.sharedChunks;
+                    } else {
+                        pending.entry.offset = writer.tell();
+                        if (!writer.writeBytes(reinterpret_cast<const char*>(pending.compressed.data()), pending.compressed.size())) {
+                            return false;
+                        }
+                    }
+                    stats.uncompressedBytes += pending.entry.uncompressedSize;
+                    index.push_back(pending.entry);
+                }
+                pendingCount = 0;
+
+                // 批次缓冲区在批之间复用，容量即为保存过程的主要内存占用
+                size_t bufferBytes = index.capacity() * sizeof(CompressedChunkIndexEntry) + deduplicator.memoryUsage();
+                for (const PendingRecord& pending : batch) {
+                    bufferBytes += pending.record.capacity() + pending.compressed.capacity();
+                }
+                stats.peakBufferBytes = std::max(stats.peakBufferBytes, bufferBytes);
+                return true;
+            };
+            auto nextSlot = [&](const ChunkCoord& coord) -> PendingRecord& {
+                PendingRecord& pending = batch[pendingCount++];
+                pending.entry = {};
+                pending.entry.cx = coord.cx;
+                pending.entry.cy = coord.cy;
+                pending.entry.cz = coord.cz;
+                pending.hasRecordChecksum = false;
+                pending.precompressed = false;
+                pending.ok = false;
+                return pending;
+            };
+            auto afterEnqueue = [&]() {
+                return pendingCount < batch.size() || flushBatch();
+            };
+
+            auto writeChunk = [&](const Chunk& chunk) {
+                PendingRecord& pending = nextSlot(ChunkCoord{chunk.getChunkX(), chunk.getChunkY(), chunk.getChunkZ()});
+                encodeChunkRecord(chunk, pending.record, base.get());
+                return afterEnqueue();
+            };
+
+            // 从未加载过的已保存区块：源为同格式 .tlwz 时原样复制压缩记录，源为 .tlwf 时只需压缩
+            auto copySaved = [&](const ChunkCoord& coord) {
+                if (!sameFormat) {
+                    std::unique_ptr<Chunk> saved = source->loadChunk(coord);
+                    if (!saved) {
+                        LOG_ERROR("Failed to read saved chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ").");
+                        return false;
+                    }
+                    return writeChunk(*saved);
+                }
+
+                PendingRecord& pending = nextSlot(coord);
+                bool read = false;
+                if (copyCompressed) {
+                    read = source->readCompressedRecord(coord, pending.compressed, pending.entry);
+                    pending.precompressed = true;
+                } else {
+                    ChunkIndexEntry rawEntry{};
+                    read = source->readRecord(coord, pending.record, rawEntry);
+                    pending.entry.uncompressedChecksum = rawEntry.checksum;
+                    pending.hasRecordChecksum = true;
+                }
+                if (!read) {
+                    LOG_ERROR("Failed to copy saved chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ").");
+                    return false;
+                }
+                return afterEnqueue();
+            };
+
+            if (!forEachChunkToSave(map, nullptr, skipUntouched, writeChunk, copySaved) || !flushBatch()) {
+                throw std::runtime_error("Failed to write chunk records.");
             }
 
-            LOG_INFO("Compressed save file (.tlwz) written successfully.");
+            // 2. 未压缩的索引 (元数据块已写在文件开头)
+            header.chunkCount = index.size();
+            header.indexOffset = writer.tell();
+            std::vector<uint8_t> indexBytes(sizeof(uint64_t) + index.size() * sizeof(CompressedChunkIndexEntry));
+            uint64_t count = index.size();
+            std::memcpy(indexBytes.data(), &count, sizeof(count));
+            if (!index.empty()) {
+                std::memcpy(indexBytes.data() + sizeof(count), index.data(), index.size() * sizeof(CompressedChunkIndexEntry));
+            }
+            header.indexChecksum = calculateCRC32(indexBytes.data(), indexBytes.size());
+            if (!writer.writeBytes(reinterpret_cast<const char*>(indexBytes.data()), indexBytes.size())) {
+                throw std::runtime_error("Failed to write compressed chunk index.");
+            }
 
+            header.headerChecksum = compressedHeaderChecksum(header);
+            if (!writer.seek(0) || !writer.write(header)) {
+                throw std::runtime_error("Failed to write final compressed file header.");
+            }
         } catch (const std::exception& e) {
             LOG_ERROR("Error writing .tlwz file: " + std::string(e.what()));
             // Attempt to clean up potentially incomplete .tlwz file
-            try { std::filesystem::remove(tlwzPath); } catch(...) {}
+            try { std::filesystem::remove(writePath); } catch(...) {}
             return false;
         }
 
-        // 7. (Optional) Delete .tlwf file
-        if (deleteTlwfAfterwards) {
-            LOG_INFO("Deleting temporary .tlwf file: " + tlwfPath);
+        if (!BinaryWriter::syncToDisk(writePath)) {
+            try { std::filesystem::remove(writePath); } catch(...) {}
+            return false;
+        }
+        if (replacingSource) {
+            if (!source->replaceFile(writePath, FORMAT_VERSION_MINOR, index, dictionary)) {
+                std::error_code removeEc;
+                std::filesystem::remove(writePath, removeEc); // 替换失败时临时文件仍在原处
+                return false;
+            }
+        } else {
+            std::error_code renameEc;
+            std::filesystem::rename(writePath, tlwzPath, renameEc);
+            if (renameEc) {
+                LOG_ERROR("Failed to replace " + tlwzPath + ": " + renameEc.message());
+                std::filesystem::remove(writePath, renameEc);
+                return false;
+            }
+        }
+        stats.chunkCount = index.size();
+        stats.fileBytes = std::filesystem::file_size(tlwzPath);
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::ostringstream statsLine;
+        statsLine << "Compressed save file (.tlwz) written successfully. Chunks: " << stats.chunkCount
+                  << " (" << stats.sharedChunks << " shared)"
+                  << ", chunk bytes: " << stats.uncompressedBytes << " -> file bytes: " << stats.fileBytes
+                  << ", peak buffer: " << stats.peakBufferBytes / 1024 << " KiB"
+                  << ", " << std::fixed << std::setprecision(1) << stats.throughputMBps() << " MiB/s";
+        LOG_INFO(statsLine.str());
+        if (outStats) *outStats = stats;
+
+        // 3. .tlwf：loadMapFromSave 优先读取 .tlwf，保留它时必须同步写出，否则删除旧文件
+        // 地图仍从该 .tlwf 按需读取区块时同样保留它
+        const bool tlwfIsSource = source && !source->isCompressed() && std::filesystem::exists(tlwfPath) &&
+                                  std::filesystem::equivalent(source->getPath(), tlwfPath, sameEc);
+        if (!deleteTlwfAfterwards || tlwfIsSource) {
+            if (deleteTlwfAfterwards) {
+                LOG_INFO("Keeping .tlwf file: the map still loads chunks from it on demand.");
+            }
+            LOG_INFO("Saving uncompressed map to: " + tlwfPath);
+            if (!saveMap(map, tlwfPath)) {
+                LOG_ERROR("Failed to save uncompressed map to .tlwf file.");
+                return false;
+            }
+        } else if (std::filesystem::exists(tlwfPath)) {
+            LOG_INFO("Deleting stale .tlwf file: " + tlwfPath);
             try {
                 if (!std::filesystem::remove(tlwfPath)) {
                     LOG_WARNING("Failed to delete .tlwf file (it might not exist or is locked).");
@@ -663,7 +1450,7 @@ namespace TilelandWorld {
     }
 
     // --- loadMapFromSave Implementation (moved from MapPersistenceManager) ---
-    std::unique_ptr<Map> MapSerializer::loadMapFromSave(const std::string& saveName, const std::string& directory) {
+    std::unique_ptr<Map> MapSerializer::loadMapFromSave(const std::string& saveName, const std::string& directory, bool lazy, TaskSystem* taskSystem) {
         std::string tlwfPath = getTlwfPath(saveName, directory);
         std::string tlwzPath = getTlwzPath(saveName, directory);
 
@@ -673,7 +1460,7 @@ namespace TilelandWorld {
         if (std::filesystem::exists(tlwfPath)) {
             LOG_INFO("Found .tlwf file: " + tlwfPath + ". Attempting direct load...");
             try {
-                std::unique_ptr<Map> map = loadMap(tlwfPath);
+                std::unique_ptr<Map> map = loadMap(tlwfPath, lazy, taskSystem);
                 if (map) {
                     LOG_INFO("Successfully loaded map directly from .tlwf file.");
                     return map;
@@ -693,7 +1480,7 @@ namespace TilelandWorld {
         if (std::filesystem::exists(tlwzPath)) {
              LOG_INFO("Found .tlwz file: " + tlwzPath + ". Attempting to load and decompress...");
              try {
-                 return loadFromCompressedFile(tlwzPath, tlwfPath);
+                 return loadFromCompressedFile(tlwzPath, tlwfPath, lazy, taskSystem);
              } catch (const std::exception& e) {
                  LOG_ERROR("Failed to load from .tlwz file: " + std::string(e.what()));
                  return nullptr; // Loading from .tlwz failed
@@ -704,8 +1491,74 @@ namespace TilelandWorld {
         }
     }
 
-    // --- loadFromCompressedFile Helper (moved from MapPersistenceManager) ---
-    std::unique_ptr<Map> MapSerializer::loadFromCompressedFile(const std::string& tlwzPath, const std::string& tlwfPath) {
+    // --- loadFromCompressedFile Helper ---
+    std::unique_ptr<Map> MapSerializer::loadFromCompressedFile(const std::string& tlwzPath, const std::string& tlwfPath, bool lazy, TaskSystem* taskSystem) {
+        uint16_t versionMinor = 0;
+        try {
+            BinaryReader reader(tlwzPath);
+            versionMinor = peekCompressedVersion(reader);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error reading .tlwz file: " + std::string(e.what()));
+            return nullptr;
+        }
+
+        if (versionMinor >= COMPRESSED_FORMAT_VERSION_MINOR_CHUNKED) {
+            return loadFromChunkedCompressedFile(tlwzPath, lazy, taskSystem);
+        }
+        LOG_INFO("Compressed save uses the whole-file layout (0." + std::to_string(versionMinor) + "). Extracting to .tlwf...");
+        return loadFromWholeFileCompressed(tlwzPath, tlwfPath, lazy, taskSystem);
+    }
+
+    // 0.2：只读取文件头、索引与元数据；区块按需从 .tlwz 中读取并解压，不生成 .tlwf
+    std::unique_ptr<Map> MapSerializer::loadFromChunkedCompressedFile(const std::string& tlwzPath, bool lazy, TaskSystem* taskSystem) {
+        try {
+            BinaryReader reader(tlwzPath);
+            CompressedFileHeaderV2 header{};
+            readCompressedHeaderV2(reader, header);
+            if (header.recordVersionMinor > FORMAT_VERSION_MINOR) {
+                throw std::runtime_error("Unsupported chunk record version " + std::to_string(header.recordVersionMinor) + ".");
+            }
+
+            std::vector<CompressedChunkIndexEntry> index;
+            readCompressedIndex(reader, header, index);
+
+            WorldMetadata worldMeta{};
+            if (!reader.seek(static_cast<std::streamoff>(header.metadataOffset))) {
+                throw std::runtime_error("Failed to seek to metadata offset.");
+            }
+            readMetadataBlock(reader, worldMeta);
+
+            std::shared_ptr<const TerrainGenerator> base = createTerrainGeneratorFromMetadata(worldMeta);
+            checkGeneratorVersion(header.generatorVersion, *base, tlwzPath);
+
+            auto map = std::make_unique<Map>();
+            map->setWorldMetadata(worldMeta);
+            map->setTerrainGenerator(createTerrainGeneratorFromMetadata(worldMeta));
+
+            auto source = std::make_shared<LazyChunkFile>(tlwzPath, header.recordVersionMinor, index);
+            source->setBaseGenerator(base);
+            source->setCompressionDictionary(readCompressionDictionary(reader, header));
+            if (lazy) {
+                map->setSavedChunkSource(std::move(source));
+                std::cout << "Map opened successfully. Saved chunk count: " << index.size() << std::endl;
+                return map;
+            }
+
+            std::vector<ChunkCoord> coords;
+            coords.reserve(index.size());
+            for (const auto& entry : index) coords.push_back(ChunkCoord{entry.cx, entry.cy, entry.cz});
+            loadAllChunks(*map, *source, coords, taskSystem);
+
+            std::cout << "Map loaded successfully. Loaded chunk count: " << index.size() << std::endl;
+            return map;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to load compressed map from " + tlwzPath + ": " + e.what());
+            return nullptr;
+        }
+    }
+
+    // 0.1：整个 .tlwf 被压缩为一个 zlib 流，解压写回 .tlwf 后再加载
+    std::unique_ptr<Map> MapSerializer::loadFromWholeFileCompressed(const std::string& tlwzPath, const std::string& tlwfPath, bool lazy, TaskSystem* taskSystem) {
         std::vector<Bytef> compressedData;
         std::vector<Bytef> decompressedData;
         CompressedFileHeader header = {};
@@ -721,7 +1574,7 @@ namespace TilelandWorld {
             if (header.magicNumber != COMPRESSED_MAGIC_NUMBER) {
                 throw std::runtime_error("Invalid magic number in compressed file.");
             }
-            if (header.versionMajor != COMPRESSED_FORMAT_VERSION_MAJOR || header.versionMinor > COMPRESSED_FORMAT_VERSION_MINOR) {
+            if (header.versionMajor != COMPRESSED_FORMAT_VERSION_MAJOR || header.versionMinor > COMPRESSED_FORMAT_VERSION_MINOR_WHOLE_FILE) {
                  throw std::runtime_error("Unsupported compressed file version.");
             }
             if (header.compressionType != COMPRESSION_TYPE_ZLIB) {
@@ -794,7 +1647,7 @@ namespace TilelandWorld {
         // 6. Load map from the newly created .tlwf
         LOG_INFO("Attempting to load map from the generated .tlwf file...");
         try {
-             std::unique_ptr<Map> map = loadMap(tlwfPath);
+             std::unique_ptr<Map> map = loadMap(tlwfPath, lazy, taskSystem);
              if (map) {
                  LOG_INFO("Successfully loaded map from decompressed .tlwf file.");
                  return map;
@@ -6,12 +6,15 @@
 #include "BinaryWriter.h"
 #include "BinaryReader.h"
 #include "FileFormat.h"
+#include "CompressedFileFormat.h"
 #include "Checksum.h"
 #include "SaveMetadata.h"
+#include "../Utils/TaskSystem.h"
 #include <string>
 #include <vector>
 #include <memory> // For std::unique_ptr
 #include <unordered_set> // For std::unordered_set
+#include <functional>
 
 namespace TilelandWorld {
 
@@ -25,10 +28,14 @@ namespace TilelandWorld {
         int32_t octaves;
         float lacunarity;
         float gain;
-        uint8_t reserved[32]{}; // 预留空间
+        int32_t latticeSpacing; // 取自原预留区，旧存档为 0，按 1 处理
+        uint8_t reserved[28]{}; // 预留空间
     };
 
+    class SaveJournal;
+
     class MapSerializer {
+        friend class SaveJournal; // 复用文件头、索引与元数据块的读写
     public:
         struct SaveSummary {
             bool compressed{false};
@@ -38,45 +45,107 @@ namespace TilelandWorld {
             WorldMetadata metadata{};
         };
 
+        // saveCompressedMap 写出 .tlwz 的统计信息
+        struct SaveStats {
+            size_t chunkCount{0};
+            size_t sharedChunks{0};         // 记录与先前区块相同、索引指向同一份压缩数据的区块数
+            uint64_t uncompressedBytes{0};  // 区块记录压缩前大小合计
+            uint64_t fileBytes{0};          // 写出的 .tlwz 文件大小
+            size_t peakBufferBytes{0};      // 保存过程中批次缓冲区、索引与去重缓存占用的内存峰值 (与地图大小基本无关)
+            double seconds{0.0};            // 写出 .tlwz 所用时间 (不含同时写出的 .tlwf)
+
+            double throughputMBps() const { return seconds > 0.0 ? uncompressedBytes / (1024.0 * 1024.0) / seconds : 0.0; }
+        };
+
         // 保存地图数据到文件
         // modifiedChunks: 可选参数。如果提供，则只保存集合中存在的区块 (用于增量保存或只保存修改过的部分)。
         static bool saveMap(const Map& map, const std::string& filepath, const std::unordered_set<ChunkCoord, ChunkCoordHash>* modifiedChunks = nullptr);
 
         // 从文件加载地图数据
         // 返回 unique_ptr<Map>，如果加载失败则返回 nullptr
-        static std::unique_ptr<Map> loadMap(const std::string& filepath);
-
-        // 保存压缩地图数据到 .tlwz 文件
-        static bool saveCompressedMap(const Map& map, const std::string& saveName, const std::string& directory = ".", bool deleteTlwfAfterwards = true);
+        // lazy 为 true 时只读取文件头、索引与元数据并保持文件打开，区块在首次访问时才读取 (见 LazyChunkFile)；
+        // 为 false 时立即读取并校验全部区块 (查看器等需要遍历全部区块的工具使用)。
+        // taskSystem 非空时立即加载的区块在其工作线程上分批并行校验与解码 (不要在该任务系统的工作线程上调用)。
+        static std::unique_ptr<Map> loadMap(const std::string& filepath, bool lazy = true, TaskSystem* taskSystem = nullptr);
+
+        // 保存压缩地图数据到 .tlwz 文件 (0.2 格式：每个区块单独压缩，索引与元数据不压缩)
+        // deleteTlwfAfterwards 为 false 时同时写出对应的 .tlwf。
+        // 区块逐个编码、压缩并直接流式写出，不经过中间 .tlwf，内存占用以固定大小的批次为上限。
+        // taskSystem 非空时区块记录分批在其工作线程上并行压缩与计算校验和，按固定顺序写出，文件内容与线程数无关。
+        // outStats 非空时填写统计信息 (同时写入日志)。
+        static bool saveCompressedMap(const Map& map, const std::string& saveName, const std::string& directory = ".", bool deleteTlwfAfterwards = true,
+                                      TaskSystem* taskSystem = nullptr, SaveStats* outStats = nullptr);
+
+        /**
+         * @brief 创建供后台保存使用的地图快照，开销为 O(已加载区块数)。调用方需持有保护地图的锁 (例如 mapMutex)。
+         * @details 每个已加载区块复制一份：调色板与覆盖表很小，索引数组以写时复制共享，之后对原地图的修改会先复制出独占的数组，
+         *          不影响快照。后备存储与存档源与原地图共享 (二者线程安全)；快照之后才被卸载的区块仍以快照中的内容保存，
+         *          快照时已在后备存储中的区块在保存时读取，可能包含之后的修改。快照只用于保存，不生成区块。
+         */
+        static std::unique_ptr<Map> createSaveSnapshot(const Map& map);
 
         // 从存档加载地图（自动处理 .tlwf 或 .tlwz）
-        static std::unique_ptr<Map> loadMapFromSave(const std::string& saveName, const std::string& directory = ".");
+        static std::unique_ptr<Map> loadMapFromSave(const std::string& saveName, const std::string& directory = ".", bool lazy = true,
+                                                    TaskSystem* taskSystem = nullptr);
 
-        // 仅读取元数据与概要信息，不加载区块
+        // 仅读取元数据与概要信息，不加载区块 (0.2 版 .tlwz 无需解压)
         static bool readSaveSummary(const std::string& saveName, const std::string& directory, SaveSummary& outSummary);
 
-        // 更新存档中的元数据（tlwf 或 tlwz 文件）
+        // 更新存档中的元数据（tlwf 或 tlwz 文件）。
+        // 生成参数与存档中的不同时拒绝 (返回 false)：已保存的区块以原参数的生成结果为基准，更改会静默改变世界
         static bool updateMetadata(const std::string& saveName, const std::string& directory, const WorldMetadata& metadata);
 
         // 获取 .tlwf 和 .tlwz 的完整路径
         static std::string getTlwfPath(const std::string& saveName, const std::string& directory);
         static std::string getTlwzPath(const std::string& saveName, const std::string& directory);
 
+        // 单个区块记录的编码/解码 (与 .tlwf 中的区块数据格式相同，不含校验和)，供后备存储等复用。
+        // base 非空且差异记录更小时，只保存与 base 生成结果不同的 Tile (CHUNK_RECORD_DELTA)。
+        static void encodeChunkRecord(const Chunk& chunk, std::vector<uint8_t>& out, const TerrainGenerator* base = nullptr);
+        // 数据格式错误、或差异记录缺少 base 时抛出 std::runtime_error。
+        static void decodeChunkRecord(const uint8_t* data, size_t size, Chunk& chunk, uint16_t versionMinor = FORMAT_VERSION_MINOR,
+                                      const TerrainGenerator* base = nullptr);
+
     private:
         // 内部辅助函数
         static bool writeHeader(BinaryWriter& writer, FileHeader& header);
         static void readAndValidateHeader(BinaryReader& reader, FileHeader& header);
 
-        // 实现区块数据的序列化和反序列化
-        static bool saveChunkData(BinaryWriter& writer, const Chunk& chunk, uint32_t& outChecksum);
-        static void loadChunkData(BinaryReader& reader, Chunk& chunk, uint32_t expectedSize, uint32_t expectedChecksum);
+        // 实现区块数据的序列化
+        static bool saveChunkData(BinaryWriter& writer, const Chunk& chunk, const TerrainGenerator* base, uint32_t& outChecksum);
+        // 从存档源读取全部 coords 中的区块放入地图；taskSystem 非空时分批并行。任一区块失败时抛出 std::runtime_error。
+        static void loadAllChunks(Map& map, LazyChunkFile& source, const std::vector<ChunkCoord>& coords, TaskSystem* taskSystem);
 
         // 实现索引的写入和读取
         static bool writeIndex(BinaryWriter& writer, const std::vector<ChunkIndexEntry>& index);
         static void readIndex(BinaryReader& reader, std::vector<ChunkIndexEntry>& index);
 
-        // 压缩加载辅助函数
-        static std::unique_ptr<Map> loadFromCompressedFile(const std::string& tlwzPath, const std::string& tlwfPath);
+        // 元数据块的写入和读取 (.tlwf 与 0.2 版 .tlwz 共用同一布局)
+        static bool writeMetadataBlock(BinaryWriter& writer, const WorldMetadata& meta);
+        static void readMetadataBlock(BinaryReader& reader, WorldMetadata& meta);
+
+        /**
+         * @brief 加载时用于重新生成区块的生成器 (由元数据创建)，保存时以它为差异编码的基准。
+         * @param outSkipUntouched 地图当前的生成器与之生成相同地形时为 true，此时未修改的区块无需保存。
+         */
+        static std::unique_ptr<TerrainGenerator> createBaseGenerator(const Map& map, bool& outSkipUntouched);
+        // 存档记录的生成器版本与当前版本不同时抛出 std::runtime_error (0 表示未记录，不检查)。
+        static void checkGeneratorVersion(uint8_t recordedVersion, const TerrainGenerator& generator, const std::string& path);
+
+        /**
+         * @brief 按保存顺序枚举需要写出的区块：内存中的、已卸载到后备存储的、从未加载过的已保存区块。
+         * @details 前两类以解码后的区块交给 onChunk；第三类只给出坐标，由 onSaved 从 Map 的存档源原样复制或重新编码。
+         *          skipUntouched 为 true 时跳过从未修改过的生成区块 (干净、且不在后备存储与存档源中)，加载时直接重新生成。
+         *          modifiedChunks 非空时只枚举其中的区块。任一回调返回 false 即中止并返回 false。
+         */
+        static bool forEachChunkToSave(const Map& map, const std::unordered_set<ChunkCoord, ChunkCoordHash>* modifiedChunks, bool skipUntouched,
+                                       const std::function<bool(const Chunk&)>& onChunk,
+                                       const std::function<bool(const ChunkCoord&)>& onSaved);
+
+        // 压缩加载辅助函数：0.2 版直接按需读取 .tlwz；0.1 版先解压为 .tlwf 再加载
+        static std::unique_ptr<Map> loadFromCompressedFile(const std::string& tlwzPath, const std::string& tlwfPath, bool lazy, TaskSystem* taskSystem);
+        static std::unique_ptr<Map> loadFromChunkedCompressedFile(const std::string& tlwzPath, bool lazy, TaskSystem* taskSystem);
+        static std::unique_ptr<Map> loadFromWholeFileCompressed(const std::string& tlwzPath, const std::string& tlwfPath, bool lazy, TaskSystem* taskSystem);
     };
 
 } // namespace TilelandWorld
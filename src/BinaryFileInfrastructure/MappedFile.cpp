@@ -0,0 +1,90 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace TilelandWorld {
+
+#ifdef _WIN32
+
+    MappedFile::MappedFile(const std::string& filepath) {
+        // FILE_SHARE_DELETE：允许在映射期间用 rename 替换存档 (保存时先写临时文件)
+        // FILE_SHARE_WRITE：允许 SaveJournal 在映射期间向存档末尾追加记录 (已映射的区域不会被改写)
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("MappedFile: Failed to open file: " + filepath);
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: Failed to query file size: " + filepath);
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        fileHandle = file;
+        if (length == 0) return; // 空文件无法创建映射
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: Failed to create file mapping: " + filepath);
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: Failed to map view of file: " + filepath);
+        }
+        mappingHandle = mapping;
+        base = static_cast<const uint8_t*>(view);
+    }
+
+    MappedFile::~MappedFile() {
+        if (base) UnmapViewOfFile(base);
+        if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+        if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+
+#else
+
+    MappedFile::MappedFile(const std::string& filepath) {
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedFile: Failed to open file: " + filepath);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: Failed to query file size: " + filepath);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("MappedFile: Failed to map file: " + filepath);
+            }
+            base = static_cast<const uint8_t*>(view);
+        }
+        ::close(fd); // 映射建立后不再需要文件描述符
+    }
+
+    MappedFile::~MappedFile() {
+        if (base) ::munmap(const_cast<uint8_t*>(base), length);
+    }
+
+#endif
+
+} // namespace TilelandWorld
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef TILELANDWORLD_MAPPEDFILE_H
+#define TILELANDWORLD_MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 只读内存映射文件 (Linux 上为 mmap，Windows 上为 MapViewOfFile)。
+     *
+     * 整个文件映射为一段连续的只读内存，读取时不经过流缓冲与系统调用；
+     * span/readAt 均做边界检查，越界时返回 nullptr/false 而不是访问映射之外的内存。
+     * 映射期间文件不应被截断或改写 (保存流程总是写临时文件再替换)。
+     */
+    class MappedFile {
+    public:
+        // 打开或映射失败时抛出 std::runtime_error。空文件可以映射，size() 为 0。
+        explicit MappedFile(const std::string& filepath);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return base; }
+        size_t size() const { return length; }
+
+        // 返回 [offset, offset + count) 的零拷贝视图；越界返回 nullptr
+        const uint8_t* span(uint64_t offset, size_t count) const {
+            if (offset > length || count > length - offset) return nullptr;
+            return base + offset;
+        }
+
+        // 按值读取 offset 处的 T (不要求对齐)
+        template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+        bool readAt(uint64_t offset, T& out) const {
+            const uint8_t* p = span(offset, sizeof(T));
+            if (!p) return false;
+            std::memcpy(&out, p, sizeof(T));
+            return true;
+        }
+
+    private:
+        const uint8_t* base = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;     // HANDLE
+        void* mappingHandle = nullptr;  // HANDLE
+#endif
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_MAPPEDFILE_H
@@ -0,0 +1,305 @@
+#include "SaveJournal.h"
+#include "MapSerializer.h"
+#include "LazyChunkFile.h"
+#include "MappedFile.h"
+#include "Checksum.h"
+#include "../Map.h"
+#include "../Utils/Logger.h"
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+namespace TilelandWorld {
+
+    namespace {
+        std::string coordString(const ChunkCoord& coord) {
+            return "(" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ")";
+        }
+
+        std::vector<ChunkIndexEntry> toIndexVector(const std::unordered_map<ChunkCoord, ChunkIndexEntry, ChunkCoordHash>& index) {
+            std::vector<ChunkIndexEntry> entries;
+            entries.reserve(index.size());
+            for (const auto& pair : index) entries.push_back(pair.second);
+            return entries;
+        }
+
+        // 从映射中原样复制一条区块记录，复制前校验 CRC，避免把损坏的数据带进新文件
+        bool copyRecord(const MappedFile& file, const ChunkCoord& coord, ChunkIndexEntry& entry, BinaryWriter& writer) {
+            const uint8_t* record = file.span(entry.offset, entry.size);
+            if (!record || calculateCRC32(record, entry.size) != entry.checksum) {
+                LOG_ERROR("SaveJournal: Invalid record for chunk " + coordString(coord) + ", compaction aborted.");
+                return false;
+            }
+            entry.offset = static_cast<uint64_t>(writer.tell());
+            return writer.writeBytes(reinterpret_cast<const char*>(record), entry.size);
+        }
+    }
+
+    SaveJournal::SaveJournal(const std::string& tlwfPath, double threshold)
+        : filepath(tlwfPath), compactionThreshold(threshold) {
+        BinaryReader reader(filepath);
+        MapSerializer::readAndValidateHeader(reader, header);
+        if (header.versionMinor != FORMAT_VERSION_MINOR) {
+            throw std::runtime_error("SaveJournal: " + filepath + " uses record format 0." + std::to_string(header.versionMinor)
+                                     + "; rewrite it with saveMap before journaling.");
+        }
+        if (header.indexOffset == 0 || header.metadataOffset == 0 || !reader.seek(header.indexOffset)) {
+            throw std::runtime_error("SaveJournal: Missing index or metadata block in " + filepath);
+        }
+
+        std::vector<ChunkIndexEntry> entries;
+        MapSerializer::readIndex(reader, entries);
+        fileEnd = header.metadataOffset + sizeof(MetadataBlock);
+        if (fileEnd > static_cast<uint64_t>(reader.fileSize())) {
+            throw std::runtime_error("SaveJournal: Truncated metadata block in " + filepath);
+        }
+
+        index.reserve(entries.size());
+        for (const auto& entry : entries) {
+            index[ChunkCoord{entry.cx, entry.cy, entry.cz}] = entry;
+            liveRecordBytes += entry.size;
+        }
+        LOG_INFO("SaveJournal opened " + filepath + " (" + std::to_string(index.size()) + " chunks, "
+                 + std::to_string(fileEnd) + " bytes).");
+    }
+
+    SaveJournal::~SaveJournal() {
+        if (pendingCompaction.valid()) pendingCompaction.wait();
+    }
+
+    uint64_t SaveJournal::trailerBytes(size_t chunkCount) {
+        return sizeof(size_t) + chunkCount * sizeof(ChunkIndexEntry) + sizeof(MetadataBlock);
+    }
+
+    uint64_t SaveJournal::liveBytesLocked() const {
+        return sizeof(FileHeader) + liveRecordBytes + trailerBytes(index.size());
+    }
+
+    bool SaveJournal::append(const Map& map, const std::unordered_set<ChunkCoord, ChunkCoordHash>& modifiedChunks) {
+        if (modifiedChunks.empty()) return true;
+
+        // 与 saveMap 相同，以加载时会使用的生成器为基准差异编码；它与文件头记录的版本不一致时不能混写
+        bool skipUntouched = false;
+        const std::unique_ptr<TerrainGenerator> base = MapSerializer::createBaseGenerator(map, skipUntouched);
+        {
+            std::lock_guard<std::mutex> lock(journalMutex);
+            if (header.generatorVersion != base->getVersion()) {
+                LOG_ERROR("SaveJournal: " + filepath + " was written with terrain generator version "
+                          + std::to_string(header.generatorVersion) + ", current " + std::to_string(base->getVersion()) + ".");
+                return false;
+            }
+        }
+
+        // 编码在锁外完成；只在存档源中的区块 (未被修改过) 无需重写
+        struct Pending {
+            ChunkIndexEntry entry;
+            std::vector<uint8_t> record;
+        };
+        std::vector<Pending> pending;
+        pending.reserve(modifiedChunks.size());
+        bool collected = MapSerializer::forEachChunkToSave(map, &modifiedChunks, skipUntouched,
+            [&pending, &base](const Chunk& chunk) {
+                Pending item{};
+                item.entry.cx = chunk.getChunkX();
+                item.entry.cy = chunk.getChunkY();
+                item.entry.cz = chunk.getChunkZ();
+                MapSerializer::encodeChunkRecord(chunk, item.record, base.get());
+                item.entry.size = static_cast<uint32_t>(item.record.size());
+                item.entry.checksum = calculateCRC32(item.record.data(), item.record.size());
+                pending.push_back(std::move(item));
+                return true;
+            },
+            [](const ChunkCoord&) { return true; });
+        if (!collected) {
+            LOG_ERROR("SaveJournal: Failed to collect modified chunks for " + filepath);
+            return false;
+        }
+
+        LazyChunkFile* mapSource = map.getSavedChunkSource();
+        std::error_code sameEc;
+        const bool isSource = mapSource && std::filesystem::equivalent(mapSource->getPath(), filepath, sameEc);
+
+        std::lock_guard<std::mutex> lock(journalMutex);
+        if (isSource) source = mapSource;
+
+        IndexMap newIndex = index;
+        uint64_t newLiveRecordBytes = liveRecordBytes;
+        FileHeader newHeader = header;
+        uint64_t newEnd = 0;
+        try {
+            BinaryWriter writer(filepath, false);
+            if (!writer.seek(static_cast<std::streamoff>(fileEnd))) return false;
+
+            for (auto& item : pending) {
+                item.entry.offset = static_cast<uint64_t>(writer.tell());
+                if (!writer.writeBytes(reinterpret_cast<const char*>(item.record.data()), item.record.size())) return false;
+
+                const ChunkCoord coord{item.entry.cx, item.entry.cy, item.entry.cz};
+                auto it = newIndex.find(coord);
+                if (it != newIndex.end()) newLiveRecordBytes -= it->second.size;
+                newLiveRecordBytes += item.entry.size;
+                newIndex[coord] = item.entry;
+            }
+
+            // 新的尾部：完整索引 + 元数据块
+            newHeader.indexOffset = static_cast<uint64_t>(writer.tell());
+            if (!MapSerializer::writeIndex(writer, toIndexVector(newIndex))) return false;
+            newHeader.metadataOffset = static_cast<uint64_t>(writer.tell());
+            if (!MapSerializer::writeMetadataBlock(writer, map.getWorldMetadata())) return false;
+            newEnd = static_cast<uint64_t>(writer.tell());
+
+            // 尾部落盘后才改写文件头 (提交点)，文件头本身再落盘一次，避免掉电后文件头先于尾部到达磁盘
+            if (!writer.flush() || !BinaryWriter::syncToDisk(filepath) || !writer.seek(0)) return false;
+            if (!MapSerializer::writeHeader(writer, newHeader) || !writer.flush() || !BinaryWriter::syncToDisk(filepath)) return false;
+        } catch (const std::exception& e) {
+            LOG_ERROR("SaveJournal: Failed to append to " + filepath + ": " + e.what());
+            return false;
+        }
+
+        stats.appendCount++;
+        stats.appendedChunks += pending.size();
+        stats.appendedBytes += newEnd - fileEnd;
+        header = newHeader;
+        index.swap(newIndex);
+        liveRecordBytes = newLiveRecordBytes;
+        fileEnd = newEnd;
+        generation++;
+
+        const uint64_t live = liveBytesLocked();
+        LOG_INFO("SaveJournal: Appended " + std::to_string(pending.size()) + " chunks to " + filepath
+                 + ", garbage " + std::to_string(fileEnd - live) + "/" + std::to_string(fileEnd) + " bytes.");
+        return true;
+    }
+
+    bool SaveJournal::needsCompaction() const {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        return fileEnd > 0 && static_cast<double>(fileEnd - liveBytesLocked()) / fileEnd >= compactionThreshold;
+    }
+
+    bool SaveJournal::compact() {
+        std::lock_guard<std::mutex> compactionLock(compactionMutex);
+
+        IndexMap snapshot;
+        FileHeader newHeader{};
+        uint64_t snapshotGeneration = 0;
+        uint64_t oldEnd = 0;
+        {
+            std::lock_guard<std::mutex> lock(journalMutex);
+            snapshot = index;
+            newHeader = header;
+            snapshotGeneration = generation;
+            oldEnd = fileEnd;
+        }
+
+        const std::string tmpPath = filepath + ".compact.tmp";
+        IndexMap newIndex;
+        newIndex.reserve(snapshot.size());
+        uint64_t newEnd = 0;
+
+        // 复制快照中的记录时不持有 journalMutex：记录只追加、不改写，append 可以同时进行
+        std::unique_lock<std::mutex> lock(journalMutex, std::defer_lock);
+        try {
+            BinaryWriter writer(tmpPath);
+            if (!writer.write(newHeader)) return false; // 占位，最后改写
+            newHeader.dataOffset = static_cast<uint64_t>(writer.tell());
+            {
+                MappedFile file(filepath);
+                for (auto& pair : snapshot) {
+                    ChunkIndexEntry entry = pair.second;
+                    if (!copyRecord(file, pair.first, entry, writer)) throw std::runtime_error("record copy failed");
+                    newIndex[pair.first] = entry;
+                }
+            }
+
+            // 提交前持锁：补齐复制期间追加的记录，并带上最新的元数据块
+            lock.lock();
+            MappedFile file(filepath);
+            if (generation != snapshotGeneration) {
+                for (const auto& pair : index) {
+                    auto it = snapshot.find(pair.first);
+                    if (it != snapshot.end() && it->second.offset == pair.second.offset) continue;
+                    ChunkIndexEntry entry = pair.second;
+                    if (!copyRecord(file, pair.first, entry, writer)) throw std::runtime_error("record copy failed");
+                    newIndex[pair.first] = entry;
+                }
+            }
+
+            newHeader.indexOffset = static_cast<uint64_t>(writer.tell());
+            if (!MapSerializer::writeIndex(writer, toIndexVector(newIndex))) throw std::runtime_error("index write failed");
+            const uint8_t* metadata = file.span(header.metadataOffset, sizeof(MetadataBlock));
+            if (!metadata) throw std::runtime_error("metadata block out of range");
+            newHeader.metadataOffset = static_cast<uint64_t>(writer.tell());
+            if (!writer.writeBytes(reinterpret_cast<const char*>(metadata), sizeof(MetadataBlock))) throw std::runtime_error("metadata write failed");
+            newEnd = static_cast<uint64_t>(writer.tell());
+
+            if (!writer.seek(0) || !MapSerializer::writeHeader(writer, newHeader) || !writer.flush()) {
+                throw std::runtime_error("header write failed");
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("SaveJournal: Compaction of " + filepath + " failed: " + e.what());
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        // 临时文件完整落盘后才替换原文件，否则掉电后可能留下被截断的存档
+        if (!BinaryWriter::syncToDisk(tmpPath)) {
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        // 替换 (仍持有 journalMutex，避免与 append 交错)；地图正从本文件按需读取时由 LazyChunkFile 关闭、替换并切换索引
+        std::vector<ChunkIndexEntry> entries = toIndexVector(newIndex);
+        if (source) {
+            if (!source->replaceFile(tmpPath, FORMAT_VERSION_MINOR, entries)) {
+                std::error_code ec;
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+        } else {
+            std::error_code ec;
+            std::filesystem::rename(tmpPath, filepath, ec);
+            if (ec) {
+                LOG_ERROR("SaveJournal: Failed to replace " + filepath + ": " + ec.message());
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+        }
+
+        header = newHeader;
+        index.swap(newIndex);
+        fileEnd = newEnd;
+        generation++;
+        stats.compactionCount++;
+        LOG_INFO("SaveJournal: Compacted " + filepath + " from " + std::to_string(oldEnd) + " to " + std::to_string(newEnd) + " bytes.");
+        return true;
+    }
+
+    bool SaveJournal::scheduleCompaction(TaskSystem& taskSystem) {
+        if (pendingCompaction.valid() &&
+            pendingCompaction.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+        }
+        if (!needsCompaction()) return false;
+        if (pendingCompaction.valid()) pendingCompaction.get();
+        pendingCompaction = taskSystem.submitFuture([this]() { return compact(); });
+        return true;
+    }
+
+    bool SaveJournal::waitForCompaction() {
+        if (!pendingCompaction.valid()) return true;
+        return pendingCompaction.get();
+    }
+
+    SaveJournal::Stats SaveJournal::getStats() const {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        Stats result = stats;
+        result.liveChunks = index.size();
+        result.fileBytes = fileEnd;
+        result.liveBytes = liveBytesLocked();
+        return result;
+    }
+
+} // namespace TilelandWorld
@@ -0,0 +1,111 @@
+#pragma once
+#ifndef TILELANDWORLD_SAVEJOURNAL_H
+#define TILELANDWORLD_SAVEJOURNAL_H
+
+#include "FileFormat.h"
+#include "../Coordinates.h"
+#include "../Utils/TaskSystem.h"
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+namespace TilelandWorld {
+
+    class Map;
+    class LazyChunkFile;
+
+    /**
+     * @brief 以日志方式增量保存 .tlwf 存档 (log-structured)。
+     *
+     * .tlwf 的文件头记录索引与元数据块的偏移量，因此增量保存无需重写整个文件：
+     * append 把修改过的区块记录追加到当前有效内容之后，紧接着写出新的索引 (只指向每个区块的最新记录) 与元数据块，
+     * 尾部落盘 (fsync) 后才原地改写文件头使其指向新索引，文件头随后再落盘一次。文件头改写之前中断 (包括掉电) 时，
+ * 旧文件头仍指向旧索引，存档保持上一次提交的状态；
+     * 末尾未提交的字节在下一次追加时被覆盖。文件格式不变，MapSerializer::loadMap 与 LazyChunkFile 无需任何改动即可读取。
+     *
+     * 每次追加的开销为 O(修改区块数) 的记录加上索引本身 (每个区块 28 字节，远小于区块记录)，与世界大小基本无关。
+     * 被新记录取代的旧记录与旧索引成为垃圾；垃圾比例超过阈值时由 compact 重写文件，只原样复制有效记录 (不解码)，
+     * 临时文件写完并落盘后替换原文件。compact 可以通过 scheduleCompaction 在 TaskSystem 上后台执行，
+     * 复制期间不阻塞 append；复制期间追加的区块在替换前补齐。
+     *
+     * 日志打开期间由它独占该存档文件的写入 (不要同时用 saveMap 覆盖同一文件)。
+     * 地图以该文件为按需读取源 (LazyChunkFile) 时，压缩通过 LazyChunkFile::replaceFile 完成替换并切换索引，
+     * 因此本对象必须先于地图销毁。
+     */
+    class SaveJournal {
+    public:
+        struct Stats {
+            size_t liveChunks{0};
+            uint64_t fileBytes{0};      // 当前有效内容长度 (最后一次提交的元数据块末尾)
+            uint64_t liveBytes{0};      // 其中仍被引用的字节 (文件头、最新区块记录、当前索引与元数据块)
+            size_t appendCount{0};      // 本对象完成的追加次数
+            size_t appendedChunks{0};   // 追加写入的区块记录数合计
+            uint64_t appendedBytes{0};  // 追加写入的字节数合计 (含索引与元数据块)
+            size_t compactionCount{0};
+
+            double garbageRatio() const { return fileBytes > 0 ? static_cast<double>(fileBytes - liveBytes) / fileBytes : 0.0; }
+        };
+
+        static constexpr double DEFAULT_COMPACTION_THRESHOLD = 0.5;
+
+        // 打开已有的 .tlwf 存档 (必须是当前格式版本)，失败时抛出 std::runtime_error。
+        explicit SaveJournal(const std::string& tlwfPath, double compactionThreshold = DEFAULT_COMPACTION_THRESHOLD);
+        // 等待尚未完成的后台压缩。
+        ~SaveJournal();
+
+        /**
+         * @brief 追加 modifiedChunks 中的区块 (内存中的或已卸载到后备存储的) 并提交新的索引与元数据。
+         * @details 只在存档源中、未被修改的区块无需重写，直接跳过。调用期间地图不得被并发修改 (与 saveMap 相同)。
+         */
+        bool append(const Map& map, const std::unordered_set<ChunkCoord, ChunkCoordHash>& modifiedChunks);
+
+        // 垃圾比例是否达到压缩阈值。
+        bool needsCompaction() const;
+
+        // 同步压缩：只保留最新记录重写文件。
+        bool compact();
+
+        /**
+         * @brief 垃圾比例达到阈值且没有正在进行的压缩时，把 compact 提交到 taskSystem。
+         * @return 提交了新的压缩任务时返回 true。
+         */
+        bool scheduleCompaction(TaskSystem& taskSystem);
+
+        // 等待后台压缩完成并返回其结果；没有后台压缩时返回 true。
+        bool waitForCompaction();
+
+        Stats getStats() const;
+        const std::string& getPath() const { return filepath; }
+
+    private:
+        // 当前索引按坐标保存，追加时覆盖旧条目
+        using IndexMap = std::unordered_map<ChunkCoord, ChunkIndexEntry, ChunkCoordHash>;
+
+        static uint64_t trailerBytes(size_t chunkCount);
+        uint64_t liveBytesLocked() const;
+
+        std::string filepath;
+        double compactionThreshold;
+
+        mutable std::mutex journalMutex; // 保护以下文件状态与统计
+        FileHeader header{};
+        IndexMap index;
+        uint64_t fileEnd = 0;           // 有效内容末尾 (= metadataOffset + sizeof(MetadataBlock))
+        uint64_t liveRecordBytes = 0;   // 当前索引引用的区块记录字节数
+        uint64_t generation = 0;        // 每次提交递增，压缩据此判断复制期间是否有新的追加
+        LazyChunkFile* source = nullptr; // 以本文件为按需读取源的 LazyChunkFile (由最近一次 append 的地图提供)
+        Stats stats;
+
+        std::mutex compactionMutex;     // 同一时间只进行一次压缩
+        std::future<bool> pendingCompaction;
+
+        SaveJournal(const SaveJournal&) = delete;
+        SaveJournal& operator=(const SaveJournal&) = delete;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_SAVEJOURNAL_H
@@ -1,12 +1,18 @@
 #include "Chunk.h"
 #include "TerrainTypes.h" // 包含默认 Tile 类型 (例如 VOIDBLOCK)
+#include "ChunkIndexPool.h"
+#include <algorithm>     // For std::fill, std::lower_bound
 
 namespace TilelandWorld
 {
-    // 构造函数：初始化区块中的所有 Tile，填充为 VOIDBLOCK 或基于生成逻辑。
+    namespace {
+        constexpr int INDEX_WORD_BITS = 64;
+    }
+
+    // 构造函数：区块初始为均匀的 VOIDBLOCK，由生成器或加载逻辑再填充。
     Chunk::Chunk(int cx, int cy, int cz) : chunkX(cx), chunkY(cy), chunkZ(cz)
     {
-        tiles.fill(Tile(TerrainType::VOIDBLOCK));
+        palette.push_back(Tile(TerrainType::VOIDBLOCK));
     }
 
     // 检查局部坐标是否在区块的有效范围内 (lx, ly 对应 XY 平面, lz 对应 Z 层级)。
@@ -17,8 +23,7 @@ namespace TilelandWorld
                lz >= 0 && lz < CHUNK_DEPTH;
     }
 
-    // 将区块内的 3D 局部坐标 (lx, ly, lz) 转换为 1D 数组 tiles 的索引。
-    // 这是必要的，因为我们将 3D 数据线性存储在 1D 数组中以提高效率。
+    // 将区块内的 3D 局部坐标 (lx, ly, lz) 转换为 1D 索引。
     size_t Chunk::localCoordsToIndex(int lx, int ly, int lz)
     {
         // 在计算索引之前，也要确保坐标在非调试版本中有效，
@@ -27,31 +32,347 @@ namespace TilelandWorld
 
         // 索引计算：假设 XY 是平面，Z 是垂直层级。
         // X 变化最快，然后是 Y，然后是 Z。
-        // 可以将其视为层 (Z)，每层是一个 XY 平面 (AREA)。
         return static_cast<size_t>(lx) +                  // X 偏移
                static_cast<size_t>(ly) * CHUNK_WIDTH +    // Y 偏移 (在当前层内)
                static_cast<size_t>(lz) * CHUNK_AREA;     // Z 偏移 (跳到对应层)
-                                                         // CHUNK_AREA = CHUNK_WIDTH * CHUNK_HEIGHT
     }
 
-    Tile &Chunk::getLocalTile(int lx, int ly, int lz)
+    // --- 位压缩索引 ---
+
+    uint8_t Chunk::bitsForPaletteSize(size_t paletteSize)
+    {
+        if (paletteSize <= 1) return 0;
+        if (paletteSize <= 2) return 1;
+        if (paletteSize <= 4) return 2;
+        if (paletteSize <= 16) return 4;
+        if (paletteSize <= 256) return 8;
+        return 16; // CHUNK_VOLUME (4096) 个不同值也能容纳
+    }
+
+    uint32_t Chunk::getPaletteIndex(size_t i) const
+    {
+        if (bitsPerIndex == 0) return 0;
+        const size_t perWord = INDEX_WORD_BITS / bitsPerIndex;
+        const uint64_t word = (*indices)[i / perWord];
+        const unsigned shift = static_cast<unsigned>((i % perWord) * bitsPerIndex);
+        const uint64_t mask = (uint64_t{1} << bitsPerIndex) - 1;
+        return static_cast<uint32_t>((word >> shift) & mask);
+    }
+
+    void Chunk::setPaletteIndex(size_t i, uint32_t value)
+    {
+        if (bitsPerIndex == 0) return;
+        detachIndices();
+        const size_t perWord = INDEX_WORD_BITS / bitsPerIndex;
+        uint64_t& word = (*indices)[i / perWord];
+        const unsigned shift = static_cast<unsigned>((i % perWord) * bitsPerIndex);
+        const uint64_t mask = (uint64_t{1} << bitsPerIndex) - 1;
+        word = (word & ~(mask << shift)) | ((static_cast<uint64_t>(value) & mask) << shift);
+    }
+
+    void Chunk::repackIndices(uint8_t newBits)
+    {
+        if (newBits == bitsPerIndex) return;
+
+        std::vector<uint64_t> repacked;
+        if (newBits > 0)
+        {
+            const size_t perWord = INDEX_WORD_BITS / newBits;
+            repacked.assign((CHUNK_VOLUME + perWord - 1) / perWord, 0);
+            for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i)
+            {
+                const uint64_t value = getPaletteIndex(i);
+                const unsigned shift = static_cast<unsigned>((i % perWord) * newBits);
+                repacked[i / perWord] |= value << shift;
+            }
+        }
+
+        replaceIndices(std::move(repacked), newBits);
+    }
+
+    void Chunk::detachIndices()
+    {
+        // 池与其他区块都只读取共享数组，引用计数为 1 时只有本区块持有
+        if (indices && indices.use_count() > 1)
+        {
+            indices = std::make_shared<std::vector<uint64_t>>(*indices);
+            indicesPooled = false;
+        }
+    }
+
+    void Chunk::replaceIndices(std::vector<uint64_t>&& words, uint8_t newBits)
+    {
+        if (words.empty()) indices.reset();
+        else indices = std::make_shared<std::vector<uint64_t>>(std::move(words));
+        indicesPooled = false;
+        bitsPerIndex = newBits;
+    }
+
+    uint32_t Chunk::findOrAddPaletteEntry(const Tile& tile)
+    {
+        for (size_t i = 0; i < palette.size(); ++i)
+        {
+            if (palette[i] == tile) return static_cast<uint32_t>(i);
+        }
+
+        // 调色板已满：先尝试回收未引用的条目，避免无谓地扩大位宽
+        size_t capacity = size_t{1} << bitsPerIndex;
+        if (palette.size() >= capacity && !isUniform())
+        {
+            compact();
+            capacity = size_t{1} << bitsPerIndex;
+        }
+
+        palette.push_back(tile);
+        if (palette.size() > capacity)
+        {
+            repackIndices(bitsForPaletteSize(palette.size()));
+        }
+        return static_cast<uint32_t>(palette.size() - 1);
+    }
+
+    void Chunk::compact()
+    {
+        if (isUniform())
+        {
+            palette.resize(1);
+            return;
+        }
+
+        std::vector<uint32_t> usage(palette.size(), 0);
+        for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i)
+        {
+            ++usage[getPaletteIndex(i)];
+        }
+
+        std::vector<Tile> newPalette;
+        std::vector<uint32_t> remap(palette.size(), 0);
+        for (size_t p = 0; p < palette.size(); ++p)
+        {
+            if (usage[p] == 0) continue;
+            remap[p] = static_cast<uint32_t>(newPalette.size());
+            newPalette.push_back(palette[p]);
+        }
+
+        if (newPalette.size() == palette.size()) return; // 没有可回收的条目
+
+        if (newPalette.size() == 1)
+        {
+            fill(newPalette.front());
+            return;
+        }
+
+        const uint8_t newBits = bitsForPaletteSize(newPalette.size());
+        const size_t perWord = INDEX_WORD_BITS / newBits;
+        std::vector<uint64_t> repacked((CHUNK_VOLUME + perWord - 1) / perWord, 0);
+        for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i)
+        {
+            const uint64_t value = remap[getPaletteIndex(i)];
+            const unsigned shift = static_cast<unsigned>((i % perWord) * newBits);
+            repacked[i / perWord] |= value << shift;
+        }
+
+        palette.swap(newPalette);
+        replaceIndices(std::move(repacked), newBits);
+    }
+
+    // --- 访问接口 ---
+
+    Tile Chunk::getLocalTile(int lx, int ly, int lz) const
     {
         if (!areLocalCoordsValid(lx, ly, lz))
         {
             // 抛出异常，因为局部区块坐标超出范围。
             throw std::out_of_range("Local chunk coordinates out of range.");
         }
-        return tiles[localCoordsToIndex(lx, ly, lz)];
+        return palette[getPaletteIndex(localCoordsToIndex(lx, ly, lz))];
     }
 
-    const Tile &Chunk::getLocalTile(int lx, int ly, int lz) const
+    void Chunk::setLocalTile(int lx, int ly, int lz, const Tile& tile)
     {
         if (!areLocalCoordsValid(lx, ly, lz))
         {
-            // 抛出异常，因为局部区块坐标超出范围。
             throw std::out_of_range("Local chunk coordinates out of range.");
         }
-        return tiles[localCoordsToIndex(lx, ly, lz)];
+        const size_t index = localCoordsToIndex(lx, ly, lz);
+        dirty = true;
+        if (!tile.hasOverride) eraseOverride(index);
+        uint32_t paletteIndex = findOrAddPaletteEntry(tile);
+        setPaletteIndex(index, paletteIndex);
+    }
+
+    // --- 覆盖表 ---
+
+    std::vector<std::pair<uint16_t, TileTraits>>::iterator Chunk::findOverride(uint16_t index)
+    {
+        return std::lower_bound(overrides.begin(), overrides.end(), index,
+            [](const std::pair<uint16_t, TileTraits>& entry, uint16_t key) { return entry.first < key; });
+    }
+
+    std::vector<std::pair<uint16_t, TileTraits>>::const_iterator Chunk::findOverride(uint16_t index) const
+    {
+        return std::lower_bound(overrides.begin(), overrides.end(), index,
+            [](const std::pair<uint16_t, TileTraits>& entry, uint16_t key) { return entry.first < key; });
+    }
+
+    void Chunk::eraseOverride(size_t index)
+    {
+        if (overrides.empty()) return;
+        auto it = findOverride(static_cast<uint16_t>(index));
+        if (it != overrides.end() && it->first == index) overrides.erase(it);
+    }
+
+    TileTraits Chunk::getTileTraits(int lx, int ly, int lz) const
+    {
+        Tile tile = getLocalTile(lx, ly, lz); // 负责坐标检查
+        if (tile.hasOverride)
+        {
+            const uint16_t index = static_cast<uint16_t>(localCoordsToIndex(lx, ly, lz));
+            auto it = findOverride(index);
+            if (it != overrides.end() && it->first == index) return it->second;
+        }
+        return TileTraits::fromTerrain(tile.terrain);
+    }
+
+    void Chunk::setTileOverride(int lx, int ly, int lz, const TileTraits& traits)
+    {
+        Tile tile = getLocalTile(lx, ly, lz);
+        if (traits == TileTraits::fromTerrain(tile.terrain))
+        {
+            clearTileOverride(lx, ly, lz);
+            return;
+        }
+
+        const uint16_t index = static_cast<uint16_t>(localCoordsToIndex(lx, ly, lz));
+        dirty = true;
+        auto it = findOverride(index);
+        if (it != overrides.end() && it->first == index) it->second = traits;
+        else overrides.insert(it, {index, traits});
+
+        if (!tile.hasOverride)
+        {
+            tile.hasOverride = 1;
+            setPaletteIndex(index, findOrAddPaletteEntry(tile));
+        }
+    }
+
+    void Chunk::clearTileOverride(int lx, int ly, int lz)
+    {
+        Tile tile = getLocalTile(lx, ly, lz);
+        if (!tile.hasOverride) return;
+        tile.hasOverride = 0;
+        setLocalTile(lx, ly, lz, tile); // 同时移除覆盖表条目
+    }
+
+    void Chunk::fill(const Tile& tile)
+    {
+        dirty = true;
+        if (!tile.hasOverride) overrides.clear();
+        palette.assign(1, tile);
+        indices.reset(); // 释放 (或不再共享) 索引数组
+        indicesPooled = false;
+        bitsPerIndex = 0;
+    }
+
+    void Chunk::copyTilesTo(Tile* out) const
+    {
+        if (isUniform())
+        {
+            std::fill(out, out + CHUNK_VOLUME, palette.front());
+            return;
+        }
+        for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i)
+        {
+            out[i] = palette[getPaletteIndex(i)];
+        }
+    }
+
+    void Chunk::copyRowTo(int lx, int ly, int lz, int count, Tile* out) const
+    {
+        assert(count >= 0 && areLocalCoordsValid(lx, ly, lz) && lx + count <= CHUNK_WIDTH && "行范围超出区块。");
+        if (isUniform())
+        {
+            std::fill(out, out + count, palette.front());
+            return;
+        }
+        const size_t start = localCoordsToIndex(lx, ly, lz);
+        for (int i = 0; i < count; ++i)
+        {
+            out[i] = palette[getPaletteIndex(start + static_cast<size_t>(i))];
+        }
+    }
+
+    void Chunk::assignTiles(const Tile* in)
+    {
+        dirty = true;
+        // 丢弃不再带覆盖位的位置上的覆盖条目
+        overrides.erase(std::remove_if(overrides.begin(), overrides.end(),
+            [in](const std::pair<uint16_t, TileTraits>& entry) { return !in[entry.first].hasOverride; }),
+            overrides.end());
+
+        std::vector<Tile> newPalette;
+        std::vector<uint16_t> paletteIndices(CHUNK_VOLUME);
+
+        // 相邻 Tile 通常相同，先与上一次命中的条目比较
+        uint16_t lastHit = 0;
+        newPalette.push_back(in[0]);
+        for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i)
+        {
+            const Tile& tile = in[i];
+            if (newPalette[lastHit] != tile)
+            {
+                size_t p = 0;
+                while (p < newPalette.size() && newPalette[p] != tile) ++p;
+                if (p == newPalette.size()) newPalette.push_back(tile);
+                lastHit = static_cast<uint16_t>(p);
+            }
+            paletteIndices[i] = lastHit;
+        }
+
+        if (newPalette.size() == 1)
+        {
+            fill(newPalette.front());
+            return;
+        }
+
+        const uint8_t newBits = bitsForPaletteSize(newPalette.size());
+        const size_t perWord = INDEX_WORD_BITS / newBits;
+        std::vector<uint64_t> packed((CHUNK_VOLUME + perWord - 1) / perWord, 0);
+        for (size_t i = 0; i < static_cast<size_t>(CHUNK_VOLUME); ++i)
+        {
+            const unsigned shift = static_cast<unsigned>((i % perWord) * newBits);
+            packed[i / perWord] |= static_cast<uint64_t>(paletteIndices[i]) << shift;
+        }
+
+        palette.swap(newPalette);
+        replaceIndices(std::move(packed), newBits);
+    }
+
+    size_t Chunk::getMemoryUsage() const
+    {
+        size_t indexBytes = 0;
+        if (indices)
+        {
+            // 池持有的引用不算共享者，否则只被一个区块使用的数组只计一半
+            const long sharers = indices.use_count() - (indicesPooled ? 1 : 0);
+            indexBytes = indices->capacity() * sizeof(uint64_t) / static_cast<size_t>(std::max<long>(1, sharers));
+        }
+        return sizeof(Chunk) +
+               palette.capacity() * sizeof(Tile) +
+               indexBytes +
+               overrides.capacity() * sizeof(std::pair<uint16_t, TileTraits>);
+    }
+
+    void Chunk::shareIndices(ChunkIndexPool& pool)
+    {
+        if (!indices) return;
+        indices = pool.intern(indices);
+        indicesPooled = true;
+    }
+
+    void Chunk::releaseIndices(ChunkIndexPool& pool) const
+    {
+        if (indices && indicesPooled) pool.release(indices);
     }
 
 } // namespace TilelandWorld
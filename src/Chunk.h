@@ -5,6 +5,10 @@
 #include "Tile.h"
 #include "Constants.h"
 #include <array>
+#include <vector>
+#include <memory>    // 用于 std::shared_ptr
+#include <utility>   // 用于 std::pair
+#include <cstdint>
 #include <stdexcept> // 用于 std::out_of_range
 #include <cassert>   // 用于 assert
 
@@ -12,13 +16,31 @@ namespace TilelandWorld {
 
     // 前向声明 MapSerializer，以便在 Chunk 中声明友元
     class MapSerializer;
+    class ChunkIndexPool;
 
+    /**
+     * @brief 区块：CHUNK_WIDTH x CHUNK_HEIGHT x CHUNK_DEPTH 的 Tile 容器。
+     *
+     * 存储采用“调色板 + 位压缩索引”的形式：
+     * - palette 保存区块内出现过的不同 Tile 值；
+     * - indices 以 bitsPerIndex 位为单位保存每个位置对应的调色板下标。
+     * 当整个区块只有一种 Tile（例如地底全是 WALL、高空全是 VOIDBLOCK）时，
+     * 区块处于“均匀”形态：palette 只有一个条目，indices 为空，几乎不占内存。
+     *
+     * 由于 Tile 不再以数组形式实际存在，访问接口按值返回 Tile，写入需通过 setLocalTile。
+     *
+     * 通行性/移动成本默认由地形派生；极少数偏离默认值的实例保存在稀疏的覆盖表中，
+     * 对应 Tile 的 hasOverride 位被置位。
+     *
+     * 索引数组以写时复制的方式共享：复制区块或经 ChunkIndexPool 去重后，内容相同的区块指向同一个数组，
+     * 直到其中之一被修改时才复制出自己的一份。调色板与覆盖表很小，始终由每个区块独占。
+     */
     class Chunk {
-        // 将 MapSerializer 声明为友元，允许它访问私有成员 (如 tiles)
+        // 将 MapSerializer 声明为友元，允许它访问私有成员
         friend class MapSerializer;
 
     public:
-        // 构造函数：使用其在区块网格中的坐标初始化区块。
+        // 构造函数：使用其在区块网格中的坐标初始化区块（均匀填充 VOIDBLOCK）。
         Chunk(int cx, int cy, int cz);
 
         // 获取区块的坐标。
@@ -27,43 +49,129 @@ namespace TilelandWorld {
         int getChunkZ() const { return chunkZ; }
 
         /**
-         * @brief 使用局部坐标 (lx, ly, lz) 访问 Tile (非 const 版本)。
+         * @brief 使用局部坐标 (lx, ly, lz) 读取 Tile。
          * @param lx 局部 X 坐标 (0 到 CHUNK_WIDTH-1)。
          * @param ly 局部 Y 坐标 (0 到 CHUNK_HEIGHT-1)。
          * @param lz 局部 Z 坐标 (0 到 CHUNK_DEPTH-1)。
-         * @return 对指定位置 Tile 的可修改引用 (Tile&)。
+         * @return 指定位置 Tile 的副本。
          * @throws std::out_of_range 如果坐标无效。
-         * @details 此版本允许修改返回的 Tile 对象。
          */
-        Tile& getLocalTile(int lx, int ly, int lz);
+        Tile getLocalTile(int lx, int ly, int lz) const;
 
         /**
-         * @brief 使用局部坐标 (lx, ly, lz) 访问 Tile (const 版本)。
-         * @param lx 局部 X 坐标 (0 到 CHUNK_WIDTH-1)。
-         * @param ly 局部 Y 坐标 (0 到 CHUNK_HEIGHT-1)。
-         * @param lz 局部 Z 坐标 (0 到 CHUNK_DEPTH-1)。
-         * @return 对指定位置 Tile 的只读引用 (const Tile&)。
+         * @brief 使用局部坐标 (lx, ly, lz) 写入 Tile。
+         * @throws std::out_of_range 如果坐标无效。
+         * @details 新值不在调色板中时会追加条目，必要时扩展索引位宽。
+         *          若新 Tile 的 hasOverride 位未置位，该位置原有的覆盖条目会被移除。
+         */
+        void setLocalTile(int lx, int ly, int lz, const Tile& tile);
+
+        /**
+         * @brief 获取指定位置实际生效的通行性/移动成本。
+         * @details hasOverride 置位且覆盖表中有条目时返回覆盖值，否则返回地形默认值。
+         * @throws std::out_of_range 如果坐标无效。
+         */
+        TileTraits getTileTraits(int lx, int ly, int lz) const;
+
+        /**
+         * @brief 为指定位置设置/清除实例级覆盖。
+         * @details 覆盖值与地形默认值相同时等价于清除。
          * @throws std::out_of_range 如果坐标无效。
-         * @details 此版本不允许修改返回的 Tile 对象，用于 const 上下文。
          */
-        const Tile& getLocalTile(int lx, int ly, int lz) const;
+        void setTileOverride(int lx, int ly, int lz, const TileTraits& traits);
+        void clearTileOverride(int lx, int ly, int lz);
+
+        // 覆盖表条目数 (调试/统计用)。
+        size_t getOverrideCount() const { return overrides.size(); }
+
+        // 用同一个 Tile 填充整个区块，区块变为均匀形态。
+        void fill(const Tile& tile);
+
+        /**
+         * @brief 批量导出/导入全部 Tile (按 localCoordsToIndex 顺序，共 CHUNK_VOLUME 个)。
+         * @details 供生成器与序列化器使用，避免逐个 Tile 查找调色板。
+         *          assignTiles 会重建调色板，若所有 Tile 相同则自动退化为均匀形态。
+         */
+        void copyTilesTo(Tile* out) const;
+        void assignTiles(const Tile* in);
+
+        /**
+         * @brief 导出一行 (固定 ly, lz) 中从 lx 开始的 count 个连续 Tile。
+         * @details 供 Map::readLayer 按行批量读取；均匀区块直接填充。调用方保证范围有效。
+         */
+        void copyRowTo(int lx, int ly, int lz, int count, Tile* out) const;
+
+        // 区块是否处于均匀形态（单一调色板条目，无索引数组）。
+        bool isUniform() const { return !indices; }
+        size_t getPaletteSize() const { return palette.size(); }
+        int getBitsPerIndex() const { return bitsPerIndex; }
+
+        // 估算区块占用的堆内存 + 对象自身大小 (字节)，用于内存统计。共享的索引数组按共享的区块数量均摊 (不计池的引用)。
+        size_t getMemoryUsage() const;
+
+        /**
+         * @brief 在 pool 中查找内容相同的索引数组并改为共享它 (没有时收录自己的数组)。
+         * @details 不改变区块内容，也不置脏标记。收录后第一次修改会复制出独占的数组。
+         */
+        void shareIndices(ChunkIndexPool& pool);
+        // 区块即将卸载：索引数组只剩本区块与 pool 持有时把它移出 pool，使其随区块一同释放。
+        void releaseIndices(ChunkIndexPool& pool) const;
+        // 两个区块是否共享同一个索引数组 (调试/统计用)。
+        bool sharesIndicesWith(const Chunk& other) const { return indices && indices == other.indices; }
+
+        // 丢弃未被引用的调色板条目并尽可能缩小索引位宽。
+        void compact();
+
+        /**
+         * @brief 脏标记：区块内容自上次落盘 (或由生成器/后备存储产生) 以来是否被修改。
+         * @details 所有写入接口都会置位；Map 在区块由生成器或后备存储创建后清除。
+         *          卸载脏区块前必须先写入后备存储 (见 Map::unloadChunk)，干净区块可直接丢弃并在需要时重建。
+         */
+        bool isDirty() const { return dirty; }
+        void markDirty() { dirty = true; }
+        void clearDirty() { dirty = false; }
 
         // 辅助函数，检查局部坐标是否在边界内。
         static bool areLocalCoordsValid(int lx, int ly, int lz);
 
     private:
         int chunkX, chunkY, chunkZ; // 此区块在世界区块网格中的坐标
-        std::array<Tile, CHUNK_VOLUME> tiles; // 存储 3D 区块数据的 1D 数组，Chunk层的核心
+
+        std::vector<Tile> palette;      // 区块内出现的不同 Tile 值，至少包含一个条目
+        std::shared_ptr<std::vector<uint64_t>> indices; // 位压缩的调色板下标 (写时复制)；均匀区块时为空
+        uint8_t bitsPerIndex = 0;       // 每个下标的位数 (0/1/2/4/8/16)，取 2 的幂以避免跨字存储
+        bool dirty = false;             // 见 isDirty
+        bool indicesPooled = false;     // indices 收录在 ChunkIndexPool 中 (池另持有一个引用)
+
+        // 稀疏覆盖表：按局部一维索引升序排列。通常为空或只有寥寥几项，有序数组比哈希表更省内存。
+        std::vector<std::pair<uint16_t, TileTraits>> overrides;
 
         /**
          * @brief 辅助函数，将 3D 局部坐标转换为 1D 数组索引。
          * @param lx 局部 X 坐标。
          * @param ly 局部 Y 坐标。
          * @param lz 局部 Z 坐标。
-         * @return 对应于 tiles 数组的一维索引。
-         * @details 这是内部实现细节，用于将三维逻辑坐标映射到一维物理存储。
+         * @return 对应的一维索引 (X 变化最快，然后是 Y，然后是 Z)。
          */
         static size_t localCoordsToIndex(int lx, int ly, int lz);
+
+        // --- 位压缩索引辅助 ---
+        uint32_t getPaletteIndex(size_t i) const;
+        void setPaletteIndex(size_t i, uint32_t value);
+        // 索引数组与其他区块 (或 ChunkIndexPool) 共享时先复制一份，再原地修改。
+        void detachIndices();
+        // 以新数组替换索引数组 (空数组表示均匀形态)。
+        void replaceIndices(std::vector<uint64_t>&& words, uint8_t newBits);
+        // 查找或追加调色板条目，返回其下标（可能触发 compact 或位宽扩展）。
+        uint32_t findOrAddPaletteEntry(const Tile& tile);
+        // 将索引数组重新编码为新的位宽。
+        void repackIndices(uint8_t newBits);
+        // 在覆盖表中查找局部索引，返回首个不小于 index 的位置。
+        std::vector<std::pair<uint16_t, TileTraits>>::iterator findOverride(uint16_t index);
+        std::vector<std::pair<uint16_t, TileTraits>>::const_iterator findOverride(uint16_t index) const;
+        void eraseOverride(size_t index);
+        // 容纳 paletteSize 个条目所需的最小位宽。
+        static uint8_t bitsForPaletteSize(size_t paletteSize);
     };
 
 } // namespace TilelandWorld
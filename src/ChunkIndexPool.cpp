@@ -0,0 +1,71 @@
+#include "ChunkIndexPool.h"
+#include <algorithm> // For std::max
+
+namespace TilelandWorld {
+
+    uint64_t ChunkIndexPool::hashOf(const IndexArray& indices) {
+        // 逐字旋转-乘法混合，最后做 splitmix64 finalizer (同 hashChunkCoord)；数组长度区分不同位宽
+        uint64_t h = indices.size() * 0x9E3779B97F4A7C15ull;
+        for (uint64_t word : indices) {
+            h = ((h << 5) | (h >> 59)) ^ word;
+            h *= 0xC2B2AE3D27D4EB4Full;
+        }
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    std::shared_ptr<ChunkIndexPool::IndexArray> ChunkIndexPool::intern(const std::shared_ptr<IndexArray>& indices) {
+        if (!indices) return indices;
+        const uint64_t hash = hashOf(*indices);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto range = entries.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == indices || *it->second == *indices) return it->second;
+        }
+
+        if (entries.size() >= sweepThreshold) {
+            sweepLocked();
+            sweepThreshold = std::max(MIN_SWEEP_THRESHOLD, entries.size() * 2);
+        }
+        entries.emplace(hash, indices);
+        return indices;
+    }
+
+    void ChunkIndexPool::release(const std::shared_ptr<IndexArray>& indices) {
+        if (!indices) return;
+        const uint64_t hash = hashOf(*indices);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto range = entries.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second != indices) continue;
+            // 池与调用方之外还有区块持有时保留，供之后的区块继续去重
+            if (indices.use_count() == 2) entries.erase(it);
+            return;
+        }
+    }
+
+    size_t ChunkIndexPool::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    void ChunkIndexPool::sweep() {
+        std::lock_guard<std::mutex> lock(mutex);
+        sweepLocked();
+    }
+
+    void ChunkIndexPool::sweepLocked() {
+        // 引用计数为 1 表示只剩池持有；新的引用只能经由 intern 取得 (持锁)，因此不会与清理竞争
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.use_count() == 1) it = entries.erase(it);
+            else ++it;
+        }
+    }
+
+} // namespace TilelandWorld
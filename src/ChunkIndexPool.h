@@ -0,0 +1,52 @@
+#pragma once
+#ifndef TILELANDWORLD_CHUNKINDEXPOOL_H
+#define TILELANDWORLD_CHUNKINDEXPOOL_H
+
+#include <vector>
+#include <memory>   // For std::shared_ptr
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 区块索引数组的去重池 (按内容寻址)。
+     *
+     * 平坦地形、人工建筑的重复区段等会产生大量内容相同的非均匀区块，它们的位压缩索引数组逐字相同。
+     * Chunk::shareIndices 把自己的数组交给 intern：池中已有相同内容时返回已有数组，区块改为共享它，
+     * 原数组随之释放。池本身持有收录数组的一个引用，因此被收录的数组永远不会被原地修改 (Chunk 写入前检查引用计数并复制)。
+     *
+     * 区块卸载时经 release 移除只剩它使用的条目；其余只剩池引用的条目在池增长到阈值时被清理，
+     * 阈值随存活条目数翻倍，清理开销均摊为 O(1)。线程安全。
+     */
+    class ChunkIndexPool {
+    public:
+        using IndexArray = std::vector<uint64_t>;
+
+        // 返回与 indices 内容相同的共享数组；池中没有时收录并返回 indices 本身。
+        std::shared_ptr<IndexArray> intern(const std::shared_ptr<IndexArray>& indices);
+
+        // indices 只剩池与调用方持有时移除其条目 (调用方即将释放它)。
+        void release(const std::shared_ptr<IndexArray>& indices);
+
+        // 池中的条目数 (含已无区块引用、尚未清理的条目)。
+        size_t size() const;
+        // 立即清理无区块引用的条目。
+        void sweep();
+
+    private:
+        static constexpr size_t MIN_SWEEP_THRESHOLD = 256;
+
+        mutable std::mutex mutex;
+        std::unordered_multimap<uint64_t, std::shared_ptr<IndexArray>> entries;
+        size_t sweepThreshold = MIN_SWEEP_THRESHOLD;
+
+        static uint64_t hashOf(const IndexArray& indices);
+        void sweepLocked();
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_CHUNKINDEXPOOL_H
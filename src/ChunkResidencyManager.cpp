@@ -0,0 +1,105 @@
+#include "ChunkResidencyManager.h"
+#include "Utils/Logger.h"
+#include <algorithm> // For std::sort
+#include <cstdlib>   // For std::abs
+#include <vector>
+
+namespace TilelandWorld
+{
+    ChunkResidencyManager::ChunkResidencyManager(size_t memoryBudgetBytes) : memoryBudget(memoryBudgetBytes)
+    {
+    }
+
+    size_t ChunkResidencyManager::update(Map &map, const ChunkCoord &focus, int keepRadiusXY, int keepRadiusZ)
+    {
+        ++currentTick;
+
+        struct Candidate
+        {
+            ChunkCoord coord;
+            uint64_t lastUsedTick;
+            long long distance; // 切比雪夫距离，越远越先卸载
+            size_t bytes;
+        };
+
+        std::vector<Candidate> candidates;
+        size_t totalBytes = 0;
+        for (const auto &pair : map)
+        {
+            const ChunkCoord &coord = pair.first;
+            const size_t bytes = pair.second->getMemoryUsage();
+            totalBytes += bytes;
+
+            const int dx = std::abs(coord.cx - focus.cx);
+            const int dy = std::abs(coord.cy - focus.cy);
+            const int dz = std::abs(coord.cz - focus.cz);
+            if (dx <= keepRadiusXY && dy <= keepRadiusXY && dz <= keepRadiusZ)
+            {
+                lastUsed[coord] = currentTick;
+                continue;
+            }
+
+            auto it = lastUsed.find(coord);
+            candidates.push_back(Candidate{coord, it == lastUsed.end() ? 0 : it->second,
+                                           std::max({dx, dy, dz}), bytes});
+        }
+
+        stats.residentChunks = map.getLoadedChunkCount();
+        stats.residentBytes = totalBytes;
+        if (memoryBudget == 0 || totalBytes <= memoryBudget)
+        {
+            warnedOverBudget = false;
+            return 0;
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            if (a.lastUsedTick != b.lastUsedTick) return a.lastUsedTick < b.lastUsedTick;
+            return a.distance > b.distance;
+        });
+
+        const size_t target = static_cast<size_t>(static_cast<double>(memoryBudget) * LOW_WATERMARK);
+        size_t evicted = 0;
+        for (const Candidate &candidate : candidates)
+        {
+            if (totalBytes <= target) break;
+
+            const Chunk *chunk = map.getChunk(candidate.coord.cx, candidate.coord.cy, candidate.coord.cz);
+            const bool wasDirty = chunk && chunk->isDirty();
+            if (!map.unloadChunk(candidate.coord.cx, candidate.coord.cy, candidate.coord.cz))
+            {
+                ++stats.failedWriteBacks;
+                continue;
+            }
+
+            lastUsed.erase(candidate.coord);
+            totalBytes -= candidate.bytes;
+            ++evicted;
+            if (wasDirty) ++stats.writtenBackTotal;
+        }
+
+        // 仅在首次无法降到预算以内时警告，避免每次 update 刷屏
+        const bool overBudget = totalBytes > memoryBudget;
+        if (overBudget && !warnedOverBudget)
+        {
+            LOG_WARNING("Chunk residency: still over budget after eviction (" + std::to_string(totalBytes / 1024) + " KiB / " +
+                        std::to_string(memoryBudget / 1024) + " KiB). Protected radius too large or write-back failing.");
+        }
+        warnedOverBudget = overBudget;
+
+        // 清理已不在内存中的区块的使用记录
+        if (lastUsed.size() > 2 * map.getLoadedChunkCount() + 64)
+        {
+            for (auto it = lastUsed.begin(); it != lastUsed.end();)
+            {
+                if (map.getChunk(it->first.cx, it->first.cy, it->first.cz)) ++it;
+                else it = lastUsed.erase(it);
+            }
+        }
+
+        stats.evictedTotal += evicted;
+        stats.residentChunks = map.getLoadedChunkCount();
+        stats.residentBytes = totalBytes;
+        return evicted;
+    }
+
+} // namespace TilelandWorld
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef TILELANDWORLD_CHUNKRESIDENCYMANAGER_H
+#define TILELANDWORLD_CHUNKRESIDENCYMANAGER_H
+
+#include "Map.h"
+#include "Coordinates.h"
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 区块驻留管理：在内存预算内按 LRU + 距离卸载区块。
+     *
+     * 每次 update 时，焦点 (通常是视口中心) 周围保护范围内的区块被标记为“刚使用”；
+     * 当已加载区块的总内存超过预算时，从最久未使用的区块开始卸载 (同一时刻使用过的按距焦点远近)，
+     * 直到降到预算的 LOW_WATERMARK 以下，避免每帧在预算边缘反复加载/卸载。
+     * 脏区块经 Map::unloadChunk 写入后备存储后才会被移除，之后 getOrLoadChunk 会透明地重新读回。
+     *
+     * 不是线程安全的：update 会修改地图，调用方需持有保护 Map 的锁 (例如 mapMutex)。
+     */
+    class ChunkResidencyManager {
+    public:
+        struct Stats {
+            size_t residentChunks = 0;  // 最近一次 update 后的已加载区块数
+            size_t residentBytes = 0;   // 最近一次 update 后的估算内存 (Chunk::getMemoryUsage 之和)
+            size_t evictedTotal = 0;    // 累计卸载的区块数
+            size_t writtenBackTotal = 0;// 其中写入后备存储的脏区块数
+            size_t failedWriteBacks = 0;// 累计写回失败 (区块被保留) 的次数
+        };
+
+        // memoryBudgetBytes 为 0 表示不限制 (只统计，不卸载)。
+        explicit ChunkResidencyManager(size_t memoryBudgetBytes);
+
+        void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+        size_t getMemoryBudget() const { return memoryBudget; }
+
+        /**
+         * @brief 刷新使用记录，超出预算时卸载区块。
+         * @param focus 焦点所在区块。
+         * @param keepRadiusXY / keepRadiusZ 保护范围 (区块数)：范围内的区块视为正在使用，永不卸载。
+         * @return 本次卸载的区块数。
+         */
+        size_t update(Map& map, const ChunkCoord& focus, int keepRadiusXY, int keepRadiusZ);
+
+        const Stats& getStats() const { return stats; }
+
+        // 卸载后内存降到预算的该比例以下
+        static constexpr double LOW_WATERMARK = 0.9;
+
+    private:
+        size_t memoryBudget;
+        uint64_t currentTick = 0;
+        // 区块最近一次位于保护范围内的 tick；未记录的区块视为 0 (最旧)
+        std::unordered_map<ChunkCoord, uint64_t, ChunkCoordHash> lastUsed;
+        Stats stats;
+        bool warnedOverBudget = false;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_CHUNKRESIDENCYMANAGER_H
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef TILELANDWORLD_CHUNKSTORE_H
+#define TILELANDWORLD_CHUNKSTORE_H
+
+#include "Coordinates.h"
+#include <memory> // For std::unique_ptr
+#include <vector>
+
+namespace TilelandWorld {
+
+    class Chunk;
+
+    /**
+     * @brief 区块后备存储的抽象基类。
+     *
+     * 被卸载的脏区块写入后备存储；Map 在需要区块时先查询后备存储，
+     * 找不到才调用地形生成器。所有方法都必须是线程安全的：
+     * createChunkIsolated 会在生成线程上 (不持有 mapMutex) 调用 loadChunk。
+     */
+    class ChunkStore {
+    public:
+        virtual ~ChunkStore() = default;
+
+        /**
+         * @brief 读取区块。
+         * @return 存储中有该区块时返回新构造的区块，否则返回 nullptr。
+         * @note 读取失败 (例如数据损坏) 时记录错误并返回 nullptr，调用方会回退到生成器。
+         */
+        virtual std::unique_ptr<Chunk> loadChunk(const ChunkCoord& coord) = 0;
+
+        /**
+         * @brief 写入 (或覆盖) 区块。
+         * @return 成功返回 true；失败时调用方不得丢弃内存中的区块。
+         */
+        virtual bool storeChunk(const Chunk& chunk) = 0;
+
+        virtual bool contains(const ChunkCoord& coord) const = 0;
+
+        // 存储中的全部区块坐标 (用于保存存档时补全未加载的区块)。
+        virtual std::vector<ChunkCoord> storedChunks() const = 0;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_CHUNKSTORE_H
@@ -0,0 +1,211 @@
+#include "ChunkTable.h"
+#include <atomic>
+
+namespace TilelandWorld
+{
+    namespace
+    {
+        // 所有 ChunkTable 共享的 generation 来源，保证不同表 (包括已销毁的表) 的 generation 互不相同
+        std::atomic<uint64_t> nextGeneration{1};
+
+        uint64_t newGeneration()
+        {
+            return nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    ChunkTable::ChunkTable() : generation(newGeneration())
+    {
+    }
+
+    ChunkTable::ChunkTable(ChunkTable &&other) noexcept
+        : control(std::move(other.control)),
+          slots(std::move(other.slots)),
+          count(other.count),
+          mask(other.mask),
+          generation(newGeneration())
+    {
+        other.control.clear();
+        other.slots.clear();
+        other.count = 0;
+        other.mask = 0;
+        other.invalidateLookups();
+    }
+
+    ChunkTable &ChunkTable::operator=(ChunkTable &&other) noexcept
+    {
+        if (this != &other)
+        {
+            control = std::move(other.control);
+            slots = std::move(other.slots);
+            count = other.count;
+            mask = other.mask;
+            invalidateLookups();
+
+            other.control.clear();
+            other.slots.clear();
+            other.count = 0;
+            other.mask = 0;
+            other.invalidateLookups();
+        }
+        return *this;
+    }
+
+    void ChunkTable::invalidateLookups()
+    {
+        generation = newGeneration();
+    }
+
+    size_t ChunkTable::findSlot(const ChunkCoord &coord, uint64_t hash) const
+    {
+        if (control.empty()) return NOT_FOUND;
+
+        const uint8_t tag = controlTag(hash);
+        size_t i = static_cast<size_t>(hash) & mask;
+        // 负载因子 < 1，必然能遇到空槽位而终止
+        while (true)
+        {
+            const uint8_t c = control[i];
+            if (c == EMPTY_SLOT) return NOT_FOUND;
+            if (c == tag && slots[i].first == coord) return i;
+            i = (i + 1) & mask;
+        }
+    }
+
+    Chunk *ChunkTable::findChunkSlow(const ChunkCoord &coord) const
+    {
+        size_t i = findSlot(coord, hashChunkCoord(coord));
+        if (i == NOT_FOUND) return nullptr;
+
+        Chunk *chunk = slots[i].second.get();
+        lastLookup = LastLookup{generation, coord, chunk};
+        return chunk;
+    }
+
+    ChunkTable::iterator ChunkTable::find(const ChunkCoord &coord)
+    {
+        size_t i = findSlot(coord, hashChunkCoord(coord));
+        return i == NOT_FOUND ? end() : iterator(this, i);
+    }
+
+    ChunkTable::const_iterator ChunkTable::find(const ChunkCoord &coord) const
+    {
+        size_t i = findSlot(coord, hashChunkCoord(coord));
+        return i == NOT_FOUND ? end() : const_iterator(this, i);
+    }
+
+    std::pair<ChunkTable::iterator, bool> ChunkTable::emplace(const ChunkCoord &coord, std::unique_ptr<Chunk> chunk)
+    {
+        const uint64_t hash = hashChunkCoord(coord);
+        size_t existing = findSlot(coord, hash);
+        if (existing != NOT_FOUND)
+        {
+            return {iterator(this, existing), false};
+        }
+
+        // 保持负载因子不超过 3/4
+        if ((count + 1) * 4 > control.size() * 3)
+        {
+            rehash(control.empty() ? MIN_CAPACITY : control.size() * 2);
+        }
+
+        size_t i = static_cast<size_t>(hash) & mask;
+        while (control[i] != EMPTY_SLOT)
+        {
+            i = (i + 1) & mask;
+        }
+        control[i] = controlTag(hash);
+        slots[i].first = coord;
+        slots[i].second = std::move(chunk);
+        ++count;
+        return {iterator(this, i), true};
+    }
+
+    void ChunkTable::insertOrAssign(const ChunkCoord &coord, std::unique_ptr<Chunk> chunk)
+    {
+        size_t i = findSlot(coord, hashChunkCoord(coord));
+        if (i == NOT_FOUND)
+        {
+            emplace(coord, std::move(chunk));
+            return;
+        }
+        slots[i].second = std::move(chunk);
+        invalidateLookups();
+    }
+
+    size_t ChunkTable::erase(const ChunkCoord &coord)
+    {
+        size_t hole = findSlot(coord, hashChunkCoord(coord));
+        if (hole == NOT_FOUND) return 0;
+
+        slots[hole].second.reset();
+        --count;
+        invalidateLookups();
+
+        // 后移删除：把探测链上后续元素前移填补空洞，直到遇到空槽位或已在理想位置的元素
+        size_t next = (hole + 1) & mask;
+        while (control[next] != EMPTY_SLOT)
+        {
+            const size_t home = static_cast<size_t>(hashChunkCoord(slots[next].first)) & mask;
+            // next 元素距其理想位置的距离 >= 距空洞的距离时，可移动到空洞
+            if (((next - home) & mask) >= ((next - hole) & mask))
+            {
+                control[hole] = control[next];
+                slots[hole] = std::move(slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+        control[hole] = EMPTY_SLOT;
+        slots[hole].second.reset();
+        return 1;
+    }
+
+    void ChunkTable::clear()
+    {
+        for (size_t i = 0; i < control.size(); ++i)
+        {
+            if (control[i] != EMPTY_SLOT)
+            {
+                slots[i].second.reset();
+                control[i] = EMPTY_SLOT;
+            }
+        }
+        count = 0;
+        invalidateLookups();
+    }
+
+    void ChunkTable::reserve(size_t expectedCount)
+    {
+        size_t needed = MIN_CAPACITY;
+        while (needed * 3 < expectedCount * 4) needed *= 2;
+        if (needed > control.size())
+        {
+            rehash(needed);
+        }
+    }
+
+    void ChunkTable::rehash(size_t newCapacity)
+    {
+        std::vector<uint8_t> oldControl(newCapacity, EMPTY_SLOT);
+        std::vector<value_type> oldSlots(newCapacity);
+        oldControl.swap(control);
+        oldSlots.swap(slots);
+        mask = newCapacity - 1;
+
+        // 区块对象由 unique_ptr 持有，移动槽位不改变 Chunk 地址，查找缓存无需失效
+        for (size_t j = 0; j < oldControl.size(); ++j)
+        {
+            if (oldControl[j] == EMPTY_SLOT) continue;
+            const uint64_t hash = hashChunkCoord(oldSlots[j].first);
+            size_t i = static_cast<size_t>(hash) & mask;
+            while (control[i] != EMPTY_SLOT)
+            {
+                i = (i + 1) & mask;
+            }
+            control[i] = oldControl[j];
+            slots[i] = std::move(oldSlots[j]);
+        }
+    }
+
+} // namespace TilelandWorld
@@ -0,0 +1,158 @@
+#pragma once
+#ifndef TILELANDWORLD_CHUNKTABLE_H
+#define TILELANDWORLD_CHUNKTABLE_H
+
+#include "Chunk.h"
+#include "Coordinates.h"
+#include <vector>
+#include <memory>   // For std::unique_ptr
+#include <utility>  // For std::pair
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 已加载区块表：以 ChunkCoord 为键的扁平开放寻址哈希表。
+     *
+     * - 槽位连续存放在一个数组中，线性探测，容量为 2 的幂，负载因子不超过 3/4；
+     * - 每个槽位配一个控制字节 (0 为空，否则为 0x80 | 哈希高 7 位)，探测时先比较控制字节，
+     *   绝大多数不匹配的槽位无需读取键；
+     * - 删除采用后移 (backward shift)，不留墓碑，长期增删后探测长度不会退化；
+     * - findChunk 带每线程的“上一次命中区块”缓存：同一区块内的连续 Tile 访问只需一次比较。
+     *
+     * 接口与 std::unordered_map 的常用子集保持一致 (find/emplace/erase/begin/end，迭代器解引用为
+     * 带 .first/.second 的 pair)，但插入会使迭代器失效 (Chunk 对象本身的地址始终稳定)。
+     * 不要通过迭代器替换 .second 指向的区块，请使用 insertOrAssign，以便使查找缓存失效。
+     * 与 unordered_map 一样不是线程安全的，调用方需自行加锁 (例如 mapMutex)。
+     */
+    class ChunkTable {
+    public:
+        using key_type = ChunkCoord;
+        using mapped_type = std::unique_ptr<Chunk>;
+        using value_type = std::pair<ChunkCoord, std::unique_ptr<Chunk>>;
+
+        template <bool IsConst>
+        class IteratorBase {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ChunkTable::value_type;
+            using difference_type = std::ptrdiff_t;
+            using TablePtr = std::conditional_t<IsConst, const ChunkTable*, ChunkTable*>;
+            using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+            using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+            IteratorBase() = default;
+            IteratorBase(TablePtr table, size_t index) : table(table), index(index) { skipEmpty(); }
+
+            // 允许 iterator 隐式转换为 const_iterator
+            template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+            IteratorBase(const IteratorBase<OtherConst>& other) : table(other.table), index(other.index) {}
+
+            reference operator*() const { return table->slots[index]; }
+            pointer operator->() const { return &table->slots[index]; }
+
+            IteratorBase& operator++() { ++index; skipEmpty(); return *this; }
+            IteratorBase operator++(int) { IteratorBase tmp = *this; ++(*this); return tmp; }
+
+            bool operator==(const IteratorBase& other) const { return index == other.index && table == other.table; }
+            bool operator!=(const IteratorBase& other) const { return !(*this == other); }
+
+        private:
+            friend class ChunkTable;
+            template <bool> friend class IteratorBase;
+
+            void skipEmpty() {
+                if (!table) return;
+                const size_t cap = table->control.size();
+                while (index < cap && table->control[index] == EMPTY_SLOT) ++index;
+            }
+
+            TablePtr table = nullptr;
+            size_t index = 0;
+        };
+
+        using iterator = IteratorBase<false>;
+        using const_iterator = IteratorBase<true>;
+
+        ChunkTable();
+        ChunkTable(ChunkTable&& other) noexcept;
+        ChunkTable& operator=(ChunkTable&& other) noexcept;
+        ChunkTable(const ChunkTable&) = delete;
+        ChunkTable& operator=(const ChunkTable&) = delete;
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        size_t capacity() const { return control.size(); }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, control.size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, control.size()); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        iterator find(const ChunkCoord& coord);
+        const_iterator find(const ChunkCoord& coord) const;
+        bool contains(const ChunkCoord& coord) const { return findSlot(coord, hashChunkCoord(coord)) != NOT_FOUND; }
+
+        /**
+         * @brief 查找区块指针，未加载返回 nullptr。
+         * @details 热路径接口：先检查本线程上一次命中的区块，命中时不访问哈希表。
+         */
+        Chunk* findChunk(const ChunkCoord& coord) const {
+            const LastLookup& cache = lastLookup;
+            if (cache.generation == generation && cache.coord == coord) {
+                return cache.chunk;
+            }
+            return findChunkSlow(coord);
+        }
+
+        // 插入新区块；键已存在时不插入，返回 {已有位置, false}。
+        std::pair<iterator, bool> emplace(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk);
+
+        // 插入或替换区块 (替换时旧区块被释放，并使所有线程的查找缓存失效)。
+        void insertOrAssign(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk);
+
+        // 移除区块，返回移除的数量 (0 或 1)。
+        size_t erase(const ChunkCoord& coord);
+
+        void clear();
+
+        // 预留至少能容纳 expectedCount 个区块而不触发扩容的容量。
+        void reserve(size_t expectedCount);
+
+    private:
+        static constexpr uint8_t EMPTY_SLOT = 0;
+        static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        // 每线程的“上一次命中”缓存。generation 全局唯一，表被修改 (删除/替换/清空/移动) 或销毁后
+        // 旧的缓存条目不会再与任何表的 generation 相等。只缓存命中，插入不会使缓存失效。
+        // generation 从 1 开始分配，零初始化的缓存不会命中。
+        struct LastLookup {
+            uint64_t generation;
+            ChunkCoord coord;
+            Chunk* chunk;
+        };
+        inline static thread_local LastLookup lastLookup{};
+
+        static uint8_t controlTag(uint64_t hash) { return static_cast<uint8_t>(0x80u | (hash >> 57)); }
+
+        size_t findSlot(const ChunkCoord& coord, uint64_t hash) const;
+        Chunk* findChunkSlow(const ChunkCoord& coord) const;
+        void rehash(size_t newCapacity);
+        void invalidateLookups();
+
+        std::vector<uint8_t> control;    // 每槽位一个控制字节
+        std::vector<value_type> slots;   // 与 control 等长
+        size_t count = 0;
+        size_t mask = 0;                 // capacity - 1
+        uint64_t generation = 0;
+    };
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_CHUNKTABLE_H
@@ -1,5 +1,5 @@
 #include "TuiRenderer.h"
-#include "../TerrainTypes.h"
+#include "../TerrainRegistry.h"
 #include <fmt/format.h>
 #include <fmt/printf.h>
 #include <algorithm>
@@ -76,6 +76,9 @@ void TuiRenderer::drawToConsoleFmt(const ViewState& state, std::shared_ptr<const
 
     std::vector<std::string> frameLines(static_cast<size_t>(state.height));
 
+    // 地形属性、光照颜色与 SGR 前缀均已预计算，循环内只做下标访问
+    const TerrainRegistry& registry = TerrainRegistry::getInstance();
+
     for (int y = 0; y < state.height; ++y)
     {
         fmt::memory_buffer line;
@@ -94,11 +97,11 @@ void TuiRenderer::drawToConsoleFmt(const ViewState& state, std::shared_ptr<const
         for (int x = 0; x < state.width; ++x)
         {
             const Tile& tile = tileBuffer[y * state.width + x];
-            const auto& props = getTerrainProperties(tile.terrain);
+            const auto& props = registry.get(tile.terrain);
 
-            RGBColor mapFg = tile.getForegroundColor();
-            RGBColor mapBg = tile.getBackgroundColor();
-            std::string mapGlyph = props.displayChar.empty() ? " " : props.displayChar;
+            const RGBColor& mapFg = registry.getLitForeground(tile.terrain, tile.lightLevel);
+            const RGBColor& mapBg = registry.getLitBackground(tile.terrain, tile.lightLevel);
+            const std::string& mapGlyph = registry.getGlyph(tile.terrain);
 
             auto emitGlyph = [&](const RGBColor& fg, const RGBColor& bg, const std::string& glyph)
             {
@@ -116,16 +119,30 @@ void TuiRenderer::drawToConsoleFmt(const ViewState& state, std::shared_ptr<const
                 fmt::format_to(std::back_inserter(line), "{}", glyph);
             };
 
+            // 纯地图格子：颜色变化时直接追加预计算的 SGR 前缀
+            auto emitMapGlyph = [&](std::string_view glyph)
+            {
+                if (!colorSet || mapFg.r != lastFg.r || mapFg.g != lastFg.g || mapFg.b != lastFg.b || mapBg.r != lastBg.r || mapBg.g != lastBg.g || mapBg.b != lastBg.b)
+                {
+                    const std::string& prefix = registry.getSgrPrefix(tile.terrain, tile.lightLevel);
+                    line.append(prefix.data(), prefix.data() + prefix.size());
+                    colorSet = true;
+                    lastFg = mapFg;
+                    lastBg = mapBg;
+                }
+                line.append(glyph.data(), glyph.data() + glyph.size());
+            };
+
             if (!props.isVisible)
             {
-                emitGlyph(mapFg, mapBg, "  ");
+                emitMapGlyph("  ");
                 continue;
             }
 
             if (!useOverlay)
             {
-                emitGlyph(mapFg, mapBg, mapGlyph);
-                emitGlyph(mapFg, mapBg, mapGlyph);
+                emitMapGlyph(mapGlyph);
+                emitMapGlyph(mapGlyph);
                 continue;
             }
 
@@ -142,8 +159,8 @@ void TuiRenderer::drawToConsoleFmt(const ViewState& state, std::shared_ptr<const
 
             if (!tileHasOverlay)
             {
-                emitGlyph(mapFg, mapBg, mapGlyph);
-                emitGlyph(mapFg, mapBg, mapGlyph);
+                emitMapGlyph(mapGlyph);
+                emitMapGlyph(mapGlyph);
                 continue;
             }
 
@@ -2,10 +2,12 @@
 #include "../Constants.h"
 #include "../Utils/Logger.h"
 #include "../UI/TuiUtils.h"
+#include "../BinaryFileInfrastructure/ChunkSwapFile.h"
 #include <iostream>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <filesystem>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -26,13 +28,30 @@ namespace TilelandWorld {
         }
     }
 
-    TuiCoreController::TuiCoreController(Map& mapRef, const Settings& cfg) : map(mapRef), settings(cfg) {
+    TuiCoreController::TuiCoreController(Map& mapRef, const Settings& cfg, const std::string& saveName) : map(mapRef), settings(cfg) {
         // 确保地形生成器与存档元数据一致。
         map.setTerrainGenerator(createTerrainGeneratorFromMetadata(map.getWorldMetadata()));
 
+        // 0. 区块驻留：被卸载的脏区块写入交换文件，需在生成线程启动前挂到地图上
+        if (!map.getChunkStore()) {
+            std::string swapPath = (std::filesystem::path(settings.saveDirectory) / ".chunk_swap.tlws").string();
+            try {
+                map.setChunkStore(std::make_shared<ChunkSwapFile>(swapPath));
+            } catch (const std::exception& e) {
+                LOG_WARNING("Chunk swap file unavailable, dirty chunks will stay resident: " + std::string(e.what()));
+            }
+        }
+        residency = std::make_unique<ChunkResidencyManager>(static_cast<size_t>(std::max(0, settings.chunkMemoryBudgetMB)) * 1024 * 1024);
+
         // 1. 初始化通用任务系统
         taskSystem = std::make_unique<TaskSystem>(); // 默认使用 (核心数-1) 个线程
 
+        // 1.5 后台自动保存 (与生成任务共用任务系统)；只写 .tlwz，地图仍从 .tlwf 按需读取时 saveCompressedMap 会同步保留它
+        if (!saveName.empty() && settings.autosaveIntervalSeconds > 0) {
+            autosaver = std::make_unique<BackgroundSaver>(saveName, settings.saveDirectory);
+            lastAutosave = std::chrono::steady_clock::now();
+        }
+
         // 2. 初始化区块生成池，传入任务系统
         generatorPool = std::make_unique<ChunkGeneratorPool>(map, *taskSystem);
 
@@ -58,6 +77,12 @@ namespace TilelandWorld {
         // 1.5 停止输入控制器
         if (inputController) inputController->stop();
         
+        // 1.8 等待进行中的自动保存 (写出在任务系统上进行，快照共享地图的后备存储与存档源)
+        if (autosaver) autosaver->wait();
+
+        // 1.9 丢弃尚未开始的生成请求，在途的区域任务结束后不再续排
+        if (generatorPool) generatorPool->cancelAll();
+
         // 2. 停止任务系统 (确保没有工作线程在访问 generatorPool 或 map)
         if (taskSystem) taskSystem->stop();
         
@@ -93,10 +118,13 @@ namespace TilelandWorld {
 
     void TuiCoreController::markChunkModified(const ChunkCoord& coord) {
         modifiedChunks.insert(coord);
+        // 同步区块的脏标记，卸载时会先写回后备存储；未驻留的区块没有需要写回的内存副本，不为此加载
+        std::lock_guard<std::mutex> lock(mapMutex);
+        if (Chunk* chunk = map.getChunk(coord.cx, coord.cy, coord.cz)) chunk->markDirty();
     }
 
     void TuiCoreController::markChunkModified(int cx, int cy, int cz) {
-        modifiedChunks.insert({cx, cy, cz});
+        markChunkModified(ChunkCoord{cx, cy, cz});
     }
 
     const std::unordered_set<ChunkCoord, ChunkCoordHash>& TuiCoreController::getModifiedChunks() const {
@@ -166,6 +194,12 @@ namespace TilelandWorld {
 
             // 请求预加载
             preloadChunks();
+
+            if (++residencyTickCounter >= RESIDENCY_UPDATE_INTERVAL) {
+                residencyTickCounter = 0;
+                updateResidency();
+                updateAutosave();
+            }
             // --- 逻辑更新结束 ---
 
             // --- TPS 休眠控制 ---
@@ -599,6 +633,22 @@ namespace TilelandWorld {
 
         int preloadRadius = 1;
 
+        // 视图移动后生成池按新视图重新排序，并取消离开保留范围 (预加载范围外再多 1 圈、上下 2 层) 的请求
+        ChunkGeneratorPool::View view;
+        view.minCx = minCx;
+        view.maxCx = maxCx;
+        view.minCy = minCy;
+        view.maxCy = maxCy;
+        view.cz = cz;
+        view.retainRadiusXY = preloadRadius + 1;
+        view.retainRadiusZ = 2;
+        generatorPool->setView(view);
+        for (const ChunkCoord& coord : generatorPool->getCancelledChunks()) {
+            pendingChunks.erase(coord);
+        }
+
+        std::vector<ChunkCoord> requests;
+
         for (int cx = minCx - preloadRadius; cx <= maxCx + preloadRadius; ++cx) {
             for (int cy = minCy - preloadRadius; cy <= maxCy + preloadRadius; ++cy) {
                 for (int zOffset = -1; zOffset <= 1; ++zOffset) {
@@ -616,12 +666,50 @@ namespace TilelandWorld {
                     if (loaded) continue;
 
                     pendingChunks.insert(coord);
-                    generatorPool->requestChunk(cx, cy, targetCz);
+                    requests.push_back(coord);
                 }
             }
         }
+
+        // 生成池按优先级取出，相邻请求合并为区域任务
+        if (!requests.empty()) {
+            generatorPool->requestChunks(requests);
+        }
     }
     
+    void TuiCoreController::updateResidency() {
+        if (!residency) return;
+
+        // 保护范围覆盖 preloadChunks 的请求范围 (视口 + 1 圈，上下各 1 层) 再多留 1 圈，避免刚卸载又被预加载
+        ChunkCoord focus = {
+            floorDiv(viewX + viewWidth / 2, CHUNK_WIDTH),
+            floorDiv(viewY + viewHeight / 2, CHUNK_HEIGHT),
+            floorDiv(currentZ, CHUNK_DEPTH)};
+        int keepRadiusXY = std::max(viewWidth / (2 * CHUNK_WIDTH), viewHeight / (2 * CHUNK_HEIGHT)) + 3;
+        int keepRadiusZ = 2;
+
+        size_t evicted = 0;
+        {
+            std::lock_guard<std::mutex> lock(mapMutex);
+            evicted = residency->update(map, focus, keepRadiusXY, keepRadiusZ);
+        }
+        if (evicted > 0) {
+            const auto& stats = residency->getStats();
+            LOG_INFO("Chunk residency: evicted " + std::to_string(evicted) + " chunks, resident " +
+                     std::to_string(stats.residentChunks) + " (" + std::to_string(stats.residentBytes / 1024) + " KiB).");
+        }
+    }
+
+    void TuiCoreController::updateAutosave() {
+        if (!autosaver) return;
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastAutosave < std::chrono::seconds(settings.autosaveIntervalSeconds)) return;
+        if (autosaver->isSaving()) return; // 上一次仍在写出，下次检查时再试
+
+        std::lock_guard<std::mutex> lock(mapMutex);
+        if (autosaver->schedule(map, *taskSystem)) lastAutosave = now;
+    }
+
     void TuiCoreController::setupConsole() {
         #ifdef _WIN32
         HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -3,6 +3,7 @@
 #define TILELANDWORLD_TUICHUNKCONTROLLER_H
 
 #include "../Map.h"
+#include "../ChunkResidencyManager.h"
 #include "../Coordinates.h"
 #include "TuiRenderer.h" 
 #include "InputController.h"
@@ -10,19 +11,22 @@
 #include "../MapGenInfrastructure/ChunkGeneratorPool.h"
 #include "../MapGenInfrastructure/TerrainGeneratorFactory.h"
 #include "../Utils/TaskSystem.h" // 引入 TaskSystem
+#include "../BinaryFileInfrastructure/BackgroundSaver.h"
 #include <unordered_set>
 #include <string>
 #include <mutex> 
 #include <memory>
 #include <vector>
 #include <functional>
+#include <chrono>
 #include <windows.h> // 引入 QueryPerformanceCounter
 
 namespace TilelandWorld {
 
     class TuiCoreController {
     public:
-        explicit TuiCoreController(Map& map, const Settings& settings);
+        // saveName 非空时按 settings.autosaveIntervalSeconds 在后台自动保存到该存档 (settings.saveDirectory 下)
+        explicit TuiCoreController(Map& map, const Settings& settings, const std::string& saveName = "");
         ~TuiCoreController();
 
         // 1. 初始化 TUI 环境
@@ -52,6 +56,11 @@ namespace TilelandWorld {
         std::unique_ptr<ChunkGeneratorPool> generatorPool; // 区块生成管理器
         std::unique_ptr<TuiRenderer> renderer; // 渲染器
         std::unique_ptr<InputController> inputController; // 输入控制器
+        std::unique_ptr<ChunkResidencyManager> residency; // 区块驻留管理 (内存预算)
+        int residencyTickCounter = 0;
+        // 后台自动保存 (未指定存档名或间隔为 0 时为空)
+        std::unique_ptr<BackgroundSaver> autosaver;
+        std::chrono::steady_clock::time_point lastAutosave;
 
         // 视图状态
         int viewX = 0;
@@ -113,6 +122,11 @@ namespace TilelandWorld {
         
         // 2. 预加载逻辑
         void preloadChunks();
+        // 按内存预算卸载远离视口的区块 (每 RESIDENCY_UPDATE_INTERVAL 个 tick 一次)
+        void updateResidency();
+        static constexpr int RESIDENCY_UPDATE_INTERVAL = 30;
+        // 到达自动保存间隔时在持锁期间创建快照，写出在任务系统上进行；上一次尚未完成时顺延
+        void updateAutosave();
         
         // 控制台辅助方法
         void setupConsole();
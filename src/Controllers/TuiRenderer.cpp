@@ -1,5 +1,5 @@
 #include "TuiRenderer.h"
-#include "../TerrainTypes.h"
+#include "../TerrainRegistry.h"
 #include "../Utils/Logger.h"
 #include <iostream>
 #include <sstream>
@@ -355,24 +355,10 @@ namespace TilelandWorld
         }
 
         // *** 关键：锁定 Map，快速复制 ***
+        // 按区块整行复制，锁持有时间只与相交区块数有关；未加载区块显示为虚空
         std::lock_guard<std::mutex> lock(mapMutex);
-
-        for (int y = 0; y < state.height; ++y)
-        {
-            for (int x = 0; x < state.width; ++x)
-            {
-                int wx = state.viewX + x;
-                int wy = state.viewY + y;
-                try
-                {
-                    tileBuffer[y * state.width + x] = map.getTile(wx, wy, state.currentZ);
-                }
-                catch (...)
-                {
-                    tileBuffer[y * state.width + x] = Tile(TerrainType::VOIDBLOCK);
-                }
-            }
-        }
+        map.readLayer(state.viewX, state.viewY, state.currentZ, state.width, state.height,
+                      tileBuffer.data(), Tile(TerrainType::VOIDBLOCK));
     }
 
     void TuiRenderer::drawToConsole(const ViewState &state, std::shared_ptr<const UI::TuiSurface> overlay, double overlayAlpha)
@@ -403,6 +389,9 @@ namespace TilelandWorld
 
         std::vector<std::string> frameLines(static_cast<size_t>(state.height));
 
+        // 地形属性、光照颜色与 SGR 前缀均已预计算，循环内只做下标访问
+        const TerrainRegistry &registry = TerrainRegistry::getInstance();
+
         for (int y = 0; y < state.height; ++y)
         {
             std::string line;
@@ -425,11 +414,11 @@ namespace TilelandWorld
             for (int x = 0; x < state.width; ++x)
             {
                 const Tile &tile = tileBuffer[y * state.width + x];
-                const auto &props = getTerrainProperties(tile.terrain);
+                const auto &props = registry.get(tile.terrain);
 
-                RGBColor mapFg = tile.getForegroundColor();
-                RGBColor mapBg = tile.getBackgroundColor();
-                std::string mapGlyph = props.displayChar.empty() ? " " : props.displayChar;
+                const RGBColor &mapFg = registry.getLitForeground(tile.terrain, tile.lightLevel);
+                const RGBColor &mapBg = registry.getLitBackground(tile.terrain, tile.lightLevel);
+                const std::string &mapGlyph = registry.getGlyph(tile.terrain);
 
                 auto emitGlyph = [&](const RGBColor &fg, const RGBColor &bg, const std::string &glyph)
                 {
@@ -455,16 +444,29 @@ namespace TilelandWorld
                     line.append(glyph);
                 };
 
+                // 纯地图格子：颜色变化时直接追加预计算的 SGR 前缀
+                auto emitMapGlyph = [&](const std::string &glyph)
+                {
+                    if (!colorSet || mapFg.r != lastFg.r || mapFg.g != lastFg.g || mapFg.b != lastFg.b || mapBg.r != lastBg.r || mapBg.g != lastBg.g || mapBg.b != lastBg.b)
+                    {
+                        line.append(registry.getSgrPrefix(tile.terrain, tile.lightLevel));
+                        colorSet = true;
+                        lastFg = mapFg;
+                        lastBg = mapBg;
+                    }
+                    line.append(glyph);
+                };
+
                 if (!props.isVisible)
                 {
-                    emitGlyph(mapFg, mapBg, "  ");
+                    emitMapGlyph("  ");
                     continue;
                 }
 
                 if (!useOverlay)
                 {
-                    emitGlyph(mapFg, mapBg, mapGlyph);
-                    emitGlyph(mapFg, mapBg, mapGlyph);
+                    emitMapGlyph(mapGlyph);
+                    emitMapGlyph(mapGlyph);
                     continue;
                 }
 
@@ -482,8 +484,8 @@ namespace TilelandWorld
 
                 if (!tileHasOverlay)
                 {
-                    emitGlyph(mapFg, mapBg, mapGlyph);
-                    emitGlyph(mapFg, mapBg, mapGlyph);
+                    emitMapGlyph(mapGlyph);
+                    emitMapGlyph(mapGlyph);
                     continue;
                 }
 
@@ -657,23 +659,12 @@ namespace TilelandWorld
     // 原始的生成逻辑，仅在缓存未命中时调用
     std::string TuiRenderer::generateTileString(const Tile &tile)
     {
-        const auto &props = getTerrainProperties(tile.terrain);
-        if (!props.isVisible)
+        const TerrainRegistry &registry = TerrainRegistry::getInstance();
+        if (!registry.get(tile.terrain).isVisible)
             return "  ";
 
-        RGBColor fg = tile.getForegroundColor();
-        RGBColor bg = tile.getBackgroundColor();
-
-        // 手动拼接，虽然这里慢一点，但只执行一次
-        std::string res;
-        res.reserve(40);
-        res += "\x1b[48;2;";
-        res += std::to_string(bg.r) + ";" + std::to_string(bg.g) + ";" + std::to_string(bg.b) + "m";
-        res += "\x1b[38;2;";
-        res += std::to_string(fg.r) + ";" + std::to_string(fg.g) + ";" + std::to_string(fg.b) + "m";
-        res += props.displayChar + props.displayChar;
-
-        return res;
+        const std::string &glyph = registry.getGlyph(tile.terrain);
+        return registry.getSgrPrefix(tile.terrain, tile.lightLevel) + glyph + glyph;
     }
 
 }
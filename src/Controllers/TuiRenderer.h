@@ -76,7 +76,7 @@ namespace TilelandWorld {
         std::atomic<double> targetFpsCap{360.0};
         std::atomic<bool> useFmtBackend{false};
 
-        // 渲染缓冲区 (本地副本)
+        // 渲染缓冲区 (本地副本，每个 Tile 仅 4 字节，复制循环与后续扫描均更省缓存)
         std::vector<Tile> tileBuffer;
         
         // --- 优化：渲染缓存 ---
@@ -4,6 +4,7 @@
 
 #include <functional> // For std::hash
 #include <cmath>      // For std::floor
+#include <cstdint>    // For uint64_t
 
 namespace TilelandWorld {
 
@@ -29,15 +30,30 @@ namespace TilelandWorld {
         }
     };
 
-    // 为 ChunkCoord 提供哈希函数，以便用于 std::unordered_map
+    /**
+     * @brief ChunkCoord 的 64 位哈希。
+     * @details 三个分量分别乘以不同的奇数常量后合并，再经 splitmix64 的终结混合，
+     *          相邻坐标 (只差 1) 的哈希值在所有位上都充分扩散。
+     *          旧实现 h1 ^ (h2 << 1) ^ (h3 << 2) 在恒等整数哈希下，
+     *          (x, y, z) 与 (x ^ 2, y ^ 1, z) 等相邻坐标大量碰撞。
+     */
+    inline uint64_t hashChunkCoord(const ChunkCoord& c) {
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(c.cx)) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(c.cy)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(c.cz)) * 0x165667B19E3779F9ull;
+        // splitmix64 finalizer
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    // 为 ChunkCoord 提供哈希函数，以便用于 std::unordered_map / unordered_set
     struct ChunkCoordHash {
         std::size_t operator()(const ChunkCoord& c) const {
-            // 一个简单的组合哈希函数
-            std::size_t h1 = std::hash<int>{}(c.cx);
-            std::size_t h2 = std::hash<int>{}(c.cy);
-            std::size_t h3 = std::hash<int>{}(c.cz);
-            // 使用位移和异或组合哈希值，减少碰撞概率
-            return h1 ^ (h2 << 1) ^ (h3 << 2);
+            return static_cast<std::size_t>(hashChunkCoord(c));
         }
     };
 
@@ -1,5 +1,6 @@
 #include "ImageAsset.h"
 #include "YuiLayer.h"
+#include "../BinaryFileInfrastructure/BinaryReader.h"
 #include <fstream>
 #include <iostream>
 
@@ -58,44 +59,49 @@ namespace TilelandWorld {
     }
 
     ImageAsset ImageAsset::load(const std::string& path) {
-        std::ifstream in(path, std::ios::binary);
-        if (!in) return ImageAsset(0, 0);
+        std::unique_ptr<BinaryReader> reader;
+        try {
+            reader = std::make_unique<BinaryReader>(path);
+        } catch (const std::exception&) {
+            return ImageAsset(0, 0);
+        }
+        BinaryReader& in = *reader;
 
         char magic[5];
-        in.read(magic, 5);
+        in.readBytes(magic, 5);
         if (std::string(magic, 5) != "TLIMG") return ImageAsset(0, 0);
 
         uint16_t ver;
-        in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+        in.readBytes(reinterpret_cast<char*>(&ver), sizeof(ver));
         if (ver == 2 || ver == 3) {
-            in.close();
+            reader.reset();
             YuiLayeredImage layered = YuiLayeredImage::load(path);
             return layered.flatten();
         }
         if (ver != 1) return ImageAsset(0, 0);
 
         uint16_t w, h;
-        in.read(reinterpret_cast<char*>(&w), sizeof(w));
-        in.read(reinterpret_cast<char*>(&h), sizeof(h));
+        in.readBytes(reinterpret_cast<char*>(&w), sizeof(w));
+        in.readBytes(reinterpret_cast<char*>(&h), sizeof(h));
 
         ImageAsset asset(w, h);
         for (int i = 0; i < w * h; ++i) {
             uint8_t len;
-            in.read(reinterpret_cast<char*>(&len), sizeof(len));
+            in.readBytes(reinterpret_cast<char*>(&len), sizeof(len));
             
             std::string ch;
             if (len > 0) {
                 ch.resize(len);
-                in.read(&ch[0], len);
+                in.readBytes(&ch[0], len);
             }
 
             RGBColor fg, bg;
-            in.read(reinterpret_cast<char*>(&fg.r), 1);
-            in.read(reinterpret_cast<char*>(&fg.g), 1);
-            in.read(reinterpret_cast<char*>(&fg.b), 1);
-            in.read(reinterpret_cast<char*>(&bg.r), 1);
-            in.read(reinterpret_cast<char*>(&bg.g), 1);
-            in.read(reinterpret_cast<char*>(&bg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.b), 1);
 
             ImageCell cell;
             cell.character = ch;
@@ -1,4 +1,5 @@
 #include "YuiLayer.h"
+#include "../BinaryFileInfrastructure/BinaryReader.h"
 #include <fstream>
 #include <algorithm>
 #include <array>
@@ -10,6 +11,15 @@
 namespace TilelandWorld {
 
 namespace {
+    // TLIMG 读取走 BinaryReader (优先内存映射)；打开失败返回 nullptr
+    std::unique_ptr<BinaryReader> openTlimgReader(const std::string& path) {
+        try {
+            return std::make_unique<BinaryReader>(path);
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
     constexpr int kMaskSize = 8; // 8x8 subcells
     struct GlyphMask {
         std::array<uint8_t, kMaskSize * kMaskSize> data{};
@@ -593,47 +603,48 @@ YuiImageMetadata YuiLayeredImage::calculateMetadata() const {
 }
 
 ImageAsset YuiLayeredImage::loadPreview(const std::string& path) {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) return ImageAsset(0, 0);
+    auto reader = openTlimgReader(path);
+    if (!reader) return ImageAsset(0, 0);
+    BinaryReader& in = *reader;
 
     char magic[5] = {0};
-    in.read(magic, 5);
+    in.readBytes(magic, 5);
     if (std::string(magic, 5) != "TLIMG") return ImageAsset(0, 0);
 
     uint16_t ver = 0;
-    in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+    in.readBytes(reinterpret_cast<char*>(&ver), sizeof(ver));
 
     if (ver == 4) {
-        in.seekg(8, std::ios::cur); // skip statsOffset
+        in.seek(8, std::ios::cur); // skip statsOffset
         uint64_t previewOffset = 0;
-        in.read(reinterpret_cast<char*>(&previewOffset), 8);
+        in.readBytes(reinterpret_cast<char*>(&previewOffset), 8);
         if (previewOffset == 0) return ImageAsset(0, 0);
 
-        in.seekg(previewOffset);
+        in.seek(previewOffset);
         uint16_t pw = 0, ph = 0;
-        in.read(reinterpret_cast<char*>(&pw), 2);
-        in.read(reinterpret_cast<char*>(&ph), 2);
+        in.readBytes(reinterpret_cast<char*>(&pw), 2);
+        in.readBytes(reinterpret_cast<char*>(&ph), 2);
         if (pw == 0 || ph == 0) return ImageAsset(0, 0);
 
         ImageAsset preview(pw, ph);
         for (int i = 0; i < pw * ph; ++i) {
             uint8_t len = 0;
-            in.read(reinterpret_cast<char*>(&len), 1);
+            in.readBytes(reinterpret_cast<char*>(&len), 1);
             std::string ch;
             if (len > 0) {
                 ch.resize(len);
-                in.read(&ch[0], len);
+                in.readBytes(&ch[0], len);
             }
             RGBColor fg{}, bg{};
             uint8_t fgA = 255, bgA = 255;
-            in.read(reinterpret_cast<char*>(&fg.r), 1);
-            in.read(reinterpret_cast<char*>(&fg.g), 1);
-            in.read(reinterpret_cast<char*>(&fg.b), 1);
-            in.read(reinterpret_cast<char*>(&fgA), 1);
-            in.read(reinterpret_cast<char*>(&bg.r), 1);
-            in.read(reinterpret_cast<char*>(&bg.g), 1);
-            in.read(reinterpret_cast<char*>(&bg.b), 1);
-            in.read(reinterpret_cast<char*>(&bgA), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&fgA), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&bgA), 1);
 
             ImageCell cell{ch, fg, bg, fgA, bgA};
             preview.setCell(i % pw, i / pw, cell);
@@ -644,62 +655,62 @@ ImageAsset YuiLayeredImage::loadPreview(const std::string& path) {
     if (ver < 3) return ImageAsset(0, 0);
 
     uint16_t w = 0, h = 0;
-    in.read(reinterpret_cast<char*>(&w), sizeof(w));
-    in.read(reinterpret_cast<char*>(&h), sizeof(h));
+    in.readBytes(reinterpret_cast<char*>(&w), sizeof(w));
+    in.readBytes(reinterpret_cast<char*>(&h), sizeof(h));
 
     uint16_t layerCount = 0;
-    in.read(reinterpret_cast<char*>(&layerCount), sizeof(layerCount));
+    in.readBytes(reinterpret_cast<char*>(&layerCount), sizeof(layerCount));
 
     // Skip layers
     for (uint16_t li = 0; li < layerCount; ++li) {
         uint16_t layerIndex = 0;
-        in.read(reinterpret_cast<char*>(&layerIndex), sizeof(layerIndex));
+        in.readBytes(reinterpret_cast<char*>(&layerIndex), sizeof(layerIndex));
         uint8_t nameLen = 0;
-        in.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
-        if (nameLen > 0) in.seekg(nameLen, std::ios::cur);
-        in.seekg(2, std::ios::cur); // opacity, visible
+        in.readBytes(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        if (nameLen > 0) in.seek(nameLen, std::ios::cur);
+        in.seek(2, std::ios::cur); // opacity, visible
 
         for (int i = 0; i < w * h; ++i) {
             uint8_t len = 0;
-            in.read(reinterpret_cast<char*>(&len), sizeof(len));
-            if (len > 0) in.seekg(len, std::ios::cur);
-            in.seekg(8, std::ios::cur); // fgRGBA, bgRGBA
+            in.readBytes(reinterpret_cast<char*>(&len), sizeof(len));
+            if (len > 0) in.seek(len, std::ios::cur);
+            in.seek(8, std::ios::cur); // fgRGBA, bgRGBA
         }
     }
 
     // Read Preview block
     uint16_t previewIdx = 0;
-    in.read(reinterpret_cast<char*>(&previewIdx), sizeof(previewIdx));
+    in.readBytes(reinterpret_cast<char*>(&previewIdx), sizeof(previewIdx));
     uint8_t pNameLen = 0;
-    in.read(reinterpret_cast<char*>(&pNameLen), sizeof(pNameLen));
-    if (pNameLen > 0) in.seekg(pNameLen, std::ios::cur);
-    in.seekg(2, std::ios::cur); // opacity, visible
+    in.readBytes(reinterpret_cast<char*>(&pNameLen), sizeof(pNameLen));
+    if (pNameLen > 0) in.seek(pNameLen, std::ios::cur);
+    in.seek(2, std::ios::cur); // opacity, visible
 
     uint16_t pw = 0, ph = 0;
-    in.read(reinterpret_cast<char*>(&pw), sizeof(pw));
-    in.read(reinterpret_cast<char*>(&ph), sizeof(ph));
+    in.readBytes(reinterpret_cast<char*>(&pw), sizeof(pw));
+    in.readBytes(reinterpret_cast<char*>(&ph), sizeof(ph));
 
     if (pw == 0 || ph == 0) return ImageAsset(0, 0);
 
     ImageAsset preview(pw, ph);
     for (int i = 0; i < pw * ph; ++i) {
         uint8_t len = 0;
-        in.read(reinterpret_cast<char*>(&len), sizeof(len));
+        in.readBytes(reinterpret_cast<char*>(&len), sizeof(len));
         std::string ch;
         if (len > 0) {
             ch.resize(len);
-            in.read(&ch[0], len);
+            in.readBytes(&ch[0], len);
         }
         RGBColor fg{}, bg{};
         uint8_t fgA = 255, bgA = 255;
-        in.read(reinterpret_cast<char*>(&fg.r), 1);
-        in.read(reinterpret_cast<char*>(&fg.g), 1);
-        in.read(reinterpret_cast<char*>(&fg.b), 1);
-        in.read(reinterpret_cast<char*>(&fgA), 1);
-        in.read(reinterpret_cast<char*>(&bg.r), 1);
-        in.read(reinterpret_cast<char*>(&bg.g), 1);
-        in.read(reinterpret_cast<char*>(&bg.b), 1);
-        in.read(reinterpret_cast<char*>(&bgA), 1);
+        in.readBytes(reinterpret_cast<char*>(&fg.r), 1);
+        in.readBytes(reinterpret_cast<char*>(&fg.g), 1);
+        in.readBytes(reinterpret_cast<char*>(&fg.b), 1);
+        in.readBytes(reinterpret_cast<char*>(&fgA), 1);
+        in.readBytes(reinterpret_cast<char*>(&bg.r), 1);
+        in.readBytes(reinterpret_cast<char*>(&bg.g), 1);
+        in.readBytes(reinterpret_cast<char*>(&bg.b), 1);
+        in.readBytes(reinterpret_cast<char*>(&bgA), 1);
 
         ImageCell cell;
         cell.character = ch;
@@ -712,43 +723,44 @@ ImageAsset YuiLayeredImage::loadPreview(const std::string& path) {
 }
 
 YuiImageMetadata YuiLayeredImage::loadImageMetadata(const std::string& path) {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) return {};
+    auto reader = openTlimgReader(path);
+    if (!reader) return {};
+    BinaryReader& in = *reader;
 
     char magic[5] = {0};
-    in.read(magic, 5);
+    in.readBytes(magic, 5);
     if (std::string(magic, 5) != "TLIMG") return {};
 
     uint16_t ver = 0;
-    in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+    in.readBytes(reinterpret_cast<char*>(&ver), sizeof(ver));
 
     if (ver == 4) {
         uint64_t statsOffset = 0;
-        in.read(reinterpret_cast<char*>(&statsOffset), 8);
+        in.readBytes(reinterpret_cast<char*>(&statsOffset), 8);
         if (statsOffset == 0) return {};
 
-        in.seekg(statsOffset);
+        in.seek(statsOffset);
         YuiImageMetadata stats;
-        in.read(reinterpret_cast<char*>(&stats.width), 4);
-        in.read(reinterpret_cast<char*>(&stats.height), 4);
-        in.read(reinterpret_cast<char*>(&stats.uniqueGlyphs), 4);
-        in.read(reinterpret_cast<char*>(&stats.uniqueColors), 4);
+        in.readBytes(reinterpret_cast<char*>(&stats.width), 4);
+        in.readBytes(reinterpret_cast<char*>(&stats.height), 4);
+        in.readBytes(reinterpret_cast<char*>(&stats.uniqueGlyphs), 4);
+        in.readBytes(reinterpret_cast<char*>(&stats.uniqueColors), 4);
         uint16_t topCount = 0;
-        in.read(reinterpret_cast<char*>(&topCount), 2);
+        in.readBytes(reinterpret_cast<char*>(&topCount), 2);
         for (int i = 0; i < topCount; ++i) {
             uint8_t gl = 0;
-            in.read(reinterpret_cast<char*>(&gl), 1);
+            in.readBytes(reinterpret_cast<char*>(&gl), 1);
             std::string s(gl, ' ');
-            if (gl > 0) in.read(&s[0], gl);
+            if (gl > 0) in.readBytes(&s[0], gl);
             int count = 0;
-            in.read(reinterpret_cast<char*>(&count), 4);
+            in.readBytes(reinterpret_cast<char*>(&count), 4);
             stats.topGlyphs.push_back({s, count});
         }
         return stats;
     }
 
     // Older versions: Load and calculate
-    in.close();
+    reader.reset();
     YuiLayeredImage layered = load(path);
     if (layered.getWidth() == 0) return {};
     return layered.calculateMetadata();
@@ -766,73 +778,74 @@ YuiLayeredImage YuiLayeredImage::fromImageAsset(const ImageAsset& asset) {
 }
 
 YuiLayeredImage YuiLayeredImage::load(const std::string& path) {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) return YuiLayeredImage(0, 0);
+    auto reader = openTlimgReader(path);
+    if (!reader) return YuiLayeredImage(0, 0);
+    BinaryReader& in = *reader;
 
     char magic[5] = {0};
-    in.read(magic, 5);
+    in.readBytes(magic, 5);
     if (std::string(magic, 5) != "TLIMG") return YuiLayeredImage(0, 0);
 
     uint16_t ver = 0;
-    in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+    in.readBytes(reinterpret_cast<char*>(&ver), sizeof(ver));
 
     if (ver == 4) {
         uint64_t statsOffset = 0, previewOffset = 0;
         uint16_t layerCount = 0;
-        in.read(reinterpret_cast<char*>(&statsOffset), 8);
-        in.read(reinterpret_cast<char*>(&previewOffset), 8);
-        in.read(reinterpret_cast<char*>(&layerCount), 2);
+        in.readBytes(reinterpret_cast<char*>(&statsOffset), 8);
+        in.readBytes(reinterpret_cast<char*>(&previewOffset), 8);
+        in.readBytes(reinterpret_cast<char*>(&layerCount), 2);
 
         std::vector<uint64_t> metaOffsets(layerCount);
         std::vector<uint64_t> dataOffsets(layerCount);
-        for (int i = 0; i < layerCount; ++i) in.read(reinterpret_cast<char*>(&metaOffsets[i]), 8);
-        for (int i = 0; i < layerCount; ++i) in.read(reinterpret_cast<char*>(&dataOffsets[i]), 8);
+        for (int i = 0; i < layerCount; ++i) in.readBytes(reinterpret_cast<char*>(&metaOffsets[i]), 8);
+        for (int i = 0; i < layerCount; ++i) in.readBytes(reinterpret_cast<char*>(&dataOffsets[i]), 8);
 
         // Read Width/Height from stats block
-        in.seekg(statsOffset);
+        in.seek(statsOffset);
         int w = 0, h = 0;
-        in.read(reinterpret_cast<char*>(&w), 4);
-        in.read(reinterpret_cast<char*>(&h), 4);
+        in.readBytes(reinterpret_cast<char*>(&w), 4);
+        in.readBytes(reinterpret_cast<char*>(&h), 4);
 
         YuiLayeredImage layered(w, h);
         layered.layers.clear();
         layered.layers.resize(layerCount);
 
         for (int i = 0; i < layerCount; ++i) {
-            in.seekg(metaOffsets[i]);
+            in.seek(metaOffsets[i]);
             uint16_t idx = 0;
-            in.read(reinterpret_cast<char*>(&idx), 2);
+            in.readBytes(reinterpret_cast<char*>(&idx), 2);
             uint8_t nameLen = 0;
-            in.read(reinterpret_cast<char*>(&nameLen), 1);
+            in.readBytes(reinterpret_cast<char*>(&nameLen), 1);
             std::string name(nameLen, ' ');
-            if (nameLen > 0) in.read(&name[0], nameLen);
+            if (nameLen > 0) in.readBytes(&name[0], nameLen);
             uint8_t opacity = 255, visible = 1;
-            in.read(reinterpret_cast<char*>(&opacity), 1);
-            in.read(reinterpret_cast<char*>(&visible), 1);
+            in.readBytes(reinterpret_cast<char*>(&opacity), 1);
+            in.readBytes(reinterpret_cast<char*>(&visible), 1);
 
             YuiLayer layer(w, h, name);
             layer.setOpacity(opacity / 255.0);
             layer.setVisible(visible != 0);
 
-            in.seekg(dataOffsets[i]);
+            in.seek(dataOffsets[i]);
             for (int cellIdx = 0; cellIdx < w * h; ++cellIdx) {
                 uint8_t len = 0;
-                in.read(reinterpret_cast<char*>(&len), 1);
+                in.readBytes(reinterpret_cast<char*>(&len), 1);
                 std::string ch;
                 if (len > 0) {
                     ch.resize(len);
-                    in.read(&ch[0], len);
+                    in.readBytes(&ch[0], len);
                 }
                 RGBColor fg{}, bg{};
                 uint8_t fgA = 255, bgA = 255;
-                in.read(reinterpret_cast<char*>(&fg.r), 1);
-                in.read(reinterpret_cast<char*>(&fg.g), 1);
-                in.read(reinterpret_cast<char*>(&fg.b), 1);
-                in.read(reinterpret_cast<char*>(&fgA), 1);
-                in.read(reinterpret_cast<char*>(&bg.r), 1);
-                in.read(reinterpret_cast<char*>(&bg.g), 1);
-                in.read(reinterpret_cast<char*>(&bg.b), 1);
-                in.read(reinterpret_cast<char*>(&bgA), 1);
+                in.readBytes(reinterpret_cast<char*>(&fg.r), 1);
+                in.readBytes(reinterpret_cast<char*>(&fg.g), 1);
+                in.readBytes(reinterpret_cast<char*>(&fg.b), 1);
+                in.readBytes(reinterpret_cast<char*>(&fgA), 1);
+                in.readBytes(reinterpret_cast<char*>(&bg.r), 1);
+                in.readBytes(reinterpret_cast<char*>(&bg.g), 1);
+                in.readBytes(reinterpret_cast<char*>(&bg.b), 1);
+                in.readBytes(reinterpret_cast<char*>(&bgA), 1);
 
                 ImageCell cell{ch, fg, bg, fgA, bgA};
                 layer.setCell(cellIdx % w, cellIdx / w, cell);
@@ -844,26 +857,26 @@ YuiLayeredImage YuiLayeredImage::load(const std::string& path) {
     }
 
     uint16_t w = 0, h = 0;
-    in.read(reinterpret_cast<char*>(&w), sizeof(w));
-    in.read(reinterpret_cast<char*>(&h), sizeof(h));
+    in.readBytes(reinterpret_cast<char*>(&w), sizeof(w));
+    in.readBytes(reinterpret_cast<char*>(&h), sizeof(h));
 
     if (ver == 1) {
         ImageAsset flat(w, h);
         for (int i = 0; i < w * h; ++i) {
             uint8_t len = 0;
-            in.read(reinterpret_cast<char*>(&len), sizeof(len));
+            in.readBytes(reinterpret_cast<char*>(&len), sizeof(len));
             std::string ch;
             if (len > 0) {
                 ch.resize(len);
-                in.read(&ch[0], len);
+                in.readBytes(&ch[0], len);
             }
             RGBColor fg{}, bg{};
-            in.read(reinterpret_cast<char*>(&fg.r), 1);
-            in.read(reinterpret_cast<char*>(&fg.g), 1);
-            in.read(reinterpret_cast<char*>(&fg.b), 1);
-            in.read(reinterpret_cast<char*>(&bg.r), 1);
-            in.read(reinterpret_cast<char*>(&bg.g), 1);
-            in.read(reinterpret_cast<char*>(&bg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.b), 1);
             ImageCell cell;
             cell.character = ch;
             cell.fg = fg;
@@ -878,7 +891,7 @@ YuiLayeredImage YuiLayeredImage::load(const std::string& path) {
     if (ver != 2 && ver != 3) return YuiLayeredImage(0, 0);
 
     uint16_t layerCount = 0;
-    in.read(reinterpret_cast<char*>(&layerCount), sizeof(layerCount));
+    in.readBytes(reinterpret_cast<char*>(&layerCount), sizeof(layerCount));
 
     YuiLayeredImage layered(w, h);
     layered.layers.clear();
@@ -886,18 +899,18 @@ YuiLayeredImage YuiLayeredImage::load(const std::string& path) {
 
     for (uint16_t li = 0; li < layerCount; ++li) {
         uint16_t layerIndex = 0;
-        in.read(reinterpret_cast<char*>(&layerIndex), sizeof(layerIndex));
+        in.readBytes(reinterpret_cast<char*>(&layerIndex), sizeof(layerIndex));
         uint8_t nameLen = 0;
-        in.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        in.readBytes(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
         std::string name = "Layer";
         if (nameLen > 0) {
             name.resize(nameLen);
-            in.read(&name[0], nameLen);
+            in.readBytes(&name[0], nameLen);
         }
         uint8_t opacityByte = 255;
         uint8_t visibleByte = 1;
-        in.read(reinterpret_cast<char*>(&opacityByte), sizeof(opacityByte));
-        in.read(reinterpret_cast<char*>(&visibleByte), sizeof(visibleByte));
+        in.readBytes(reinterpret_cast<char*>(&opacityByte), sizeof(opacityByte));
+        in.readBytes(reinterpret_cast<char*>(&visibleByte), sizeof(visibleByte));
 
         YuiLayer layer(w, h, name);
         layer.setOpacity(opacityByte / 255.0);
@@ -905,22 +918,22 @@ YuiLayeredImage YuiLayeredImage::load(const std::string& path) {
 
         for (int i = 0; i < w * h; ++i) {
             uint8_t len = 0;
-            in.read(reinterpret_cast<char*>(&len), sizeof(len));
+            in.readBytes(reinterpret_cast<char*>(&len), sizeof(len));
             std::string ch;
             if (len > 0) {
                 ch.resize(len);
-                in.read(&ch[0], len);
+                in.readBytes(&ch[0], len);
             }
             RGBColor fg{}, bg{};
             uint8_t fgA = 255, bgA = 255;
-            in.read(reinterpret_cast<char*>(&fg.r), 1);
-            in.read(reinterpret_cast<char*>(&fg.g), 1);
-            in.read(reinterpret_cast<char*>(&fg.b), 1);
-            in.read(reinterpret_cast<char*>(&fgA), 1);
-            in.read(reinterpret_cast<char*>(&bg.r), 1);
-            in.read(reinterpret_cast<char*>(&bg.g), 1);
-            in.read(reinterpret_cast<char*>(&bg.b), 1);
-            in.read(reinterpret_cast<char*>(&bgA), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&fg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&fgA), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.r), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.g), 1);
+            in.readBytes(reinterpret_cast<char*>(&bg.b), 1);
+            in.readBytes(reinterpret_cast<char*>(&bgA), 1);
 
             ImageCell cell;
             cell.character = ch;
@@ -1,9 +1,11 @@
 #include "Map.h"
 #include "Constants.h"
 #include "MapGenInfrastructure/FlatTerrainGenerator.h"
+#include "BinaryFileInfrastructure/LazyChunkFile.h"
 #include "Utils/Logger.h" // <-- 包含 Logger
 #include <stdexcept>      // For exceptions
 #include <utility>        // For std::move
+#include <algorithm>      // For std::min, std::max, std::fill
 
 #ifdef _WIN32
 #include <windows.h> // For QueryPerformanceCounter
@@ -15,6 +17,8 @@ namespace TilelandWorld
     // 修改构造函数实现
     Map::Map(std::unique_ptr<TerrainGenerator> generator)
     {
+        // 默认元数据与生成器保持一致（Flat 默认值）。
+        worldMetadata = WorldMetadata{};
         if (generator)
         {
             terrainGenerator = std::move(generator);
@@ -23,9 +27,9 @@ namespace TilelandWorld
         {
             // 如果没有提供生成器，创建一个默认的（例如 FlatTerrainGenerator）
             terrainGenerator = std::make_unique<FlatTerrainGenerator>(0); // 地面高度为 0
+            // 存档只保存与生成结果不同的部分，加载时按元数据重建生成器，因此元数据必须描述同一个生成器
+            worldMetadata.noiseType = "Flat";
         }
-        // 默认元数据与生成器保持一致（Flat 默认值）。
-        worldMetadata = WorldMetadata{};
     }
 
     // --- 坐标转换实现 ---
@@ -48,10 +52,9 @@ namespace TilelandWorld
     Chunk *Map::getOrLoadChunk(int cx, int cy, int cz)
     {
         ChunkCoord coord = {cx, cy, cz};
-        auto it = loadedChunks.find(coord);
-        if (it != loadedChunks.end())
+        if (Chunk *chunk = loadedChunks.findChunk(coord))
         {
-            return it->second.get(); // 区块已加载，返回指针
+            return chunk; // 区块已加载，返回指针
         }
         else
         {
@@ -66,6 +69,25 @@ namespace TilelandWorld
     // 新增：独立生成区块 (不加锁，不修改 Map 状态)
     std::unique_ptr<Chunk> Map::createChunkIsolated(int cx, int cy, int cz) const
     {
+        // 先查询后备存储 (之前被卸载的区块，比存档中的版本新)，再查询存档文件
+        const ChunkCoord coord{cx, cy, cz};
+        if (chunkStore)
+        {
+            if (auto stored = chunkStore->loadChunk(coord))
+            {
+                stored->clearDirty();
+                return stored;
+            }
+        }
+        if (savedChunkSource)
+        {
+            if (auto saved = savedChunkSource->loadChunk(coord))
+            {
+                saved->clearDirty(); // 与存档一致，卸载时可直接丢弃
+                return saved;
+            }
+        }
+
         auto newChunk = std::make_unique<Chunk>(cx, cy, cz);
 
         // *** 使用地形生成器填充新区块 ***
@@ -87,40 +109,106 @@ namespace TilelandWorld
                         ") in " + std::to_string(elapsedMs) + " ms.");
             #endif
         }
-        
+
+        // 生成器的输出可随时重建，不算脏
+        newChunk->clearDirty();
         return newChunk;
     }
 
+    std::vector<std::unique_ptr<Chunk>> Map::createChunksIsolated(const std::vector<ChunkCoord>& coords) const
+    {
+        std::vector<std::unique_ptr<Chunk>> chunks(coords.size());
+        std::vector<Chunk*> toGenerate;
+        for (size_t i = 0; i < coords.size(); ++i)
+        {
+            const ChunkCoord& coord = coords[i];
+            if (chunkStore)
+            {
+                chunks[i] = chunkStore->loadChunk(coord);
+            }
+            if (!chunks[i] && savedChunkSource)
+            {
+                chunks[i] = savedChunkSource->loadChunk(coord);
+            }
+            if (chunks[i])
+            {
+                chunks[i]->clearDirty();
+                continue;
+            }
+            chunks[i] = std::make_unique<Chunk>(coord.cx, coord.cy, coord.cz);
+            toGenerate.push_back(chunks[i].get());
+        }
+
+        if (terrainGenerator && !toGenerate.empty())
+        {
+            #ifdef _WIN32
+            LARGE_INTEGER freq, start, end;
+            QueryPerformanceFrequency(&freq);
+            QueryPerformanceCounter(&start);
+            #endif
+
+            terrainGenerator->generateChunks(toGenerate.data(), toGenerate.size());
+
+            #ifdef _WIN32
+            QueryPerformanceCounter(&end);
+            double elapsedMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart;
+            LOG_INFO("Generated " + std::to_string(toGenerate.size()) + " chunks in " + std::to_string(elapsedMs) + " ms.");
+            #endif
+        }
+
+        // 生成器的输出可随时重建，不算脏
+        for (Chunk* chunk : toGenerate) chunk->clearDirty();
+        return chunks;
+    }
+
     // 新增：将区块加入地图
     void Map::addChunk(std::unique_ptr<Chunk> chunk)
     {
         if (!chunk) return;
         ChunkCoord coord = {chunk->getChunkX(), chunk->getChunkY(), chunk->getChunkZ()};
+        chunk->shareIndices(chunkIndexPool);
         
         // 再次检查是否存在 (防止多线程竞争)
-        if (loadedChunks.find(coord) == loadedChunks.end()) {
-            loadedChunks.emplace(coord, std::move(chunk));
-        } else {
+        if (!loadedChunks.emplace(coord, std::move(chunk)).second) {
             LOG_WARNING("Attempted to add existing chunk (" + std::to_string(coord.cx) + "," + std::to_string(coord.cy) + "," + std::to_string(coord.cz) + ")");
         }
     }
 
-    const Chunk *Map::getChunk(int cx, int cy, int cz) const
+    void Map::setSavedChunkSource(std::shared_ptr<LazyChunkFile> source)
+    {
+        savedChunkSource = std::move(source);
+    }
+
+    bool Map::unloadChunk(int cx, int cy, int cz)
     {
         ChunkCoord coord = {cx, cy, cz};
-        auto it = loadedChunks.find(coord);
-        if (it != loadedChunks.end())
-        {
-            return it->second.get();
-        }
-        else
+        Chunk *chunk = loadedChunks.findChunk(coord);
+        if (!chunk) return true;
+
+        if (chunk->isDirty())
         {
-            return nullptr; // 区块未加载
+            if (!chunkStore || !chunkStore->storeChunk(*chunk))
+            {
+                return false; // 无处写回，保留在内存中
+            }
         }
+        chunk->releaseIndices(chunkIndexPool);
+        loadedChunks.erase(coord);
+        return true;
+    }
+
+    const Chunk *Map::getChunk(int cx, int cy, int cz) const
+    {
+        return loadedChunks.findChunk(ChunkCoord{cx, cy, cz}); // 未加载时为 nullptr
+    }
+
+    Chunk *Map::getChunk(int cx, int cy, int cz)
+    {
+        return loadedChunks.findChunk(ChunkCoord{cx, cy, cz});
     }
 
     // --- Tile 访问实现 ---
-    Tile &Map::getTile(int wx, int wy, int wz)
+    Tile Map::getTile(int wx, int wy, int wz)
     {
         ChunkCoord chunkCoord = mapToChunkCoords(wx, wy, wz);
         Chunk *chunk = getOrLoadChunk(chunkCoord.cx, chunkCoord.cy, chunkCoord.cz);
@@ -136,22 +224,15 @@ namespace TilelandWorld
         return chunk->getLocalTile(lx, ly, lz); // 可能因无效局部坐标抛出 out_of_range
     }
 
-    const Tile &Map::getTile(int wx, int wy, int wz) const
+    Tile Map::getTile(int wx, int wy, int wz) const
     {
         ChunkCoord chunkCoord = mapToChunkCoords(wx, wy, wz);
         const Chunk *chunk = getChunk(chunkCoord.cx, chunkCoord.cy, chunkCoord.cz); // 只获取已加载的
 
         if (!chunk)
         {
-            // 如果只读访问时区块未加载，我们不能创建它。
-            // 这里可以选择：
-            // 1. 抛出异常
-            // 2. 返回一个代表“虚空”或“未加载”的静态 const Tile 对象
-            // 我们先抛出异常
+            // 如果只读访问时区块未加载，我们不能创建它，直接抛出异常。
             throw std::runtime_error("Attempted to access tile in unloaded chunk via const Map reference.");
-            // 或者:
-            // static const Tile unloadedTile(TerrainType::VOIDBLOCK); // Or UNKNOWN
-            // return unloadedTile;
         }
 
         int lx, ly, lz;
@@ -161,24 +242,107 @@ namespace TilelandWorld
 
     void Map::setTile(int wx, int wy, int wz, const Tile &tile)
     {
-        // 获取 Tile 的可修改引用，然后赋值
-        getTile(wx, wy, wz) = tile;
+        ChunkCoord chunkCoord = mapToChunkCoords(wx, wy, wz);
+        Chunk *chunk = getOrLoadChunk(chunkCoord.cx, chunkCoord.cy, chunkCoord.cz);
+        if (!chunk)
+        {
+            throw std::runtime_error("Failed to get or load chunk for world coordinates.");
+        }
+
+        int lx, ly, lz;
+        mapToLocalCoords(wx, wy, wz, lx, ly, lz);
+        chunk->setLocalTile(lx, ly, lz, tile);
     }
 
     void Map::setTileTerrain(int wx, int wy, int wz, TerrainType terrainType)
     {
-        // 获取 Tile 的可修改引用，然后修改其地形类型
-        // 注意：这不会自动更新 Tile 的其他属性（如通行性、移动成本）
-        // 可能需要一个更复杂的 Tile::setTerrain 方法来处理这个
-        Tile &targetTile = getTile(wx, wy, wz);
+        // 读取-修改-写回：区块按调色板存储，无法直接修改引用
+        // 通行性与移动成本由新地形派生，原有的实例覆盖随之失效
+        Tile targetTile = getTile(wx, wy, wz);
         targetTile.terrain = terrainType;
-        // TODO: Consider updating other tile properties based on the new terrain type
-        // const auto& props = getTerrainProperties(terrainType);
-        // targetTile.canEnterSameLevel = props.allowEnterSameLevel;
-        // targetTile.canStandOnTop = props.allowStandOnTop;
-        // targetTile.movementCost = props.defaultMovementCost;
-        // 可以添加日志记录地形变化
-        // LOG_INFO("Set terrain at (" + std::to_string(wx) + "," + std::to_string(wy) + "," + std::to_string(wz) + ") to " + std::to_string(static_cast<int>(terrainType)));
+        targetTile.hasOverride = 0;
+        setTile(wx, wy, wz, targetTile);
+    }
+
+    TileTraits Map::getTileTraits(int wx, int wy, int wz)
+    {
+        ChunkCoord chunkCoord = mapToChunkCoords(wx, wy, wz);
+        Chunk *chunk = getOrLoadChunk(chunkCoord.cx, chunkCoord.cy, chunkCoord.cz);
+        if (!chunk)
+        {
+            throw std::runtime_error("Failed to get or load chunk for world coordinates.");
+        }
+
+        int lx, ly, lz;
+        mapToLocalCoords(wx, wy, wz, lx, ly, lz);
+        return chunk->getTileTraits(lx, ly, lz);
+    }
+
+    void Map::setTileOverride(int wx, int wy, int wz, const TileTraits& traits)
+    {
+        ChunkCoord chunkCoord = mapToChunkCoords(wx, wy, wz);
+        Chunk *chunk = getOrLoadChunk(chunkCoord.cx, chunkCoord.cy, chunkCoord.cz);
+        if (!chunk)
+        {
+            throw std::runtime_error("Failed to get or load chunk for world coordinates.");
+        }
+
+        int lx, ly, lz;
+        mapToLocalCoords(wx, wy, wz, lx, ly, lz);
+        chunk->setTileOverride(lx, ly, lz, traits);
+    }
+
+    // --- 批量读取实现 ---
+    void Map::readLayer(int wx, int wy, int wz, int width, int height, Tile* out, const Tile& placeholder) const
+    {
+        if (width <= 0 || height <= 0) return;
+
+        const int cz = floorDiv(wz, CHUNK_DEPTH);
+        const int lz = floorMod(wz, CHUNK_DEPTH);
+        const int cx0 = floorDiv(wx, CHUNK_WIDTH);
+        const int cx1 = floorDiv(wx + width - 1, CHUNK_WIDTH);
+        const int cy0 = floorDiv(wy, CHUNK_HEIGHT);
+        const int cy1 = floorDiv(wy + height - 1, CHUNK_HEIGHT);
+
+        // 按区块遍历窗口：每个区块查一次表，然后逐行复制与窗口相交的部分
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            const int chunkMinY = cy * CHUNK_HEIGHT;
+            const int y0 = std::max(wy, chunkMinY);
+            const int y1 = std::min(wy + height, chunkMinY + CHUNK_HEIGHT);
+
+            for (int cx = cx0; cx <= cx1; ++cx)
+            {
+                const int chunkMinX = cx * CHUNK_WIDTH;
+                const int x0 = std::max(wx, chunkMinX);
+                const int x1 = std::min(wx + width, chunkMinX + CHUNK_WIDTH);
+                const int span = x1 - x0;
+
+                const Chunk* chunk = loadedChunks.findChunk(ChunkCoord{cx, cy, cz});
+                for (int y = y0; y < y1; ++y)
+                {
+                    Tile* dst = out + static_cast<size_t>(y - wy) * width + (x0 - wx);
+                    if (chunk)
+                    {
+                        chunk->copyRowTo(x0 - chunkMinX, y - chunkMinY, lz, span, dst);
+                    }
+                    else
+                    {
+                        std::fill(dst, dst + span, placeholder);
+                    }
+                }
+            }
+        }
+    }
+
+    void Map::readRegion(int wx, int wy, int wz, int width, int height, int depth, Tile* out, const Tile& placeholder) const
+    {
+        if (width <= 0 || height <= 0) return;
+        const size_t layerSize = static_cast<size_t>(width) * height;
+        for (int z = 0; z < depth; ++z)
+        {
+            readLayer(wx, wy, wz + z, width, height, out + z * layerSize, placeholder);
+        }
     }
 
     void Map::setTerrainGenerator(std::unique_ptr<TerrainGenerator> generator)
@@ -3,17 +3,21 @@
 #define TILELANDWORLD_MAP_H
 
 #include "Chunk.h"
+#include "ChunkTable.h"
+#include "ChunkStore.h"
+#include "ChunkIndexPool.h"
 #include "Coordinates.h"
 #include "Tile.h"
 #include "SaveMetadata.h"
 #include "MapGenInfrastructure/TerrainGenerator.h" // 包含生成器基类
-#include <unordered_map>
 #include <memory> // For std::unique_ptr
+#include <vector>
 
 namespace TilelandWorld {
 
     // 前向声明 MapSerializer，以便在 Map 中声明友元
     class MapSerializer;
+    class LazyChunkFile;
 
     class Map {
         // 将 MapSerializer 声明为友元，允许它访问私有成员 (如 loadedChunks)
@@ -28,30 +32,64 @@ namespace TilelandWorld {
         static void mapToLocalCoords(int wx, int wy, int wz, int& lx, int& ly, int& lz);
 
         // --- 区块管理 ---
-        // 获取指定坐标的区块，如果未加载则创建（或未来加载）。
+        // 获取指定坐标的区块，如果未加载则依次尝试后备存储、存档文件 (按需读取)，最后由生成器创建。
         // 返回指向区块的指针，如果无法创建/加载则可能返回 nullptr。
         Chunk* getOrLoadChunk(int cx, int cy, int cz);
         const Chunk* getChunk(int cx, int cy, int cz) const; // 只获取已加载的区块
+        Chunk* getChunk(int cx, int cy, int cz);
 
         // --- Tile 访问与设置 (使用世界坐标) ---
-        // 获取 Tile 的引用。如果区块未加载，会尝试加载/创建。
-        // 如果无法访问（例如，区块加载失败），可能抛出异常或返回特定值/指针。
-        // 为简化，这里先实现总是尝试加载/创建并返回引用（可能抛出）。
-        Tile& getTile(int wx, int wy, int wz);
-        const Tile& getTile(int wx, int wy, int wz) const;
+        // 获取 Tile 的副本。如果区块未加载，会尝试加载/创建。
+        // 区块以调色板形式压缩存储，因此不再返回引用；修改请使用 setTile。
+        // 如果无法访问（例如，区块加载失败），可能抛出异常。
+        Tile getTile(int wx, int wy, int wz);
+        Tile getTile(int wx, int wy, int wz) const;
         void setTile(int wx, int wy, int wz, const Tile& tile);
         void setTileTerrain(int wx, int wy, int wz, TerrainType terrainType);
 
+        // 实际生效的通行性/移动成本 (地形默认值或区块覆盖表中的实例覆盖)。
+        TileTraits getTileTraits(int wx, int wy, int wz);
+        void setTileOverride(int wx, int wy, int wz, const TileTraits& traits);
+
+        // --- 批量读取 (只读，不加载/生成区块) ---
+        /**
+         * @brief 将 Z 层 wz 上以 (wx, wy) 为左上角、width x height 的矩形窗口复制到 out。
+         * @param out 调用方提供的缓冲区，至少 width * height 个 Tile，按行存放 (out[y * width + x])。
+         * @param placeholder 未加载区块对应位置的填充值。
+         * @details 每个相交区块只查找一次，再按行整段复制，不抛出异常。
+         */
+        void readLayer(int wx, int wy, int wz, int width, int height, Tile* out, const Tile& placeholder) const;
+
+        // 三维版本：连续 depth 层 (wz 起向上)，out[(z * height + y) * width + x]。
+        void readRegion(int wx, int wy, int wz, int width, int height, int depth, Tile* out, const Tile& placeholder) const;
+
         // --- 优化接口：分离生成与插入 ---
         // 生成一个区块但不加入地图管理 (用于多线程/异步生成，避免长时间占用锁)
         std::unique_ptr<Chunk> createChunkIsolated(int cx, int cy, int cz) const;
+        // 批量版本：需要生成的区块一起交给 TerrainGenerator::generateChunks (相邻区块合并噪声计算)，结果顺序与 coords 相同
+        std::vector<std::unique_ptr<Chunk>> createChunksIsolated(const std::vector<ChunkCoord>& coords) const;
         
-        // 将已生成的区块加入地图
+        // 将已生成的区块加入地图 (内容与已加载区块相同时共享其索引数组，见 ChunkIndexPool)
         void addChunk(std::unique_ptr<Chunk> chunk);
 
+        /**
+         * @brief 卸载区块。脏区块先写入后备存储，写入失败或没有后备存储时保留区块。
+         * @return 区块已不在内存中 (包括原本就未加载) 时返回 true。
+         */
+        bool unloadChunk(int cx, int cy, int cz);
+
+        // --- 后备存储 ---
+        // 设置后会在生成前先查询存储，并允许卸载脏区块。应在生成线程启动之前设置。
+        void setChunkStore(std::shared_ptr<ChunkStore> store) { chunkStore = std::move(store); }
+        ChunkStore* getChunkStore() const { return chunkStore.get(); }
+
+        // 存档文件的按需读取器 (由 MapSerializer::loadMap 设置)，尚未访问的区块仍留在文件中。
+        void setSavedChunkSource(std::shared_ptr<LazyChunkFile> source);
+        LazyChunkFile* getSavedChunkSource() const { return savedChunkSource.get(); }
+
         // --- Iteration over loaded chunks ---
         // Provide const iterators to allow reading loaded chunk data without exposing the map itself.
-        using LoadedChunksConstIterator = std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkCoordHash>::const_iterator;
+        using LoadedChunksConstIterator = ChunkTable::const_iterator;
 
         LoadedChunksConstIterator begin() const { return loadedChunks.cbegin(); }
         LoadedChunksConstIterator end() const { return loadedChunks.cend(); }
@@ -59,16 +97,24 @@ namespace TilelandWorld {
 
         void setTerrainGenerator(std::unique_ptr<TerrainGenerator> generator);
 
+        // 已加载区块共享索引数组所用的去重池 (统计/测试用)。
+        const ChunkIndexPool& getChunkIndexPool() const { return chunkIndexPool; }
+
         const WorldMetadata& getWorldMetadata() const { return worldMetadata; }
         void setWorldMetadata(const WorldMetadata& meta) { worldMetadata = meta; }
 
     private:
-        // 存储已加载的区块，使用区块坐标作为键，是MAP层的核心
-        std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkCoordHash> loadedChunks;
+        // 存储已加载的区块，使用区块坐标作为键，是MAP层的核心 (开放寻址表，带每线程最近命中缓存)
+        ChunkTable loadedChunks;
         // 地形生成器
         std::unique_ptr<TerrainGenerator> terrainGenerator;
         WorldMetadata worldMetadata;
-        // (未来可能添加：区块加载器、生成器、卸载逻辑等)
+        // 被卸载区块的后备存储 (可为空)。以 shared_ptr 持有，地图存活期间被卸载的区块不会丢失
+        std::shared_ptr<ChunkStore> chunkStore;
+        // 打开的存档文件，未加载的已保存区块从这里按需读取 (可为空)
+        std::shared_ptr<LazyChunkFile> savedChunkSource;
+        // 内容相同的区块共享同一个索引数组 (写时复制)，平坦地面层等大片重复的非均匀区块只占一份内存
+        ChunkIndexPool chunkIndexPool;
     };
 
 } // namespace TilelandWorld
@@ -1,29 +1,149 @@
 #include "ChunkGeneratorPool.h"
 #include "../Utils/Logger.h"
+#include <algorithm>
+#include <cstdlib>
 
 namespace TilelandWorld {
 
-    ChunkGeneratorPool::ChunkGeneratorPool(const Map& mapRef, TaskSystem& taskSystemRef) 
-        : map(mapRef), taskSystem(taskSystemRef) {
+    ChunkGeneratorPool::ChunkGeneratorPool(const Map& mapRef, TaskSystem& taskSystemRef, size_t maxJobs) 
+        : map(mapRef), taskSystem(taskSystemRef),
+          maxConcurrentJobs(maxJobs > 0 ? maxJobs : std::max<size_t>(1, taskSystemRef.getThreadCount())) {
         // 不再创建线程
     }
 
+    ChunkGeneratorPool::~ChunkGeneratorPool() {
+        cancelAll();
+    }
+
+    int ChunkGeneratorPool::priorityOf(const View& view, const ChunkCoord& coord) {
+        const int dx = coord.cx < view.minCx ? view.minCx - coord.cx : (coord.cx > view.maxCx ? coord.cx - view.maxCx : 0);
+        const int dy = coord.cy < view.minCy ? view.minCy - coord.cy : (coord.cy > view.maxCy ? coord.cy - view.maxCy : 0);
+        const int dz = std::abs(coord.cz - view.cz);
+        if (dx == 0 && dy == 0 && dz == 0) return 0;
+        return 1 + std::max(dx, dy) + 2 * dz;
+    }
+
+    bool ChunkGeneratorPool::isRetained(const View& view, const ChunkCoord& coord) {
+        const int dx = coord.cx < view.minCx ? view.minCx - coord.cx : (coord.cx > view.maxCx ? coord.cx - view.maxCx : 0);
+        const int dy = coord.cy < view.minCy ? view.minCy - coord.cy : (coord.cy > view.maxCy ? coord.cy - view.maxCy : 0);
+        return std::max(dx, dy) <= view.retainRadiusXY && std::abs(coord.cz - view.cz) <= view.retainRadiusZ;
+    }
+
     void ChunkGeneratorPool::requestChunk(int cx, int cy, int cz) {
-        // 构造一个 lambda 任务
-        // 注意：必须按值捕获 cx, cy, cz
-        // 注意：捕获 this 指针，因此必须确保 ChunkGeneratorPool 的生命周期长于任务执行时间
-        taskSystem.submit([this, cx, cy, cz]() {
-            // 1. 执行耗时的生成操作 (在工作线程中)
-            // createChunkIsolated 内部已经包含了计时日志和异常处理(部分)
-            // 但为了安全，TaskSystem 也会捕获异常
-            auto chunk = map.createChunkIsolated(cx, cy, cz);
-            
-            // 2. 将结果放入完成队列
-            {
-                std::lock_guard<std::mutex> lock(finishedMutex);
+        requestChunks({ChunkCoord{cx, cy, cz}});
+    }
+
+    void ChunkGeneratorPool::requestChunks(const std::vector<ChunkCoord>& coords) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (const ChunkCoord& coord : coords) {
+            if (pending.emplace(coord, nextSequence).second) {
+                ++nextSequence;
+                ++stats.requestedTotal;
+            }
+        }
+        startJobs();
+    }
+
+    void ChunkGeneratorPool::setView(const View& newView) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (hasView && newView == view) return;
+        view = newView;
+        hasView = true;
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (isRetained(view, it->first)) {
+                ++it;
+                continue;
+            }
+            cancelled.push_back(it->first);
+            ++stats.cancelledTotal;
+            it = pending.erase(it);
+        }
+    }
+
+    void ChunkGeneratorPool::cancelAll() {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stats.cancelledTotal += pending.size();
+        pending.clear();
+    }
+
+    void ChunkGeneratorPool::startJobs() {
+        while (activeJobs < maxConcurrentJobs && activeJobs < pending.size()) {
+            ++activeJobs;
+            // 注意：捕获 this 指针，因此必须确保 ChunkGeneratorPool 的生命周期长于任务执行时间
+            taskSystem.submit([this]() { runJob(); });
+        }
+    }
+
+    std::vector<ChunkCoord> ChunkGeneratorPool::takeBatch() {
+        std::vector<ChunkCoord> batch;
+        if (pending.empty()) return batch;
+
+        // 优先级最高的请求 (同优先级取最早的)
+        auto best = pending.begin();
+        int bestPriority = priority(best->first);
+        for (auto it = std::next(pending.begin()); it != pending.end(); ++it) {
+            const int p = priority(it->first);
+            if (p < bestPriority || (p == bestPriority && it->second < best->second)) {
+                best = it;
+                bestPriority = p;
+            }
+        }
+
+        // 同区域的其他请求一起生成；最高优先级是可见区块时只带上可见区块，保证可见区块总是先完成
+        const ChunkCoord first = best->first;
+        const int regionX = floorDiv(first.cx, REGION_WIDTH);
+        const int regionY = floorDiv(first.cy, REGION_HEIGHT);
+        std::vector<std::pair<std::pair<int, uint64_t>, ChunkCoord>> members;
+        for (const auto& [coord, sequence] : pending) {
+            if (floorDiv(coord.cx, REGION_WIDTH) != regionX || floorDiv(coord.cy, REGION_HEIGHT) != regionY) continue;
+            const int p = priority(coord);
+            if (bestPriority == 0 && p != 0) continue;
+            members.push_back({{p, sequence}, coord});
+        }
+        // 组内也按优先级排列 (生成器按顺序填充)，超出上限的留到下一批
+        std::sort(members.begin(), members.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        if (members.size() > REGION_MAX_CHUNKS) members.resize(REGION_MAX_CHUNKS);
+
+        batch.reserve(members.size());
+        for (const auto& member : members) {
+            batch.push_back(member.second);
+            pending.erase(member.second);
+        }
+        return batch;
+    }
+
+    void ChunkGeneratorPool::runJob() {
+        std::vector<ChunkCoord> batch;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            batch = takeBatch();
+            if (batch.empty()) {
+                --activeJobs;
+                return;
+            }
+        }
+
+        // 1. 执行耗时的生成操作 (在工作线程中)；相邻区块的噪声合并计算
+        auto chunks = map.createChunksIsolated(batch);
+
+        // 2. 将结果放入完成队列
+        {
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            for (auto& chunk : chunks) {
                 finishedQueue.push_back(std::move(chunk));
             }
-        });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stats.generatedTotal += batch.size();
+            ++stats.jobsTotal;
+            if (pending.empty()) {
+                --activeJobs;
+                return;
+            }
+        }
+        taskSystem.submit([this]() { runJob(); });
     }
 
     std::vector<std::unique_ptr<Chunk>> ChunkGeneratorPool::getFinishedChunks() {
@@ -36,4 +156,23 @@ namespace TilelandWorld {
         return result;
     }
 
+    std::vector<ChunkCoord> ChunkGeneratorPool::getCancelledChunks() {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        std::vector<ChunkCoord> result;
+        result.swap(cancelled);
+        return result;
+    }
+
+    size_t ChunkGeneratorPool::getPendingCount() const {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return pending.size();
+    }
+
+    ChunkGeneratorPool::Stats ChunkGeneratorPool::getStats() const {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        Stats result = stats;
+        result.pending = pending.size();
+        return result;
+    }
+
 } // namespace TilelandWorld
@@ -4,10 +4,13 @@
 
 #include "../Map.h"
 #include "../Chunk.h"
+#include "../Coordinates.h"
 #include "../Utils/TaskSystem.h" // 引入通用任务系统
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <unordered_map>
+#include <cstdint>
 
 namespace TilelandWorld {
 
@@ -15,32 +18,109 @@ namespace TilelandWorld {
      * @brief 区块生成任务管理器。
      * 
      * 它不再拥有自己的线程，而是将生成请求打包成任务提交给全局 TaskSystem。
+     * 请求先进入池内的待生成集合，最多 maxConcurrentJobs 个任务从中取出请求生成，
+     * 任务系统的 FIFO 队列里不会堆积已经离开视口的区块：
+     * 每次取出优先级最高的请求 (见 priorityOf)，并带上同一 REGION_WIDTH x REGION_HEIGHT 区域内的其他请求
+     * 合并为一个区域任务 (最多 REGION_MAX_CHUNKS 个)，由 Map::createChunksIsolated 一起生成。
+     * 优先级在取出时按当前视图计算，视图移动后立即生效；setView 时保留范围外尚未开始的请求被取消，
+     * 通过 getCancelledChunks 告知调用方。已开始生成的区域任务不会中断。
      * 它负责收集生成好的区块结果。
      */
     class ChunkGeneratorPool {
     public:
-        // 构造函数：需要传入 Map 和 TaskSystem
-        ChunkGeneratorPool(const Map& map, TaskSystem& taskSystem);
-        ~ChunkGeneratorPool() = default;
+        // 当前视图 (区块坐标)：[minCx, maxCx] x [minCy, maxCy] 的 cz 层可见
+        struct View {
+            int minCx = 0;
+            int maxCx = 0;
+            int minCy = 0;
+            int maxCy = 0;
+            int cz = 0;
+            int retainRadiusXY = 2; // 与可见矩形的 XY 距离超过该值的请求被取消
+            int retainRadiusZ = 2;  // 与 cz 的层级差超过该值的请求被取消
 
-        // 请求生成一个区块 (提交到 TaskSystem)
+            bool operator==(const View& other) const {
+                return minCx == other.minCx && maxCx == other.maxCx && minCy == other.minCy && maxCy == other.maxCy &&
+                       cz == other.cz && retainRadiusXY == other.retainRadiusXY && retainRadiusZ == other.retainRadiusZ;
+            }
+            bool operator!=(const View& other) const { return !(*this == other); }
+        };
+
+        struct Stats {
+            size_t pending = 0;        // 尚未开始生成的请求
+            size_t requestedTotal = 0; // 累计接受的请求 (重复请求不计)
+            size_t cancelledTotal = 0; // 累计取消的请求
+            size_t generatedTotal = 0; // 累计生成的区块
+            size_t jobsTotal = 0;      // 累计执行的区域任务
+        };
+
+        // 构造函数：需要传入 Map 和 TaskSystem；maxConcurrentJobs 为 0 时取任务系统的线程数
+        ChunkGeneratorPool(const Map& map, TaskSystem& taskSystem, size_t maxConcurrentJobs = 0);
+        // 取消尚未开始的请求。在途任务持有 this，必须在任务系统停止之后析构
+        ~ChunkGeneratorPool();
+
+        // 请求生成一个区块 (加入待生成集合)
         void requestChunk(int cx, int cy, int cz);
 
+        // 请求生成一批区块；已在待生成集合中的忽略
+        void requestChunks(const std::vector<ChunkCoord>& coords);
+
+        /**
+         * @brief 更新视图：之后取出的请求按新视图排序，保留范围外尚未开始的请求被取消。
+         * @details 未设置视图之前所有请求优先级相同 (按请求顺序)，不取消。
+         */
+        void setView(const View& view);
+
+        // 取消全部尚未开始的请求 (不计入 getCancelledChunks，用于关闭前让在途任务尽快结束)
+        void cancelAll();
+
         // 获取所有已完成的区块
         std::vector<std::unique_ptr<Chunk>> getFinishedChunks();
 
-        // 获取当前待处理的请求数量 (注意：这里只能统计 TaskSystem 中尚未被取走的任务，比较困难，
-        // 简化为不提供或仅提供本地计数，这里暂时移除 getPendingCount 以简化，
-        // 因为实际 pending 状态由 Controller 的 pendingChunks 集合管理)
-        // size_t getPendingCount() const; 
+        // 获取自上次调用以来被 setView 取消的请求，调用方据此清理自己的待处理记录
+        std::vector<ChunkCoord> getCancelledChunks();
+
+        // 获取当前尚未开始生成的请求数量
+        size_t getPendingCount() const;
+        Stats getStats() const;
+
+        /**
+         * @brief 请求的优先级，越小越先生成。
+         * @details 可见区块 (在可见矩形内且位于 cz 层) 为 0，其余为 1 + XY 距离 + 2 * 层级差：
+         *          同层的外圈先于其他层的可见范围，视口平移时最先进入视野。
+         */
+        static int priorityOf(const View& view, const ChunkCoord& coord);
+        static bool isRetained(const View& view, const ChunkCoord& coord);
+
+        static constexpr int REGION_WIDTH = 4;  // 区域任务的 X 跨度 (区块)
+        static constexpr int REGION_HEIGHT = 4; // 区域任务的 Y 跨度 (区块)
+        static constexpr size_t REGION_MAX_CHUNKS = REGION_WIDTH * REGION_HEIGHT * 3; // 预加载每列请求 3 个 Z 层级
 
     private:
         const Map& map;
         TaskSystem& taskSystem; // 引用全局任务系统
+        const size_t maxConcurrentJobs;
+
+        // 待生成请求 -> 请求序号 (同优先级按请求顺序)
+        std::unordered_map<ChunkCoord, uint64_t, ChunkCoordHash> pending;
+        uint64_t nextSequence = 0;
+        View view;
+        bool hasView = false;
+        size_t activeJobs = 0; // 已提交到任务系统、尚未结束的任务
+        std::vector<ChunkCoord> cancelled;
+        Stats stats;
+        mutable std::mutex queueMutex;
 
         // 完成队列
         std::vector<std::unique_ptr<Chunk>> finishedQueue;
         mutable std::mutex finishedMutex;
+
+        // 需持有 queueMutex
+        void startJobs();
+        std::vector<ChunkCoord> takeBatch();
+        int priority(const ChunkCoord& coord) const { return hasView ? priorityOf(view, coord) : 0; }
+
+        // 任务主体：取出一批生成，还有请求时把自己重新排到任务系统队尾 (自动保存等其他任务可以插入)
+        void runJob();
     };
 
 } // namespace TilelandWorld
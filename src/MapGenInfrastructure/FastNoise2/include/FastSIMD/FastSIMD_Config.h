@@ -23,11 +23,11 @@
 #define FASTSIMD_COMPILE_SSE41  (FASTSIMD_x86 & true)
 #define FASTSIMD_COMPILE_SSE42  (FASTSIMD_x86 & true )
 #define FASTSIMD_COMPILE_AVX    (FASTSIMD_x86 & false) // Not supported
-#define FASTSIMD_COMPILE_AVX2   (FASTSIMD_x86 & false )
-#define FASTSIMD_COMPILE_AVX512 (FASTSIMD_x86 & false )
+#define FASTSIMD_COMPILE_AVX2   (FASTSIMD_x86 & true )
+#define FASTSIMD_COMPILE_AVX512 (FASTSIMD_x86 & true )
 
 #define FASTSIMD_COMPILE_NEON   (FASTSIMD_ARM & false )
 
-#define FASTSIMD_USE_FMA                   true
+#define FASTSIMD_USE_FMA                   false // Fused results differ from SSE, terrain must not depend on the SIMD level
 #define FASTSIMD_CONFIG_GENERATE_CONSTANTS false
 
@@ -0,0 +1,23 @@
+#include "FastSIMD/FastSIMD.h"
+
+#if FASTSIMD_COMPILE_AVX2
+// Shared inline code must be compiled before the target switch so the linker
+// never picks an AVX2 copy of it for the lower levels
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "FastNoise/FastNoise.h"
+
+// GCC needs no per file compiler flags (MSVC neither), clang must build this
+// file with -mavx2. FMA contraction is disabled so results match SSE4.1
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#if !defined( __AVX2__ )
+#pragma GCC target( "avx2" )
+#endif
+#pragma GCC optimize( "fp-contract=off" )
+#endif
+
+#include "Internal/AVX.h"
+#define FS_SIMD_CLASS FastSIMD::AVX2
+#include "Internal/SourceBuilder.inl"
+#endif
@@ -0,0 +1,24 @@
+#include "FastSIMD/FastSIMD.h"
+
+#if FASTSIMD_COMPILE_AVX512
+// Shared inline code must be compiled before the target switch so the linker
+// never picks an AVX512 copy of it for the lower levels
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "FastNoise/FastNoise.h"
+
+// GCC needs no per file compiler flags (MSVC neither), clang must build this
+// file with -mavx512f -mavx512dq -mavx512vl -mavx512bw. FMA contraction is
+// disabled so results match SSE4.1
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#if !defined( __AVX512F__ )
+#pragma GCC target( "avx512f,avx512dq,avx512vl,avx512bw" )
+#endif
+#pragma GCC optimize( "fp-contract=off" )
+#endif
+
+#include "Internal/AVX512.h"
+#define FS_SIMD_CLASS FastSIMD::AVX512
+#include "Internal/SourceBuilder.inl"
+#endif
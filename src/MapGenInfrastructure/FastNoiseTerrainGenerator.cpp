@@ -1,5 +1,6 @@
 #include "FastNoiseTerrainGenerator.h"
 #include "../Constants.h"
+#include "../Coordinates.h"
 #include "../TerrainTypes.h"
 #include "../Utils/Logger.h"
 
@@ -7,6 +8,11 @@
 #include <string>
 #include <stdexcept> // For std::runtime_error
 #include <memory>    // For std::unique_ptr (though SmartNode handles ownership)
+#include <atomic>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
 
 // --- Include necessary FastNoise headers ---
 #include <FastNoise/Generators/BasicGenerators.h> // Contains Perlin, OpenSimplex2, Value
@@ -15,15 +21,310 @@
 #include <FastNoise/FastNoise.h>                  // Main header
 #include <FastSIMD/FastSIMD.h>                    // *** Include for FastSIMD levels ***
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILELANDWORLD_NOISE_LERP_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace TilelandWorld
 {
 
+    namespace
+    {
+        // Level_Null: 由 FastSIMD 按 CPU 选择最高的已编译级别
+        std::atomic<FastSIMD::eLevel> simdLevelOverride{FastSIMD::Level_Null};
+
+        // out[i] = a[i] + (b[i] - a[i]) * t；SSE2 与标量路径逐位相同 (不使用 FMA)
+        void lerpRow(const float* a, const float* b, float t, float* out, int count)
+        {
+            int i = 0;
+#ifdef TILELANDWORLD_NOISE_LERP_SSE2
+            const __m128 vt = _mm_set1_ps(t);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 va = _mm_loadu_ps(a + i);
+                const __m128 vb = _mm_loadu_ps(b + i);
+                _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), vt)));
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                out[i] = a[i] + (b[i] - a[i]) * t;
+            }
+        }
+
+        static_assert(CHUNK_WIDTH == CHUNK_HEIGHT, "Noise lattice assumes square chunk layers");
+
+        // 格点间距 spacing 时，地表带 (含上下各一层格点) 覆盖的格点层范围 [first, first + count)
+        int latticeFirstZ(int spacing) { return floorDiv(FastNoiseTerrainGenerator::NOISE_MIN_Z, spacing); }
+        int latticeDepth(int spacing) { return floorDiv(FastNoiseTerrainGenerator::NOISE_MAX_Z, spacing) + 2 - latticeFirstZ(spacing); }
+
+        /**
+         * @brief 由一列格点三线性插值出 [NOISE_MIN_Z, NOISE_MAX_Z] 的逐 Tile 噪声。
+         * @param lattice 该列第 latticeFirstZ 层格点的 (0, 0) 位置；rowStride/layerStride 为所在格点数组的行、层跨度。
+         * @param out CHUNK_AREA * NOISE_BAND_DEPTH 个值，按 lx + ly * CHUNK_WIDTH + (z - NOISE_MIN_Z) * CHUNK_AREA 排列。
+         */
+        void interpolateLattice(const float* lattice, int spacing, size_t rowStride, size_t layerStride, float* out)
+        {
+            constexpr int MAX_SIDE = CHUNK_WIDTH / 2 + 1;
+            const int s = spacing;
+            const int side = CHUNK_WIDTH / s + 1;
+            const int firstZ = latticeFirstZ(s);
+            const float invS = 1.0f / s; // s 为 2 的幂，插值权重精确
+            float plane[MAX_SIDE * MAX_SIDE];
+            float rows[MAX_SIDE * CHUNK_WIDTH];
+            for (int z = FastNoiseTerrainGenerator::NOISE_MIN_Z; z <= FastNoiseTerrainGenerator::NOISE_MAX_Z; ++z)
+            {
+                // Z 方向：相邻两层格点插值成一个平面
+                const int lz = floorDiv(z, s);
+                const float tz = (z - lz * s) * invS;
+                const float* below = lattice + static_cast<size_t>(lz - firstZ) * layerStride;
+                for (int gy = 0; gy < side; ++gy)
+                {
+                    lerpRow(below + gy * rowStride, below + layerStride + gy * rowStride, tz, plane + gy * side, side);
+                }
+
+                // X 方向：每行格点展开为 CHUNK_WIDTH 个值
+                for (int gy = 0; gy < side; ++gy)
+                {
+                    const float* src = plane + gy * side;
+                    float* dst = rows + gy * CHUNK_WIDTH;
+                    for (int lx = 0; lx < CHUNK_WIDTH; ++lx)
+                    {
+                        const int gx = lx / s;
+                        dst[lx] = src[gx] + (src[gx + 1] - src[gx]) * ((lx - gx * s) * invS);
+                    }
+                }
+
+                // Y 方向：相邻两行插值写入输出层
+                float* layer = out + static_cast<size_t>(z - FastNoiseTerrainGenerator::NOISE_MIN_Z) * CHUNK_AREA;
+                for (int ly = 0; ly < CHUNK_HEIGHT; ++ly)
+                {
+                    const int gy = ly / s;
+                    const float* row = rows + gy * CHUNK_WIDTH;
+                    lerpRow(row, row + CHUNK_WIDTH, (ly - gy * s) * invS, layer + ly * CHUNK_WIDTH, CHUNK_WIDTH);
+                }
+            }
+        }
+
+        Tile makeGeneratedTile(TerrainType type)
+        {
+            Tile tile(type); // 通行性与移动成本由地形注册表派生，构造时无需查表
+            tile.lightLevel = MAX_LIGHT_LEVEL;
+            tile.isExplored = true;
+            return tile;
+        }
+    }
+
+    void FastNoiseTerrainGenerator::setSimdLevelOverride(FastSIMD::eLevel level)
+    {
+        if (level != FastSIMD::Level_Null && level < FastSIMD::Level_SSE41)
+        {
+            LOG_WARNING("SIMD level " + simdLevelName(level) + " generates different terrain, using sse41 instead.");
+            level = FastSIMD::Level_SSE41;
+        }
+        simdLevelOverride = level;
+    }
+
+    FastSIMD::eLevel FastNoiseTerrainGenerator::getSimdLevelOverride()
+    {
+        return simdLevelOverride;
+    }
+
+    bool FastNoiseTerrainGenerator::parseSimdLevel(const std::string &name, FastSIMD::eLevel &level)
+    {
+        std::string lower;
+        for (char c : name)
+        {
+            if (c == '.' || c == '_' || c == '-' || std::isspace(static_cast<unsigned char>(c))) continue;
+            lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+        if (lower.empty() || lower == "auto") level = FastSIMD::Level_Null;
+        else if (lower == "sse41") level = FastSIMD::Level_SSE41;
+        else if (lower == "sse42") level = FastSIMD::Level_SSE42;
+        else if (lower == "avx2") level = FastSIMD::Level_AVX2;
+        else if (lower == "avx512") level = FastSIMD::Level_AVX512;
+        else return false;
+        return true;
+    }
+
+    std::string FastNoiseTerrainGenerator::simdLevelName(FastSIMD::eLevel level)
+    {
+        switch (level)
+        {
+        case FastSIMD::Level_Null: return "auto";
+        case FastSIMD::Level_Scalar: return "scalar";
+        case FastSIMD::Level_SSE: return "sse";
+        case FastSIMD::Level_SSE2: return "sse2";
+        case FastSIMD::Level_SSE3: return "sse3";
+        case FastSIMD::Level_SSSE3: return "ssse3";
+        case FastSIMD::Level_SSE41: return "sse41";
+        case FastSIMD::Level_SSE42: return "sse42";
+        case FastSIMD::Level_AVX: return "avx";
+        case FastSIMD::Level_AVX2: return "avx2";
+        case FastSIMD::Level_AVX512: return "avx512";
+        case FastSIMD::Level_NEON: return "neon";
+        default: return std::to_string(level);
+        }
+    }
+
+    FastSIMD::eLevel FastNoiseTerrainGenerator::getSimdLevel() const
+    {
+        return noiseSource ? noiseSource->GetSIMDLevel() : FastSIMD::Level_Null;
+    }
+
+    struct FastNoiseTerrainGenerator::ColumnCache
+    {
+        using Column = std::shared_ptr<const std::vector<float>>;
+
+        std::mutex mutex;
+        std::list<std::pair<uint64_t, Column>> lru; // 最近使用的在前
+        std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Column>>::iterator> index;
+
+        std::atomic<uint64_t> uniformChunks{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> regionCalls{0};
+
+        static uint64_t key(int cx, int cy)
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+        }
+    };
+
+    FastNoiseTerrainGenerator::FastNoiseTerrainGenerator(FastNoiseTerrainGenerator&&) noexcept = default;
+    FastNoiseTerrainGenerator& FastNoiseTerrainGenerator::operator=(FastNoiseTerrainGenerator&&) noexcept = default;
+    FastNoiseTerrainGenerator::~FastNoiseTerrainGenerator() = default;
+
+    FastNoiseTerrainGenerator::Stats FastNoiseTerrainGenerator::getStats() const
+    {
+        Stats stats;
+        if (columnCache)
+        {
+            stats.uniformChunks = columnCache->uniformChunks;
+            stats.columnHits = columnCache->hits;
+            stats.columnMisses = columnCache->misses;
+            stats.regionNoiseCalls = columnCache->regionCalls;
+        }
+        return stats;
+    }
+
+    size_t FastNoiseTerrainGenerator::getNoiseSamplesPerColumn() const
+    {
+        if (latticeSpacing <= 1) return static_cast<size_t>(CHUNK_AREA) * NOISE_BAND_DEPTH;
+        const size_t side = static_cast<size_t>(CHUNK_WIDTH / latticeSpacing + 1);
+        return side * side * static_cast<size_t>(latticeDepth(latticeSpacing));
+    }
+
+    std::shared_ptr<const std::vector<float>> FastNoiseTerrainGenerator::findColumn(int cx, int cy) const
+    {
+        ColumnCache& cache = *columnCache;
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.index.find(ColumnCache::key(cx, cy));
+        if (it == cache.index.end()) return nullptr;
+        cache.lru.splice(cache.lru.begin(), cache.lru, it->second);
+        ++cache.hits;
+        return it->second->second;
+    }
+
+    std::shared_ptr<const std::vector<float>> FastNoiseTerrainGenerator::storeColumn(int cx, int cy, std::shared_ptr<const std::vector<float>> column) const
+    {
+        // 两个线程同时生成同一列时结果相同，后插入的丢弃
+        ColumnCache& cache = *columnCache;
+        const uint64_t key = ColumnCache::key(cx, cy);
+        ++cache.misses;
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.index.find(key);
+        if (it != cache.index.end()) return it->second->second;
+        cache.lru.emplace_front(key, std::move(column));
+        cache.index[key] = cache.lru.begin();
+        if (cache.lru.size() > COLUMN_CACHE_CAPACITY)
+        {
+            cache.index.erase(cache.lru.back().first);
+            cache.lru.pop_back();
+        }
+        return cache.lru.front().second;
+    }
+
+    std::shared_ptr<const std::vector<float>> FastNoiseTerrainGenerator::getNoiseColumn(int cx, int cy) const
+    {
+        if (auto column = findColumn(cx, cy)) return column;
+        // 在锁外生成
+        return storeColumn(cx, cy, std::move(generateNoiseColumns(cx, cy, 1, 1).front()));
+    }
+
+    std::vector<std::shared_ptr<std::vector<float>>> FastNoiseTerrainGenerator::generateNoiseColumns(int cx0, int cy0, int width, int height) const
+    {
+        const size_t columnSize = static_cast<size_t>(CHUNK_AREA) * NOISE_BAND_DEPTH;
+        std::vector<std::shared_ptr<std::vector<float>>> columns(static_cast<size_t>(width) * height);
+        for (auto& column : columns) column = std::make_shared<std::vector<float>>(columnSize);
+
+        // 整个矩形一次噪声调用，输出写入线程内复用的缓冲区再拆分到各列
+        thread_local std::vector<float> scratch;
+        if (latticeSpacing <= 1)
+        {
+            if (width == 1 && height == 1)
+            {
+                noiseSource->GenUniformGrid3D(columns[0]->data(),
+                                              cx0 * CHUNK_WIDTH, cy0 * CHUNK_HEIGHT, NOISE_MIN_Z,
+                                              CHUNK_WIDTH, CHUNK_HEIGHT, NOISE_BAND_DEPTH,
+                                              this->frequency, this->seed);
+                return columns;
+            }
+
+            const size_t rowLength = static_cast<size_t>(width) * CHUNK_WIDTH;
+            const size_t rowCount = static_cast<size_t>(height) * CHUNK_HEIGHT;
+            if (scratch.size() < rowLength * rowCount * NOISE_BAND_DEPTH) scratch.resize(rowLength * rowCount * NOISE_BAND_DEPTH);
+            noiseSource->GenUniformGrid3D(scratch.data(),
+                                          cx0 * CHUNK_WIDTH, cy0 * CHUNK_HEIGHT, NOISE_MIN_Z,
+                                          static_cast<int>(rowLength), static_cast<int>(rowCount), NOISE_BAND_DEPTH,
+                                          this->frequency, this->seed);
+            for (int j = 0; j < height; ++j)
+            {
+                for (int i = 0; i < width; ++i)
+                {
+                    float* out = columns[static_cast<size_t>(j) * width + i]->data();
+                    for (int z = 0; z < NOISE_BAND_DEPTH; ++z)
+                    {
+                        for (int ly = 0; ly < CHUNK_HEIGHT; ++ly)
+                        {
+                            const float* src = scratch.data() + (static_cast<size_t>(z) * rowCount + j * CHUNK_HEIGHT + ly) * rowLength + i * CHUNK_WIDTH;
+                            std::copy(src, src + CHUNK_WIDTH, out + z * CHUNK_AREA + ly * CHUNK_WIDTH);
+                        }
+                    }
+                }
+            }
+            return columns;
+        }
+
+        // 格点坐标 = 世界坐标 / s，频率乘 s：格点 k 的采样位置只取决于 k，相邻列在共享边界上取值相同
+        const int s = latticeSpacing;
+        const int cells = CHUNK_WIDTH / s;
+        const size_t sideX = static_cast<size_t>(width) * cells + 1;
+        const size_t sideY = static_cast<size_t>(height) * cells + 1;
+        const int depth = latticeDepth(s);
+        if (scratch.size() < sideX * sideY * depth) scratch.resize(sideX * sideY * depth);
+        noiseSource->GenUniformGrid3D(scratch.data(),
+                                      cx0 * cells, cy0 * cells, latticeFirstZ(s),
+                                      static_cast<int>(sideX), static_cast<int>(sideY), depth,
+                                      this->frequency * s, this->seed);
+        for (int j = 0; j < height; ++j)
+        {
+            for (int i = 0; i < width; ++i)
+            {
+                interpolateLattice(scratch.data() + static_cast<size_t>(j) * cells * sideX + static_cast<size_t>(i) * cells,
+                                   s, sideX, sideX * sideY, columns[static_cast<size_t>(j) * width + i]->data());
+            }
+        }
+        return columns;
+    }
+
     // --- FastNoiseTerrainGenerator Implementation ---
 
     FastNoiseTerrainGenerator::FastNoiseTerrainGenerator(
         int seed, float frequency, const std::string &noiseTypeStr, const std::string &fractalTypeStr,
-        int octaves, float lacunarity, float gain)
-        : seed(seed), frequency(frequency)
+        int octaves, float lacunarity, float gain, int latticeSpacing)
+        : seed(seed), frequency(frequency), latticeSpacing(latticeSpacing), targetLevel(getSimdLevelOverride()), columnCache(std::make_unique<ColumnCache>())
 {
     // Normalize and trim inputs
     auto trim = [](std::string s) {
@@ -48,11 +349,27 @@ namespace TilelandWorld
     std::string noiseLower = toLower(noiseType);
     std::string fractalLower = toLower(fractalType);
 
+    // 同样的规范化参数必然构造出同样的节点树 (包括失败时的回退)；未使用分形时分形参数不影响结果
+    configuration = noiseLower + "|" + std::to_string(seed) + "|" + std::to_string(frequency) + "|" + fractalLower;
+    if (!fractalLower.empty()) {
+        configuration += "|" + std::to_string(octaves) + "|" + std::to_string(lacunarity) + "|" + std::to_string(gain);
+    }
+
+    // 格点间距必须是能整除区块边长的 2 的幂 (区块边界落在格点上，插值权重精确)
+    if (latticeSpacing < 1 || latticeSpacing > CHUNK_WIDTH || (latticeSpacing & (latticeSpacing - 1)) != 0) {
+        LOG_WARNING("Invalid noise lattice spacing " + std::to_string(latticeSpacing) + ", sampling every tile.");
+        this->latticeSpacing = 1;
+    }
+    if (this->latticeSpacing > 1) {
+        configuration += "|lattice=" + std::to_string(this->latticeSpacing);
+    }
+
     // Log the configuration attempt
     LOG_INFO("Configuring FastNoiseTerrainGenerator:");
         LOG_INFO("  Seed: " + std::to_string(seed));
         LOG_INFO("  Frequency: " + std::to_string(frequency));
         LOG_INFO("  Base Noise: '" + noiseType + "'");
+        LOG_INFO("  Lattice Spacing: " + std::to_string(this->latticeSpacing));
         if (!fractalType.empty())
         {
             LOG_INFO("  Fractal Modifier: '" + fractalType + "' (Maps to internal FastNoise type)");
@@ -68,10 +385,10 @@ namespace TilelandWorld
         try
         {
             // --- Specify target SIMD level ---
-            // *** Try forcing SSE4.1 (Level 4) ***
-            // You could also try FastSIMD::Level_SSE2 (Level 4) if SSE4.1 fails
-
-            LOG_INFO("Requesting FastNoise nodes with SIMD level: SSE4.1 (32)");
+            // Level_Null lets FastSIMD pick the best compiled level the CPU supports;
+            // an override is clamped to the CPU maximum by FastSIMD::New
+            LOG_INFO("Requesting FastNoise nodes with SIMD level: " + simdLevelName(targetLevel) +
+                     " (CPU max: " + simdLevelName(FastSIMD::CPUMaxSIMDLevel()) + ")");
 
             // --- Create Base Noise Node ---
             FastNoise::SmartNode<> baseNoiseNode;
@@ -157,14 +474,11 @@ namespace TilelandWorld
             if (this->noiseSource)
             {
                 FastSIMD::eLevel actualLevel = this->noiseSource->GetSIMDLevel();
-                LOG_INFO("Actual SIMD level of created noiseSource: " + std::to_string(actualLevel));
-                if (actualLevel != targetLevel)
+                LOG_INFO("Actual SIMD level of created noiseSource: " + simdLevelName(actualLevel));
+                if (targetLevel != FastSIMD::Level_Null && actualLevel != targetLevel)
                 {
-                    // Log a warning, but maybe don't throw if a lower level was created?
-                    // Or throw if it's higher than requested (shouldn't happen here)
-                    LOG_WARNING("SIMD level mismatch after creation! Requested " + std::to_string(targetLevel) + ", got " + std::to_string(actualLevel));
-                    // Decide if this is a fatal error for your application
-                    // throw std::runtime_error("Failed to enforce requested SIMD level during node creation.");
+                    // The override is higher than the CPU supports (or not compiled); FastSIMD fell back
+                    LOG_WARNING("Requested SIMD level " + simdLevelName(targetLevel) + " is not available, using " + simdLevelName(actualLevel));
                 }
             }
             else
@@ -177,12 +491,12 @@ namespace TilelandWorld
         {
             LOG_ERROR("Failed to initialize FastNoise: " + std::string(e.what()));
             LOG_ERROR("Parameters: noiseType='" + noiseType + "' (len=" + std::to_string(noiseType.size()) + ") fractal='" + fractalType + "' (len=" + std::to_string(fractalType.size()) + ") seed=" + std::to_string(seed));
-            LOG_WARNING("Falling back to default Perlin noise configuration (SSE4.1)."); // Updated log
-            // *** Ensure fallback also uses targetLevel (SSE4.1) ***
+            LOG_WARNING("Falling back to default Perlin noise configuration.");
+            // *** Ensure fallback also uses targetLevel ***
             this->noiseSource = FastNoise::New<FastNoise::Perlin>(targetLevel);
             if (!this->noiseSource)
             { // Check fallback immediately
-                LOG_ERROR("CRITICAL FAILURE: Fallback to Perlin noise (SSE4.1) also failed!");
+                LOG_ERROR("CRITICAL FAILURE: Fallback to Perlin noise also failed!");
                 // Try Scalar as a last resort?
                 LOG_WARNING("Attempting last resort fallback to Perlin noise (Scalar).");
                 this->noiseSource = FastNoise::New<FastNoise::Perlin>(FastSIMD::Level_Scalar);
@@ -192,12 +506,12 @@ namespace TilelandWorld
         {
             LOG_ERROR("An unknown error occurred during FastNoise initialization.");
             LOG_ERROR("Parameters: noiseType='" + noiseType + "' (len=" + std::to_string(noiseType.size()) + ") fractal='" + fractalType + "' (len=" + std::to_string(fractalType.size()) + ") seed=" + std::to_string(seed));
-            LOG_WARNING("Falling back to default Perlin noise configuration (SSE4.1)."); // Updated log
-            // *** Ensure fallback also uses targetLevel (SSE4.1) ***
+            LOG_WARNING("Falling back to default Perlin noise configuration.");
+            // *** Ensure fallback also uses targetLevel ***
             this->noiseSource = FastNoise::New<FastNoise::Perlin>(targetLevel);
             if (!this->noiseSource)
             { // Check fallback immediately
-                LOG_ERROR("CRITICAL FAILURE: Fallback to Perlin noise (SSE4.1) also failed!");
+                LOG_ERROR("CRITICAL FAILURE: Fallback to Perlin noise also failed!");
                 LOG_WARNING("Attempting last resort fallback to Perlin noise (Scalar).");
                 this->noiseSource = FastNoise::New<FastNoise::Perlin>(FastSIMD::Level_Scalar);
             }
@@ -211,6 +525,12 @@ namespace TilelandWorld
         }
     }
 
+    bool FastNoiseTerrainGenerator::generatesSameAs(const TerrainGenerator& other) const
+    {
+        const auto* noise = dynamic_cast<const FastNoiseTerrainGenerator*>(&other);
+        return noise && noise->getVersion() == getVersion() && noise->configuration == configuration;
+    }
+
     // --- generateChunk Method ---
     void FastNoiseTerrainGenerator::generateChunk(Chunk &chunk) const
     {
@@ -224,59 +544,121 @@ namespace TilelandWorld
             return;
         }
 
-        int baseWX = chunk.getChunkX() * CHUNK_WIDTH;
-        int baseWY = chunk.getChunkY() * CHUNK_HEIGHT;
-        int baseWZ = chunk.getChunkZ() * CHUNK_DEPTH;
+        if (fillOutsideBand(chunk)) return;
+        fillFromColumn(chunk, getNoiseColumn(chunk.getChunkX(), chunk.getChunkY())->data());
+    }
+
+    void FastNoiseTerrainGenerator::generateChunks(Chunk* const* chunks, size_t count) const
+    {
+        if (!noiseSource || count <= 1)
+        {
+            for (size_t i = 0; i < count; ++i) generateChunk(*chunks[i]);
+            return;
+        }
+
+        // 1. 带外区块直接填充，其余按列收集；缓存中已有的列直接使用
+        using Column = std::shared_ptr<const std::vector<float>>;
+        std::unordered_map<uint64_t, Column> columns;
+        std::vector<std::pair<int, int>> missing;
+        std::vector<Chunk*> banded;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Chunk& chunk = *chunks[i];
+            if (fillOutsideBand(chunk)) continue;
+            banded.push_back(&chunk);
+            const uint64_t key = ColumnCache::key(chunk.getChunkX(), chunk.getChunkY());
+            if (columns.count(key)) continue;
+            Column column = findColumn(chunk.getChunkX(), chunk.getChunkY());
+            if (!column) missing.emplace_back(chunk.getChunkX(), chunk.getChunkY());
+            columns.emplace(key, std::move(column));
+        }
 
-        std::vector<float> noiseOutput(CHUNK_VOLUME);
+        // 2. 缺少的列覆盖了大部分包围矩形时整体一次生成，否则逐列生成
+        if (!missing.empty())
+        {
+            int minX = missing[0].first, maxX = minX, minY = missing[0].second, maxY = minY;
+            for (const auto& [cx, cy] : missing)
+            {
+                minX = std::min(minX, cx); maxX = std::max(maxX, cx);
+                minY = std::min(minY, cy); maxY = std::max(maxY, cy);
+            }
+            const int width = maxX - minX + 1;
+            const int height = maxY - minY + 1;
+            if (missing.size() > 1 && missing.size() * 2 >= static_cast<size_t>(width) * height &&
+                static_cast<size_t>(width) * height <= REGION_MAX_COLUMNS)
+            {
+                auto generated = generateNoiseColumns(minX, minY, width, height);
+                ++columnCache->regionCalls;
+                for (const auto& [cx, cy] : missing)
+                {
+                    auto& column = generated[static_cast<size_t>(cy - minY) * width + (cx - minX)];
+                    columns[ColumnCache::key(cx, cy)] = storeColumn(cx, cy, std::move(column));
+                }
+            }
+            else
+            {
+                for (const auto& [cx, cy] : missing)
+                {
+                    columns[ColumnCache::key(cx, cy)] = storeColumn(cx, cy, std::move(generateNoiseColumns(cx, cy, 1, 1).front()));
+                }
+            }
+        }
 
-        // --- Runtime SIMD Level Check (Optional but good for verification) ---
-        FastSIMD::eLevel detectedLevel = noiseSource->GetSIMDLevel();
-        // LOG_INFO("Runtime SIMD level: " + std::to_string(detectedLevel));
-        // *** Check against the requested SSE4.1 level ***
-        if (detectedLevel != targetLevel)
+        // 3. 拆分到各区块
+        for (Chunk* chunk : banded)
         {
-            // Log potentially non-fatal mismatch if constructor fallback occurred
-            LOG_WARNING("SIMD level mismatch detected at runtime!  got: " + std::to_string(detectedLevel));
-            // If the level is lower (e.g., Scalar fallback), maybe allow it?
-            // If it's higher (shouldn't happen), it's an error.
-            // For now, let's just log and continue, assuming the constructor handled fallbacks.
-            // If strict SSE4.1 is required, uncomment the return:
-            // return;
+            fillFromColumn(*chunk, columns[ColumnCache::key(chunk->getChunkX(), chunk->getChunkY())]->data());
         }
-        // --- End Runtime Check ---
+    }
 
-        // Generate 3D noise grid using the configured noiseSource
-        // This should now call the SSE4.1 (or fallback) version of GenUniformGrid3D
-        noiseSource->GenUniformGrid3D(noiseOutput.data(),
-                                      baseWX, baseWY, baseWZ,
-                                      CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_DEPTH,
-                                      this->frequency, this->seed);
+    bool FastNoiseTerrainGenerator::fillOutsideBand(Chunk &chunk) const
+    {
+        // 区块与地表带相交时需要噪声
+        const int baseWZ = chunk.getChunkZ() * CHUNK_DEPTH;
+        if (baseWZ <= NOISE_MAX_Z && baseWZ + CHUNK_DEPTH - 1 >= NOISE_MIN_Z) return false;
+
+        // 地形只由高度决定，不采样噪声
+        const TerrainType type = mapNoiseToTerrain(0.0f, baseWZ);
+        bool uniform = true;
+        for (int lz = 1; lz < CHUNK_DEPTH && uniform; ++lz)
+        {
+            uniform = mapNoiseToTerrain(0.0f, baseWZ + lz) == type;
+        }
+        if (uniform)
+        {
+            chunk.fill(makeGeneratedTile(type));
+            ++columnCache->uniformChunks;
+        }
+        else
+        {
+            fillFromColumn(chunk, nullptr);
+        }
+        return true;
+    }
 
+    void FastNoiseTerrainGenerator::fillFromColumn(Chunk &chunk, const float* column) const
+    {
         // Map noise to terrain
+        // 先写入线性缓冲区，再一次性交给区块构建调色板 (避免逐 Tile 查找调色板)；缓冲区按线程复用
+        thread_local std::vector<Tile> tiles(CHUNK_VOLUME);
+        const int baseWZ = chunk.getChunkZ() * CHUNK_DEPTH;
         for (int lz = 0; lz < CHUNK_DEPTH; ++lz)
         {
-            int currentWZ = baseWZ + lz;
-            for (int ly = 0; ly < CHUNK_HEIGHT; ++ly)
+            const int currentWZ = baseWZ + lz;
+            Tile* layer = tiles.data() + lz * CHUNK_AREA;
+            if (currentWZ < NOISE_MIN_Z || currentWZ > NOISE_MAX_Z)
             {
-                for (int lx = 0; lx < CHUNK_WIDTH; ++lx)
-                {
-                    int index = lx + ly * CHUNK_WIDTH + lz * (CHUNK_WIDTH * CHUNK_HEIGHT);
-                    float noiseValue = noiseOutput[index];
-
-                    TerrainType currentType = mapNoiseToTerrain(noiseValue, currentWZ);
-                    const auto &props = getTerrainProperties(currentType);
-
-                    Tile &tile = chunk.getLocalTile(lx, ly, lz);
-                    tile.terrain = currentType;
-                    tile.canEnterSameLevel = props.allowEnterSameLevel;
-                    tile.canStandOnTop = props.allowStandOnTop;
-                    tile.movementCost = props.defaultMovementCost;
-                    tile.lightLevel = MAX_LIGHT_LEVEL;
-                    tile.isExplored = true;
-                }
+                std::fill(layer, layer + CHUNK_AREA, makeGeneratedTile(mapNoiseToTerrain(0.0f, currentWZ)));
+                continue;
+            }
+
+            const float* noise = column + (currentWZ - NOISE_MIN_Z) * CHUNK_AREA;
+            for (int i = 0; i < CHUNK_AREA; ++i)
+            {
+                layer[i] = makeGeneratedTile(mapNoiseToTerrain(noise[i], currentWZ));
             }
         }
+        chunk.assignTiles(tiles.data());
     }
 
     // --- mapNoiseToTerrain Method ---
@@ -8,6 +8,8 @@
 #include <FastNoise/FastNoise.h> // 包含 FastNoise2 主头文件
 #include <string>
 #include <memory> // For std::unique_ptr
+#include <cstdint>
+#include <vector>
 
 namespace TilelandWorld {
 
@@ -15,6 +17,11 @@ namespace TilelandWorld {
      * @brief 使用 FastNoise2 库生成地形的生成器。
      *
      * 通过配置 FastNoise 节点树来生成噪声，并将噪声值映射到地形类型。
+     * 噪声值只在 [NOISE_MIN_Z, NOISE_MAX_Z] 的地表带内影响地形：完全在带外的区块不采样噪声，
+     * 按高度直接填充 (通常为均匀区块)；带内的噪声按 (cx, cy) 列整体生成一次并缓存，
+     * 同一列上不同 Z 层级的区块共用。结果与逐区块采样完全相同。
+     * 格点间距大于 1 时只在间距为 latticeSpacing 的世界坐标格点上采样噪声 (区块边界多一层格点)，
+     * 格点之间三线性插值；格点与世界坐标对齐，相邻区块在边界上取值一致。
      */
     class FastNoiseTerrainGenerator : public TerrainGenerator {
     public:
@@ -27,6 +34,7 @@ namespace TilelandWorld {
          * @param octaves 分形计算的倍频程数。
          * @param lacunarity 分形计算的空隙度。
          * @param gain 分形计算的增益。
+         * @param latticeSpacing 噪声采样格点间距 (1/2/4/8/16)，1 为逐 Tile 采样；其他值按 1 处理。
          */
         FastNoiseTerrainGenerator(
             int seed = 1337,
@@ -35,7 +43,8 @@ namespace TilelandWorld {
             const std::string& fractalType = std::string("FBm"),  // 默认使用 FBM 分形
             int octaves = 3,
             float lacunarity = 2.0f,
-            float gain = 0.5f
+            float gain = 0.5f,
+            int latticeSpacing = 1
         );
 
         // 禁用拷贝构造和赋值
@@ -43,8 +52,9 @@ namespace TilelandWorld {
         FastNoiseTerrainGenerator& operator=(const FastNoiseTerrainGenerator&) = delete;
 
         // 允许移动构造和赋值 (如果需要的话)
-        FastNoiseTerrainGenerator(FastNoiseTerrainGenerator&&) = default;
-        FastNoiseTerrainGenerator& operator=(FastNoiseTerrainGenerator&&) = default;
+        FastNoiseTerrainGenerator(FastNoiseTerrainGenerator&&) noexcept;
+        FastNoiseTerrainGenerator& operator=(FastNoiseTerrainGenerator&&) noexcept;
+        ~FastNoiseTerrainGenerator() override;
 
 
         /**
@@ -53,15 +63,92 @@ namespace TilelandWorld {
          */
         void generateChunk(Chunk& chunk) const override;
 
+        /**
+         * @brief 批量填充区块：缓存中缺少的列在其包围矩形内合并为一次噪声调用，再拆分到各区块。
+         * @details 噪声采样位置只取决于世界坐标，结果与逐个 generateChunk 完全相同。
+         */
+        void generateChunks(Chunk* const* chunks, size_t count) const override;
+
+        /**
+         * @brief 生成统计 (调试/基准测试用)。
+         * uniformChunks: 不采样噪声直接填充的区块数；columnHits/columnMisses: 地表带噪声列缓存的命中与生成次数；
+         * regionNoiseCalls: generateChunks 中合并多列的噪声调用次数。
+         */
+        struct Stats {
+            uint64_t uniformChunks{0};
+            uint64_t columnHits{0};
+            uint64_t columnMisses{0};
+            uint64_t regionNoiseCalls{0};
+        };
+        Stats getStats() const;
+
+        // mapNoiseToTerrain 只在此 Z 范围 (含两端) 内使用噪声值，范围外的地形只由高度决定
+        static constexpr int NOISE_MIN_Z = -5;
+        static constexpr int NOISE_MAX_Z = 4;
+        static constexpr int NOISE_BAND_DEPTH = NOISE_MAX_Z - NOISE_MIN_Z + 1;
+        // 缓存的地表带噪声列数 (每列 CHUNK_AREA * NOISE_BAND_DEPTH 个 float，约 10 KB)
+        static constexpr size_t COLUMN_CACHE_CAPACITY = 512;
+        // generateChunks 一次噪声调用最多覆盖的列数
+        static constexpr size_t REGION_MAX_COLUMNS = 64;
+
+        // 实际使用的格点间距
+        int getLatticeSpacing() const { return latticeSpacing; }
+        // 生成一列地表带噪声时的噪声求值次数 (逐 Tile 采样为 CHUNK_AREA * NOISE_BAND_DEPTH)
+        size_t getNoiseSamplesPerColumn() const;
+
+        static constexpr uint8_t VERSION = 1;
+        uint8_t getVersion() const override { return VERSION; }
+        bool generatesSameAs(const TerrainGenerator& other) const override;
+
+        // 实际使用的 SIMD 级别 (节点创建时按 CPU 支持与覆盖设置选出)
+        FastSIMD::eLevel getSimdLevel() const;
+
+        /**
+         * @brief 设置之后创建的生成器使用的最高 SIMD 级别 (进程内全局)。
+         * @param level FastSIMD::Level_Null 表示自动选择 CPU 支持的最高级别；高于 CPU 支持的级别会被降到 CPU 最高级别。
+         *        低于 SSE4.1 的级别提升到 SSE4.1：SSE2 及标量实现以模拟方式舍入，生成的地形与其他级别不同，
+         *        而未修改的区块不写入存档、加载时重新生成。
+         * @note 只影响之后构造的生成器，已有的生成器保持原来的级别。SSE4.1 及以上各级别生成的地形逐位相同，只影响速度。
+         */
+        static void setSimdLevelOverride(FastSIMD::eLevel level);
+        static FastSIMD::eLevel getSimdLevelOverride();
+
+        /**
+         * @brief 解析设置中的 SIMD 级别名称 ("auto", "sse41", "sse42", "avx2", "avx512"，不区分大小写)。
+         * @return 对应级别，"auto" 为 Level_Null；无法识别时返回 false。
+         */
+        static bool parseSimdLevel(const std::string& name, FastSIMD::eLevel& level);
+        static std::string simdLevelName(FastSIMD::eLevel level);
+
     private:
         int seed;
         float frequency;
-        const FastSIMD::eLevel targetLevel = FastSIMD::Level_SSE41;
+        int latticeSpacing;
+        FastSIMD::eLevel targetLevel; // 构造时的覆盖设置，Level_Null 为自动
+        std::string configuration; // 规范化后的全部生成参数，用于 generatesSameAs
         // 可以添加更多配置参数，如阈值等
 
         // FastNoise 节点智能指针
         FastNoise::SmartNode<> noiseSource;
 
+        // 地表带噪声的列缓存 (LRU，多个生成线程共用，内部加锁)
+        struct ColumnCache;
+        std::unique_ptr<ColumnCache> columnCache;
+
+        // 返回 (cx, cy) 列在 [NOISE_MIN_Z, NOISE_MAX_Z] 内的噪声 (按 lx + ly * CHUNK_WIDTH + (z - NOISE_MIN_Z) * CHUNK_AREA 排列)
+        std::shared_ptr<const std::vector<float>> getNoiseColumn(int cx, int cy) const;
+        // 查找缓存 (命中时计数)；未缓存返回 nullptr
+        std::shared_ptr<const std::vector<float>> findColumn(int cx, int cy) const;
+        // 放入缓存 (计为一次生成)，返回缓存中的版本
+        std::shared_ptr<const std::vector<float>> storeColumn(int cx, int cy, std::shared_ptr<const std::vector<float>> column) const;
+        // 一次噪声调用生成 [cx0, cx0 + width) x [cy0, cy0 + height) 各列的噪声，按 (cy - cy0) * width + (cx - cx0) 排列
+        std::vector<std::shared_ptr<std::vector<float>>> generateNoiseColumns(int cx0, int cy0, int width, int height) const;
+
+        // 区块与地表带不相交时按高度填充并返回 true
+        bool fillOutsideBand(Chunk& chunk) const;
+        // 由列噪声映射地形写入区块 (column 只在地表带内的层级读取)
+        void fillFromColumn(Chunk& chunk, const float* column) const;
+
         /**
          * @brief 将噪声值映射到地形类型。
          * @param noiseValue 从 FastNoise 获取的噪声值 (通常在 -1 到 1 之间)。
@@ -1,39 +1,54 @@
 #include "FlatTerrainGenerator.h"
 #include "../Constants.h" // For CHUNK dimensions
-#include "../TerrainTypes.h" // Include for getTerrainProperties
+#include "../TerrainTypes.h"
+#include <vector>
+#include <algorithm> // For std::fill
 
 namespace TilelandWorld {
 
     FlatTerrainGenerator::FlatTerrainGenerator(int groundLevel, TerrainType groundType, TerrainType airType)
         : groundLevel(groundLevel), groundType(groundType), airType(airType) {}
 
+    bool FlatTerrainGenerator::generatesSameAs(const TerrainGenerator& other) const {
+        const auto* flat = dynamic_cast<const FlatTerrainGenerator*>(&other);
+        return flat && flat->getVersion() == getVersion() && flat->groundLevel == groundLevel
+            && flat->groundType == groundType && flat->airType == airType;
+    }
+
     void FlatTerrainGenerator::generateChunk(Chunk& chunk) const {
         // 获取区块的世界坐标基点
         int baseWX = chunk.getChunkX() * CHUNK_WIDTH;
         int baseWY = chunk.getChunkY() * CHUNK_HEIGHT;
         int baseWZ = chunk.getChunkZ() * CHUNK_DEPTH;
 
-        // 遍历区块内的所有局部坐标
+        auto makeTile = [](TerrainType type) {
+            Tile tile(type); // 构造函数按地形默认属性初始化通行性与移动成本
+            // 设置默认光照（或由光照系统处理）
+            tile.lightLevel = MAX_LIGHT_LEVEL; // 假设默认全亮
+            // *** 设置为已探索，以便在测试中可见 ***
+            tile.isExplored = true;
+            return tile;
+        };
+
+        // 整个区块都在地面以下或以上：直接均匀填充
+        if (baseWZ + CHUNK_DEPTH <= groundLevel) {
+            chunk.fill(makeTile(groundType));
+            return;
+        }
+        if (baseWZ >= groundLevel) {
+            chunk.fill(makeTile(airType));
+            return;
+        }
+
+        // 跨越地面的区块：逐层写入缓冲区后一次性导入
+        std::vector<Tile> tiles(CHUNK_VOLUME);
         for (int lz = 0; lz < CHUNK_DEPTH; ++lz) {
             int currentWZ = baseWZ + lz; // 计算当前 Tile 的世界 Z 坐标
             TerrainType currentType = (currentWZ < groundLevel) ? groundType : airType;
-            const auto& props = getTerrainProperties(currentType); // 获取地形属性
-
-            for (int ly = 0; ly < CHUNK_HEIGHT; ++ly) {
-                for (int lx = 0; lx < CHUNK_WIDTH; ++lx) {
-                    Tile& tile = chunk.getLocalTile(lx, ly, lz);
-                    tile.terrain = currentType;
-                    // 设置 Tile 的默认属性基于地形
-                    tile.canEnterSameLevel = props.allowEnterSameLevel;
-                    tile.canStandOnTop = props.allowStandOnTop;
-                    tile.movementCost = props.defaultMovementCost;
-                    // 设置默认光照（或由光照系统处理）
-                    tile.lightLevel = MAX_LIGHT_LEVEL; // 假设默认全亮
-                    // *** 设置为已探索，以便在测试中可见 ***
-                    tile.isExplored = true;
-                }
-            }
+            Tile layerTile = makeTile(currentType);
+            std::fill(tiles.begin() + lz * CHUNK_AREA, tiles.begin() + (lz + 1) * CHUNK_AREA, layerTile);
         }
+        chunk.assignTiles(tiles.data());
     }
 
 } // namespace TilelandWorld
@@ -27,6 +27,10 @@ namespace TilelandWorld {
 
         void generateChunk(Chunk& chunk) const override;
 
+        static constexpr uint8_t VERSION = 1;
+        uint8_t getVersion() const override { return VERSION; }
+        bool generatesSameAs(const TerrainGenerator& other) const override;
+
     private:
         int groundLevel;
         TerrainType groundType;
@@ -2,6 +2,9 @@
 #ifndef TILELANDWORLD_TERRAINGENERATOR_H
 #define TILELANDWORLD_TERRAINGENERATOR_H
 
+#include <cstdint>
+#include <cstddef>
+
 // 前向声明 Chunk 类，避免循环包含
 namespace TilelandWorld {
     class Chunk;
@@ -25,6 +28,28 @@ namespace TilelandWorld {
          *       来确定性地填充 chunk 内的所有 Tile。
          */
         virtual void generateChunk(Chunk& chunk) const = 0;
+
+        /**
+         * @brief 批量填充多个区块 (通常是相邻的一片区域)。
+         * @details 默认逐个调用 generateChunk；生成器可以覆盖以合并计算，结果必须与逐个生成完全相同。
+         */
+        virtual void generateChunks(Chunk* const* chunks, std::size_t count) const {
+            for (std::size_t i = 0; i < count; ++i) generateChunk(*chunks[i]);
+        }
+
+        /**
+         * @brief 生成算法版本，写入存档文件头。
+         * @details 存档只保存与生成结果不同的 Tile，未修改的区块完全不保存，加载时重新生成；
+         *          因此同样的参数生成的内容一旦改变 (算法、映射阈值等)，必须递增版本号，
+         *          旧存档在版本不一致时拒绝加载而不是把差异套用到不同的地形上。0 保留为"未记录"。
+         */
+        virtual uint8_t getVersion() const = 0;
+
+        /**
+         * @brief 是否与 other 生成完全相同的地形 (同一种生成器、相同参数与版本)。
+         * @details 保存时据此判断地图当前的生成器能否由存档元数据重建；不能重建时未修改的区块也必须写入存档。
+         */
+        virtual bool generatesSameAs(const TerrainGenerator& other) const = 0;
     };
 
 } // namespace TilelandWorld
@@ -23,7 +23,8 @@ std::unique_ptr<TerrainGenerator> createTerrainGeneratorFromMetadata(const World
         meta.fractalType,
         meta.octaves,
         meta.lacunarity,
-        meta.gain);
+        meta.gain,
+        meta.latticeSpacing);
 }
 
 } // namespace TilelandWorld
@@ -15,8 +15,19 @@ struct WorldMetadata {
     int octaves{5};
     float lacunarity{2.0f};
     float gain{0.5f};
+    // 噪声采样格点间距 (Tile)：1 为逐 Tile 采样；2/4/8/16 时只在格点上采样，其余位置三线性插值。
+    // 旧存档没有此字段，读作 1。
+    int latticeSpacing{4};
 };
 
+// 两份元数据是否生成同样的地形。存档不保存未修改的区块，其余区块以生成结果为基准差异编码，
+// 因此存档创建后这些参数不能再更改。
+inline bool sameGenerationParameters(const WorldMetadata& a, const WorldMetadata& b) {
+    return a.seed == b.seed && a.frequency == b.frequency && a.noiseType == b.noiseType &&
+           a.fractalType == b.fractalType && a.octaves == b.octaves && a.lacunarity == b.lacunarity &&
+           a.gain == b.gain && a.latticeSpacing == b.latticeSpacing;
+}
+
 } // namespace TilelandWorld
 
 #endif // TILELANDWORLD_SAVEMETADATA_H
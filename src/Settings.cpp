@@ -80,9 +80,13 @@ Settings SettingsManager::load(const std::string& path) {
 
         maybeSet<int>(key, value, "viewWidth", cfg.viewWidth);
         maybeSet<int>(key, value, "viewHeight", cfg.viewHeight);
+        maybeSet<int>(key, value, "chunkMemoryBudgetMB", cfg.chunkMemoryBudgetMB);
+        maybeSet<int>(key, value, "autosaveIntervalSeconds", cfg.autosaveIntervalSeconds);
 
         maybeSet<std::string>(key, value, "saveDirectory", cfg.saveDirectory);
         maybeSet<std::string>(key, value, "assetDirectory", cfg.assetDirectory);
+        maybeSet<std::string>(key, value, "terrainDataFile", cfg.terrainDataFile);
+        maybeSet<std::string>(key, value, "simdLevel", cfg.simdLevel);
     }
 
     return cfg;
@@ -117,9 +121,13 @@ bool SettingsManager::save(const Settings& s, const std::string& path) {
 
     out << "viewWidth=" << s.viewWidth << "\n";
     out << "viewHeight=" << s.viewHeight << "\n";
+    out << "chunkMemoryBudgetMB=" << s.chunkMemoryBudgetMB << "\n";
+    out << "autosaveIntervalSeconds=" << s.autosaveIntervalSeconds << "\n";
 
     out << "saveDirectory=" << s.saveDirectory << "\n";
     out << "assetDirectory=" << s.assetDirectory << "\n";
+    out << "terrainDataFile=" << s.terrainDataFile << "\n";
+    out << "simdLevel=" << s.simdLevel << "\n";
 
     return true;
 }
@@ -31,11 +31,22 @@ struct Settings {
     // Rendering backend
     bool useFmtRenderer{false};
 
+    // Chunk residency: loaded chunks are evicted (dirty ones spilled to a swap file) above this budget; 0 = unlimited
+    int chunkMemoryBudgetMB{256};
+
     // Saves
     std::string saveDirectory{"saves"};
+    // Background autosave of the running world (snapshot + write on a worker thread); 0 = disabled
+    int autosaveIntervalSeconds{300};
 
     // Assets
     std::string assetDirectory{"res/Assets"};
+
+    // Terrain definitions (see TerrainRegistry.h); written from the built-in table if missing
+    std::string terrainDataFile{"terrains.cfg"};
+
+    // Terrain generation SIMD level: auto (best the CPU supports), sse41, sse42, avx2, avx512
+    std::string simdLevel{"auto"};
     
     // View sizing
     bool autoViewSize{false};
@@ -0,0 +1,233 @@
+#include "TerrainRegistry.h"
+#include "Constants.h" // For MAX_LIGHT_LEVEL
+#include "Utils/Logger.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+namespace TilelandWorld {
+
+    namespace {
+        // 光照缩放 (原 Tile.cpp 中的实现)，只在注册时为每个光照等级调用一次。
+        RGBColor scaleColorByLight(const RGBColor& baseColor, uint8_t lightLevel) {
+            if (lightLevel >= MAX_LIGHT_LEVEL) {
+                return baseColor;
+            }
+            const float minBrightnessFactor = 0.1f;
+            if (lightLevel == 0) {
+                 return {
+                     static_cast<uint8_t>(baseColor.r * minBrightnessFactor),
+                     static_cast<uint8_t>(baseColor.g * minBrightnessFactor),
+                     static_cast<uint8_t>(baseColor.b * minBrightnessFactor)
+                 };
+            }
+            float scale = minBrightnessFactor + (1.0f - minBrightnessFactor) * (static_cast<float>(lightLevel) / MAX_LIGHT_LEVEL);
+            RGBColor scaledColor;
+            scaledColor.r = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, baseColor.r * scale)));
+            scaledColor.g = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, baseColor.g * scale)));
+            scaledColor.b = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, baseColor.b * scale)));
+            return scaledColor;
+        }
+
+        std::string buildSgrPrefix(const RGBColor& fg, const RGBColor& bg) {
+            std::string res;
+            res.reserve(40);
+            res += "\x1b[48;2;";
+            res += std::to_string(bg.r) + ";" + std::to_string(bg.g) + ";" + std::to_string(bg.b) + "m";
+            res += "\x1b[38;2;";
+            res += std::to_string(fg.r) + ";" + std::to_string(fg.g) + ";" + std::to_string(fg.b) + "m";
+            return res;
+        }
+
+        std::string trim(const std::string& s) {
+            size_t start = 0;
+            while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) ++start;
+            size_t end = s.size();
+            while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1]))) --end;
+            return s.substr(start, end - start);
+        }
+
+        bool parseBool(const std::string& text) {
+            std::string t = text;
+            std::transform(t.begin(), t.end(), t.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+            return t == "1" || t == "true" || t == "yes" || t == "on";
+        }
+
+        // "r,g,b" -> RGBColor，各分量需在 0-255 之间
+        bool parseColor(const std::string& text, RGBColor& out) {
+            std::stringstream ss(text);
+            std::string part;
+            int comps[3];
+            for (int i = 0; i < 3; ++i) {
+                if (!std::getline(ss, part, ',')) return false;
+                comps[i] = std::stoi(trim(part));
+                if (comps[i] < 0 || comps[i] > 255) return false;
+            }
+            out = RGBColor{static_cast<uint8_t>(comps[0]), static_cast<uint8_t>(comps[1]), static_cast<uint8_t>(comps[2])};
+            return true;
+        }
+
+        // 数据文件中的一个 [名称] 分节
+        struct TerrainSection {
+            std::string name;
+            int line = 0;
+            std::vector<std::pair<std::string, std::string>> entries;
+        };
+    }
+
+    TerrainRegistry& TerrainRegistry::getInstance() {
+        static TerrainRegistry instance;
+        return instance;
+    }
+
+    TerrainRegistry::TerrainRegistry() {
+        // 内置地形
+        // TerrainProperties: {displayChar, fgColor, bgColor, allowEnterSameLevel, allowStandOnTop, isVisible, defaultMovementCost}
+        registerTerrain(TerrainType::UNKNOWN,   "UNKNOWN",   {"?",   {255, 0, 255}, {0, 0, 0},       false, false, true,  99}); // 品红前景，黑背景, 可见
+        registerTerrain(TerrainType::VOIDBLOCK, "VOIDBLOCK", {" ",   {0, 0, 0},     {0, 0, 0},       true,  false, false, 99}); // 黑前景，黑背景 (纯黑), 不可见
+        registerTerrain(TerrainType::GRASS,     "GRASS",     {"░",   {0, 180, 0},   {0, 100, 0},     true,  false, true,  1});  // 亮绿前景，暗绿背景, 可见
+        registerTerrain(TerrainType::WATER,     "WATER",     {"≈",   {0, 100, 255}, {0, 50, 150},    false, false, true,  5});  // 亮蓝前景，暗蓝背景, 可见
+        registerTerrain(TerrainType::WALL,      "WALL",      {"█",   {150, 150, 150},{100, 100, 100}, false, true,  true,  99}); // 灰色前景，深灰背景, 可见
+        registerTerrain(TerrainType::FLOOR,     "FLOOR",     {"·",   {200, 200, 200},{50, 50, 50},    true,  false, true,  1});  // 浅灰前景，非常暗的灰背景, 可见
+    }
+
+    void TerrainRegistry::registerTerrain(TerrainType type, const std::string& name, const TerrainProperties& props) {
+        const size_t id = static_cast<size_t>(type);
+        if (id >= properties.size()) {
+            // 空洞 ID 只占位，查找时由 slot 解析为 UNKNOWN
+            properties.resize(id + 1);
+            names.resize(id + 1);
+            glyphs.resize(id + 1);
+            registered.resize(id + 1, false);
+            lightRows.resize(id + 1, 0);
+        }
+
+        if (!registered[id]) {
+            // 首次注册时才分配光照表的一行
+            registered[id] = true;
+            lightRows[id] = static_cast<uint32_t>(litForeground.size() / LIGHT_LEVELS);
+            litForeground.resize(litForeground.size() + LIGHT_LEVELS);
+            litBackground.resize(litBackground.size() + LIGHT_LEVELS);
+            sgrPrefixes.resize(sgrPrefixes.size() + LIGHT_LEVELS);
+        }
+        properties[id] = props;
+        names[id] = name;
+        rebuildDerived(id);
+    }
+
+    void TerrainRegistry::rebuildDerived(size_t id) {
+        const TerrainProperties& props = properties[id];
+        glyphs[id] = props.displayChar.empty() ? " " : props.displayChar;
+        for (size_t light = 0; light < LIGHT_LEVELS; ++light) {
+            const size_t i = static_cast<size_t>(lightRows[id]) * LIGHT_LEVELS + light;
+            litForeground[i] = scaleColorByLight(props.foregroundColor, static_cast<uint8_t>(light));
+            litBackground[i] = scaleColorByLight(props.backgroundColor, static_cast<uint8_t>(light));
+            sgrPrefixes[i] = buildSgrPrefix(litForeground[i], litBackground[i]);
+        }
+    }
+
+    bool TerrainRegistry::findByName(const std::string& name, TerrainType& outType) const {
+        for (size_t id = 0; id < names.size(); ++id) {
+            if (registered[id] && names[id] == name) {
+                outType = static_cast<TerrainType>(id);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TerrainRegistry::loadFromFile(const std::string& path) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            return false;
+        }
+
+        std::vector<TerrainSection> sections;
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') continue;
+            if (line.front() == '[' && line.back() == ']') {
+                sections.push_back(TerrainSection{trim(line.substr(1, line.size() - 2)), lineNo, {}});
+                continue;
+            }
+            auto pos = line.find('=');
+            if (pos == std::string::npos || sections.empty()) {
+                LOG_WARNING("Terrain data " + path + ":" + std::to_string(lineNo) + ": ignoring line outside of a [terrain] section.");
+                continue;
+            }
+            sections.back().entries.emplace_back(trim(line.substr(0, pos)), trim(line.substr(pos + 1)));
+        }
+
+        size_t loaded = 0;
+        for (const auto& section : sections) {
+            try {
+                // 确定 ID：显式给出，或按名称匹配已注册地形
+                long id = -1;
+                for (const auto& kv : section.entries) {
+                    if (kv.first == "id") id = std::stol(kv.second);
+                }
+                if (id < 0) {
+                    TerrainType existing;
+                    if (findByName(section.name, existing)) id = static_cast<long>(existing);
+                }
+                if (id < 0 || id > 0xFFFF) {
+                    throw std::runtime_error("missing or out-of-range id");
+                }
+
+                TerrainType type = static_cast<TerrainType>(id);
+                TerrainProperties props = get(type); // 未给出的字段沿用当前值
+                for (const auto& kv : section.entries) {
+                    const std::string& key = kv.first;
+                    const std::string& value = kv.second;
+                    if (key == "id") continue;
+                    else if (key == "char") props.displayChar = value;
+                    else if (key == "fg") { if (!parseColor(value, props.foregroundColor)) throw std::runtime_error("invalid fg colour"); }
+                    else if (key == "bg") { if (!parseColor(value, props.backgroundColor)) throw std::runtime_error("invalid bg colour"); }
+                    else if (key == "enterSameLevel") props.allowEnterSameLevel = parseBool(value);
+                    else if (key == "standOnTop") props.allowStandOnTop = parseBool(value);
+                    else if (key == "visible") props.isVisible = parseBool(value);
+                    else if (key == "movementCost") props.defaultMovementCost = std::stoi(value);
+                    else LOG_WARNING("Terrain data " + path + ": unknown key '" + key + "' in [" + section.name + "].");
+                }
+
+                registerTerrain(type, section.name, props);
+                ++loaded;
+            } catch (const std::exception& e) {
+                LOG_WARNING("Terrain data " + path + ":" + std::to_string(section.line) + ": skipping [" + section.name + "]: " + e.what());
+            }
+        }
+
+        LOG_INFO("Loaded " + std::to_string(loaded) + " terrain definitions from " + path);
+        return loaded > 0;
+    }
+
+    bool TerrainRegistry::saveToFile(const std::string& path) const {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        auto colorStr = [](const RGBColor& c) {
+            return std::to_string(c.r) + "," + std::to_string(c.g) + "," + std::to_string(c.b);
+        };
+
+        out << "# TilelandWorld terrain table\n";
+        for (size_t id = 0; id < properties.size(); ++id) {
+            if (!registered[id]) continue;
+            const TerrainProperties& p = properties[id];
+            out << "\n[" << names[id] << "]\n";
+            out << "id=" << id << "\n";
+            out << "char=" << p.displayChar << "\n";
+            out << "fg=" << colorStr(p.foregroundColor) << "\n";
+            out << "bg=" << colorStr(p.backgroundColor) << "\n";
+            out << "enterSameLevel=" << (p.allowEnterSameLevel ? "1" : "0") << "\n";
+            out << "standOnTop=" << (p.allowStandOnTop ? "1" : "0") << "\n";
+            out << "visible=" << (p.isVisible ? "1" : "0") << "\n";
+            out << "movementCost=" << p.defaultMovementCost << "\n";
+        }
+        return true;
+    }
+
+} // namespace TilelandWorld
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef TILELANDWORLD_TERRAINREGISTRY_H
+#define TILELANDWORLD_TERRAINREGISTRY_H
+
+#include "TerrainTypes.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace TilelandWorld {
+
+    /**
+     * @brief 地形注册表：以地形 ID 为下标的稠密数组。
+     *
+     * 内置地形在构造时注册，启动时可通过 loadFromFile 从数据文件追加/覆盖地形，
+     * 无需重新编译即可新增地形。每个已注册地形在所有光照等级 (0-255) 下的前景/背景色、
+     * 以及对应的 SGR 转义前缀均在注册时预计算，热路径上只需两次下标访问。
+     * 光照表只为已注册的 ID 分配 (每个约 10 KiB)，因此稀疏的大 ID 不会放大内存。
+     * 空洞 ID (小于 size() 但未注册) 在查找时解析为 UNKNOWN，覆盖 UNKNOWN 后它们随之改变。
+     *
+     * 注册表只应在启动阶段 (渲染/生成线程开始之前) 修改，之后视为只读。
+     *
+     * 数据文件格式 (与 settings.cfg 相同的 key=value，按 [名称] 分节)：
+     * @code
+     * # 未给出的字段沿用同 ID 已注册地形的值 (若无则沿用 UNKNOWN)
+     * [LAVA]
+     * id=6
+     * char=≈
+     * fg=255,120,0
+     * bg=160,40,0
+     * enterSameLevel=0
+     * standOnTop=0
+     * visible=1
+     * movementCost=99
+     * @endcode
+     */
+    class TerrainRegistry {
+    public:
+        static constexpr size_t LIGHT_LEVELS = 256;
+
+        static TerrainRegistry& getInstance();
+
+        // 按 ID 获取属性；未注册的 ID 回退到 UNKNOWN (ID 0)。
+        const TerrainProperties& get(TerrainType type) const {
+            return properties[slot(type)];
+        }
+
+        // 非空的显示字符 (displayChar 为空时为一个空格)。
+        const std::string& getGlyph(TerrainType type) const {
+            return glyphs[slot(type)];
+        }
+
+        // 光照缩放后的颜色。
+        const RGBColor& getLitForeground(TerrainType type, uint8_t lightLevel) const {
+            return litForeground[lightIndex(type, lightLevel)];
+        }
+        const RGBColor& getLitBackground(TerrainType type, uint8_t lightLevel) const {
+            return litBackground[lightIndex(type, lightLevel)];
+        }
+
+        // 设置背景与前景色的 SGR 转义前缀 ("\x1b[48;2;r;g;bm\x1b[38;2;r;g;bm")。
+        const std::string& getSgrPrefix(TerrainType type, uint8_t lightLevel) const {
+            return sgrPrefixes[lightIndex(type, lightLevel)];
+        }
+
+        const std::string& getName(TerrainType type) const { return names[slot(type)]; }
+
+        // 已分配的 ID 数量 (最大 ID + 1)。
+        size_t size() const { return properties.size(); }
+
+        bool isRegistered(TerrainType type) const {
+            size_t id = static_cast<size_t>(type);
+            return id < registered.size() && registered[id];
+        }
+
+        // 按名称查找，未找到返回 false。
+        bool findByName(const std::string& name, TerrainType& outType) const;
+
+        // 注册或覆盖一个地形，并重新计算其派生数据。
+        void registerTerrain(TerrainType type, const std::string& name, const TerrainProperties& props);
+
+        /**
+         * @brief 从数据文件加载地形定义。
+         * @return 文件能打开且至少成功注册一个地形时返回 true。格式错误的分节会被跳过并记录警告。
+         */
+        bool loadFromFile(const std::string& path);
+
+        // 将当前注册表写出为数据文件，便于以内置地形为模板编辑。
+        bool saveToFile(const std::string& path) const;
+
+    private:
+        TerrainRegistry();
+        TerrainRegistry(const TerrainRegistry&) = delete;
+        TerrainRegistry& operator=(const TerrainRegistry&) = delete;
+
+        // 未注册的 ID (越界或空洞) 解析为 UNKNOWN
+        size_t slot(TerrainType type) const {
+            size_t id = static_cast<size_t>(type);
+            return id < registered.size() && registered[id] ? id : 0;
+        }
+        size_t lightIndex(TerrainType type, uint8_t lightLevel) const {
+            return static_cast<size_t>(lightRows[slot(type)]) * LIGHT_LEVELS + lightLevel;
+        }
+
+        void rebuildDerived(size_t id);
+
+        std::vector<TerrainProperties> properties; // 按 ID 索引；空洞 ID 的条目不使用
+        std::vector<std::string> names;
+        std::vector<std::string> glyphs;
+        std::vector<bool> registered;              // 空洞 ID 为 false
+        std::vector<uint32_t> lightRows;           // [id] -> 光照表的行 (只对已注册的 ID 有效)
+        std::vector<RGBColor> litForeground;       // [row * LIGHT_LEVELS + light]
+        std::vector<RGBColor> litBackground;
+        std::vector<std::string> sgrPrefixes;
+    };
+
+    // 获取地形属性：稠密数组的一次下标访问。热循环中可直接持有 TerrainRegistry 引用。
+    inline const TerrainProperties& getTerrainProperties(TerrainType type) {
+        return TerrainRegistry::getInstance().get(type);
+    }
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_TERRAINREGISTRY_H
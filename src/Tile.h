@@ -2,48 +2,91 @@
 #ifndef TILELANDWORLD_TILE_H
 #define TILELANDWORLD_TILE_H
 
-#include "TerrainTypes.h" // 引入地形类型定义
+#include "TerrainRegistry.h" // 引入地形类型定义与属性表
 #include "Constants.h"    // 引入常量定义 (例如 MAX_LIGHT_LEVEL)
 #include <cstdint>       // For uint8_t
 #include <string>        // For std::string
 
 namespace TilelandWorld {
 
-    // 定义基本的 Tile 结构
+    /**
+     * @brief 单个 Tile 的通行性/移动成本。
+     * @details 默认值来自地形属性表；个别实例需要偏离默认值时，
+     *          由所在区块的稀疏覆盖表保存 (见 Chunk::setTileOverride)。
+     */
+    struct TileTraits {
+        bool canEnterSameLevel = false; // 同层级可通行性
+        bool canStandOnTop = false;     // Tile的上表面可站立
+        int movementCost = 0;           // 移动消耗
+
+        static TileTraits fromTerrain(TerrainType type) {
+            const auto& props = getTerrainProperties(type);
+            return TileTraits{props.allowEnterSameLevel, props.allowStandOnTop, props.defaultMovementCost};
+        }
+
+        bool operator==(const TileTraits& other) const {
+            return canEnterSameLevel == other.canEnterSameLevel &&
+                   canStandOnTop == other.canStandOnTop &&
+                   movementCost == other.movementCost;
+        }
+        bool operator!=(const TileTraits& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief 基本的 Tile 结构，紧凑打包为 4 字节。
+     *
+     * 只保存实例特有的数据：地形 ID、光照、已探索位与覆盖位。
+     * 通行性与移动成本不再逐实例复制，而是由地形属性表派生；
+     * hasOverride 置位时，真实值保存在所在区块的覆盖表中。
+     */
     struct Tile {
         // --- Tile 基本类型枚举标识 ---
-        TerrainType terrain = TerrainType::UNKNOWN; // 地形类型
-
-        // --- Tile 地形属性 ---
-        // 当前 Tile 实例的通行性状态。这些值由地形的默认属性初始化，但可能被游戏逻辑修改。
-        bool canEnterSameLevel; // 同层级可通行性
-        bool canStandOnTop;     // Tile的上表面可站立
-        int movementCost;       // 移动消耗 (可能需要根据移动方式调整，例如攀爬 vs. 平地移动)
+        TerrainType terrain = TerrainType::UNKNOWN; // 地形类型 (16 位)
 
         // --- 可见性/光照 ---
         uint8_t lightLevel = MAX_LIGHT_LEVEL; // 当前光照等级 (0-255), 0=全黑, 255=全亮
-        bool isExplored = false; // 是否已被玩家探索过 (用于战争迷雾)
+        uint8_t isExplored : 1;  // 是否已被玩家探索过 (用于战争迷雾)
+        uint8_t hasOverride : 1; // 通行性/移动成本是否被区块覆盖表覆盖
+        uint8_t reservedFlags : 6; // 保留，始终为 0
 
         // --- 其他层/元素/状态 ---
-        // TODO: 添加指向或标识物体、角色、特效等的数据成员
-        // 例如：
-        // int objectId = -1;
-        // int characterId = -1;
-        // TODO: 添加特殊效果标志 (e.g., bitmask, std::set<EffectType>)
-        // TODO: 添加事件触发器 ID 或指针
-
-        // 构造函数 - 根据地形类型初始化
+        // TODO: 物体、角色、特效、事件触发器等数据应放入区块级的稀疏表，而非扩大 Tile
+
+        // 构造函数 - 根据地形类型初始化 (位域显式清零，保证比较与序列化结果确定)
         explicit Tile(TerrainType type = TerrainType::UNKNOWN) :
             terrain(type),
             lightLevel(MAX_LIGHT_LEVEL), // 默认设置为最大光照
-            isExplored(false)            // 默认未探索
-        {
-            const auto& props = getTerrainProperties(type);
-            // 初始化 Tile 的通行状态和移动成本为地形的默认值
-            canEnterSameLevel = props.allowEnterSameLevel;
-            canStandOnTop = props.allowStandOnTop;
-            movementCost = props.defaultMovementCost;
+            isExplored(0),               // 默认未探索
+            hasOverride(0),
+            reservedFlags(0)
+        {}
+
+        // --- 由地形属性表派生的默认通行性 (不考虑区块覆盖表，需要时使用 Chunk/Map::getTileTraits) ---
+        bool canEnterSameLevel() const { return getTerrainProperties(terrain).allowEnterSameLevel; }
+        bool canStandOnTop() const { return getTerrainProperties(terrain).allowStandOnTop; }
+        int movementCost() const { return getTerrainProperties(terrain).defaultMovementCost; }
+
+        /**
+         * @brief 与平台无关的 32 位打包形式，供序列化使用。
+         * @details 位 0-15: terrain, 位 16-23: lightLevel, 位 24: isExplored, 位 25: hasOverride。
+         */
+        uint32_t toPacked() const {
+            return static_cast<uint32_t>(static_cast<uint16_t>(terrain)) |
+                   (static_cast<uint32_t>(lightLevel) << 16) |
+                   (static_cast<uint32_t>(isExplored) << 24) |
+                   (static_cast<uint32_t>(hasOverride) << 25);
         }
+        static Tile fromPacked(uint32_t packed) {
+            Tile tile(static_cast<TerrainType>(packed & 0xFFFFu));
+            tile.lightLevel = static_cast<uint8_t>((packed >> 16) & 0xFFu);
+            tile.isExplored = (packed >> 24) & 1u;
+            tile.hasOverride = (packed >> 25) & 1u;
+            return tile;
+        }
+
+        // 按打包值比较，供区块调色板去重使用
+        bool operator==(const Tile& other) const { return toPacked() == other.toPacked(); }
+        bool operator!=(const Tile& other) const { return !(*this == other); }
 
         const std::string& getDisplayChar() const; // 获取用于显示的字符
 
@@ -52,6 +95,8 @@ namespace TilelandWorld {
         RGBColor getBackgroundColor() const; // 返回计算后的颜色，实现移至 cpp
     };
 
+    static_assert(sizeof(Tile) == 4, "Tile 应紧凑打包为 4 字节");
+
 } // namespace TilelandWorld
 
 #endif // TILELANDWORLD_TILE_H
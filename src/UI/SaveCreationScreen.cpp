@@ -36,12 +36,14 @@ namespace {
     }
 }
 
-SaveCreationScreen::SaveCreationScreen(std::string defaultDirectory, WorldMetadata defaults, std::string defaultNameValue, bool lockName, bool lockDirectory)
+SaveCreationScreen::SaveCreationScreen(std::string defaultDirectory, WorldMetadata defaults, std::string defaultNameValue, bool lockName, bool lockDirectory, bool lockGeneration)
     : surface(100, 40), name(defaultNameValue.empty() ? defaultName() : sanitizedName(defaultNameValue)), directory(std::move(defaultDirectory)), meta(defaults) {
     allowNameEdit = !lockName;
     allowDirectoryEdit = !lockDirectory;
+    allowGenerationEdit = !lockGeneration;
     noiseChoices = {"OpenSimplex2", "Perlin", "Value"};
     fractalChoices = {"FBm", "Ridged", "PingPong"};
+    latticeChoices = {1, 2, 4, 8};
     syncChoiceFromMetadata();
     buildFields();
 }
@@ -59,6 +61,7 @@ void SaveCreationScreen::buildFields() {
     fields.push_back(Field{"Octaves", FieldType::Integer, 1.0, 1.0, 12.0});
     fields.push_back(Field{"Lacunarity", FieldType::Float, 0.1, 1.0, 4.0});
     fields.push_back(Field{"Gain", FieldType::Float, 0.05, 0.1, 1.0});
+    fields.push_back(Field{"Noise lattice", FieldType::Choice});
     fields.push_back(Field{"Create", FieldType::Action});
 }
 
@@ -73,6 +76,11 @@ void SaveCreationScreen::syncChoiceFromMetadata() {
     fractalIndex = findIdx(fractalChoices, meta.fractalType, 0);
     meta.noiseType = noiseChoices[noiseIndex];
     meta.fractalType = fractalChoices[fractalIndex];
+    latticeIndex = 0;
+    for (size_t i = 0; i < latticeChoices.size(); ++i) {
+        if (latticeChoices[i] == meta.latticeSpacing) latticeIndex = i;
+    }
+    meta.latticeSpacing = latticeChoices[latticeIndex];
 }
 
 SaveCreationScreen::Result SaveCreationScreen::show() {
@@ -125,6 +133,7 @@ SaveCreationScreen::Result SaveCreationScreen::show() {
     if (accepted) {
         meta.noiseType = noiseChoices[noiseIndex];
         meta.fractalType = fractalChoices[fractalIndex];
+        meta.latticeSpacing = latticeChoices[latticeIndex];
         result.accepted = true;
         result.metadata = meta;
         result.saveDirectory = directory;
@@ -160,7 +169,7 @@ void SaveCreationScreen::renderFrame() {
     for (size_t i = 0; i < fields.size(); ++i) {
         bool focus = i == selected;
         bool editing = (static_cast<int>(i) == editingIndex);
-        RGBColor rowFg = focus ? theme.focusFg : theme.itemFg;
+        RGBColor rowFg = focus ? theme.focusFg : (isFieldEditable(i) ? theme.itemFg : theme.hintFg);
         RGBColor rowBg = focus ? theme.focusBg : theme.panel;
         if (editing) {
             rowBg = TuiUtils::blendColor(rowBg, theme.accent, 0.25);
@@ -211,6 +220,7 @@ std::string SaveCreationScreen::valueForField(size_t idx) const {
         case FieldType::Choice:
             if (idx == 4) return noiseChoices[noiseIndex];
             if (idx == 5) return fractalChoices[fractalIndex];
+            if (idx == 9) return latticeChoices[latticeIndex] == 1 ? std::string("every tile") : "every " + std::to_string(latticeChoices[latticeIndex]) + " tiles";
             return "";
         case FieldType::Action:
             return "[ Create ]";
@@ -253,6 +263,7 @@ void SaveCreationScreen::handleKey(int key, bool& running, bool& accepted) {
     } else if (key == kArrowDown || key == 's' || key == 'S') {
         selected = (selected + 1) % fields.size();
     } else if (key == kArrowLeft || key == 'a' || key == 'A') {
+        if (!isFieldEditable(selected)) return;
         auto& f = fields[selected];
         if (f.type == FieldType::Integer) {
             if (selected == 2) {
@@ -266,8 +277,10 @@ void SaveCreationScreen::handleKey(int key, bool& running, bool& accepted) {
             else if (selected == 8) meta.gain = static_cast<float>(clampDouble(meta.gain - f.step, f.minVal, f.maxVal));
         } else if (f.type == FieldType::Choice) {
             if (selected == 4 && noiseIndex > 0) --noiseIndex; else if (selected == 5 && fractalIndex > 0) --fractalIndex;
+            else if (selected == 9 && latticeIndex > 0) --latticeIndex;
         }
     } else if (key == kArrowRight || key == 'd' || key == 'D' || key == ' ') {
+        if (!isFieldEditable(selected)) return;
         auto& f = fields[selected];
         if (f.type == FieldType::Integer) {
             if (selected == 2) {
@@ -281,6 +294,7 @@ void SaveCreationScreen::handleKey(int key, bool& running, bool& accepted) {
             else if (selected == 8) meta.gain = static_cast<float>(clampDouble(meta.gain + f.step, f.minVal, f.maxVal));
         } else if (f.type == FieldType::Choice) {
             if (selected == 4 && noiseIndex + 1 < noiseChoices.size()) ++noiseIndex; else if (selected == 5 && fractalIndex + 1 < fractalChoices.size()) ++fractalIndex;
+            else if (selected == 9 && latticeIndex + 1 < latticeChoices.size()) ++latticeIndex;
         } else if (f.type == FieldType::Action) {
             accepted = true; running = false; return;
         } else if (f.type == FieldType::Directory) {
@@ -300,7 +314,7 @@ void SaveCreationScreen::handleKey(int key, bool& running, bool& accepted) {
     } else if (key == 'b' || key == 'B') {
         if (allowDirectoryEdit) openDirectoryPicker();
     } else if (key == 'r' || key == 'R') {
-        if (selected == 2 || selected == fields.size() - 1) { // seed row or create row
+        if (allowGenerationEdit && (selected == 2 || selected == fields.size() - 1)) { // seed row or create row
             randomizeSeed();
         }
     } else if (key == 'e' || key == 'E') {
@@ -355,11 +369,13 @@ void SaveCreationScreen::handleMouse(const InputEvent& ev, bool& running, bool&
 
         if (f.type == FieldType::Directory) {
             if (allowDirectoryEdit) openDirectoryPicker();
-        } else if (f.type == FieldType::Choice) {
+        } else if (f.type == FieldType::Choice && isFieldEditable(idx)) {
             if (idx == 4) {
                 noiseIndex = (noiseIndex + 1) % noiseChoices.size();
             } else if (idx == 5) {
                 fractalIndex = (fractalIndex + 1) % fractalChoices.size();
+            } else if (idx == 9) {
+                latticeIndex = (latticeIndex + 1) % latticeChoices.size();
             }
         } else if (f.type == FieldType::Action) {
             accepted = true; running = false;
@@ -367,9 +383,16 @@ void SaveCreationScreen::handleMouse(const InputEvent& ev, bool& running, bool&
     }
 }
 
+bool SaveCreationScreen::isFieldEditable(size_t idx) const {
+    if (idx == 0) return allowNameEdit;
+    if (idx == 1) return allowDirectoryEdit;
+    if (idx >= 2 && idx <= 9) return allowGenerationEdit; // 种子到采样间距
+    return true;
+}
+
 void SaveCreationScreen::startEdit(size_t idx) {
     if (idx >= fields.size()) return;
-    if ((idx == 0 && !allowNameEdit) || (idx == 1 && !allowDirectoryEdit)) return;
+    if (!isFieldEditable(idx)) return;
     editingIndex = static_cast<int>(idx);
     editingType = fields[idx].type;
     if (editingType == FieldType::Text) {
@@ -22,7 +22,7 @@ public:
         WorldMetadata metadata{};
     };
 
-    explicit SaveCreationScreen(std::string defaultDirectory, WorldMetadata defaults = {}, std::string defaultName = {}, bool lockName = false, bool lockDirectory = false);
+    explicit SaveCreationScreen(std::string defaultDirectory, WorldMetadata defaults = {}, std::string defaultName = {}, bool lockName = false, bool lockDirectory = false, bool lockGeneration = false);
 
     // 显示创建界面，返回结果；accepted=false 表示取消
     Result show();
@@ -49,6 +49,8 @@ private:
 
     bool allowNameEdit{true};
     bool allowDirectoryEdit{true};
+    // 编辑已有存档时锁定生成参数：已保存区块以原参数的生成结果为基准
+    bool allowGenerationEdit{true};
 
     std::vector<Field> fields;
     size_t selected{0};
@@ -64,8 +66,10 @@ private:
     // choices
     std::vector<std::string> noiseChoices;
     std::vector<std::string> fractalChoices;
+    std::vector<int> latticeChoices; // 噪声采样格点间距
     size_t noiseIndex{0};
     size_t fractalIndex{0};
+    size_t latticeIndex{0};
 
     // layout cache
     int listStartY{6};
@@ -84,6 +88,7 @@ private:
     void renderFrame();
     void handleKey(int key, bool& running, bool& accepted);
     void handleMouse(const InputEvent& ev, bool& running, bool& accepted);
+    bool isFieldEditable(size_t idx) const;
     void startEdit(size_t idx);
     void commitEdit();
     void cancelEdit();
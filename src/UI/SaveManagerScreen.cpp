@@ -78,14 +78,14 @@ void SaveManagerScreen::show() {
     input.stop();
 }
 
-void SaveManagerScreen::runGame(std::unique_ptr<Map> map) {
+void SaveManagerScreen::runGame(std::unique_ptr<Map> map, const std::string& saveName) {
     if (!map) return;
 
     // 清屏：进入游戏主循环前做一次 ANSI 清屏
     std::cout << "\x1b[2J\x1b[H" << std::flush;
 
     try {
-        TuiCoreController controller(*map, settings);
+        TuiCoreController controller(*map, settings, saveName);
         LOG_INFO("SaveManager: TuiCoreController created.");
 
         controller.initialize();
@@ -197,7 +197,8 @@ void SaveManagerScreen::renderInfoBar() {
           << " | Fractal " << summary.metadata.fractalType
           << " | Oct " << summary.metadata.octaves
           << " | Lac " << std::setprecision(2) << summary.metadata.lacunarity
-          << " | Gain " << std::setprecision(2) << summary.metadata.gain;
+          << " | Gain " << std::setprecision(2) << summary.metadata.gain
+          << " | Lattice " << summary.metadata.latticeSpacing;
     std::string l2 = line2.str();
     l2 = TuiUtils::trimToUtf8VisualWidth(l2, surface.getWidth() - 4);
     surface.drawText(2, y + 1, l2, theme.itemFg, theme.panel);
@@ -231,7 +232,7 @@ void SaveManagerScreen::handleKey(int key, bool& running, Result&, InputControll
             if (map) {
                 LOG_INFO("SaveManager: Loaded save '" + saveName + "'. Starting game.");
                 input.stop();
-                runGame(std::move(map));
+                runGame(std::move(map), saveName);
                 input.start();
                 refreshList();
             } else {
@@ -252,7 +253,7 @@ void SaveManagerScreen::handleKey(int key, bool& running, Result&, InputControll
                 MapSerializer::saveCompressedMap(*map, form.saveName, settings.saveDirectory, false);
 
                 LOG_INFO("SaveManager: Created new save '" + form.saveName + "'. Starting game.");
-                runGame(std::move(map));
+                runGame(std::move(map), form.saveName);
                 refreshList();
             }
             input.start();
@@ -325,7 +326,7 @@ bool SaveManagerScreen::editSave(size_t idx, InputController& input) {
     if (infoCache.size() <= idx || !infoCache[idx].ok) return false;
 
     auto meta = infoCache[idx].summary.metadata;
-    SaveCreationScreen editor(settings.saveDirectory, meta, saves[idx], true, true);
+    SaveCreationScreen editor(settings.saveDirectory, meta, saves[idx], true, true, true);
 
     input.stop();
     auto form = editor.show();
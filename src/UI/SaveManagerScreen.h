@@ -59,7 +59,8 @@ private:
     std::string formatBytes(size_t bytes) const;
     bool editSave(size_t idx, InputController& input);
 
-    void runGame(std::unique_ptr<Map> map);
+    // saveName 用于游戏中的后台自动保存
+    void runGame(std::unique_ptr<Map> map, const std::string& saveName);
     bool deleteSelected();
 };
 
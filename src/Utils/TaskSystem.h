@@ -56,6 +56,9 @@ namespace TilelandWorld {
          */
         void stop();
 
+        // 工作线程数量
+        size_t getThreadCount() const { return workers.size(); }
+
     private:
         std::vector<std::thread> workers;
         std::queue<std::function<void()>> tasks;
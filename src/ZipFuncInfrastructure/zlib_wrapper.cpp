@@ -5,6 +5,8 @@
 
 #include <limits> // For numeric_limits
 #include <stdexcept> // For std::length_error
+#include <algorithm> // For std::min
+#include <utility>
 
 // Define byte_vector locally for convenience if needed, or use std::vector<Bytef> directly
 using byte_vector = std::vector<Bytef>;
@@ -23,64 +25,260 @@ namespace SimpZlib {
         }
     }
 
-    // Wrapper function signature uses types from zlib.h
-    Status compress(const byte_vector& input, byte_vector& output, int level) {
-        // Use z_uLong (from zlib.h via Z_PREFIX) for internal length variables
-        // These types are directly available because zlib.h is included.
-        z_uLong destLenEst = ::z_compressBound(input.size());
-        output.resize(destLenEst);
+    namespace {
+        // Contexts kept per thread and kind; more than this are simply freed on release.
+        constexpr size_t MAX_POOLED_STREAMS = 4;
+        // zlib counts buffer sizes in uInt; larger buffers are fed in slices of this size.
+        constexpr size_t MAX_STREAM_SLICE = std::numeric_limits<uInt>::max();
 
-        z_uLong destLen = destLenEst;
+        thread_local bool poolDestroyed = false;
 
-        if (input.size() > std::numeric_limits<z_uLong>::max()) {
-             output.clear();
-             return Status::StreamError;
+        struct StreamPool {
+            std::vector<std::pair<int, z_stream*>> deflaters; // (level, stream)
+            std::vector<z_stream*> inflaters;
+
+            ~StreamPool() {
+                for (auto& entry : deflaters) {
+                    deflateEnd(entry.second);
+                    delete entry.second;
+                }
+                for (z_stream* stream : inflaters) {
+                    inflateEnd(stream);
+                    delete stream;
+                }
+                poolDestroyed = true;
+            }
+        };
+
+        StreamPool& threadPool() {
+            thread_local StreamPool pool;
+            return pool;
+        }
+
+        z_stream* acquireDeflater(int level) {
+            if (!poolDestroyed) {
+                auto& pooled = threadPool().deflaters;
+                for (auto it = pooled.begin(); it != pooled.end(); ++it) {
+                    if (it->first != level) continue;
+                    z_stream* stream = it->second;
+                    pooled.erase(it);
+                    return stream;
+                }
+            }
+            z_stream* stream = new z_stream{};
+            if (deflateInit(stream, level) != Z_OK) {
+                delete stream;
+                return nullptr;
+            }
+            return stream;
+        }
+
+        // Streams are reset when released (not when acquired), so a pooled stream is always ready to use.
+        void releaseDeflater(z_stream* stream, int level) {
+            if (!stream) return;
+            if (!poolDestroyed && threadPool().deflaters.size() < MAX_POOLED_STREAMS && deflateReset(stream) == Z_OK) {
+                threadPool().deflaters.emplace_back(level, stream);
+                return;
+            }
+            deflateEnd(stream);
+            delete stream;
+        }
+
+        z_stream* acquireInflater() {
+            if (!poolDestroyed && !threadPool().inflaters.empty()) {
+                z_stream* stream = threadPool().inflaters.back();
+                threadPool().inflaters.pop_back();
+                return stream;
+            }
+            z_stream* stream = new z_stream{};
+            if (inflateInit(stream) != Z_OK) {
+                delete stream;
+                return nullptr;
+            }
+            return stream;
+        }
+
+        void releaseInflater(z_stream* stream) {
+            if (!stream) return;
+            if (!poolDestroyed && threadPool().inflaters.size() < MAX_POOLED_STREAMS && inflateReset(stream) == Z_OK) {
+                threadPool().inflaters.push_back(stream);
+                return;
+            }
+            inflateEnd(stream);
+            delete stream;
+        }
+
+        uInt sliceOf(size_t remaining) {
+            return static_cast<uInt>(std::min(remaining, MAX_STREAM_SLICE));
+        }
+    }
+
+    // --- Deflater ---
+
+    Deflater::Deflater(int level)
+        : stream(acquireDeflater(level)), level(level), started(false), finished(false), dictionary(nullptr), dictionarySize(0) {}
+
+    Deflater::~Deflater() {
+        releaseDeflater(stream, level);
+    }
+
+    void Deflater::reset() {
+        if (stream && started) deflateReset(stream);
+        started = false;
+        finished = false;
+    }
+
+    void Deflater::setDictionary(const Bytef* data, size_t size) {
+        dictionary = size > 0 ? data : nullptr;
+        dictionarySize = dictionary ? size : 0;
+    }
+
+    size_t Deflater::bound(size_t inputSize) const {
+        // deflateBound only counts the 4-byte DICTID once the dictionary has been set, which push() does lazily
+        const size_t dictId = dictionary ? 4 : 0;
+        if (stream && inputSize <= std::numeric_limits<uLong>::max()) return deflateBound(stream, static_cast<uLong>(inputSize)) + dictId;
+        return ::z_compressBound(static_cast<z_uLong>(inputSize)) + dictId;
+    }
+
+    Status Deflater::push(const Bytef* input, size_t inputSize, Bytef* output, size_t outputCapacity,
+                          size_t& inputConsumed, size_t& outputProduced, bool finish) {
+        inputConsumed = 0;
+        outputProduced = 0;
+        if (!stream) return Status::MemoryError;
+        if (finished) return inputSize == 0 ? Status::OK : Status::StreamError;
+        if (!started) {
+            started = true;
+            if (dictionary) {
+                if (dictionarySize > MAX_STREAM_SLICE) return Status::StreamError;
+                const int ret = deflateSetDictionary(stream, dictionary, static_cast<uInt>(dictionarySize));
+                if (ret != Z_OK) return mapZlibError(ret);
+            }
         }
-        z_uLong sourceLen = input.size(); // Direct assignment, size_t to z_uLong
 
-        // Call zlib function - types match due to zlib.h inclusion and Z_PREFIX
-        int ret = ::z_compress2(output.data(), &destLen, input.data(), sourceLen, level);
+        for (;;) {
+            const uInt inSlice = sliceOf(inputSize - inputConsumed);
+            const uInt outSlice = sliceOf(outputCapacity - outputProduced);
+            stream->next_in = const_cast<Bytef*>(input) + inputConsumed;
+            stream->avail_in = inSlice;
+            stream->next_out = output + outputProduced;
+            stream->avail_out = outSlice;
+            const bool lastSlice = finish && inSlice == inputSize - inputConsumed;
+
+            const int ret = deflate(stream, lastSlice ? Z_FINISH : Z_NO_FLUSH);
+            inputConsumed += inSlice - stream->avail_in;
+            outputProduced += outSlice - stream->avail_out;
 
-        Status status = mapZlibError(ret);
+            if (ret == Z_STREAM_END) {
+                finished = true;
+                return Status::OK;
+            }
+            if (ret == Z_BUF_ERROR) return Status::OK; // No progress possible: output full (or nothing to do)
+            if (ret != Z_OK) return mapZlibError(ret);
+            if (outputProduced == outputCapacity) return Status::OK;
+            if (!finish && inputConsumed == inputSize) return Status::OK;
+        }
+    }
+
+    Status Deflater::compressAll(const Bytef* input, size_t inputSize, std::vector<Bytef>& output) {
+        reset();
+        output.resize(bound(inputSize));
+        size_t consumed = 0, produced = 0;
+        Status status = push(input, inputSize, output.data(), output.size(), consumed, produced, true);
+        if (status == Status::OK && !finished) status = Status::OutputBufferError;
         if (status == Status::OK) {
-            output.resize(destLen);
+            output.resize(produced);
         } else {
             output.clear();
         }
         return status;
     }
 
-    // Wrapper function signature uses types from zlib.h
-    Status uncompress(const byte_vector& input, byte_vector& output, uLong known_uncompressed_size) {
-        // known_uncompressed_size is already uLong (which becomes z_uLong due to Z_PREFIX)
-        z_uLong destLenExpected = known_uncompressed_size; // Direct use
+    // --- Inflater ---
 
-        if (destLenExpected == 0) {
-             output.clear();
-             return Status::StreamError;
+    Inflater::Inflater() : stream(acquireInflater()), finished(false), dictionary(nullptr), dictionarySize(0) {}
+
+    Inflater::~Inflater() {
+        releaseInflater(stream);
+    }
+
+    void Inflater::reset() {
+        if (stream && (finished || stream->total_in != 0 || stream->total_out != 0)) inflateReset(stream);
+        finished = false;
+    }
+
+    void Inflater::setDictionary(const Bytef* data, size_t size) {
+        dictionary = size > 0 ? data : nullptr;
+        dictionarySize = dictionary ? size : 0;
+    }
+
+    Status Inflater::pull(const Bytef* input, size_t inputSize, Bytef* output, size_t outputCapacity,
+                          size_t& inputConsumed, size_t& outputProduced) {
+        inputConsumed = 0;
+        outputProduced = 0;
+        if (!stream) return Status::MemoryError;
+        if (finished) return inputSize == 0 ? Status::OK : Status::DataError; // Trailing bytes after the stream
+
+        for (;;) {
+            const uInt inSlice = sliceOf(inputSize - inputConsumed);
+            const uInt outSlice = sliceOf(outputCapacity - outputProduced);
+            stream->next_in = const_cast<Bytef*>(input) + inputConsumed;
+            stream->avail_in = inSlice;
+            stream->next_out = output + outputProduced;
+            stream->avail_out = outSlice;
+
+            const int ret = inflate(stream, Z_NO_FLUSH);
+            inputConsumed += inSlice - stream->avail_in;
+            outputProduced += outSlice - stream->avail_out;
+
+            if (ret == Z_STREAM_END) {
+                finished = true;
+                return Status::OK;
+            }
+            if (ret == Z_BUF_ERROR) return Status::OK; // Needs more input or more output space
+            if (ret == Z_NEED_DICT) {
+                // inflateSetDictionary checks the dictionary's Adler-32 against the one recorded in the stream
+                if (!dictionary || dictionarySize > MAX_STREAM_SLICE
+                    || inflateSetDictionary(stream, dictionary, static_cast<uInt>(dictionarySize)) != Z_OK) {
+                    return Status::DataError;
+                }
+                continue;
+            }
+            if (ret != Z_OK) return mapZlibError(ret);
+            if (outputProduced == outputCapacity || inputConsumed == inputSize) return Status::OK;
         }
+    }
+
+    Status Inflater::uncompressAll(const Bytef* input, size_t inputSize, Bytef* output, size_t outputSize) {
+        reset();
+        size_t consumed = 0, produced = 0;
+        Status status = pull(input, inputSize, output, outputSize, consumed, produced);
+        if (status != Status::OK) return status;
+        if (!finished) {
+            // Output full before the end of the stream means the expected size is too small; otherwise the input is truncated
+            return produced == outputSize ? Status::OutputBufferError : Status::DataError;
+        }
+        return produced == outputSize ? Status::OK : Status::DataError;
+    }
 
-        output.resize(destLenExpected);
-        z_uLong destLen = destLenExpected;
+    // --- Whole-buffer helpers ---
 
-        if (input.size() > std::numeric_limits<z_uLong>::max()) {
+    Status compress(const byte_vector& input, byte_vector& output, int level, const byte_vector* dictionary) {
+        Deflater deflater(level);
+        if (dictionary) deflater.setDictionary(dictionary->data(), dictionary->size());
+        return deflater.compressAll(input.data(), input.size(), output);
+    }
+
+    Status uncompress(const byte_vector& input, byte_vector& output, uLong known_uncompressed_size, const byte_vector* dictionary) {
+        if (known_uncompressed_size == 0) {
              output.clear();
              return Status::StreamError;
         }
-        z_uLong sourceLen = input.size(); // Direct assignment
 
-        // Call zlib function - types match
-        int ret = ::z_uncompress(output.data(), &destLen, input.data(), sourceLen);
-
-        Status status = mapZlibError(ret);
-        if (status == Status::OK) {
-            if (destLen != destLenExpected) {
-                 output.resize(destLen);
-                 return Status::DataError;
-            }
-        } else {
-            output.clear();
-        }
+        output.resize(known_uncompressed_size);
+        Inflater inflater;
+        if (dictionary) inflater.setDictionary(dictionary->data(), dictionary->size());
+        Status status = inflater.uncompressAll(input.data(), input.size(), output.data(), output.size());
+        if (status != Status::OK) output.clear();
         return status;
     }
 
@@ -20,13 +20,89 @@ namespace SimpZlib {
 
     // Compresses data using zlib default settings or a specified level.
     // Uses types directly from zlib.h
-    Status compress(const std::vector<Bytef>& input, std::vector<Bytef>& output, int level = -1); // Use std::vector<Bytef>
+    // An optional preset dictionary (see Deflater::setDictionary) must be passed again to uncompress().
+    Status compress(const std::vector<Bytef>& input, std::vector<Bytef>& output, int level = -1,
+                    const std::vector<Bytef>* dictionary = nullptr); // Use std::vector<Bytef>
 
     // Decompresses data. known_uncompressed_size must be the exact size of the original data.
     // Uses types directly from zlib.h
-    Status uncompress(const std::vector<Bytef>& input, std::vector<Bytef>& output, uLong known_uncompressed_size); // Use uLong
+    Status uncompress(const std::vector<Bytef>& input, std::vector<Bytef>& output, uLong known_uncompressed_size,
+                      const std::vector<Bytef>* dictionary = nullptr); // Use uLong
 
     // Optional: Function to get error string (implement in cpp)
     // std::string getStatusString(Status s);
 
+    // --- Streaming API ---
+    // Deflater/Inflater borrow a z_stream from a small per-thread pool on construction and hand it back
+    // (after deflateReset/inflateReset) on destruction, so compressing many small payloads does not
+    // allocate and initialise a full deflate state each time. Output always goes to a caller-provided
+    // buffer; when it fills up, call again with the unconsumed remainder of the input.
+    // compress()/uncompress() above use the same pool.
+
+    class Deflater {
+    public:
+        explicit Deflater(int level = Z_DEFAULT_COMPRESSION);
+        ~Deflater();
+        Deflater(const Deflater&) = delete;
+        Deflater& operator=(const Deflater&) = delete;
+
+        // Compresses input[0, inputSize) into output[0, outputCapacity). Pass finish = true with the last piece
+        // of input (possibly empty) and keep calling until isFinished(). inputConsumed/outputProduced report
+        // how much of each buffer this call used.
+        Status push(const Bytef* input, size_t inputSize, Bytef* output, size_t outputCapacity,
+                    size_t& inputConsumed, size_t& outputProduced, bool finish);
+
+        // Preset dictionary applied at the start of every stream (deflateSetDictionary) until changed.
+        // The bytes are not copied and must outlive the streams that use them; pass nullptr to clear.
+        void setDictionary(const Bytef* data, size_t size);
+
+        // Compresses a whole buffer as one stream into output (resized to fit; capacity is reused).
+        Status compressAll(const Bytef* input, size_t inputSize, std::vector<Bytef>& output);
+
+        bool isFinished() const { return finished; }
+        void reset(); // Starts a new stream on the same context.
+        bool valid() const { return stream != nullptr; }
+
+        // Upper bound of the compressed size of inputSize bytes at this level (including the DICTID of a preset dictionary).
+        size_t bound(size_t inputSize) const;
+
+    private:
+        z_stream* stream;
+        int level;
+        bool started;
+        bool finished;
+        const Bytef* dictionary;
+        size_t dictionarySize;
+    };
+
+    class Inflater {
+    public:
+        Inflater();
+        ~Inflater();
+        Inflater(const Inflater&) = delete;
+        Inflater& operator=(const Inflater&) = delete;
+
+        // Decompresses input into output[0, outputCapacity). isFinished() becomes true at the end of the stream;
+        // an output buffer that fills up is not an error, call again with the remaining input.
+        Status pull(const Bytef* input, size_t inputSize, Bytef* output, size_t outputCapacity,
+                    size_t& inputConsumed, size_t& outputProduced);
+
+        // Dictionary supplied when a stream asks for one (inflateSetDictionary). Streams compressed without a
+        // dictionary still decode; a stream that needs a different dictionary fails with DataError.
+        void setDictionary(const Bytef* data, size_t size);
+
+        // Decompresses a whole stream into output[0, outputSize); fails unless exactly outputSize bytes come out.
+        Status uncompressAll(const Bytef* input, size_t inputSize, Bytef* output, size_t outputSize);
+
+        bool isFinished() const { return finished; }
+        void reset();
+        bool valid() const { return stream != nullptr; }
+
+    private:
+        z_stream* stream;
+        bool finished;
+        const Bytef* dictionary;
+        size_t dictionarySize;
+    };
+
 } // namespace SimpZlib
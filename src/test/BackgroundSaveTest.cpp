@@ -0,0 +1,200 @@
+#include "../Map.h"
+#include "../BinaryFileInfrastructure/BackgroundSaver.h"
+#include "../BinaryFileInfrastructure/MapSerializer.h"
+#include "../BinaryFileInfrastructure/ChunkSwapFile.h"
+#include "../BinaryFileInfrastructure/LazyChunkFile.h"
+#include "../Constants.h"
+#include "../Utils/Logger.h"
+#include "../Utils/TaskSystem.h"
+#include "TestTiles.h"
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include <cassert>
+
+using namespace TilelandWorld;
+
+namespace {
+    const std::string saveName = "background_save_test";
+    const std::string swapPath = "background_save_test.tlws";
+    const int side = 12;
+
+    // 每个区块放一个标记，并改写一行使区块为非均匀形态 (索引数组参与写时复制)
+    void markAll(Map& map, int value) {
+        for (int cy = 0; cy < side; ++cy) {
+            for (int cx = 0; cx < side; ++cx) {
+                for (int x = 0; x < CHUNK_WIDTH; ++x) map.setTile(cx * CHUNK_WIDTH + x, cy * CHUNK_HEIGHT, 1, Tile(TerrainType::GRASS));
+                map.setTile(cx * CHUNK_WIDTH + 2, cy * CHUNK_HEIGHT + 3, 1, markerTile(value + cx + cy));
+            }
+        }
+    }
+
+    bool allMarked(Map& map, int value) {
+        for (int cy = 0; cy < side; ++cy) {
+            for (int cx = 0; cx < side; ++cx) {
+                if (!(map.getTile(cx * CHUNK_WIDTH + 2, cy * CHUNK_HEIGHT + 3, 1) == markerTile(value + cx + cy))) return false;
+            }
+        }
+        return true;
+    }
+
+    void removeSaveFiles() {
+        std::filesystem::remove(MapSerializer::getTlwzPath(saveName, "."));
+        std::filesystem::remove(MapSerializer::getTlwfPath(saveName, "."));
+        std::filesystem::remove(MapSerializer::getTlwzPath(saveName, ".") + ".tmp");
+        std::filesystem::remove(MapSerializer::getTlwfPath(saveName, ".") + ".tmp");
+    }
+
+    std::vector<char> readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    Tile markerAt(Map& map, int cx, int cy) {
+        return map.getTile(cx * CHUNK_WIDTH + 2, cy * CHUNK_HEIGHT + 3, 1);
+    }
+}
+
+// 快照与地图共享索引数组，修改地图时先复制，快照内容不变
+bool testSnapshotCopyOnWrite() {
+    std::cout << "\n--- Testing Snapshot Copy-On-Write ---" << std::endl;
+    Map map;
+    markAll(map, 1);
+
+    std::unique_ptr<Map> snapshot = MapSerializer::createSaveSnapshot(map);
+    assert(snapshot->getLoadedChunkCount() == map.getLoadedChunkCount());
+    assert(snapshot->getWorldMetadata().noiseType == map.getWorldMetadata().noiseType);
+    const Chunk* live = map.getChunk(0, 0, 0);
+    const Chunk* copy = snapshot->getChunk(0, 0, 0);
+    assert(live && copy && copy != live);
+    assert(!live->isUniform() && live->sharesIndicesWith(*copy));
+    assert(copy->isDirty());
+
+    map.setTile(2, 3, 1, markerTile(9));
+    assert(!map.getChunk(0, 0, 0)->sharesIndicesWith(*copy));
+    assert(snapshot->getTile(2, 3, 1) == markerTile(1));
+    assert(map.getTile(2, 3, 1) == markerTile(9));
+    // 其他区块仍共享
+    assert(map.getChunk(1, 1, 0)->sharesIndicesWith(*snapshot->getChunk(1, 1, 0)));
+
+    std::cout << "Snapshot copy-on-write tests passed." << std::endl;
+    return true;
+}
+
+// 保存进行期间修改、卸载区块：存档是快照时刻的内容，之后的保存包含新修改
+bool testBackgroundSave() {
+    std::cout << "\n--- Testing Background Save ---" << std::endl;
+    const std::string tlwzPath = MapSerializer::getTlwzPath(saveName, ".");
+    removeSaveFiles();
+
+    TaskSystem taskSystem(2);
+    Map map;
+    map.setChunkStore(std::make_shared<ChunkSwapFile>(swapPath));
+    markAll(map, 1);
+    // 已有的存档在保存期间保持完整，替换是原子的
+    assert(MapSerializer::saveCompressedMap(map, saveName, "."));
+
+    BackgroundSaver saver(saveName, ".");
+    markAll(map, 2);
+    assert(saver.schedule(map, taskSystem));
+    if (saver.isSaving()) {
+        assert(!saver.schedule(map, taskSystem)); // 同一时间只进行一次保存
+    }
+
+    // 保存期间继续修改，并把一半区块卸载到交换文件 (卸载的是修改后的版本)
+    markAll(map, 3);
+    for (int cy = 0; cy < side / 2; ++cy)
+        for (int cx = 0; cx < side; ++cx) assert(map.unloadChunk(cx, cy, 0));
+    assert(saver.wait());
+    assert(!saver.isSaving());
+    assert(!std::filesystem::exists(tlwzPath + ".tmp"));
+
+    auto stats = saver.getStats();
+    assert(stats.scheduledCount == 1 && stats.completedCount == 1 && stats.failedCount == 0);
+    assert(stats.lastSave.chunkCount == static_cast<size_t>(side * side));
+    std::cout << "Snapshot of " << side * side << " chunks took " << stats.lastSnapshotSeconds * 1000.0
+              << " ms, background save " << stats.lastSaveSeconds * 1000.0 << " ms." << std::endl;
+
+    {
+        auto saved = MapSerializer::loadMapFromSave(saveName, ".", false);
+        assert(saved);
+        assert(allMarked(*saved, 2));
+    }
+
+    // 下一次保存包含快照之后的修改 (含已卸载到交换文件的区块)
+    assert(saver.schedule(map, taskSystem));
+    assert(saver.wait());
+    assert(saver.getStats().completedCount == 2);
+    {
+        auto saved = MapSerializer::loadMapFromSave(saveName, ".", false);
+        assert(saved);
+        assert(allMarked(*saved, 3));
+    }
+    assert(allMarked(map, 3));
+
+    removeSaveFiles();
+    std::cout << "Background save tests passed." << std::endl;
+    return true;
+}
+
+// 地图从 .tlwf 按需读取时，提供修改区块的保存经日志追加到 .tlwf，不重写 .tlwz
+bool testJournaledSave() {
+    std::cout << "\n--- Testing Journaled Save ---" << std::endl;
+    const std::string tlwzPath = MapSerializer::getTlwzPath(saveName, ".");
+    removeSaveFiles();
+    {
+        Map map;
+        markAll(map, 1);
+        assert(MapSerializer::saveCompressedMap(map, saveName, ".", false)); // 同时写出 .tlwf
+    }
+    const std::vector<char> tlwzBefore = readFile(tlwzPath);
+
+    TaskSystem taskSystem(2);
+    auto map = MapSerializer::loadMapFromSave(saveName, ".");
+    assert(map && map->getSavedChunkSource() && !map->getSavedChunkSource()->isCompressed());
+    {
+        BackgroundSaver saver(saveName, ".");
+        std::unordered_set<ChunkCoord, ChunkCoordHash> modified;
+        map->setTile(2, 3, 1, markerTile(9));
+        map->setTile(CHUNK_WIDTH + 2, CHUNK_HEIGHT + 3, 1, markerTile(10));
+        modified.insert({0, 0, 0});
+        modified.insert({1, 1, 0});
+        assert(saver.schedule(*map, taskSystem, &modified));
+        assert(saver.wait());
+        assert(saver.getStats().journaledCount == 1 && saver.getStats().completedCount == 1);
+
+        map->setTile(2 * CHUNK_WIDTH + 2, 2 * CHUNK_HEIGHT + 3, 1, markerTile(11));
+        modified = {ChunkCoord{2, 2, 0}};
+        assert(saver.schedule(*map, taskSystem, &modified));
+        assert(saver.wait());
+        assert(saver.getStats().journaledCount == 2);
+        assert(readFile(tlwzPath) == tlwzBefore);
+    }
+    map.reset();
+
+    auto saved = MapSerializer::loadMapFromSave(saveName, ".", false);
+    assert(saved);
+    assert(markerAt(*saved, 0, 0) == markerTile(9) && markerAt(*saved, 1, 1) == markerTile(10) && markerAt(*saved, 2, 2) == markerTile(11));
+    assert(markerAt(*saved, 3, 0) == markerTile(1 + 3) && markerAt(*saved, 5, 7) == markerTile(1 + 12));
+
+    removeSaveFiles();
+    std::cout << "Journaled save tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("background_save_test.log")) {
+        return 1;
+    }
+
+    bool ok = testSnapshotCopyOnWrite() && testBackgroundSave() && testJournaledSave();
+    std::filesystem::remove(swapPath);
+
+    std::cout << (ok ? "\n--- Background Save Tests Passed ---" : "\n--- Background Save Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
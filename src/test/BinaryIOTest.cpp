@@ -1,5 +1,6 @@
 #include "../src/BinaryFileInfrastructure/BinaryWriter.h"
 #include "../src/BinaryFileInfrastructure/BinaryReader.h"
+#include "../src/BinaryFileInfrastructure/MappedFile.h"
 #include "../src/BinaryFileInfrastructure/FileFormat.h" // For FileHeader struct
 #include "../src/BinaryFileInfrastructure/Checksum.h"   // For checksum functions
 #include "../Utils/Logger.h" // <-- 包含 Logger
@@ -10,6 +11,8 @@
 #include <limits>
 #include <cstring> // For std::memcmp
 #include <iomanip> // For std::hex, std::setw, std::setfill
+#include <fstream>
+#include <filesystem>
 
 // 使用 TilelandWorld 命名空间
 using namespace TilelandWorld;
@@ -235,6 +238,74 @@ bool runBinaryIOTests() {
     return allTestsPassed;
 }
 
+// 内存映射后端：零拷贝视图与边界检查
+bool runMappedFileTests() {
+    std::cout << "\n--- Running Mapped File Tests ---" << std::endl;
+    const std::string mappedPath = "binary_io_mapped_test.bin";
+    const std::string emptyPath = "binary_io_empty_test.bin";
+    bool passed = true;
+
+    try {
+        {
+            BinaryWriter writer(mappedPath);
+            for (uint32_t i = 0; i < 256; ++i) {
+                assert(writer.write(i));
+            }
+        }
+        { std::ofstream touch(emptyPath, std::ios::binary); }
+
+        MappedFile file(mappedPath);
+        assert(file.size() == 256 * sizeof(uint32_t));
+        uint32_t value = 0;
+        assert(file.readAt(10 * sizeof(uint32_t), value) && value == 10);
+        assert(file.readAt(1, value)); // 非对齐读取
+        assert(file.span(file.size(), 0) != nullptr);
+        assert(file.span(file.size() - 3, 4) == nullptr);
+        assert(file.span(file.size() + 1, 0) == nullptr);
+        assert(!file.readAt(file.size() - 2, value));
+
+        MappedFile empty(emptyPath);
+        assert(empty.size() == 0);
+        assert(!empty.readAt(0, value));
+
+        bool threw = false;
+        try {
+            MappedFile missing("binary_io_missing_test.bin");
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+
+        BinaryReader reader(mappedPath);
+        assert(reader.isMapped());
+        assert(reader.fileSize() == static_cast<std::streamoff>(file.size()));
+        assert(reader.seek(4 * sizeof(uint32_t)));
+        const uint8_t* view = reader.readView(2 * sizeof(uint32_t));
+        assert(view && std::memcmp(view, file.data() + 4 * sizeof(uint32_t), 2 * sizeof(uint32_t)) == 0);
+        assert(reader.tell() == static_cast<std::streamoff>(6 * sizeof(uint32_t)));
+        assert(reader.read(value) && value == 6);
+        // 数据不足时不返回视图，读取位置不变
+        assert(reader.seek(-2, std::ios::end));
+        assert(reader.readView(4) == nullptr);
+        assert(reader.tell() == static_cast<std::streamoff>(file.size() - 2));
+        assert(!reader.read(value) && reader.eof());
+        assert(!reader.seek(static_cast<std::streampos>(file.size() + 1)));
+        assert(reader.seek(-1, std::ios::cur) && !reader.eof()); // seek 清除 EOF 状态
+
+        BinaryReader emptyReader(emptyPath);
+        assert(emptyReader.fileSize() == 0);
+        assert(!emptyReader.read(value) && emptyReader.eof());
+    } catch (const std::exception& e) {
+        std::cerr << "Mapped file test failed with exception: " << e.what() << std::endl;
+        passed = false;
+    }
+
+    std::filesystem::remove(mappedPath);
+    std::filesystem::remove(emptyPath);
+    std::cout << "--- Mapped File Tests " << (passed ? "Passed" : "Failed") << " ---" << std::endl;
+    return passed;
+}
+
 int main() {
     // 初始化日志
     if (!TilelandWorld::Logger::getInstance().initialize("binary_io_test.log")) {
@@ -242,7 +313,7 @@ int main() {
     }
 
     LOG_INFO("Starting Binary I/O Tests...");
-    bool success = runBinaryIOTests();
+    bool success = runBinaryIOTests() && runMappedFileTests();
     LOG_INFO("Binary I/O Tests finished.");
 
     // 关闭日志
@@ -0,0 +1,122 @@
+#include "../BinaryFileInfrastructure/Checksum.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace TilelandWorld;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using CRC32Function = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+    uint32_t finished(CRC32Function fn, const uint8_t* data, size_t size) {
+        return ~fn(0xFFFFFFFF, data, size);
+    }
+
+    bool pclmulAvailable() {
+        return activeCRC32Implementation() == CRC32Implementation::Pclmul;
+    }
+
+    // 各实现与逐字节查表结果一致；覆盖各种长度与未对齐起点
+    bool testCorrectness() {
+        std::cout << "\n--- CRC32 correctness ---" << std::endl;
+        const std::string check = "123456789";
+        assert(calculateCRC32(check.data(), check.size()) == 0xCBF43926); // IEEE 802.3 标准校验值
+        assert(calculateCRC32(nullptr, 0) == 0);
+
+        std::mt19937 rng(2024);
+        std::vector<uint8_t> data(70000);
+        for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+        for (size_t size = 0; size <= 1100; size += (size < 300 ? 1 : 37)) {
+            for (size_t offset = 0; offset < 16; offset += 5) {
+                const uint8_t* p = data.data() + offset;
+                const uint32_t expected = finished(Detail::crc32Bytewise, p, size);
+                assert(finished(Detail::crc32SliceBy8, p, size) == expected);
+                if (pclmulAvailable()) assert(finished(Detail::crc32Pclmul, p, size) == expected);
+                assert(updateCRC32(0, p, size) == expected);
+            }
+        }
+        const uint32_t whole = finished(Detail::crc32Bytewise, data.data(), data.size());
+        assert(calculateCRC32(data.data(), data.size()) == whole);
+
+        // 分段继续计算与分段合并
+        for (int round = 0; round < 200; ++round) {
+            const size_t split = rng() % (data.size() + 1);
+            const uint32_t crcA = calculateCRC32(data.data(), split);
+            const uint32_t crcB = calculateCRC32(data.data() + split, data.size() - split);
+            assert(updateCRC32(crcA, data.data() + split, data.size() - split) == whole);
+            assert(combineCRC32(crcA, crcB, data.size() - split) == whole);
+        }
+        assert(combineCRC32(whole, 0, 0) == whole);
+
+        // 按区块大小切分后逐段合并
+        const size_t piece = 4096;
+        uint32_t merged = 0;
+        for (size_t begin = 0; begin < data.size(); begin += piece) {
+            const size_t len = std::min(piece, data.size() - begin);
+            merged = combineCRC32(merged, calculateCRC32(data.data() + begin, len), len);
+        }
+        assert(merged == whole);
+
+        std::cout << "Correctness checks passed (active implementation: "
+                  << (pclmulAvailable() ? "PCLMULQDQ" : "slicing-by-8") << ")." << std::endl;
+        return true;
+    }
+
+    double gigabytesPerSecond(CRC32Function fn, const std::vector<uint8_t>& data, size_t totalBytes, uint32_t& sink) {
+        const size_t repeat = std::max<size_t>(1, totalBytes / data.size());
+        const auto start = Clock::now();
+        for (size_t r = 0; r < repeat; ++r) sink ^= fn(sink, data.data(), data.size());
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return static_cast<double>(repeat * data.size()) / std::max(seconds, 1e-9) / 1e9;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (!Logger::getInstance().initialize("checksum_benchmark.log")) {
+        return 1;
+    }
+
+    if (!testCorrectness()) {
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
+    // 每种大小处理的总字节数
+    size_t totalBytes = 256ull << 20;
+    if (argc > 1) {
+        totalBytes = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) << 20;
+    }
+
+    std::cout << "\n--- CRC32 throughput (GB/s) ---" << std::endl;
+    std::cout << std::left << std::setw(12) << "size" << std::setw(12) << "bytewise"
+              << std::setw(12) << "slice-by-8" << std::setw(12) << "pclmul" << std::endl;
+
+    uint32_t sink = 0;
+    std::mt19937 rng(7);
+    for (size_t size : {size_t(256), size_t(4096), size_t(64) << 10, size_t(16) << 20}) {
+        std::vector<uint8_t> data(size);
+        for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+        const double bytewise = gigabytesPerSecond(Detail::crc32Bytewise, data, totalBytes / 4, sink);
+        const double slice = gigabytesPerSecond(Detail::crc32SliceBy8, data, totalBytes, sink);
+        const double pclmul = pclmulAvailable() ? gigabytesPerSecond(Detail::crc32Pclmul, data, totalBytes, sink) : 0.0;
+
+        std::cout << std::left << std::setw(12) << size << std::fixed << std::setprecision(2)
+                  << std::setw(12) << bytewise << std::setw(12) << slice << std::setw(12) << pclmul << std::endl;
+        LOG_INFO("CRC32 benchmark size=" + std::to_string(size) + " bytewise=" + std::to_string(bytewise)
+                 + " slice8=" + std::to_string(slice) + " pclmul=" + std::to_string(pclmul) + " GB/s");
+    }
+
+    std::cout << "\n--- Checksum Benchmark Finished (sink " << sink << ") ---" << std::endl;
+    Logger::getInstance().shutdown();
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include "../Chunk.h"
+#include "../Tile.h"
+#include "../Constants.h"
+#include "../BinaryFileInfrastructure/ChunkCodec.h"
+#include "../BinaryFileInfrastructure/MapSerializer.h"
+#include "../BinaryFileInfrastructure/FileFormat.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+using namespace TilelandWorld;
+
+namespace {
+    std::vector<Tile> roundTrip(const std::vector<Tile>& tiles, size_t& encodedBytes) {
+        std::vector<uint8_t> data{0xAB}; // 编码追加在已有内容之后
+        encodedBytes = ChunkCodec::encodeTiles(tiles.data(), data);
+        assert(data.size() == 1 + encodedBytes && data[0] == 0xAB);
+
+        data.push_back(0xCD); // 解码只消耗自己的字节
+        std::vector<Tile> decoded(CHUNK_VOLUME);
+        assert(ChunkCodec::decodeTiles(data.data() + 1, data.size() - 1, decoded.data()) == encodedBytes);
+        return decoded;
+    }
+
+    bool throwsOnDecode(const std::vector<uint8_t>& data) {
+        std::vector<Tile> tiles(CHUNK_VOLUME);
+        try {
+            ChunkCodec::decodeTiles(data.data(), data.size(), tiles.data());
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+// 均匀区块：一个游程、均匀光照、常量位图
+bool testUniformTiles() {
+    std::cout << "\n--- Testing Uniform Tiles ---" << std::endl;
+    Tile tile(TerrainType::GRASS);
+    tile.isExplored = 1;
+    std::vector<Tile> tiles(CHUNK_VOLUME, tile);
+
+    size_t bytes = 0;
+    assert(roundTrip(tiles, bytes) == tiles);
+    std::cout << "Uniform chunk: " << bytes << " bytes (packed array " << CHUNK_VOLUME * sizeof(uint32_t) << ")" << std::endl;
+    assert(bytes == sizeof(uint16_t) + sizeof(CompactTerrainRun) + 2 + 1 + 1);
+
+    std::cout << "Uniform tile tests passed." << std::endl;
+    return true;
+}
+
+// 分层与逐行变化的地形：游程沿 X 行，可跨行合并
+bool testLayeredTiles() {
+    std::cout << "\n--- Testing Layered Tiles ---" << std::endl;
+    std::vector<Tile> tiles(CHUNK_VOLUME);
+    for (int lz = 0; lz < CHUNK_DEPTH; ++lz) {
+        for (int ly = 0; ly < CHUNK_HEIGHT; ++ly) {
+            for (int lx = 0; lx < CHUNK_WIDTH; ++lx) {
+                Tile tile(lz < 4 ? TerrainType::WALL : (ly % 2 ? TerrainType::WATER : TerrainType::FLOOR));
+                tile.lightLevel = static_cast<uint8_t>(lz * 16 + lx);
+                tile.isExplored = (lx + ly) % 3 == 0;
+                tile.hasOverride = lx == 7;
+                tiles[lx + ly * CHUNK_WIDTH + lz * CHUNK_AREA] = tile;
+            }
+        }
+    }
+
+    size_t bytes = 0;
+    assert(roundTrip(tiles, bytes) == tiles);
+    // 4 层 WALL 合并为一个游程，其余每行一个游程；光照逐 Tile 保存，两张位图逐位保存
+    const size_t runs = 1 + (CHUNK_DEPTH - 4) * CHUNK_HEIGHT;
+    assert(bytes == sizeof(uint16_t) + runs * sizeof(CompactTerrainRun) + 1 + CHUNK_VOLUME + 2 * (1 + CHUNK_VOLUME / 8));
+    std::cout << "Layered chunk: " << bytes << " bytes" << std::endl;
+
+    std::cout << "Layered tile tests passed." << std::endl;
+    return true;
+}
+
+// 随机内容与极端取值 (地形 ID 高位、光照 0/255、全部标志组合)，覆盖向量化路径的符号与打包处理
+bool testRandomTiles() {
+    std::cout << "\n--- Testing Random Tiles ---" << std::endl;
+    std::mt19937 rng(20240607);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<Tile> tiles(CHUNK_VOLUME);
+        for (auto& tile : tiles) {
+            const uint32_t r = rng();
+            uint16_t terrain = round % 2 ? static_cast<uint16_t>(r) : static_cast<uint16_t>(r % 6);
+            if (r % 97 == 0) terrain = 0xFFFF;
+            if (r % 89 == 0) terrain = 0x8000;
+            tile = Tile(static_cast<TerrainType>(terrain));
+            tile.lightLevel = round == 0 ? 0 : static_cast<uint8_t>(r >> 16);
+            tile.isExplored = (r >> 24) & 1;
+            tile.hasOverride = (r >> 25) & 1;
+        }
+        size_t bytes = 0;
+        assert(roundTrip(tiles, bytes) == tiles);
+    }
+
+    std::cout << "Random tile tests passed." << std::endl;
+    return true;
+}
+
+// 损坏的数据在解码时抛出异常，而不是越界读取
+bool testMalformedData() {
+    std::cout << "\n--- Testing Malformed Data ---" << std::endl;
+    std::vector<Tile> tiles(CHUNK_VOLUME, Tile(TerrainType::WATER));
+    tiles[100].lightLevel = 3;
+    std::vector<uint8_t> data;
+    ChunkCodec::encodeTiles(tiles.data(), data);
+
+    for (size_t cut = 0; cut < data.size(); ++cut) {
+        assert(throwsOnDecode(std::vector<uint8_t>(data.begin(), data.begin() + cut)));
+    }
+
+    // 游程长度合计不等于 CHUNK_VOLUME
+    std::vector<uint8_t> shortRun = data;
+    CompactTerrainRun run{};
+    std::memcpy(&run, shortRun.data() + sizeof(uint16_t), sizeof(run));
+    run.length -= 1;
+    std::memcpy(shortRun.data() + sizeof(uint16_t), &run, sizeof(run));
+    assert(throwsOnDecode(shortRun));
+
+    // 未知平面模式
+    std::vector<uint8_t> badMode = data;
+    badMode[sizeof(uint16_t) + sizeof(CompactTerrainRun)] = 0x7F;
+    assert(throwsOnDecode(badMode));
+
+    // 稀疏位图的下标必须严格递增
+    std::vector<Tile> flagged(CHUNK_VOLUME, Tile(TerrainType::WATER));
+    flagged[5].hasOverride = 1;
+    flagged[9].hasOverride = 1;
+    std::vector<uint8_t> sparse;
+    ChunkCodec::encodeTiles(flagged.data(), sparse);
+    assert(sparse[sparse.size() - 7] == TILE_PLANE_SPARSE);
+    std::swap(sparse[sparse.size() - 4], sparse[sparse.size() - 2]);
+    assert(throwsOnDecode(sparse));
+
+    std::cout << "Malformed data tests passed." << std::endl;
+    return true;
+}
+
+// 区块记录：紧凑编码连同覆盖表往返；紧凑编码更大时退回完整记录
+bool testChunkRecords() {
+    std::cout << "\n--- Testing Chunk Records ---" << std::endl;
+    Chunk chunk(2, -1, 0);
+    chunk.fill(Tile(TerrainType::FLOOR));
+    chunk.setLocalTile(3, 4, 5, Tile(TerrainType::WALL));
+    const TileTraits bridge{true, true, 3};
+    chunk.setTileOverride(6, 7, 8, bridge);
+
+    std::vector<uint8_t> record;
+    MapSerializer::encodeChunkRecord(chunk, record);
+    assert(record[0] == CHUNK_RECORD_COMPACT);
+    std::cout << "Sparse chunk record: " << record.size() << " bytes" << std::endl;
+    assert(record.size() < 64);
+
+    Chunk decoded(2, -1, 0);
+    MapSerializer::decodeChunkRecord(record.data(), record.size(), decoded);
+    for (int lz = 0; lz < CHUNK_DEPTH; ++lz)
+        for (int ly = 0; ly < CHUNK_HEIGHT; ++ly)
+            for (int lx = 0; lx < CHUNK_WIDTH; ++lx) {
+                assert(decoded.getLocalTile(lx, ly, lz) == chunk.getLocalTile(lx, ly, lz));
+                assert(decoded.getTileTraits(lx, ly, lz) == chunk.getTileTraits(lx, ly, lz));
+            }
+    assert(decoded.getTileTraits(6, 7, 8) == bridge);
+
+    // 0.5 的记录中不可能出现紧凑编码
+    bool rejected = false;
+    try {
+        MapSerializer::decodeChunkRecord(record.data(), record.size(), decoded, FORMAT_VERSION_MINOR_DELTA_RECORD);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    // 地形与光照都是噪声时完整记录更小
+    std::mt19937 rng(7);
+    std::vector<Tile> noisy(CHUNK_VOLUME);
+    for (auto& tile : noisy) {
+        tile = Tile(static_cast<TerrainType>(rng() % 6));
+        tile.lightLevel = static_cast<uint8_t>(rng());
+    }
+    Chunk noisyChunk(0, 0, 0);
+    noisyChunk.assignTiles(noisy.data());
+    MapSerializer::encodeChunkRecord(noisyChunk, record);
+    assert(record[0] == CHUNK_RECORD_FULL);
+    Chunk noisyDecoded(0, 0, 0);
+    MapSerializer::decodeChunkRecord(record.data(), record.size(), noisyDecoded);
+    std::vector<Tile> roundTripped(CHUNK_VOLUME);
+    noisyDecoded.copyTilesTo(roundTripped.data());
+    assert(roundTripped == noisy);
+
+    std::cout << "Chunk record tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("chunk_codec_test.log")) {
+        return 1;
+    }
+
+    bool ok = testUniformTiles() && testLayeredTiles() && testRandomTiles() && testMalformedData() && testChunkRecords();
+
+    std::cout << (ok ? "\n--- Chunk Codec Tests Passed ---" : "\n--- Chunk Codec Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+#include "../Map.h"
+#include "../MapGenInfrastructure/ChunkGeneratorPool.h"
+#include "../MapGenInfrastructure/TerrainGenerator.h"
+#include "../Utils/Logger.h"
+#include "../Utils/TaskSystem.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <unordered_set>
+#include <cassert>
+
+using namespace TilelandWorld;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // 记录生成顺序；闸门关闭时生成调用阻塞，用来让请求在池中排队
+    class GatedGenerator : public TerrainGenerator {
+    public:
+        void generateChunk(Chunk& chunk) const override {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ++waiting;
+                condition.notify_all();
+                condition.wait(lock, [this] { return open; });
+                --waiting;
+                order.push_back({chunk.getChunkX(), chunk.getChunkY(), chunk.getChunkZ()});
+            }
+            chunk.fill(Tile(TerrainType::GRASS));
+        }
+        uint8_t getVersion() const override { return 1; }
+        bool generatesSameAs(const TerrainGenerator& other) const override { return &other == this; }
+
+        void waitUntilBlocked() const {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return waiting > 0; });
+        }
+        void openGate() {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+            condition.notify_all();
+        }
+        std::vector<ChunkCoord> getOrder() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return order;
+        }
+
+    private:
+        mutable std::mutex mutex;
+        mutable std::condition_variable condition;
+        mutable int waiting = 0;
+        mutable std::vector<ChunkCoord> order;
+        bool open = false;
+    };
+
+    const ChunkCoord blocker{100, 100, 0};
+
+    ChunkGeneratorPool::View makeView(int minCx, int minCy, int size, int cz, int retainXY, int retainZ) {
+        ChunkGeneratorPool::View view;
+        view.minCx = minCx;
+        view.maxCx = minCx + size - 1;
+        view.minCy = minCy;
+        view.maxCy = minCy + size - 1;
+        view.cz = cz;
+        view.retainRadiusXY = retainXY;
+        view.retainRadiusZ = retainZ;
+        return view;
+    }
+
+    std::vector<ChunkCoord> makeRequests(int minC, int maxC) {
+        std::vector<ChunkCoord> coords;
+        for (int cx = minC; cx <= maxC; ++cx)
+            for (int cy = minC; cy <= maxC; ++cy)
+                for (int cz = -1; cz <= 1; ++cz) coords.push_back({cx, cy, cz});
+        return coords;
+    }
+
+    size_t collectFinished(ChunkGeneratorPool& pool, size_t expected) {
+        size_t count = 0;
+        const auto deadline = Clock::now() + std::chrono::seconds(30);
+        while (count < expected && Clock::now() < deadline) {
+            count += pool.getFinishedChunks().size();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return count + pool.getFinishedChunks().size();
+    }
+}
+
+bool testPriority() {
+    std::cout << "\n--- Testing Priority ---" << std::endl;
+    const auto view = makeView(0, 0, 2, 0, 2, 2);
+    assert(ChunkGeneratorPool::priorityOf(view, {1, 1, 0}) == 0);
+    assert(ChunkGeneratorPool::priorityOf(view, {2, 1, 0}) == 2);     // 同层外圈
+    assert(ChunkGeneratorPool::priorityOf(view, {0, 0, 1}) == 3);     // 其他层的可见范围
+    assert(ChunkGeneratorPool::priorityOf(view, {-2, 3, -1}) == 5);
+    assert(ChunkGeneratorPool::isRetained(view, {3, -2, 2}));
+    assert(!ChunkGeneratorPool::isRetained(view, {4, 0, 0}));
+    assert(!ChunkGeneratorPool::isRetained(view, {0, 0, -3}));
+    std::cout << "Priority tests passed." << std::endl;
+    return true;
+}
+
+// 取出时按当前视图排序：视图在请求之后移动，新视图的可见区块最先生成
+bool testReprioritization() {
+    std::cout << "\n--- Testing Reprioritization ---" << std::endl;
+    auto generatorOwner = std::make_unique<GatedGenerator>();
+    GatedGenerator& generator = *generatorOwner;
+    Map map(std::move(generatorOwner));
+    TaskSystem taskSystem(1);
+    ChunkGeneratorPool pool(map, taskSystem, 1);
+
+    pool.requestChunk(blocker.cx, blocker.cy, blocker.cz);
+    generator.waitUntilBlocked();
+
+    pool.setView(makeView(0, 0, 2, 0, 100, 100));
+    const auto coords = makeRequests(-2, 3);
+    pool.requestChunks(coords);
+    pool.requestChunks(coords); // 重复请求被忽略
+    assert(pool.getPendingCount() == coords.size());
+
+    const auto moved = makeView(2, 2, 2, 0, 100, 100);
+    pool.setView(moved);
+    generator.openGate();
+    assert(collectFinished(pool, coords.size() + 1) == coords.size() + 1);
+    taskSystem.stop();
+
+    const auto order = generator.getOrder();
+    assert(order.size() == coords.size() + 1 && order[0] == blocker);
+    for (size_t i = 1; i <= 4; ++i) assert(ChunkGeneratorPool::priorityOf(moved, order[i]) == 0);
+    assert(ChunkGeneratorPool::priorityOf(moved, order[5]) == 2);
+
+    const auto stats = pool.getStats();
+    assert(stats.requestedTotal == coords.size() + 1 && stats.generatedTotal == coords.size() + 1);
+    assert(stats.cancelledTotal == 0 && stats.pending == 0);
+    std::cout << "Reprioritization tests passed." << std::endl;
+    return true;
+}
+
+// 视图移动后保留范围外尚未开始的请求被取消，不会生成
+bool testCancellation() {
+    std::cout << "\n--- Testing Cancellation ---" << std::endl;
+    auto generatorOwner = std::make_unique<GatedGenerator>();
+    GatedGenerator& generator = *generatorOwner;
+    Map map(std::move(generatorOwner));
+    TaskSystem taskSystem(1);
+    ChunkGeneratorPool pool(map, taskSystem, 1);
+
+    pool.requestChunk(blocker.cx, blocker.cy, blocker.cz);
+    generator.waitUntilBlocked();
+
+    pool.setView(makeView(0, 0, 2, 0, 1, 1));
+    pool.requestChunks(makeRequests(-1, 2));
+    assert(pool.getPendingCount() == 48);
+    assert(pool.getCancelledChunks().empty());
+
+    const auto moved = makeView(2, 0, 2, 0, 1, 1);
+    pool.setView(moved);
+    pool.setView(moved); // 视图不变时不重复处理
+    const auto cancelled = pool.getCancelledChunks();
+    assert(cancelled.size() == 24 && pool.getPendingCount() == 24);
+    std::unordered_set<ChunkCoord, ChunkCoordHash> cancelledSet;
+    for (const ChunkCoord& coord : cancelled) {
+        assert(!ChunkGeneratorPool::isRetained(moved, coord));
+        cancelledSet.insert(coord);
+    }
+    assert(pool.getCancelledChunks().empty());
+
+    generator.openGate();
+    assert(collectFinished(pool, 25) == 25);
+    taskSystem.stop();
+    for (const ChunkCoord& coord : generator.getOrder()) {
+        assert(cancelledSet.count(coord) == 0);
+    }
+    assert(pool.getStats().cancelledTotal == 24);
+    std::cout << "Cancellation tests passed." << std::endl;
+    return true;
+}
+
+// 关闭前 cancelAll：在途任务结束后不再续排
+bool testCancelAll() {
+    std::cout << "\n--- Testing Cancel All ---" << std::endl;
+    auto generatorOwner = std::make_unique<GatedGenerator>();
+    GatedGenerator& generator = *generatorOwner;
+    Map map(std::move(generatorOwner));
+    TaskSystem taskSystem(2);
+    ChunkGeneratorPool pool(map, taskSystem);
+
+    pool.requestChunk(blocker.cx, blocker.cy, blocker.cz);
+    generator.waitUntilBlocked();
+    pool.requestChunks(makeRequests(-8, 8));
+    pool.cancelAll();
+    assert(pool.getPendingCount() == 0);
+    assert(pool.getCancelledChunks().empty());
+
+    generator.openGate();
+    taskSystem.stop();
+    // 最多是已被取出的批次
+    assert(generator.getOrder().size() <= 1 + ChunkGeneratorPool::REGION_MAX_CHUNKS);
+    std::cout << "Cancel all tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("chunk_generator_pool_test.log")) {
+        return 1;
+    }
+
+    bool ok = testPriority() && testReprioritization() && testCancellation() && testCancelAll();
+
+    std::cout << (ok ? "\n--- Chunk Generator Pool Tests Passed ---" : "\n--- Chunk Generator Pool Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
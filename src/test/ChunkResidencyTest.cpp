@@ -0,0 +1,121 @@
+#include "../Map.h"
+#include "../ChunkResidencyManager.h"
+#include "../BinaryFileInfrastructure/ChunkSwapFile.h"
+#include "../BinaryFileInfrastructure/MapSerializer.h"
+#include "../Constants.h"
+#include "../Utils/Logger.h"
+#include "TestTiles.h"
+#include <iostream>
+#include <memory>
+#include <filesystem>
+#include <cassert>
+
+using namespace TilelandWorld;
+
+namespace {
+    const std::string swapPath = "chunk_residency_test.tlws";
+    const std::string savePath = "chunk_residency_test.tlwf";
+}
+
+// 生成的区块是干净的；写入后变脏；卸载脏区块需要后备存储
+bool testDirtyTracking() {
+    std::cout << "\n--- Testing Dirty Tracking ---" << std::endl;
+    Map map;
+    Chunk* chunk = map.getOrLoadChunk(0, 0, 0);
+    assert(chunk && !chunk->isDirty());
+
+    map.setTile(1, 2, 3, markerTile(7));
+    assert(chunk->isDirty());
+
+    // 没有后备存储：脏区块不能卸载，干净区块可以
+    assert(!map.unloadChunk(0, 0, 0));
+    assert(map.getChunk(0, 0, 0) != nullptr);
+    map.getOrLoadChunk(5, 5, 0);
+    assert(map.unloadChunk(5, 5, 0));
+    assert(map.getChunk(5, 5, 0) == nullptr);
+
+    std::cout << "Dirty tracking tests passed." << std::endl;
+    return true;
+}
+
+// 超出预算时卸载远处区块，修改过的区块写回交换文件后可透明地重新加载，保存存档时也不会丢失
+bool testEvictionAndReload() {
+    std::cout << "\n--- Testing Eviction And Reload ---" << std::endl;
+    Map map;
+    auto swap = std::make_shared<ChunkSwapFile>(swapPath);
+    map.setChunkStore(swap);
+
+    const int side = 12;
+    for (int cy = 0; cy < side; ++cy) {
+        for (int cx = 0; cx < side; ++cx) {
+            map.getOrLoadChunk(cx, cy, 0);
+        }
+    }
+    // 每个区块在不同位置写入一个不同的标记 (区块变脏，且索引数组各不相同，不会经 ChunkIndexPool 共享)
+    for (int cy = 0; cy < side; ++cy) {
+        for (int cx = 0; cx < side; ++cx) {
+            map.setTile(cx * CHUNK_WIDTH + cx, cy * CHUNK_HEIGHT + cy, 5, markerTile(cx + cy * side));
+        }
+    }
+
+    size_t perChunk = map.getChunk(0, 0, 0)->getMemoryUsage();
+    ChunkResidencyManager residency(perChunk * 20);
+
+    // 焦点在 (0,0)，保护半径 1：网格内受保护的是 (0..1, 0..1) 四个区块，其余按 LRU 卸载
+    size_t evicted = residency.update(map, ChunkCoord{0, 0, 0}, 1, 0);
+    const auto& stats = residency.getStats();
+    std::cout << "Evicted " << evicted << ", resident " << stats.residentChunks << " (" << stats.residentBytes << " bytes)" << std::endl;
+    assert(evicted > 0);
+    assert(stats.residentBytes <= residency.getMemoryBudget());
+    assert(stats.writtenBackTotal == evicted);
+    assert(swap->getStoredCount() == evicted);
+    // 保护范围内的区块不被卸载
+    assert(map.getChunk(0, 0, 0) && map.getChunk(1, 1, 0));
+
+    // 被卸载的区块透明重新加载，内容保持不变，且重新加载后为干净状态
+    for (int cy = 0; cy < side; ++cy) {
+        for (int cx = 0; cx < side; ++cx) {
+            Tile tile = map.getTile(cx * CHUNK_WIDTH + cx, cy * CHUNK_HEIGHT + cy, 5);
+            assert(tile == markerTile(cx + cy * side));
+        }
+    }
+    assert(map.getLoadedChunkCount() == static_cast<size_t>(side * side));
+
+    // 焦点移动到对角：上一轮保护过的 (0,0) 一带比从未保护过的区块更近使用，应当留下
+    residency.update(map, ChunkCoord{side - 1, side - 1, 0}, 1, 0);
+    assert(residency.getStats().residentBytes <= residency.getMemoryBudget());
+    assert(map.getChunk(side - 1, side - 1, 0) != nullptr);
+    assert(map.getChunk(0, 0, 0) != nullptr);
+    assert(map.getChunk(side / 2, side / 2, 0) == nullptr);
+
+    // 保存存档时包含已卸载的区块
+    assert(MapSerializer::saveMap(map, savePath));
+    auto loaded = MapSerializer::loadMap(savePath, false);
+    assert(loaded);
+    assert(loaded->getLoadedChunkCount() == static_cast<size_t>(side * side));
+    const Map& constLoaded = *loaded;
+    for (int cy = 0; cy < side; ++cy) {
+        for (int cx = 0; cx < side; ++cx) {
+            assert(constLoaded.getTile(cx * CHUNK_WIDTH + cx, cy * CHUNK_HEIGHT + cy, 5) == markerTile(cx + cy * side));
+        }
+    }
+
+    std::filesystem::remove(savePath);
+    std::cout << "Eviction and reload tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("chunk_residency_test.log")) {
+        return 1;
+    }
+
+    bool ok = testDirtyTracking() && testEvictionAndReload();
+
+    // 交换文件随存储对象析构而删除
+    assert(!std::filesystem::exists(swapPath));
+
+    std::cout << (ok ? "\n--- Chunk Residency Tests Passed ---" : "\n--- Chunk Residency Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+#include "../Chunk.h"
+#include "../ChunkIndexPool.h"
+#include "../Map.h"
+#include "../MapGenInfrastructure/FlatTerrainGenerator.h"
+#include "../Tile.h"
+#include "../TerrainTypes.h"
+#include "../Constants.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <cstdlib> // For rand()
+#include <memory>
+
+using namespace TilelandWorld;
+
+// 均匀区块：新建区块与 fill 后都不应分配索引数组
+bool testUniformChunk() {
+    std::cout << "\n--- Testing Uniform Chunk ---" << std::endl;
+    Chunk chunk(0, 0, 0);
+    assert(chunk.isUniform());
+    assert(chunk.getPaletteSize() == 1);
+    assert(chunk.getLocalTile(3, 4, 5).terrain == TerrainType::VOIDBLOCK);
+
+    chunk.fill(Tile(TerrainType::WALL));
+    assert(chunk.isUniform());
+    assert(chunk.getLocalTile(15, 15, 15).terrain == TerrainType::WALL);
+
+    // 写入与当前值相同的 Tile 不应破坏均匀形态
+    chunk.setLocalTile(1, 2, 3, Tile(TerrainType::WALL));
+    assert(chunk.isUniform());
+
+    std::cout << "Uniform chunk memory: " << chunk.getMemoryUsage() << " bytes" << std::endl;
+    std::cout << "Uniform chunk tests passed." << std::endl;
+    return true;
+}
+
+// 调色板增长：不同值数量增加时位宽随之扩展，已有数据保持不变
+bool testPaletteGrowth() {
+    std::cout << "\n--- Testing Palette Growth ---" << std::endl;
+    Chunk chunk(1, 2, 3);
+    std::vector<Tile> expected(CHUNK_VOLUME, Tile(TerrainType::VOIDBLOCK));
+
+    for (int i = 0; i < 300; ++i) {
+        int lx = rand() % CHUNK_WIDTH;
+        int ly = rand() % CHUNK_HEIGHT;
+        int lz = rand() % CHUNK_DEPTH;
+        Tile tile(static_cast<TerrainType>(rand() % 6));
+        tile.lightLevel = static_cast<uint8_t>(i % 40); // 制造超过 16 个不同值，触发 8 位索引
+        chunk.setLocalTile(lx, ly, lz, tile);
+        expected[lx + ly * CHUNK_WIDTH + lz * CHUNK_AREA] = tile;
+    }
+    assert(!chunk.isUniform());
+    std::cout << "Palette size: " << chunk.getPaletteSize() << ", bits per index: " << chunk.getBitsPerIndex() << std::endl;
+
+    for (int lz = 0; lz < CHUNK_DEPTH; ++lz) {
+        for (int ly = 0; ly < CHUNK_HEIGHT; ++ly) {
+            for (int lx = 0; lx < CHUNK_WIDTH; ++lx) {
+                assert(chunk.getLocalTile(lx, ly, lz) == expected[lx + ly * CHUNK_WIDTH + lz * CHUNK_AREA]);
+            }
+        }
+    }
+
+    std::cout << "Palette growth tests passed." << std::endl;
+    return true;
+}
+
+// 批量导入/导出与 compact：全部覆盖为同一值后应能回退为均匀形态
+bool testBulkAndCompact() {
+    std::cout << "\n--- Testing Bulk Assign / Compact ---" << std::endl;
+    std::vector<Tile> tiles(CHUNK_VOLUME, Tile(TerrainType::GRASS));
+    for (int i = 0; i < CHUNK_VOLUME; i += 7) tiles[i] = Tile(TerrainType::WATER);
+
+    Chunk chunk(0, 0, 0);
+    chunk.assignTiles(tiles.data());
+    assert(chunk.getPaletteSize() == 2);
+    assert(chunk.getBitsPerIndex() == 1);
+
+    std::vector<Tile> roundTrip(CHUNK_VOLUME);
+    chunk.copyTilesTo(roundTrip.data());
+    for (int i = 0; i < CHUNK_VOLUME; ++i) assert(roundTrip[i] == tiles[i]);
+
+    for (int i = 0; i < CHUNK_VOLUME; i += 7) {
+        chunk.setLocalTile(i % CHUNK_WIDTH, (i / CHUNK_WIDTH) % CHUNK_HEIGHT, i / CHUNK_AREA, Tile(TerrainType::GRASS));
+    }
+    chunk.compact();
+    assert(chunk.isUniform());
+    assert(chunk.getLocalTile(0, 0, 0).terrain == TerrainType::GRASS);
+
+    // 全部相同的数组导入后直接是均匀区块
+    std::vector<Tile> solid(CHUNK_VOLUME, Tile(TerrainType::WALL));
+    chunk.assignTiles(solid.data());
+    assert(chunk.isUniform());
+
+    std::cout << "Bulk assign / compact tests passed." << std::endl;
+    return true;
+}
+
+// 覆盖表：覆盖位进入调色板，覆盖值保存在稀疏表中，写回普通 Tile 时自动移除
+bool testTileOverrides() {
+    std::cout << "\n--- Testing Tile Overrides ---" << std::endl;
+    assert(sizeof(Tile) == 4);
+
+    Chunk chunk(0, 0, 0);
+    chunk.fill(Tile(TerrainType::WATER));
+    assert(chunk.getTileTraits(2, 3, 4) == TileTraits::fromTerrain(TerrainType::WATER));
+
+    const TileTraits bridge{true, true, 2};
+    chunk.setTileOverride(2, 3, 4, bridge);
+    assert(chunk.getLocalTile(2, 3, 4).hasOverride);
+    assert(chunk.getTileTraits(2, 3, 4) == bridge);
+    assert(chunk.getTileTraits(2, 3, 5) == TileTraits::fromTerrain(TerrainType::WATER));
+    assert(chunk.getOverrideCount() == 1);
+
+    // 与默认值相同的覆盖等价于清除
+    chunk.setTileOverride(2, 3, 4, TileTraits::fromTerrain(TerrainType::WATER));
+    assert(!chunk.getLocalTile(2, 3, 4).hasOverride);
+    assert(chunk.getOverrideCount() == 0);
+
+    chunk.setTileOverride(7, 7, 7, bridge);
+    chunk.setLocalTile(7, 7, 7, Tile(TerrainType::GRASS));
+    assert(chunk.getOverrideCount() == 0);
+    assert(chunk.getTileTraits(7, 7, 7) == TileTraits::fromTerrain(TerrainType::GRASS));
+
+    // 打包形式往返
+    Tile tile(TerrainType::FLOOR);
+    tile.lightLevel = 123;
+    tile.isExplored = true;
+    tile.hasOverride = true;
+    assert(Tile::fromPacked(tile.toPacked()) == tile);
+
+    std::cout << "Tile override tests passed." << std::endl;
+    return true;
+}
+
+// 索引数组共享：内容相同的区块经去重池共享同一个数组，修改时复制，互不影响
+bool testSharedIndices() {
+    std::cout << "\n--- Testing Shared Indices ---" << std::endl;
+    auto layered = [](int cx) {
+        Chunk chunk(cx, 0, 0);
+        for (int lx = 0; lx < CHUNK_WIDTH; ++lx)
+            for (int ly = 0; ly < CHUNK_HEIGHT; ++ly)
+                chunk.setLocalTile(lx, ly, 0, Tile(TerrainType::WALL));
+        return chunk;
+    };
+    Chunk a = layered(0);
+    Chunk b = layered(1);
+    Chunk uniform(2, 0, 0);
+    assert(!a.sharesIndicesWith(b));
+    const size_t unsharedBytes = a.getMemoryUsage();
+
+    ChunkIndexPool pool;
+    a.shareIndices(pool);
+    assert(a.getMemoryUsage() == unsharedBytes); // 池的引用不算共享
+    b.shareIndices(pool);
+    uniform.shareIndices(pool); // 均匀区块没有索引数组，不进入池
+    assert(a.sharesIndicesWith(b) && pool.size() == 1);
+    assert(!uniform.sharesIndicesWith(uniform));
+    assert(b.getMemoryUsage() < unsharedBytes && a.getMemoryUsage() == b.getMemoryUsage());
+
+    // 写入只影响被写的区块
+    b.setLocalTile(5, 5, 5, Tile(TerrainType::WATER));
+    assert(!a.sharesIndicesWith(b));
+    assert(a.getLocalTile(5, 5, 5).terrain == TerrainType::VOIDBLOCK);
+    assert(b.getLocalTile(5, 5, 5).terrain == TerrainType::WATER);
+    assert(a.getLocalTile(5, 5, 0).terrain == TerrainType::WALL);
+
+    // 复制区块同样共享数组；原区块被修改时副本保持不变
+    Chunk copy = a;
+    assert(copy.sharesIndicesWith(a));
+    a.setLocalTile(0, 0, 0, Tile(TerrainType::GRASS));
+    assert(copy.getLocalTile(0, 0, 0).terrain == TerrainType::WALL);
+    assert(a.getLocalTile(0, 0, 0).terrain == TerrainType::GRASS);
+
+    // 调色板不同、布局相同的区块也共享索引数组
+    Chunk c(3, 0, 0);
+    for (int lx = 0; lx < CHUNK_WIDTH; ++lx)
+        for (int ly = 0; ly < CHUNK_HEIGHT; ++ly)
+            c.setLocalTile(lx, ly, 0, Tile(TerrainType::WATER));
+    c.shareIndices(pool);
+    assert(c.sharesIndicesWith(copy));
+    assert(c.getLocalTile(1, 1, 0).terrain == TerrainType::WATER && copy.getLocalTile(1, 1, 0).terrain == TerrainType::WALL);
+
+    // 没有区块引用的条目被清理
+    a = Chunk(0, 0, 0);
+    b = Chunk(1, 0, 0);
+    copy = Chunk(4, 0, 0);
+    c = Chunk(3, 0, 0);
+    pool.sweep();
+    assert(pool.size() == 0);
+
+    // 平坦地形中跨越地面的区块在地图中共享同一个数组
+    Map map(std::make_unique<FlatTerrainGenerator>(5));
+    for (int cx = 0; cx < 8; ++cx) map.getOrLoadChunk(cx, 0, 0);
+    const Chunk* first = map.getChunk(0, 0, 0);
+    assert(!first->isUniform());
+    for (int cx = 1; cx < 8; ++cx) assert(map.getChunk(cx, 0, 0)->sharesIndicesWith(*first));
+    map.setTile(3 * CHUNK_WIDTH, 0, 0, Tile(TerrainType::WATER));
+    assert(!map.getChunk(3, 0, 0)->sharesIndicesWith(*first));
+    assert(map.getChunk(4, 0, 0)->sharesIndicesWith(*first));
+    assert(map.getTile(4 * CHUNK_WIDTH, 0, 0).terrain != TerrainType::WATER);
+
+    // 卸载最后一个使用某数组的区块时，池中的条目随之移除
+    const size_t pooled = map.getChunkIndexPool().size();
+    assert(pooled >= 1);
+    for (int cx = 0; cx < 8; ++cx) {
+        if (cx == 3) continue; // 被修改过的区块是脏的，无处写回
+        assert(map.unloadChunk(cx, 0, 0));
+        if (cx < 7) assert(map.getChunkIndexPool().size() == pooled);
+    }
+    assert(map.getChunkIndexPool().size() == pooled - 1);
+
+    std::cout << "Shared index tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("chunk_storage_test.log")) {
+        return 1;
+    }
+
+    bool ok = testUniformChunk() && testPaletteGrowth() && testBulkAndCompact() && testTileOverrides() && testSharedIndices();
+
+    std::cout << (ok ? "\n--- Chunk Storage Tests Passed ---" : "\n--- Chunk Storage Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+#include "../ChunkTable.h"
+#include "../Chunk.h"
+#include "../Coordinates.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace TilelandWorld;
+
+namespace {
+    // 旧版 ChunkCoordHash，仅用于对照
+    struct LegacyChunkCoordHash {
+        std::size_t operator()(const ChunkCoord& c) const {
+            std::size_t h1 = std::hash<int>{}(c.cx);
+            std::size_t h2 = std::hash<int>{}(c.cy);
+            std::size_t h3 = std::hash<int>{}(c.cz);
+            return h1 ^ (h2 << 1) ^ (h3 << 2);
+        }
+    };
+
+    using LegacyMap = std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, LegacyChunkCoordHash>;
+
+    using Clock = std::chrono::steady_clock;
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 以原点为中心的近似立方体区域 (已加载区块在空间上相邻，正是旧哈希最差的情形)
+    std::vector<ChunkCoord> makeCoords(size_t count) {
+        int side = 1;
+        while (static_cast<size_t>(side) * side * 4 < count) ++side;
+        std::vector<ChunkCoord> coords;
+        coords.reserve(count);
+        for (int cz = -2; coords.size() < count; ++cz) {
+            for (int cy = -side / 2; cy < side - side / 2 && coords.size() < count; ++cy) {
+                for (int cx = -side / 2; cx < side - side / 2 && coords.size() < count; ++cx) {
+                    coords.push_back(ChunkCoord{cx, cy, cz});
+                }
+            }
+        }
+        return coords;
+    }
+
+    struct Timings {
+        double insertMs = 0;
+        double hitMs = 0;
+        double missMs = 0;
+        double scanMs = 0;
+    };
+
+    // 扫描模式：模拟 getTile 逐行读取，每个区块连续访问 CHUNK_WIDTH 次
+    constexpr int SCAN_REPEAT = 16;
+
+    Timings benchLegacy(const std::vector<ChunkCoord>& coords, const std::vector<ChunkCoord>& probes, const std::vector<ChunkCoord>& misses, size_t& checksum) {
+        Timings t;
+        LegacyMap map;
+        auto start = Clock::now();
+        for (const auto& c : coords) map.emplace(c, std::make_unique<Chunk>(c.cx, c.cy, c.cz));
+        t.insertMs = msSince(start);
+
+        start = Clock::now();
+        for (const auto& c : probes) {
+            auto it = map.find(c);
+            checksum += (it != map.end()) ? static_cast<size_t>(it->second->getChunkX()) : 0;
+        }
+        t.hitMs = msSince(start);
+
+        start = Clock::now();
+        for (const auto& c : misses) checksum += map.find(c) == map.end() ? 1 : 0;
+        t.missMs = msSince(start);
+
+        start = Clock::now();
+        for (const auto& c : probes) {
+            for (int r = 0; r < SCAN_REPEAT; ++r) {
+                auto it = map.find(c);
+                checksum += static_cast<size_t>(it->second->getChunkY());
+            }
+        }
+        t.scanMs = msSince(start);
+        return t;
+    }
+
+    Timings benchTable(const std::vector<ChunkCoord>& coords, const std::vector<ChunkCoord>& probes, const std::vector<ChunkCoord>& misses, size_t& checksum) {
+        Timings t;
+        ChunkTable table;
+        auto start = Clock::now();
+        for (const auto& c : coords) table.emplace(c, std::make_unique<Chunk>(c.cx, c.cy, c.cz));
+        t.insertMs = msSince(start);
+
+        start = Clock::now();
+        for (const auto& c : probes) {
+            auto it = table.find(c);
+            checksum += (it != table.end()) ? static_cast<size_t>(it->second->getChunkX()) : 0;
+        }
+        t.hitMs = msSince(start);
+
+        start = Clock::now();
+        for (const auto& c : misses) checksum += table.findChunk(c) == nullptr ? 1 : 0;
+        t.missMs = msSince(start);
+
+        start = Clock::now();
+        for (const auto& c : probes) {
+            for (int r = 0; r < SCAN_REPEAT; ++r) {
+                checksum += static_cast<size_t>(table.findChunk(c)->getChunkY());
+            }
+        }
+        t.scanMs = msSince(start);
+        return t;
+    }
+
+    // 与 std::unordered_map 对照的随机增删查
+    bool testCorrectness() {
+        std::cout << "\n--- ChunkTable correctness ---" << std::endl;
+        std::mt19937 rng(12345);
+        std::uniform_int_distribution<int> dist(-20, 20);
+        ChunkTable table;
+        std::unordered_map<ChunkCoord, Chunk*, ChunkCoordHash> reference;
+
+        for (int step = 0; step < 200000; ++step) {
+            ChunkCoord c{dist(rng), dist(rng), dist(rng) / 4};
+            int op = static_cast<int>(rng() % 4);
+            if (op < 2) {
+                auto chunk = std::make_unique<Chunk>(c.cx, c.cy, c.cz);
+                Chunk* raw = chunk.get();
+                bool inserted = table.emplace(c, std::move(chunk)).second;
+                bool refInserted = reference.emplace(c, raw).second;
+                assert(inserted == refInserted);
+            } else if (op == 2) {
+                size_t erased = table.erase(c);
+                assert(erased == reference.erase(c));
+            } else {
+                auto it = reference.find(c);
+                Chunk* expected = it == reference.end() ? nullptr : it->second;
+                assert(table.findChunk(c) == expected);
+                assert(table.findChunk(c) == expected); // 第二次命中每线程缓存
+                assert((table.find(c) != table.end()) == (expected != nullptr));
+            }
+            assert(table.size() == reference.size());
+        }
+
+        size_t iterated = 0;
+        for (const auto& pair : table) {
+            assert(reference.at(pair.first) == pair.second.get());
+            ++iterated;
+        }
+        assert(iterated == reference.size());
+
+        // 删除后缓存不得返回已释放的区块
+        ChunkCoord probe{100, 100, 100};
+        table.emplace(probe, std::make_unique<Chunk>(100, 100, 100));
+        assert(table.findChunk(probe) != nullptr);
+        table.erase(probe);
+        assert(table.findChunk(probe) == nullptr);
+
+        std::cout << "Correctness checks passed (" << iterated << " chunks)." << std::endl;
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (!Logger::getInstance().initialize("chunk_table_benchmark.log")) {
+        return 1;
+    }
+
+    if (!testCorrectness()) {
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
+    std::vector<size_t> sizes = {10000, 100000, 1000000};
+    if (argc > 1) {
+        sizes.assign(1, static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)));
+    }
+
+    std::cout << "\n--- ChunkTable vs unordered_map (legacy hash) ---" << std::endl;
+    std::cout << std::left << std::setw(10) << "chunks" << std::setw(12) << "container"
+              << std::setw(12) << "insert ms" << std::setw(12) << "hit ms"
+              << std::setw(12) << "miss ms" << std::setw(12) << "scan ms" << std::endl;
+
+    size_t checksumLegacy = 0;
+    size_t checksumTable = 0;
+    for (size_t n : sizes) {
+        std::vector<ChunkCoord> coords = makeCoords(n);
+        std::vector<ChunkCoord> probes = coords;
+        std::shuffle(probes.begin(), probes.end(), std::mt19937(42));
+        std::vector<ChunkCoord> misses;
+        misses.reserve(n);
+        for (const auto& c : probes) misses.push_back(ChunkCoord{c.cx, c.cy, c.cz + 100000});
+
+        Timings legacy = benchLegacy(coords, probes, misses, checksumLegacy);
+        Timings table = benchTable(coords, probes, misses, checksumTable);
+
+        auto row = [n](const char* name, const Timings& t) {
+            std::cout << std::left << std::setw(10) << n << std::setw(12) << name << std::fixed << std::setprecision(2)
+                      << std::setw(12) << t.insertMs << std::setw(12) << t.hitMs
+                      << std::setw(12) << t.missMs << std::setw(12) << t.scanMs << std::endl;
+        };
+        row("unordered", legacy);
+        row("ChunkTable", table);
+        LOG_INFO("ChunkTable benchmark n=" + std::to_string(n) +
+                 " hit speedup=" + std::to_string(legacy.hitMs / std::max(table.hitMs, 1e-6)) +
+                 " scan speedup=" + std::to_string(legacy.scanMs / std::max(table.scanMs, 1e-6)));
+    }
+
+    // 两种容器访问到的数据必须一致
+    bool ok = checksumLegacy == checksumTable;
+    std::cout << (ok ? "\n--- Chunk Table Benchmark Finished ---" : "\n--- Chunk Table Benchmark Checksum Mismatch ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+#include "../Chunk.h"
+#include "../BinaryFileInfrastructure/CompressionDictionary.h"
+#include "../BinaryFileInfrastructure/MapSerializer.h"
+#include "../MapGenInfrastructure/FastNoiseTerrainGenerator.h"
+#include "../ZipFuncInfrastructure/zlib_wrapper.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace TilelandWorld;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Record = std::vector<uint8_t>;
+
+    // 噪声地形区块，随机修改少量 Tile 模拟玩家改动
+    std::vector<Record> makeRecords(int side) {
+        FastNoiseTerrainGenerator generator(20240611);
+        std::mt19937 rng(11);
+        std::vector<Record> records;
+        for (int cy = 0; cy < side; ++cy) {
+            for (int cx = 0; cx < side; ++cx) {
+                Chunk chunk(cx, cy, 0);
+                generator.generateChunk(chunk);
+                for (int i = rng() % 8; i > 0; --i) {
+                    Tile tile(TerrainType::FLOOR);
+                    tile.isExplored = 1;
+                    tile.lightLevel = static_cast<uint8_t>(rng());
+                    chunk.setLocalTile(rng() % CHUNK_WIDTH, rng() % CHUNK_HEIGHT, rng() % CHUNK_DEPTH, tile);
+                }
+                records.emplace_back();
+                MapSerializer::encodeChunkRecord(chunk, records.back());
+            }
+        }
+        return records;
+    }
+
+    SimpZlib::Status unpack(const Record& packed, Record& out, size_t size, const Record* dictionary) {
+        return SimpZlib::uncompress(packed, out, static_cast<uLong>(size), dictionary);
+    }
+
+    bool testCorrectness(const std::vector<Record>& records) {
+        std::cout << "\n--- Preset dictionary correctness ---" << std::endl;
+        // 样本太少时不构建字典
+        assert(CompressionDictionary::build({records.begin(), records.begin() + 2}).empty());
+
+        const Record dictionary = CompressionDictionary::build({records.begin(), records.begin() + 64});
+        assert(!dictionary.empty() && dictionary.size() <= CompressionDictionary::DEFAULT_SIZE);
+        assert(CompressionDictionary::build({records.begin(), records.begin() + 64}, 512).size() <= 512);
+
+        Record otherDictionary = dictionary;
+        otherDictionary[0] ^= 0xFF;
+        for (size_t i = 0; i < records.size(); i += 7) {
+            const Record& record = records[i];
+            Record packed, unpacked;
+            assert(SimpZlib::compress(record, packed, -1, &dictionary) == SimpZlib::Status::OK);
+            assert(unpack(packed, unpacked, record.size(), &dictionary) == SimpZlib::Status::OK && unpacked == record);
+            // 缺少或使用了不同的字典都无法解压
+            assert(unpack(packed, unpacked, record.size(), nullptr) != SimpZlib::Status::OK);
+            assert(unpack(packed, unpacked, record.size(), &otherDictionary) != SimpZlib::Status::OK);
+            // 未使用字典的流提供字典也能解压
+            assert(SimpZlib::compress(record, packed) == SimpZlib::Status::OK);
+            assert(unpack(packed, unpacked, record.size(), &dictionary) == SimpZlib::Status::OK && unpacked == record);
+        }
+
+        // 流式接口：reset 之后的下一个流同样载入字典
+        SimpZlib::Deflater deflater;
+        SimpZlib::Inflater inflater;
+        deflater.setDictionary(dictionary.data(), dictionary.size());
+        inflater.setDictionary(dictionary.data(), dictionary.size());
+        for (int round = 0; round < 3; ++round) {
+            const Record& record = records[round * 5];
+            Record packed, unpacked(record.size());
+            deflater.reset();
+            assert(deflater.compressAll(record.data(), record.size(), packed) == SimpZlib::Status::OK);
+            inflater.reset();
+            assert(inflater.uncompressAll(packed.data(), packed.size(), unpacked.data(), unpacked.size()) == SimpZlib::Status::OK);
+            assert(unpacked == record);
+        }
+
+        std::cout << "Correctness checks passed (dictionary " << dictionary.size() << " bytes)." << std::endl;
+        return true;
+    }
+
+    struct Result {
+        size_t compressedBytes = 0;
+        double compressSeconds = 0;
+        double uncompressSeconds = 0;
+    };
+
+    Result measure(const std::vector<Record>& records, const Record* dictionary, int repeat) {
+        Result result;
+        std::vector<Record> packed(records.size());
+        auto start = Clock::now();
+        for (int r = 0; r < repeat; ++r) {
+            for (size_t i = 0; i < records.size(); ++i) {
+                assert(SimpZlib::compress(records[i], packed[i], -1, dictionary) == SimpZlib::Status::OK);
+            }
+        }
+        result.compressSeconds = std::chrono::duration<double>(Clock::now() - start).count() / repeat;
+        for (const auto& p : packed) result.compressedBytes += p.size();
+
+        Record unpacked;
+        start = Clock::now();
+        for (int r = 0; r < repeat; ++r) {
+            for (size_t i = 0; i < records.size(); ++i) {
+                assert(unpack(packed[i], unpacked, records[i].size(), dictionary) == SimpZlib::Status::OK);
+            }
+        }
+        result.uncompressSeconds = std::chrono::duration<double>(Clock::now() - start).count() / repeat;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (!Logger::getInstance().initialize("compression_dictionary_benchmark.log")) {
+        return 1;
+    }
+
+    // 区块网格边长 (side x side 个区块)
+    int side = 24;
+    if (argc > 1) {
+        side = std::max(9, std::atoi(argv[1]));
+    }
+    const std::vector<Record> records = makeRecords(side);
+
+    if (!testCorrectness(records)) {
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
+    // 与 saveCompressedMap 相同：从第一批记录构建字典
+    const auto buildStart = Clock::now();
+    const Record dictionary = CompressionDictionary::build({records.begin(), records.begin() + 64});
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+    size_t rawBytes = 0;
+    for (const auto& record : records) rawBytes += record.size();
+
+    std::cout << "\n--- Chunk record compression (" << records.size() << " records, " << rawBytes << " bytes, dictionary "
+              << dictionary.size() << " bytes built in " << std::fixed << std::setprecision(2) << buildMs << " ms) ---" << std::endl;
+    std::cout << std::left << std::setw(14) << "mode" << std::setw(14) << "bytes" << std::setw(10) << "ratio"
+              << std::setw(16) << "compress ms" << std::setw(16) << "uncompress ms" << std::endl;
+
+    const int repeat = 5;
+    for (const Record* dict : {static_cast<const Record*>(nullptr), &dictionary}) {
+        const Result result = measure(records, dict, repeat);
+        const double ratio = static_cast<double>(result.compressedBytes) / rawBytes;
+        const std::string mode = dict ? "dictionary" : "plain";
+        std::cout << std::left << std::setw(14) << mode << std::setw(14) << result.compressedBytes << std::fixed << std::setprecision(3)
+                  << std::setw(10) << ratio << std::setprecision(2) << std::setw(16) << result.compressSeconds * 1000
+                  << std::setw(16) << result.uncompressSeconds * 1000 << std::endl;
+        LOG_INFO("Dictionary benchmark mode=" + mode + " bytes=" + std::to_string(result.compressedBytes)
+                 + " ratio=" + std::to_string(ratio) + " compressMs=" + std::to_string(result.compressSeconds * 1000)
+                 + " uncompressMs=" + std::to_string(result.uncompressSeconds * 1000));
+    }
+
+    std::cout << "\n--- Compression Dictionary Benchmark Finished ---" << std::endl;
+    Logger::getInstance().shutdown();
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "../Map.h"
+#include "../Tile.h"
+#include "../Constants.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+
+using namespace TilelandWorld;
+
+// readLayer/readRegion 与逐个 getTile 的结果必须一致 (包括负坐标与跨区块窗口)
+bool testReadLayerMatchesGetTile() {
+    std::cout << "\n--- Testing readLayer vs getTile ---" << std::endl;
+    Map map; // 默认 FlatTerrainGenerator
+
+    // 加载 3x3 个区块 (z 层 0)，并写入一些可区分的数据
+    for (int cy = -1; cy <= 1; ++cy) {
+        for (int cx = -1; cx <= 1; ++cx) {
+            map.getOrLoadChunk(cx, cy, 0);
+        }
+    }
+    for (int i = 0; i < 500; ++i) {
+        int wx = rand() % (3 * CHUNK_WIDTH) - CHUNK_WIDTH;
+        int wy = rand() % (3 * CHUNK_HEIGHT) - CHUNK_HEIGHT;
+        int wz = rand() % CHUNK_DEPTH;
+        Tile tile(static_cast<TerrainType>(rand() % 6));
+        tile.lightLevel = static_cast<uint8_t>(rand() % 256);
+        map.setTile(wx, wy, wz, tile);
+    }
+
+    const Map& constMap = map;
+    const Tile placeholder(TerrainType::UNKNOWN);
+    for (int iter = 0; iter < 200; ++iter) {
+        // 窗口可能超出已加载范围，超出部分应为占位值
+        int width = 1 + rand() % 60;
+        int height = 1 + rand() % 60;
+        int wx = rand() % 80 - 40;
+        int wy = rand() % 80 - 40;
+        int wz = rand() % (CHUNK_DEPTH + 4) - 2;
+
+        std::vector<Tile> buffer(static_cast<size_t>(width) * height);
+        constMap.readLayer(wx, wy, wz, width, height, buffer.data(), placeholder);
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                // 未加载区块 (或超出 z 范围) 应为占位值
+                ChunkCoord cc = Map::mapToChunkCoords(wx + x, wy + y, wz);
+                Tile expected = constMap.getChunk(cc.cx, cc.cy, cc.cz)
+                                    ? constMap.getTile(wx + x, wy + y, wz)
+                                    : placeholder;
+                assert(buffer[static_cast<size_t>(y) * width + x] == expected);
+            }
+        }
+    }
+
+    // readRegion：多层与逐层 readLayer 一致
+    const int w = 20, h = 18, d = 5;
+    std::vector<Tile> region(static_cast<size_t>(w) * h * d);
+    constMap.readRegion(-7, -9, 2, w, h, d, region.data(), placeholder);
+    std::vector<Tile> layer(static_cast<size_t>(w) * h);
+    for (int z = 0; z < d; ++z) {
+        constMap.readLayer(-7, -9, 2 + z, w, h, layer.data(), placeholder);
+        for (size_t i = 0; i < layer.size(); ++i) {
+            assert(region[z * layer.size() + i] == layer[i]);
+        }
+    }
+
+    std::cout << "readLayer/readRegion tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("map_region_read_test.log")) {
+        return 1;
+    }
+
+    bool ok = testReadLayerMatchesGetTile();
+
+    std::cout << (ok ? "\n--- Map Region Read Tests Passed ---" : "\n--- Map Region Read Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
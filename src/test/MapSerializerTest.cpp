@@ -3,9 +3,12 @@
 #include "../BinaryFileInfrastructure/BinaryReader.h"
 #include "../BinaryFileInfrastructure/FileFormat.h"
 #include "../BinaryFileInfrastructure/Checksum.h"
+#include "../BinaryFileInfrastructure/LazyChunkFile.h"
+#include "../MapGenInfrastructure/FlatTerrainGenerator.h"
+#include "../MapGenInfrastructure/TerrainGeneratorFactory.h"
 #include "../Constants.h"
 #include "../Tile.h"
-#include "../TerrainTypes.h" // Needed for getTerrainProperties
+#include "../TerrainRegistry.h" // Needed for getTerrainProperties
 #include "../Utils/Logger.h" // Include Logger
 #include <iostream>
 #include <vector>
@@ -15,6 +18,9 @@
 #include <cmath>   // For std::min, std::max
 #include <limits>  // For std::numeric_limits
 #include <cstring> // Include for memcpy
+#include <filesystem>
+#include <fstream>
+#include <cstddef> // For offsetof
 
 // Platform-specific includes and setup for virtual terminal processing
 #ifdef _WIN32
@@ -127,6 +133,268 @@ void printMapLayerToTerminal(Map& map, int zLayer, int startX, int startY, int w
     std::cout << "---------------------------------------" << std::endl; // Footer
 }
 
+// 按需加载：打开存档只读取索引；访问时才解码区块；保存回同一文件时保留从未访问过的区块
+bool testLazyLoading() {
+    std::cout << "\n--- Testing Lazy Chunk Loading ---" << std::endl;
+    const std::string lazyPath = "map_serializer_lazy_test.tlwf";
+    auto marker = [](int cx, int cy) {
+        Tile tile(TerrainType::WATER);
+        tile.lightLevel = static_cast<uint8_t>(cx * 16 + cy);
+        return tile;
+    };
+
+    {
+        Map map;
+        for (int cy = 0; cy < 3; ++cy) {
+            for (int cx = 0; cx < 3; ++cx) {
+                map.setTile(cx * CHUNK_WIDTH + 1, cy * CHUNK_HEIGHT + 2, 3, marker(cx, cy));
+            }
+        }
+        assert(MapSerializer::saveMap(map, lazyPath));
+    }
+
+    auto lazyMap = MapSerializer::loadMap(lazyPath);
+    assert(lazyMap);
+    assert(lazyMap->getLoadedChunkCount() == 0);
+    assert(lazyMap->getSavedChunkSource() && lazyMap->getSavedChunkSource()->getChunkCount() == 9);
+
+    // 首次访问才读取，且读回的区块与存档一致 (干净)
+    assert(lazyMap->getTile(CHUNK_WIDTH + 1, 2, 3) == marker(1, 0));
+    assert(lazyMap->getLoadedChunkCount() == 1);
+    assert(!lazyMap->getChunk(1, 0, 0)->isDirty());
+
+    // 修改一个区块后保存回同一文件：其余 8 个未访问的区块原样复制
+    lazyMap->setTile(CHUNK_WIDTH + 1, 2, 3, marker(9, 9));
+    assert(MapSerializer::saveMap(*lazyMap, lazyPath));
+    assert(!std::filesystem::exists(lazyPath + ".tmp"));
+    assert(lazyMap->getTile(2 * CHUNK_WIDTH + 1, 2 * CHUNK_HEIGHT + 2, 3) == marker(2, 2)); // 读取器已切换到新文件
+
+    auto eagerMap = MapSerializer::loadMap(lazyPath, false);
+    assert(eagerMap && eagerMap->getLoadedChunkCount() == 9);
+    const Map& constEager = *eagerMap;
+    for (int cy = 0; cy < 3; ++cy) {
+        for (int cx = 0; cx < 3; ++cx) {
+            Tile expected = (cx == 1 && cy == 0) ? marker(9, 9) : marker(cx, cy);
+            assert(constEager.getTile(cx * CHUNK_WIDTH + 1, cy * CHUNK_HEIGHT + 2, 3) == expected);
+        }
+    }
+
+    lazyMap.reset();
+    std::filesystem::remove(lazyPath);
+    std::cout << "Lazy chunk loading tests passed." << std::endl;
+    return true;
+}
+
+// 存档文件被替换后无法重新打开：保留原索引，之后的保存失败而不是丢弃未加载的区块，且不留下临时文件
+bool testSourceReopenFailure() {
+    std::cout << "\n--- Testing Save Source Reopen Failure ---" << std::endl;
+#ifndef _WIN32 // Windows 上创建符号链接需要额外权限
+    const std::string path = "map_serializer_reopen_test.tlwf";
+    const std::string otherPath = "map_serializer_reopen_other.tlwf";
+    const std::string dangling = "map_serializer_reopen_link";
+    const std::string linkTarget = "map_serializer_reopen_missing.tlwf";
+    {
+        Map map;
+        for (int cx = 0; cx < 3; ++cx) map.setTile(cx * CHUNK_WIDTH, 0, 0, Tile(TerrainType::WATER));
+        assert(MapSerializer::saveMap(map, path));
+    }
+    auto lazyMap = MapSerializer::loadMap(path);
+    assert(lazyMap && lazyMap->getSavedChunkSource()->getChunkCount() == 3);
+    lazyMap->setTile(1, 1, 1, Tile(TerrainType::WALL));
+
+    // 用悬空的符号链接“替换”存档：rename 成功，重新打开失败
+    std::filesystem::create_symlink(linkTarget, dangling);
+    LazyChunkFile* source = lazyMap->getSavedChunkSource();
+    assert(!source->replaceFile(dangling, FORMAT_VERSION_MINOR, std::vector<ChunkIndexEntry>{}));
+    assert(source->hasFailed());
+    assert(source->getChunkCount() == 3 && source->contains(ChunkCoord{2, 0, 0}));
+
+    assert(!MapSerializer::saveMap(*lazyMap, otherPath));
+    assert(!std::filesystem::exists(otherPath) && !std::filesystem::exists(otherPath + ".tmp"));
+    std::ofstream(linkTarget).put('\0'); // 让链接可解析：保存目标即存档源，先写临时文件，失败后临时文件被删除
+    assert(!MapSerializer::saveMap(*lazyMap, path));
+    assert(!std::filesystem::exists(path + ".tmp"));
+
+    lazyMap.reset();
+    std::filesystem::remove(path);
+    std::filesystem::remove(linkTarget);
+    std::filesystem::remove(otherPath);
+#endif
+    std::cout << "Save source reopen failure tests passed." << std::endl;
+    return true;
+}
+
+// 差异编码：只保存与生成器结果不同的 Tile，未修改的生成区块不写入存档
+bool testDeltaEncoding() {
+    std::cout << "\n--- Testing Delta Encoding ---" << std::endl;
+    const std::string deltaPath = "map_serializer_delta_test.tlwf";
+    Tile edited(TerrainType::WATER);
+    edited.lightLevel = 7;
+
+    {
+        Map map; // 默认 Flat 生成器，元数据与之一致
+        for (int cy = 0; cy < 4; ++cy)
+            for (int cx = 0; cx < 4; ++cx) map.getOrLoadChunk(cx, cy, 0);
+        map.setTile(CHUNK_WIDTH + 3, CHUNK_HEIGHT + 4, 5, edited);
+        assert(MapSerializer::saveMap(map, deltaPath));
+    }
+
+    auto lazyMap = MapSerializer::loadMap(deltaPath);
+    assert(lazyMap && lazyMap->getSavedChunkSource()->getChunkCount() == 1);
+    std::vector<uint8_t> record;
+    ChunkIndexEntry entry{};
+    assert(lazyMap->getSavedChunkSource()->readRecord(ChunkCoord{1, 1, 0}, record, entry));
+    assert(record[0] == CHUNK_RECORD_DELTA);
+    assert(entry.size == 1 + sizeof(uint32_t) + sizeof(TileDeltaRecord) + sizeof(uint32_t));
+
+    // 修改过的区块由生成结果加差异重建，其余区块直接重新生成
+    Map reference;
+    for (int cy = 0; cy < 4; ++cy) {
+        for (int cx = 0; cx < 4; ++cx) {
+            lazyMap->getOrLoadChunk(cx, cy, 0);
+            reference.getOrLoadChunk(cx, cy, 0);
+            for (int z = 0; z < CHUNK_DEPTH; z += 5) {
+                const int wx = cx * CHUNK_WIDTH + 3, wy = cy * CHUNK_HEIGHT + 4;
+                const Tile expected = (cx == 1 && cy == 1 && z == 5) ? edited : reference.getTile(wx, wy, z);
+                assert(lazyMap->getTile(wx, wy, z) == expected);
+            }
+        }
+    }
+    lazyMap.reset();
+
+    // 生成器版本不一致时拒绝加载
+    {
+        std::fstream file(deltaPath, std::ios::binary | std::ios::in | std::ios::out);
+        FileHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        assert(header.generatorVersion == FlatTerrainGenerator::VERSION);
+        header.generatorVersion = FlatTerrainGenerator::VERSION + 1;
+        header.headerChecksum = calculateCRC32(&header, sizeof(FileHeader) - sizeof(uint32_t));
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    assert(!MapSerializer::loadMap(deltaPath));
+
+    // 生成器无法由元数据重建时，未修改的区块仍须完整保存
+    {
+        Map custom(std::make_unique<FlatTerrainGenerator>(3));
+        for (int cx = 0; cx < 4; ++cx) custom.getOrLoadChunk(cx, 0, 0);
+        assert(MapSerializer::saveMap(custom, deltaPath));
+    }
+    auto customMap = MapSerializer::loadMap(deltaPath, false);
+    assert(customMap && customMap->getLoadedChunkCount() == 4);
+    assert(customMap->getTile(0, 0, 2).terrain == TerrainType::GRASS);
+    customMap.reset();
+
+    std::filesystem::remove(deltaPath);
+    std::cout << "Delta encoding tests passed." << std::endl;
+    return true;
+}
+
+// 修改 .tlwf 的元数据：生成参数与存档不同时拒绝，文件与世界都不变；参数相同时原地改写定长的元数据块
+bool testMetadataUpdate() {
+    std::cout << "\n--- Testing Metadata Update ---" << std::endl;
+    const std::string saveName = "map_serializer_meta_test";
+    const std::string tlwfPath = MapSerializer::getTlwfPath(saveName, ".");
+    WorldMetadata meta{};
+    meta.seed = 4242;
+    meta.noiseType = "OpenSimplex2";
+    meta.latticeSpacing = 1;
+    Tile edited(TerrainType::WATER);
+    edited.lightLevel = 3;
+
+    std::vector<Tile> expected;
+    {
+        Map map(createTerrainGeneratorFromMetadata(meta));
+        map.setWorldMetadata(meta);
+        for (int cx = 0; cx < 2; ++cx) map.getOrLoadChunk(cx, 0, 0);
+        map.setTile(1, 2, 3, edited);
+        for (int x = 0; x < 2 * CHUNK_WIDTH; x += 3) expected.push_back(map.getTile(x, 5, 7));
+        assert(MapSerializer::saveMap(map, tlwfPath));
+    }
+    const auto sizeBefore = std::filesystem::file_size(tlwfPath);
+
+    WorldMetadata changed = meta;
+    changed.seed = 99;
+    assert(!MapSerializer::updateMetadata(saveName, ".", changed));
+    changed = meta;
+    changed.octaves = meta.octaves + 1;
+    assert(!MapSerializer::updateMetadata(saveName, ".", changed));
+    changed = meta;
+    changed.latticeSpacing = 4;
+    assert(!MapSerializer::updateMetadata(saveName, ".", changed));
+    assert(MapSerializer::updateMetadata(saveName, ".", meta));
+    assert(std::filesystem::file_size(tlwfPath) == sizeBefore);
+
+    MapSerializer::SaveSummary summary{};
+    assert(MapSerializer::readSaveSummary(saveName, ".", summary));
+    assert(!summary.compressed && sameGenerationParameters(summary.metadata, meta));
+
+    // 未保存的区块按原参数重新生成，修改过的区块由原参数的生成结果加差异重建
+    auto loaded = MapSerializer::loadMap(tlwfPath);
+    assert(loaded && loaded->getWorldMetadata().seed == meta.seed);
+    assert(loaded->getTile(1, 2, 3) == edited);
+    for (int x = 0, i = 0; x < 2 * CHUNK_WIDTH; x += 3, ++i) assert(loaded->getTile(x, 5, 7) == expected[i]);
+    loaded.reset();
+
+    std::filesystem::remove(tlwfPath);
+    std::cout << "Metadata update tests passed." << std::endl;
+    return true;
+}
+
+// 噪声格点间距写入元数据块的预留区；旧存档 (预留区为 0) 读作逐 Tile 采样
+bool testLatticeSpacingMetadata() {
+    std::cout << "\n--- Testing Lattice Spacing Metadata ---" << std::endl;
+    const std::string saveName = "map_serializer_lattice_test";
+    const std::string tlwfPath = MapSerializer::getTlwfPath(saveName, ".");
+    const std::string tlwzPath = MapSerializer::getTlwzPath(saveName, ".");
+
+    WorldMetadata meta{};
+    meta.latticeSpacing = 8;
+    {
+        Map map;
+        map.setWorldMetadata(meta);
+        map.setTile(1, 2, 3, Tile(TerrainType::WATER));
+        assert(MapSerializer::saveMap(map, tlwfPath));
+    }
+    MapSerializer::SaveSummary summary{};
+    assert(MapSerializer::readSaveSummary(saveName, ".", summary));
+    assert(summary.metadata.latticeSpacing == 8);
+
+    {
+        auto loaded = MapSerializer::loadMap(tlwfPath, false);
+        assert(loaded && loaded->getWorldMetadata().latticeSpacing == 8);
+        assert(MapSerializer::saveCompressedMap(*loaded, saveName, ".", true));
+    }
+    {
+        auto loaded = MapSerializer::loadMapFromSave(saveName, ".", false);
+        assert(loaded && loaded->getWorldMetadata().latticeSpacing == 8);
+        assert(loaded->getTile(1, 2, 3).terrain == TerrainType::WATER);
+    }
+    std::filesystem::remove(tlwzPath);
+
+    {
+        Map map;
+        map.setTile(1, 2, 3, Tile(TerrainType::WATER));
+        assert(MapSerializer::saveMap(map, tlwfPath));
+    }
+    {
+        // 把间距字段清零，模拟预留区为 0 的旧存档
+        std::fstream file(tlwfPath, std::ios::binary | std::ios::in | std::ios::out);
+        FileHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        const int32_t zero = 0;
+        file.seekp(static_cast<std::streamoff>(header.metadataOffset + offsetof(MetadataBlock, latticeSpacing)));
+        file.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+    }
+    assert(MapSerializer::readSaveSummary(saveName, ".", summary));
+    assert(summary.metadata.latticeSpacing == 1);
+
+    std::filesystem::remove(tlwfPath);
+    std::cout << "Lattice spacing metadata tests passed." << std::endl;
+    return true;
+}
+
 // Run the map serializer tests
 bool runMapSerializerTests() {
     std::cout << "--- Running Map Serializer Tests ---" << std::endl;
@@ -169,12 +437,16 @@ bool runMapSerializerTests() {
                              (gradientPos / maxCoordSum) * MAX_LIGHT_LEVEL)
                 );
 
-                Tile& tile = map.getTile(x, y, z);
+                Tile tile = map.getTile(x, y, z);
                 tile.lightLevel = currentLightLevel;
                 tile.isExplored = true; // Mark as explored for potential later checks
+                map.setTile(x, y, z, tile);
             }
         }
     }
+    // 实例级通行性覆盖：写入区块覆盖表，随存档一同保存
+    const TileTraits bridgeTraits{true, true, 2};
+    map.setTileOverride(1, 1, 0, bridgeTraits);
     std::cout << "Map populated." << std::endl;
 
     // --- 2. Save Map ---
@@ -192,12 +464,15 @@ bool runMapSerializerTests() {
     } else {
         std::cout << "Map loaded successfully." << std::endl;
         try {
-             Tile& loadedTile = loadedMap->getTile(mapSizeX - 1, mapSizeY - 1, 0);
+             Tile loadedTile = loadedMap->getTile(mapSizeX - 1, mapSizeY - 1, 0);
              assert(loadedTile.terrain == TerrainType::GRASS);
              assert(loadedTile.lightLevel == MAX_LIGHT_LEVEL); // Bottom-right should be max light
-             Tile& loadedTileOrigin = loadedMap->getTile(0, 0, 0);
+             Tile loadedTileOrigin = loadedMap->getTile(0, 0, 0);
              assert(loadedTileOrigin.terrain == TerrainType::GRASS);
              assert(loadedTileOrigin.lightLevel == 0); // Top-left should be min light
+             assert(loadedMap->getTile(1, 1, 0).hasOverride);
+             assert(loadedMap->getTileTraits(1, 1, 0) == bridgeTraits);
+             assert(loadedMap->getTileTraits(2, 1, 0) == TileTraits::fromTerrain(TerrainType::GRASS));
              std::cout << "Basic verification of loaded map passed." << std::endl;
         } catch (const std::exception& e) {
              std::cerr << "Verification failed: " << e.what() << std::endl;
@@ -235,7 +510,8 @@ bool runMapSerializerTests() {
                   << " (" << (header.endianness == ENDIANNESS_LITTLE ? "Little" : (header.endianness == ENDIANNESS_BIG ? "Big" : "Unknown")) << ")" << std::endl;
         std::cout << "  ChecksumType: " << (int)header.checksumType
                   << " (" << (header.checksumType == CHECKSUM_TYPE_CRC32 ? "CRC32" : (header.checksumType == CHECKSUM_TYPE_XOR ? "XOR" : "Unknown")) << ")" << std::endl;
-        std::cout << "  Reserved:     " << header.reserved << std::endl;
+        std::cout << "  Generator:    " << (int)header.generatorVersion << std::endl;
+        std::cout << "  Reserved:     " << (int)header.reserved << std::endl;
         std::cout << "  Metadata Off: " << header.metadataOffset << std::endl;
         std::cout << "  Index Offset: " << header.indexOffset << std::endl;
         std::cout << "  Data Offset:  " << header.dataOffset << std::endl;
@@ -294,7 +570,9 @@ bool runMapSerializerTests() {
             std::cout << "    Offset: " << entry.offset << std::endl;
             std::cout << "    Size:   " << entry.size << " bytes" << std::endl;
             std::cout << "    Checksum: 0x" << std::hex << entry.checksum << std::dec << std::endl;
-            assert(entry.size == sizeof(Tile) * CHUNK_VOLUME); // Verify expected chunk size
+            // Encoding tag + delta count + deltas (only the z=0 layer differs from the Flat generator) + override count + override records
+            const size_t baseRecordSize = 1 + sizeof(uint32_t) + CHUNK_AREA * sizeof(TileDeltaRecord) + sizeof(uint32_t);
+            assert(entry.size >= baseRecordSize && (entry.size - baseRecordSize) % sizeof(TileOverrideRecord) == 0); // Verify expected chunk size
         }
 
         // Read and Verify Chunk Data (Basic Verification)
@@ -330,10 +608,13 @@ bool runMapSerializerTests() {
                        << " (" << (calculatedDataChecksum == entry.checksum ? "OK" : "Mismatch!") << ")" << std::endl;
              assert(calculatedDataChecksum == entry.checksum);
 
-             // Optional: Verify first tile data
-             if (entry.size >= sizeof(Tile)) {
-                 Tile firstTile;
-                 memcpy(&firstTile, chunkBuffer.data(), sizeof(Tile));
+             // Optional: Verify first tile data (first delta entry)
+             if (entry.size >= 1 + sizeof(uint32_t) + sizeof(TileDeltaRecord)) {
+                 assert(static_cast<uint8_t>(chunkBuffer[0]) == CHUNK_RECORD_DELTA);
+                 TileDeltaRecord firstDelta{};
+                 memcpy(&firstDelta, chunkBuffer.data() + 1 + sizeof(uint32_t), sizeof(firstDelta));
+                 assert(firstDelta.localIndex == 0);
+                 Tile firstTile = Tile::fromPacked(firstDelta.packedTile);
                  std::cout << "    First Tile Terrain: " << static_cast<int>(firstTile.terrain)
                            << " (Expected GRASS=" << static_cast<int>(TerrainType::GRASS) << ")" << std::endl;
                  assert(firstTile.terrain == TerrainType::GRASS);
@@ -354,6 +635,12 @@ bool runMapSerializerTests() {
     }
 
 
+    allTestsPassed = testLazyLoading() && allTestsPassed;
+    allTestsPassed = testDeltaEncoding() && allTestsPassed;
+    allTestsPassed = testMetadataUpdate() && allTestsPassed;
+    allTestsPassed = testLatticeSpacingMetadata() && allTestsPassed;
+    allTestsPassed = testSourceReopenFailure() && allTestsPassed;
+
     std::cout << "\n--- Map Serializer Tests " << (allTestsPassed ? "Passed" : "Failed") << " ---" << std::endl;
     return allTestsPassed;
 }
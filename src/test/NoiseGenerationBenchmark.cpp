@@ -0,0 +1,420 @@
+#include "../Chunk.h"
+#include "../Constants.h"
+#include "../Map.h"
+#include "../MapGenInfrastructure/FastNoiseTerrainGenerator.h"
+#include "../MapGenInfrastructure/ChunkGeneratorPool.h"
+#include "../SaveMetadata.h"
+#include "../Utils/Logger.h"
+#include "../Utils/TaskSystem.h"
+#include <FastNoise/FastNoise.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <thread>
+
+using namespace TilelandWorld;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct NoiseConfig {
+        const char* noiseType;
+        const char* fractalType;
+    };
+
+    const NoiseConfig configs[] = {
+        {"Perlin", "FBm"},
+        {"OpenSimplex2", "Ridged"},
+        {"Value", "None"},
+        {"CellularDistance", "None"},
+    };
+
+    // 可选的级别中本次构建编译了、FastNoise 节点支持且 CPU 支持的 (从低到高)；不可用的级别会回退到更低级别
+    std::vector<FastSIMD::eLevel> availableLevels() {
+        std::vector<FastSIMD::eLevel> levels;
+        for (FastSIMD::eLevel level : {FastSIMD::Level_SSE41, FastSIMD::Level_SSE42, FastSIMD::Level_AVX2, FastSIMD::Level_AVX512}) {
+            auto node = FastNoise::New<FastNoise::Perlin>(level);
+            if (node && node->GetSIMDLevel() == level) levels.push_back(level);
+        }
+        return levels;
+    }
+
+    std::unique_ptr<FastNoiseTerrainGenerator> makeGenerator(FastSIMD::eLevel level, const NoiseConfig& config, int latticeSpacing = 1) {
+        FastNoiseTerrainGenerator::setSimdLevelOverride(level);
+        auto generator = std::make_unique<FastNoiseTerrainGenerator>(1337, 0.02f, config.noiseType, config.fractalType,
+                                                                     3, 2.0f, 0.5f, latticeSpacing);
+        FastNoiseTerrainGenerator::setSimdLevelOverride(FastSIMD::Level_Null);
+        return generator;
+    }
+
+    bool sameTiles(const Chunk& a, const Chunk& b) {
+        for (int i = 0; i < CHUNK_VOLUME; ++i) {
+            const int lx = i % CHUNK_WIDTH, ly = (i / CHUNK_WIDTH) % CHUNK_HEIGHT, lz = i / CHUNK_AREA;
+            if (!(a.getLocalTile(lx, ly, lz) == b.getLocalTile(lx, ly, lz))) return false;
+        }
+        return true;
+    }
+
+    bool generatesSameTiles(const FastNoiseTerrainGenerator& reference, const FastNoiseTerrainGenerator& generator) {
+        for (int cz = -1; cz <= 0; ++cz) {
+            for (int c = -2; c < 3; ++c) {
+                Chunk expected(c, -c, cz);
+                Chunk actual(c, -c, cz);
+                reference.generateChunk(expected);
+                generator.generateChunk(actual);
+                if (!sameTiles(expected, actual)) return false;
+            }
+        }
+        return true;
+    }
+
+    // SSE4.1 及以上各级别生成的地形逐 Tile 一致 (未修改的区块不写入存档、加载时重新生成，级别不能影响地形)。
+    // SSE2 没有舍入指令，FastSIMD 的模拟实现对 .5 的舍入方向不同，因此不能选择更低的级别。
+    bool testLevelsAgree(const std::vector<FastSIMD::eLevel>& levels) {
+        std::cout << "\n--- SIMD level terrain agreement ---" << std::endl;
+
+        FastSIMD::eLevel level;
+        assert(FastNoiseTerrainGenerator::parseSimdLevel("auto", level) && level == FastSIMD::Level_Null);
+        assert(FastNoiseTerrainGenerator::parseSimdLevel("AVX-512", level) && level == FastSIMD::Level_AVX512);
+        assert(FastNoiseTerrainGenerator::parseSimdLevel("sse4.1", level) && level == FastSIMD::Level_SSE41);
+        assert(!FastNoiseTerrainGenerator::parseSimdLevel("mmx", level));
+        assert(!FastNoiseTerrainGenerator::parseSimdLevel("sse2", level));
+        assert(!FastNoiseTerrainGenerator::parseSimdLevel("scalar", level));
+        FastNoiseTerrainGenerator::setSimdLevelOverride(FastSIMD::Level_SSE2);
+        assert(FastNoiseTerrainGenerator::getSimdLevelOverride() == FastSIMD::Level_SSE41);
+        FastNoiseTerrainGenerator::setSimdLevelOverride(FastSIMD::Level_Null);
+
+        // 未设置覆盖时使用 CPU 支持的最高已编译级别
+        assert(FastNoiseTerrainGenerator().getSimdLevel() == levels.back());
+
+        for (const auto& config : configs) {
+            auto reference = makeGenerator(levels.front(), config);
+            assert(reference->getSimdLevel() == levels.front());
+            for (size_t i = 1; i < levels.size(); ++i) {
+                auto generator = makeGenerator(levels[i], config);
+                assert(generator->getSimdLevel() == levels[i]);
+                assert(generator->generatesSameAs(*reference));
+                assert(generatesSameTiles(*reference, *generator));
+            }
+        }
+
+        std::cout << "SSE4.1 and wider levels generate identical terrain." << std::endl;
+        return true;
+    }
+
+    // 地表带外的区块不采样噪声；同一列的多个 Z 层级共用一次噪声生成
+    bool testColumnCache() {
+        std::cout << "\n--- Z-range early-out and column cache ---" << std::endl;
+        FastNoiseTerrainGenerator generator;
+        for (int cz : {-3, -2, -1, 0, 1, 2}) {
+            Chunk chunk(4, -7, cz);
+            generator.generateChunk(chunk);
+            const int baseWZ = cz * CHUNK_DEPTH;
+            const bool outsideBand = baseWZ > FastNoiseTerrainGenerator::NOISE_MAX_Z ||
+                                     baseWZ + CHUNK_DEPTH - 1 < FastNoiseTerrainGenerator::NOISE_MIN_Z;
+            assert(chunk.isUniform() == outsideBand);
+        }
+        auto stats = generator.getStats();
+        assert(stats.uniformChunks == 4);
+        assert(stats.columnMisses == 1 && stats.columnHits == 1);
+
+        // 缓存淘汰后重新生成的结果不变
+        Chunk first(0, 0, 0);
+        generator.generateChunk(first);
+        for (size_t i = 1; i <= FastNoiseTerrainGenerator::COLUMN_CACHE_CAPACITY; ++i) {
+            Chunk other(static_cast<int>(i), 0, 0);
+            generator.generateChunk(other);
+        }
+        Chunk again(0, 0, 0);
+        generator.generateChunk(again);
+        assert(generator.getStats().columnMisses == 3 + FastNoiseTerrainGenerator::COLUMN_CACHE_CAPACITY);
+        for (int i = 0; i < CHUNK_VOLUME; ++i) {
+            const int lx = i % CHUNK_WIDTH, ly = (i / CHUNK_WIDTH) % CHUNK_HEIGHT, lz = i / CHUNK_AREA;
+            assert(first.getLocalTile(lx, ly, lz) == again.getLocalTile(lx, ly, lz));
+        }
+
+        std::cout << "Early-out and column cache checks passed." << std::endl;
+        return true;
+    }
+
+    // 格点采样：参数校验、配置区分、跨 SIMD 级别确定，噪声求值次数约为逐 Tile 采样的 1/20
+    bool testLatticeSampling(const std::vector<FastSIMD::eLevel>& levels) {
+        std::cout << "\n--- Coarse lattice sampling ---" << std::endl;
+        const NoiseConfig& config = configs[0];
+
+        auto perTile = makeGenerator(FastSIMD::Level_Null, config);
+        auto lattice = makeGenerator(FastSIMD::Level_Null, config, 4);
+        assert(perTile->getLatticeSpacing() == 1 && lattice->getLatticeSpacing() == 4);
+        assert(makeGenerator(FastSIMD::Level_Null, config, 3)->getLatticeSpacing() == 1);
+        assert(makeGenerator(FastSIMD::Level_Null, config, 32)->getLatticeSpacing() == 1);
+        assert(makeGenerator(FastSIMD::Level_Null, config, 3)->generatesSameAs(*perTile));
+        assert(!lattice->generatesSameAs(*perTile));
+        assert(!makeGenerator(FastSIMD::Level_Null, config, 8)->generatesSameAs(*lattice));
+        assert(!generatesSameTiles(*perTile, *lattice));
+
+        const size_t fullSamples = perTile->getNoiseSamplesPerColumn();
+        assert(fullSamples == static_cast<size_t>(CHUNK_AREA) * FastNoiseTerrainGenerator::NOISE_BAND_DEPTH);
+        for (int spacing : {2, 4, 8, 16}) {
+            const size_t samples = makeGenerator(FastSIMD::Level_Null, config, spacing)->getNoiseSamplesPerColumn();
+            std::cout << "spacing " << std::setw(2) << spacing << ": " << samples << " noise samples per column (per-tile "
+                      << fullSamples << ")" << std::endl;
+        }
+        assert(lattice->getNoiseSamplesPerColumn() * 10 <= fullSamples);
+
+        for (FastSIMD::eLevel level : levels) {
+            if (level < FastSIMD::Level_SSE41) continue;
+            for (int spacing : {2, 4, 8, 16}) {
+                auto reference = makeGenerator(levels.back(), config, spacing);
+                auto generator = makeGenerator(level, config, spacing);
+                assert(generator->generatesSameAs(*reference));
+                assert(generatesSameTiles(*reference, *generator));
+            }
+        }
+
+        std::cout << "Lattice sampling checks passed." << std::endl;
+        return true;
+    }
+
+    // cx0..cx0+w-1, cy0..cy0+h-1, cz -1..1 的区块 (按列分组)
+    std::vector<std::unique_ptr<Chunk>> makeBlock(int cx0, int cy0, int w, int h) {
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        for (int cy = cy0; cy < cy0 + h; ++cy)
+            for (int cx = cx0; cx < cx0 + w; ++cx)
+                for (int cz = -1; cz <= 1; ++cz) chunks.push_back(std::make_unique<Chunk>(cx, cy, cz));
+        return chunks;
+    }
+
+    void generateBatch(const FastNoiseTerrainGenerator& generator, std::vector<std::unique_ptr<Chunk>>& chunks) {
+        std::vector<Chunk*> pointers;
+        for (auto& chunk : chunks) pointers.push_back(chunk.get());
+        generator.generateChunks(pointers.data(), pointers.size());
+    }
+
+    // 批量生成与逐个生成结果相同；缺少的列合并为一次噪声调用
+    bool testRegionGeneration() {
+        std::cout << "\n--- Batched region generation ---" << std::endl;
+        for (int spacing : {1, 4}) {
+            auto batched = makeGenerator(FastSIMD::Level_Null, configs[0], spacing);
+            auto single = makeGenerator(FastSIMD::Level_Null, configs[0], spacing);
+
+            auto block = makeBlock(-2, 1, 4, 4);
+            generateBatch(*batched, block);
+            auto stats = batched->getStats();
+            assert(stats.regionNoiseCalls == 1 && stats.columnMisses == 16 && stats.columnHits == 0);
+            assert(stats.uniformChunks == 16); // cz = 1 在地表带之上
+            for (auto& chunk : block) {
+                Chunk expected(chunk->getChunkX(), chunk->getChunkY(), chunk->getChunkZ());
+                single->generateChunk(expected);
+                assert(sameTiles(expected, *chunk));
+            }
+
+            // 与已缓存的列部分重叠：只生成缺少的列
+            auto shifted = makeBlock(0, 3, 4, 4);
+            generateBatch(*batched, shifted);
+            stats = batched->getStats();
+            assert(stats.regionNoiseCalls == 2 && stats.columnMisses == 16 + 12 && stats.columnHits == 4);
+            for (auto& chunk : shifted) {
+                Chunk expected(chunk->getChunkX(), chunk->getChunkY(), chunk->getChunkZ());
+                single->generateChunk(expected);
+                assert(sameTiles(expected, *chunk));
+            }
+
+            // 相距很远的两列不合并
+            std::vector<std::unique_ptr<Chunk>> sparse;
+            sparse.push_back(std::make_unique<Chunk>(100, 100, 0));
+            sparse.push_back(std::make_unique<Chunk>(110, 90, 0));
+            generateBatch(*batched, sparse);
+            assert(batched->getStats().regionNoiseCalls == 2);
+            for (auto& chunk : sparse) {
+                Chunk expected(chunk->getChunkX(), chunk->getChunkY(), chunk->getChunkZ());
+                single->generateChunk(expected);
+                assert(sameTiles(expected, *chunk));
+            }
+        }
+
+        // 生成池按 4x4 区块的区域分组生成
+        {
+            Map map(makeGenerator(FastSIMD::Level_Null, configs[0], 4));
+            TaskSystem taskSystem(2);
+            ChunkGeneratorPool pool(map, taskSystem);
+            std::vector<ChunkCoord> coords;
+            for (int cx = 0; cx < 6; ++cx)
+                for (int cy = 0; cy < 6; ++cy)
+                    for (int cz = -1; cz <= 1; ++cz) coords.push_back({cx, cy, cz});
+            pool.requestChunks(coords);
+
+            std::vector<std::unique_ptr<Chunk>> finished;
+            const auto deadline = Clock::now() + std::chrono::seconds(60);
+            while (finished.size() < coords.size() && Clock::now() < deadline) {
+                for (auto& chunk : pool.getFinishedChunks()) finished.push_back(std::move(chunk));
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            taskSystem.stop();
+            assert(finished.size() == coords.size());
+            assert(pool.getStats().jobsTotal == 4);
+            for (auto& chunk : finished) {
+                auto expected = map.createChunkIsolated(chunk->getChunkX(), chunk->getChunkY(), chunk->getChunkZ());
+                assert(sameTiles(*expected, *chunk) && !chunk->isDirty());
+            }
+        }
+
+        std::cout << "Batched region generation checks passed." << std::endl;
+        return true;
+    }
+
+    // 冷缓存下按 4x4x3 区域逐个生成与批量生成的速度
+    void benchmarkRegionJobs(int side) {
+        std::cout << "\n--- Region jobs (default world, " << side << "x" << side << " columns, cz -1..1, cold cache) ---" << std::endl;
+        const WorldMetadata meta{};
+        for (int spacing : {1, 4}) {
+            double rates[2] = {0.0, 0.0};
+            for (int batchedMode = 0; batchedMode < 2; ++batchedMode) {
+                FastNoiseTerrainGenerator generator(static_cast<int>(meta.seed), meta.frequency, meta.noiseType, meta.fractalType,
+                                                    meta.octaves, meta.lacunarity, meta.gain, spacing);
+                const auto start = Clock::now();
+                for (int bx = 0; bx < side; bx += 4) {
+                    for (int by = 0; by < side; by += 4) {
+                        auto block = makeBlock(bx, by, 4, 4);
+                        if (batchedMode) {
+                            generateBatch(generator, block);
+                        } else {
+                            for (auto& chunk : block) generator.generateChunk(*chunk);
+                        }
+                    }
+                }
+                const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                rates[batchedMode] = side * side * 3 / std::max(seconds, 1e-9);
+            }
+            std::cout << std::right << "spacing " << std::setw(2) << spacing << std::fixed << std::setprecision(0)
+                      << "  per chunk " << std::setw(8) << rates[0] << "  region " << std::setw(8) << rates[1] << " chunks/s" << std::endl;
+            LOG_INFO("Region jobs spacing " + std::to_string(spacing) + ": per chunk=" + std::to_string(rates[0]) +
+                     " region=" + std::to_string(rates[1]) + " chunks/s");
+        }
+    }
+
+    // 默认新世界参数 (WorldMetadata) 下逐 Tile 采样与格点采样的区块生成速度
+    void benchmarkLatticeSpacing(int side) {
+        std::cout << "\n--- Lattice spacing (default world, " << side << "x" << side << " columns, cz -1..0) ---" << std::endl;
+        const WorldMetadata meta{};
+        for (int spacing : {1, 2, 4, 8}) {
+            FastNoiseTerrainGenerator generator(static_cast<int>(meta.seed), meta.frequency, meta.noiseType, meta.fractalType,
+                                                meta.octaves, meta.lacunarity, meta.gain, spacing);
+            const auto start = Clock::now();
+            for (int cx = 0; cx < side; ++cx)
+                for (int cy = 0; cy < side; ++cy)
+                    for (int cz = -1; cz <= 0; ++cz) {
+                        Chunk chunk(cx, cy, cz);
+                        generator.generateChunk(chunk);
+                    }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            const double rate = side * side * 2 / std::max(seconds, 1e-9);
+            std::cout << std::right << "spacing " << std::setw(2) << spacing << std::fixed << std::setprecision(0) << std::setw(10) << rate
+                      << " chunks/s" << std::endl;
+            LOG_INFO("Lattice spacing " + std::to_string(spacing) + ": " + std::to_string(rate) + " chunks/s");
+        }
+    }
+
+    // 与预加载相同的访问模式：side x side 列，每列 cz = -2..1
+    void benchmarkPreloadPattern(int side) {
+        std::cout << "\n--- Preload pattern (" << side << "x" << side << " columns, cz -2..1) ---" << std::endl;
+
+        // 对照：旧实现对每个区块做完整的 16x16x16 采样
+        auto node = FastNoise::New<FastNoise::FractalFBm>();
+        node->SetSource(FastNoise::New<FastNoise::Perlin>());
+        node->SetOctaveCount(3);
+        std::vector<float> noise(CHUNK_VOLUME);
+        auto start = Clock::now();
+        for (int cx = 0; cx < side; ++cx)
+            for (int cy = 0; cy < side; ++cy)
+                for (int cz = -2; cz <= 1; ++cz)
+                    node->GenUniformGrid3D(noise.data(), cx * CHUNK_WIDTH, cy * CHUNK_HEIGHT, cz * CHUNK_DEPTH,
+                                           CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_DEPTH, 0.02f, 1337);
+        const double fullSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        FastNoiseTerrainGenerator generator;
+        start = Clock::now();
+        for (int cx = 0; cx < side; ++cx)
+            for (int cy = 0; cy < side; ++cy)
+                for (int cz = -2; cz <= 1; ++cz) {
+                    Chunk chunk(cx, cy, cz);
+                    generator.generateChunk(chunk);
+                }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        const int chunks = side * side * 4;
+        const auto stats = generator.getStats();
+        std::cout << std::left << std::setw(34) << "full 3D sampling (noise only)" << std::fixed << std::setprecision(0)
+                  << chunks / std::max(fullSeconds, 1e-9) << " chunks/s" << std::endl;
+        std::cout << std::left << std::setw(34) << "generator (incl. terrain mapping)"
+                  << chunks / std::max(seconds, 1e-9) << " chunks/s" << std::endl;
+        std::cout << "uniform " << stats.uniformChunks << ", column misses " << stats.columnMisses
+                  << ", column hits " << stats.columnHits << " of " << chunks << " chunks" << std::endl;
+        LOG_INFO("Preload pattern: full=" + std::to_string(chunks / std::max(fullSeconds, 1e-9)) + " generator=" +
+                 std::to_string(chunks / std::max(seconds, 1e-9)) + " chunks/s");
+    }
+
+    double chunksPerSecond(const FastNoiseTerrainGenerator& generator, int chunkCount) {
+        const auto start = Clock::now();
+        for (int i = 0; i < chunkCount; ++i) {
+            Chunk chunk(i % 32, i / 32, 0);
+            generator.generateChunk(chunk);
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return chunkCount / std::max(seconds, 1e-9);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (!Logger::getInstance().initialize("noise_generation_benchmark.log")) {
+        return 1;
+    }
+
+    const std::vector<FastSIMD::eLevel> levels = availableLevels();
+    if (levels.empty()) {
+        std::cout << "SSE4.1 not available, skipped." << std::endl;
+        Logger::getInstance().shutdown();
+        return 0;
+    }
+    if (!testLevelsAgree(levels) || !testColumnCache() || !testLatticeSampling(levels) || !testRegionGeneration()) {
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
+    // 每个级别、每种噪声生成的区块数
+    int chunkCount = 512;
+    if (argc > 1) {
+        chunkCount = std::max(1, std::atoi(argv[1]));
+    }
+
+    std::cout << "\n--- Chunk generation throughput (chunks/s, " << chunkCount << " chunks) ---" << std::endl;
+    std::cout << std::left << std::setw(26) << "noise";
+    for (FastSIMD::eLevel level : levels) std::cout << std::setw(10) << FastNoiseTerrainGenerator::simdLevelName(level);
+    std::cout << std::endl;
+
+    for (const auto& config : configs) {
+        std::cout << std::left << std::setw(26) << (std::string(config.noiseType) + "/" + config.fractalType);
+        std::string line = std::string("Noise benchmark ") + config.noiseType + "/" + config.fractalType + ":";
+        for (FastSIMD::eLevel level : levels) {
+            auto generator = makeGenerator(level, config);
+            chunksPerSecond(*generator, 16); // 预热
+            const double rate = chunksPerSecond(*generator, chunkCount);
+            std::cout << std::fixed << std::setprecision(0) << std::setw(10) << rate;
+            line += " " + FastNoiseTerrainGenerator::simdLevelName(level) + "=" + std::to_string(rate);
+        }
+        std::cout << std::endl;
+        LOG_INFO(line + " chunks/s");
+    }
+
+    benchmarkPreloadPattern(24);
+    benchmarkLatticeSpacing(24);
+    benchmarkRegionJobs(24);
+
+    std::cout << "\n--- Noise Generation Benchmark Finished ---" << std::endl;
+    Logger::getInstance().shutdown();
+    return 0;
+}
@@ -4,8 +4,11 @@
 #include "../Utils/Logger.h"
 #include "../Chunk.h" // Needed for CHUNK constants and comparing chunks
 #include "../Tile.h"   // Needed for comparing tiles
-#include "../TerrainTypes.h" // <-- Include for getTerrainProperties
+#include "../TerrainRegistry.h" // <-- Include for getTerrainProperties
 #include "../BinaryFileInfrastructure/FileFormat.h" // <-- Include for FileHeader
+#include "../BinaryFileInfrastructure/CompressedFileFormat.h"
+#include "../BinaryFileInfrastructure/Checksum.h"
+#include "../ZipFuncInfrastructure/zlib_wrapper.h"
 #include "../BinaryFileInfrastructure/MapSerializer.h" // <-- Include MapSerializer
 #include <memory>
 #include <string>
@@ -17,6 +20,10 @@
 #include <iomanip> // <-- Include for std::setw
 #include <fstream> // For file manipulation in tests
 #include <cstdlib> // For rand()
+#include <cstring> // For std::memcpy
+#include <unordered_set>
+#include <algorithm> // For std::min
+#include <iterator>
 
 // Platform-specific includes and setup for virtual terminal processing
 #ifdef _WIN32
@@ -92,7 +99,7 @@ void printMapLayerToTerminal(Map& map, int zLayer, int startX, int startY, int w
                 std::cout << "|";
             }
             try {
-                Tile& tile = map.getTile(x, y, zLayer);
+                Tile tile = map.getTile(x, y, zLayer);
                 std::cout << formatTileForTerminal(tile);
             } catch (const std::exception& e) {
                 std::cerr << "EE";
@@ -127,8 +134,8 @@ bool compareMaps(const Map& map1, const Map& map2) {
         for (int lz = 0; lz < CHUNK_DEPTH; ++lz) {
             for (int ly = 0; ly < CHUNK_HEIGHT; ++ly) {
                 for (int lx = 0; lx < CHUNK_WIDTH; ++lx) {
-                    const Tile& tile1 = chunk1->getLocalTile(lx, ly, lz);
-                    const Tile& tile2 = chunk2->getLocalTile(lx, ly, lz);
+                    Tile tile1 = chunk1->getLocalTile(lx, ly, lz);
+                    Tile tile2 = chunk2->getLocalTile(lx, ly, lz);
                     if (tile1.terrain != tile2.terrain || 
                         tile1.lightLevel != tile2.lightLevel || 
                         tile1.isExplored != tile2.isExplored)
@@ -181,7 +188,9 @@ bool runSaveLoadCycleTest() {
             TerrainType newTerrain = (rand() % 2 == 0) ? TerrainType::WATER : TerrainType::FLOOR;
             originalMap->setTileTerrain(x, y, z, newTerrain);
             if (rand() % 3 == 0) { // 约1/3设置为已探索
-                originalMap->getTile(x, y, z).isExplored = true;
+                Tile exploredTile = originalMap->getTile(x, y, z);
+                exploredTile.isExplored = true;
+                originalMap->setTile(x, y, z, exploredTile);
             }
             modifiedCount++;
         }
@@ -205,16 +214,17 @@ bool runSaveLoadCycleTest() {
     assert(std::filesystem::exists(tlwzPath));
     assert(!std::filesystem::exists(tlwfPath)); // TLWF should be deleted
 
-    // 3. Load Map (should load from TLWZ, recreate TLWF)
+    // 3. Load Map (should load from TLWZ directly)
     LOG_INFO("Loading map (should use TLWZ)...");
-    std::unique_ptr<Map> loadedMap = MapSerializer::loadMapFromSave(saveName, saveDir);  // Updated class
+    // 立即加载全部区块，便于与原地图逐区块比较
+    std::unique_ptr<Map> loadedMap = MapSerializer::loadMapFromSave(saveName, saveDir, false);  // Updated class
     if (!loadedMap) {
         LOG_ERROR("loadMapFromSave failed!");
         cleanupTestFiles();
         return false;
     }
-    // After loading from TLWZ, TLWF should now exist
-    assert(std::filesystem::exists(tlwfPath));
+    // 0.2 版 .tlwz 可直接按区块读取，加载时不再解压出 .tlwf
+    assert(!std::filesystem::exists(tlwfPath));
 
     // 4. Compare
     LOG_INFO("Comparing maps...");
@@ -300,7 +310,9 @@ bool runStartupLoadTest() {
                 TerrainType newTerrain = (rand() % 2 == 0) ? TerrainType::WATER : TerrainType::FLOOR;
                 tempMap->setTileTerrain(x, y, z, newTerrain);
                 if (rand() % 3 == 0) {
-                    tempMap->getTile(x, y, z).isExplored = true;
+                    Tile exploredTile = tempMap->getTile(x, y, z);
+                    exploredTile.isExplored = true;
+                    tempMap->setTile(x, y, z, exploredTile);
                 }
                 modifiedCount++;
             }
@@ -344,8 +356,8 @@ bool runStartupLoadTest() {
                     LOG_ERROR("Scenario 2 FAILED: Verification of loaded map failed.");
                     scenarioPassed = false;
                 }
-                assert(std::filesystem::exists(tlwfPath));
-                LOG_INFO("Scenario 2: .tlwf file was correctly recreated during load from .tlwz.");
+                assert(!std::filesystem::exists(tlwfPath));
+                LOG_INFO("Scenario 2: map was read from .tlwz without recreating .tlwf.");
             }
         }
         if (!scenarioPassed) overallSuccess = false;
@@ -371,7 +383,9 @@ bool runStartupLoadTest() {
                 TerrainType newTerrain = (rand() % 2 == 0) ? TerrainType::WATER : TerrainType::FLOOR;
                 tempMap->setTileTerrain(x, y, z, newTerrain);
                 if (rand() % 3 == 0) {
-                    tempMap->getTile(x, y, z).isExplored = true;
+                    Tile exploredTile = tempMap->getTile(x, y, z);
+                    exploredTile.isExplored = true;
+                    tempMap->setTile(x, y, z, exploredTile);
                 }
                 modifiedCount++;
             }
@@ -490,6 +504,238 @@ bool runStartupLoadTest() {
     return overallSuccess;
 }
 
+// 分块 .tlwz：概要读取、原地修改元数据、按需加载、就地重写；以及旧的 0.1 整文件压缩存档仍可读取
+bool runCompressedFormatTest() {
+    LOG_INFO("--- Running Compressed Format Test ---");
+    const std::string saveName = "compressed_format_test";
+    const std::string saveDir = ".";
+    const std::string tlwfPath = MapSerializer::getTlwfPath(saveName, saveDir);
+    const std::string tlwzPath = MapSerializer::getTlwzPath(saveName, saveDir);
+    auto cleanupFiles = [&]() {
+        try { std::filesystem::remove(tlwfPath); } catch(...) {}
+        try { std::filesystem::remove(tlwzPath); } catch(...) {}
+    };
+    cleanupFiles();
+
+    WorldMetadata meta{};
+    meta.seed = 4242;
+    auto original = std::make_unique<Map>(std::make_unique<FlatTerrainGenerator>(0));
+    original->setWorldMetadata(meta);
+    for (int cy = 0; cy < 3; ++cy) {
+        for (int cx = 0; cx < 3; ++cx) {
+            original->setTileTerrain(cx * CHUNK_WIDTH + cx, cy * CHUNK_HEIGHT + cy, 1, TerrainType::WATER);
+        }
+    }
+
+    // 1. 保存 0.2 版，读取概要 (不解压)
+    if (!MapSerializer::saveCompressedMap(*original, saveName, saveDir, true)) {
+        LOG_ERROR("Compressed format test: saveCompressedMap failed.");
+        cleanupFiles();
+        return false;
+    }
+    {
+        BinaryReader reader(tlwzPath);
+        CompressedFileHeaderV2 header{};
+        assert(reader.read(header));
+        assert(header.versionMinor == COMPRESSED_FORMAT_VERSION_MINOR);
+        assert(header.chunkCount == original->getLoadedChunkCount());
+        assert(header.metadataOffset == sizeof(header)); // 0.4：元数据块紧跟文件头
+    }
+    MapSerializer::SaveSummary summary{};
+    assert(MapSerializer::readSaveSummary(saveName, saveDir, summary));
+    assert(summary.compressed && summary.chunkCount == original->getLoadedChunkCount());
+    assert(summary.metadata.seed == meta.seed);
+
+    // 生成参数不可修改：未保存的区块与差异记录都依赖原参数，拒绝时文件不变；参数相同的改写不改变任何字节
+    {
+        auto readFile = [](const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        };
+        const std::vector<char> before = readFile(tlwzPath);
+        WorldMetadata changed = meta;
+        changed.seed = 777;
+        assert(!MapSerializer::updateMetadata(saveName, saveDir, changed));
+        changed = meta;
+        changed.noiseType = "Flat";
+        assert(!MapSerializer::updateMetadata(saveName, saveDir, changed));
+        assert(readFile(tlwzPath) == before);
+        assert(MapSerializer::readSaveSummary(saveName, saveDir, summary));
+        assert(summary.metadata.seed == meta.seed && summary.metadata.noiseType == meta.noiseType);
+        assert(MapSerializer::updateMetadata(saveName, saveDir, original->getWorldMetadata()));
+        assert(readFile(tlwzPath) == before);
+    }
+
+    // 2. 按需加载：只解压被访问的区块；修改后保存回同一个 .tlwz
+    {
+        auto lazyMap = MapSerializer::loadMapFromSave(saveName, saveDir);
+        assert(lazyMap && lazyMap->getLoadedChunkCount() == 0);
+        assert(lazyMap->getTile(0, 0, 1).terrain == TerrainType::WATER);
+        assert(lazyMap->getLoadedChunkCount() == 1);
+        lazyMap->setTileTerrain(2, 2, 2, TerrainType::FLOOR);
+        original->setTileTerrain(2, 2, 2, TerrainType::FLOOR);
+        if (!MapSerializer::saveCompressedMap(*lazyMap, saveName, saveDir, true)) {
+            LOG_ERROR("Compressed format test: rewriting the open .tlwz failed.");
+            cleanupFiles();
+            return false;
+        }
+        // 未加载的区块在重写后仍可从新文件读取
+        assert(lazyMap->getTile(2 * CHUNK_WIDTH + 2, 2 * CHUNK_HEIGHT + 2, 1).terrain == TerrainType::WATER);
+    }
+    auto reloaded = MapSerializer::loadMapFromSave(saveName, saveDir, false);
+    if (!reloaded || !compareMaps(*original, *reloaded)) {
+        LOG_ERROR("Compressed format test: rewritten .tlwz does not match.");
+        cleanupFiles();
+        return false;
+    }
+
+    // 3. 手工构造 0.1 版 (整个 .tlwf 压缩为单个流) 并加载
+    cleanupFiles();
+    assert(MapSerializer::saveMap(*original, tlwfPath));
+    {
+        std::ifstream in(tlwfPath, std::ios::binary);
+        std::vector<Bytef> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::vector<Bytef> packed;
+        assert(SimpZlib::compress(raw, packed) == SimpZlib::Status::OK);
+
+        CompressedFileHeader header{};
+        header.magicNumber = COMPRESSED_MAGIC_NUMBER;
+        header.versionMajor = COMPRESSED_FORMAT_VERSION_MAJOR;
+        header.versionMinor = COMPRESSED_FORMAT_VERSION_MINOR_WHOLE_FILE;
+        header.compressionType = COMPRESSION_TYPE_ZLIB;
+        header.uncompressedSize = raw.size();
+        header.uncompressedChecksum = calculateCRC32(raw.data(), raw.size());
+        header.compressedSize = packed.size();
+        header.compressedChecksum = calculateCRC32(packed.data(), packed.size());
+        std::ofstream out(tlwzPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+    }
+    std::filesystem::remove(tlwfPath);
+    summary = {};
+    assert(MapSerializer::readSaveSummary(saveName, saveDir, summary));
+    assert(summary.chunkCount == original->getLoadedChunkCount());
+    auto legacy = MapSerializer::loadMapFromSave(saveName, saveDir, false);
+    if (!legacy || !compareMaps(*original, *legacy)) {
+        LOG_ERROR("Compressed format test: legacy 0.1 .tlwz failed to load.");
+        cleanupFiles();
+        return false;
+    }
+    legacy.reset();
+
+    cleanupFiles();
+    LOG_INFO("--- Compressed Format Test Passed ---");
+    return true;
+}
+
+// 并行压缩：分批在 TaskSystem 上压缩，文件内容与线程数无关；并行加载结果与原地图一致
+bool runParallelCompressionTest() {
+    LOG_INFO("--- Running Parallel Compression Test ---");
+    const std::string saveName = "parallel_compression_test";
+    const std::string saveDir = ".";
+    const std::string tlwfPath = MapSerializer::getTlwfPath(saveName, saveDir);
+    const std::string tlwzPath = MapSerializer::getTlwzPath(saveName, saveDir);
+    auto cleanupFiles = [&]() {
+        try { std::filesystem::remove(tlwfPath); } catch(...) {}
+        try { std::filesystem::remove(tlwzPath); } catch(...) {}
+    };
+    auto readFile = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    // 区块数为批次大小的数倍，且各区块内容不同；每个区块都有同样的一段墙，供预设字典提取
+    auto original = std::make_unique<Map>(std::make_unique<FlatTerrainGenerator>(0));
+    for (int cy = 0; cy < 20; ++cy) {
+        for (int cx = 0; cx < 20; ++cx) {
+            for (int lx = 0; lx < CHUNK_WIDTH; lx += 2) {
+                original->setTileTerrain(cx * CHUNK_WIDTH + lx, cy * CHUNK_HEIGHT + 3, lx % CHUNK_DEPTH, TerrainType::WALL);
+            }
+            for (int i = 0; i < 20; ++i) {
+                original->setTileTerrain(cx * CHUNK_WIDTH + rand() % CHUNK_WIDTH, cy * CHUNK_HEIGHT + rand() % CHUNK_HEIGHT,
+                                         rand() % CHUNK_DEPTH, (rand() % 2 == 0) ? TerrainType::WATER : TerrainType::FLOOR);
+            }
+        }
+    }
+    // 另有一排只有那段墙的区块：记录逐字节相同，只写出一份
+    const size_t identicalChunks = 10;
+    for (int cx = 0; cx < static_cast<int>(identicalChunks); ++cx) {
+        for (int lx = 0; lx < CHUNK_WIDTH; lx += 2) {
+            original->setTileTerrain(cx * CHUNK_WIDTH + lx, 25 * CHUNK_HEIGHT + 3, lx % CHUNK_DEPTH, TerrainType::WALL);
+        }
+    }
+
+    MapSerializer::SaveStats stats{};
+    assert(MapSerializer::saveCompressedMap(*original, saveName, saveDir, true, nullptr, &stats));
+    const std::vector<char> serialBytes = readFile(tlwzPath);
+    // 流式写出：缓冲区峰值只与批次大小有关，远小于全部区块展开后的数据 (记录本身按差异编码，已经很小)
+    assert(stats.chunkCount == original->getLoadedChunkCount());
+    assert(stats.fileBytes == serialBytes.size());
+    assert(stats.peakBufferBytes > 0 && stats.peakBufferBytes < stats.chunkCount * CHUNK_VOLUME * sizeof(uint32_t) / 2);
+    assert(stats.sharedChunks == identicalChunks - 1);
+
+    // 区块足够多时从第一批记录中构建预设字典，紧跟在文件头之后
+    CompressedFileHeaderV2 header{};
+    CompressionDictionaryHeader dictHeader{};
+    std::memcpy(&header, serialBytes.data(), sizeof(header));
+    std::memcpy(&dictHeader, serialBytes.data() + sizeof(header) + sizeof(MetadataBlock), sizeof(dictHeader));
+    assert(header.versionMinor == COMPRESSED_FORMAT_VERSION_MINOR);
+    assert(dictHeader.size > 0 && dictHeader.size <= MAX_COMPRESSION_DICTIONARY_SIZE);
+    const size_t dictOffset = sizeof(header) + sizeof(MetadataBlock);
+    assert(header.dataOffset == dictOffset + sizeof(dictHeader) + dictHeader.size);
+    assert(dictHeader.checksum == calculateCRC32(serialBytes.data() + dictOffset + sizeof(dictHeader), dictHeader.size));
+
+    for (int threads : {1, 4}) {
+        TaskSystem tasks(threads);
+        assert(MapSerializer::saveCompressedMap(*original, saveName, saveDir, true, &tasks));
+        if (readFile(tlwzPath) != serialBytes) {
+            LOG_ERROR("Parallel compression test: output differs with " + std::to_string(threads) + " worker thread(s).");
+            cleanupFiles();
+            return false;
+        }
+    }
+
+    TaskSystem tasks(4);
+    auto loaded = MapSerializer::loadMapFromSave(saveName, saveDir, false, &tasks);
+    if (!loaded || !compareMaps(*original, *loaded)) {
+        LOG_ERROR("Parallel compression test: parallel load does not match.");
+        cleanupFiles();
+        return false;
+    }
+    loaded.reset();
+
+    // 懒加载后修改一格再保存：未修改的记录原样复制，必须沿用源文件的字典
+    auto lazy = MapSerializer::loadMapFromSave(saveName, saveDir, true);
+    assert(lazy);
+    lazy->setTileTerrain(1, 1, 1, TerrainType::WALL);
+    original->setTileTerrain(1, 1, 1, TerrainType::WALL);
+    assert(MapSerializer::saveCompressedMap(*lazy, saveName, saveDir, true));
+    lazy.reset();
+    const std::vector<char> resaved = readFile(tlwzPath);
+    CompressionDictionaryHeader resavedDict{};
+    std::memcpy(&resavedDict, resaved.data() + dictOffset, sizeof(resavedDict));
+    assert(resavedDict.size == dictHeader.size && resavedDict.checksum == dictHeader.checksum);
+    // 原样复制的记录保持共享：索引中指向同一偏移量的条目数不变
+    CompressedFileHeaderV2 resavedHeader{};
+    std::memcpy(&resavedHeader, resaved.data(), sizeof(resavedHeader));
+    std::vector<CompressedChunkIndexEntry> resavedIndex(resavedHeader.chunkCount);
+    std::memcpy(resavedIndex.data(), resaved.data() + resavedHeader.indexOffset + sizeof(uint64_t),
+                resavedIndex.size() * sizeof(CompressedChunkIndexEntry));
+    std::unordered_set<uint64_t> offsets;
+    for (const auto& entry : resavedIndex) offsets.insert(entry.offset);
+    assert(resavedIndex.size() - offsets.size() == identicalChunks - 1);
+    auto reloaded = MapSerializer::loadMapFromSave(saveName, saveDir, false);
+    if (!reloaded || !compareMaps(*original, *reloaded)) {
+        LOG_ERROR("Parallel compression test: re-save with copied records does not match.");
+        cleanupFiles();
+        return false;
+    }
+
+    cleanupFiles();
+    LOG_INFO("--- Parallel Compression Test Passed ---");
+    return true;
+}
+
 int main() {
     if (!TilelandWorld::Logger::getInstance().initialize("persistence_test.log")) {
         return 1;
@@ -509,9 +755,11 @@ int main() {
     LOG_INFO("Starting Persistence Tests...");
     bool success1 = runSaveLoadCycleTest(); // Run the original cycle test
     bool success2 = runStartupLoadTest();   // Run the new startup simulation test
+    bool success3 = runCompressedFormatTest();
+    bool success4 = runParallelCompressionTest();
     LOG_INFO("Persistence Tests finished.");
 
     TilelandWorld::Logger::getInstance().shutdown();
 
-    return (success1 && success2) ? 0 : 1;
+    return (success1 && success2 && success3 && success4) ? 0 : 1;
 }
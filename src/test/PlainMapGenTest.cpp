@@ -1,7 +1,7 @@
 #include "../Map.h"
 #include "../Tile.h"
 #include "../Constants.h"
-#include "../TerrainTypes.h" // 需要包含 TerrainTypes 以使用 getTerrainProperties
+#include "../TerrainRegistry.h" // 需要包含 TerrainRegistry 以使用 getTerrainProperties
 #include "../MapGenInfrastructure/FlatTerrainGenerator.h" // 虽然 Map 默认创建，但包含可能有助于理解
 #include "../Utils/Logger.h" // <-- 包含 Logger
 #include <iostream>
@@ -104,7 +104,7 @@ void printMapLayerToTerminal(Map& map, int zLayer, int startX, int startY, int w
              }
             try {
                 // 现在调用非 const getTile，会触发 getOrLoadChunk -> generateChunk
-                Tile& tile = map.getTile(x, y, zLayer); // 使用非 const getTile
+                Tile tile = map.getTile(x, y, zLayer); // 使用非 const getTile
                 std::cout << formatTileForTerminal(tile);
             } catch (const std::exception& e) {
                 // Handle potential errors during generation or access
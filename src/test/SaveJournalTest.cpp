@@ -0,0 +1,170 @@
+#include "../Map.h"
+#include "../BinaryFileInfrastructure/SaveJournal.h"
+#include "../BinaryFileInfrastructure/MapSerializer.h"
+#include "../Constants.h"
+#include "../Utils/Logger.h"
+#include "../Utils/TaskSystem.h"
+#include "TestTiles.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <unordered_set>
+#include <cassert>
+
+using namespace TilelandWorld;
+
+namespace {
+    const std::string journalPath = "save_journal_test.tlwf";
+    const int side = 6;
+
+    void mark(Map& map, int cx, int cy, int value, std::unordered_set<ChunkCoord, ChunkCoordHash>& modified) {
+        map.setTile(cx * CHUNK_WIDTH + 2, cy * CHUNK_HEIGHT + 3, 1, markerTile(value));
+        modified.insert(ChunkCoord{cx, cy, 0});
+    }
+
+    // 改写区块的整个 z=0 层，使记录明显大于索引条目 (未修改的生成区块不会写入存档)
+    void paveLayer(Map& map, int cx, int cy) {
+        for (int y = 0; y < CHUNK_HEIGHT; ++y)
+            for (int x = 0; x < CHUNK_WIDTH; ++x) map.setTile(cx * CHUNK_WIDTH + x, cy * CHUNK_HEIGHT + y, 0, Tile(TerrainType::GRASS));
+    }
+
+    // 按需读取的地图先加载区块 (const 访问不会触发加载)
+    Tile markerAt(Map& map, int cx, int cy) {
+        map.getOrLoadChunk(cx, cy, 0);
+        const Map& constMap = map;
+        return constMap.getTile(cx * CHUNK_WIDTH + 2, cy * CHUNK_HEIGHT + 3, 1);
+    }
+
+    uint64_t fileSize() { return std::filesystem::file_size(journalPath); }
+}
+
+// 追加只写修改过的区块，加载后看到最新版本
+bool testAppend() {
+    std::cout << "\n--- Testing Journal Append ---" << std::endl;
+    {
+        Map map;
+        for (int cy = 0; cy < side; ++cy)
+            for (int cx = 0; cx < side; ++cx) paveLayer(map, cx, cy);
+        assert(MapSerializer::saveMap(map, journalPath));
+    }
+    const uint64_t baseSize = fileSize();
+
+    auto map = MapSerializer::loadMap(journalPath);
+    assert(map);
+    SaveJournal journal(journalPath);
+    assert(journal.getStats().liveChunks == static_cast<size_t>(side * side));
+    assert(journal.getStats().garbageRatio() == 0.0);
+
+    std::unordered_set<ChunkCoord, ChunkCoordHash> modified;
+    mark(*map, 1, 1, 5, modified);
+    mark(*map, 2, 3, 6, modified);
+    assert(journal.append(*map, modified));
+
+    auto stats = journal.getStats();
+    assert(stats.appendedChunks == 2);
+    assert(stats.liveChunks == static_cast<size_t>(side * side));
+    // 追加量与修改量成正比：两个区块记录 + 索引 + 元数据块，远小于整个存档
+    assert(stats.appendedBytes < baseSize / 4);
+    assert(stats.garbageRatio() > 0.0);
+
+    auto reloaded = MapSerializer::loadMap(journalPath, false);
+    assert(reloaded);
+    assert(reloaded->getLoadedChunkCount() == static_cast<size_t>(side * side));
+    assert(markerAt(*reloaded, 1, 1) == markerTile(5));
+    assert(markerAt(*reloaded, 2, 3) == markerTile(6));
+
+    // 再次修改同一区块：索引只指向最新记录
+    modified.clear();
+    mark(*map, 1, 1, 9, modified);
+    assert(journal.append(*map, modified));
+    reloaded = MapSerializer::loadMap(journalPath, false);
+    assert(reloaded && reloaded->getLoadedChunkCount() == static_cast<size_t>(side * side));
+    assert(markerAt(*reloaded, 1, 1) == markerTile(9));
+    assert(markerAt(*reloaded, 2, 3) == markerTile(6));
+
+    std::cout << "Journal append tests passed." << std::endl;
+    return true;
+}
+
+// 未提交的尾部 (例如追加中途崩溃) 被忽略，并在下一次追加时覆盖
+bool testTornTail() {
+    std::cout << "\n--- Testing Torn Tail ---" << std::endl;
+    {
+        std::ofstream out(journalPath, std::ios::binary | std::ios::app);
+        std::string junk(4096, '\x5A');
+        out.write(junk.data(), junk.size());
+    }
+    auto map = MapSerializer::loadMap(journalPath, false);
+    assert(map && markerAt(*map, 1, 1) == markerTile(9));
+
+    SaveJournal journal(journalPath);
+    std::unordered_set<ChunkCoord, ChunkCoordHash> modified;
+    mark(*map, 4, 4, 3, modified);
+    assert(journal.append(*map, modified));
+    auto reloaded = MapSerializer::loadMap(journalPath, false);
+    assert(reloaded && markerAt(*reloaded, 4, 4) == markerTile(3));
+    assert(markerAt(*reloaded, 1, 1) == markerTile(9));
+
+    std::cout << "Torn tail tests passed." << std::endl;
+    return true;
+}
+
+// 垃圾比例超过阈值后在后台压缩；地图正从该文件按需读取时切换到压缩后的文件
+bool testCompaction() {
+    std::cout << "\n--- Testing Compaction ---" << std::endl;
+    auto map = MapSerializer::loadMap(journalPath); // 按需读取，大部分区块尚未加载
+    assert(map);
+    {
+        SaveJournal journal(journalPath, 0.3);
+        TaskSystem tasks(2);
+
+        std::unordered_set<ChunkCoord, ChunkCoordHash> modified;
+        for (int cx = 0; cx < side; ++cx) mark(*map, cx, 0, cx, modified);
+        int rounds = 0;
+        while (!journal.needsCompaction()) {
+            assert(journal.append(*map, modified));
+            assert(++rounds < 100);
+        }
+        const uint64_t before = journal.getStats().fileBytes;
+        assert(journal.scheduleCompaction(tasks));
+        assert(journal.waitForCompaction());
+
+        auto stats = journal.getStats();
+        std::cout << "Compacted " << before << " -> " << stats.fileBytes << " bytes after " << rounds << " appends" << std::endl;
+        assert(stats.compactionCount == 1);
+        assert(stats.garbageRatio() == 0.0);
+        assert(stats.fileBytes < before);
+        assert(fileSize() == stats.fileBytes);
+        assert(!journal.needsCompaction());
+
+        // 压缩后继续追加
+        modified.clear();
+        mark(*map, 5, 5, 11, modified);
+        assert(journal.append(*map, modified));
+    }
+
+    // 未加载过的区块从替换后的文件读取
+    assert(markerAt(*map, 1, 1) == markerTile(9));
+    assert(markerAt(*map, 2, 3) == markerTile(6));
+    auto reloaded = MapSerializer::loadMap(journalPath, false);
+    assert(reloaded && reloaded->getLoadedChunkCount() == static_cast<size_t>(side * side));
+    for (int cx = 0; cx < side; ++cx) assert(markerAt(*reloaded, cx, 0) == markerTile(cx));
+    assert(markerAt(*reloaded, 5, 5) == markerTile(11));
+    assert(markerAt(*reloaded, 4, 4) == markerTile(3));
+
+    std::cout << "Compaction tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("save_journal_test.log")) {
+        return 1;
+    }
+
+    bool ok = testAppend() && testTornTail() && testCompaction();
+    std::filesystem::remove(journalPath);
+
+    std::cout << (ok ? "\n--- Save Journal Tests Passed ---" : "\n--- Save Journal Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
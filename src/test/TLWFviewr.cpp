@@ -528,7 +528,7 @@ int main(int argc, char *argv[])
 
     // 3. Load Map for TUI
     LOG_INFO("Loading map data for TUI...");
-    std::unique_ptr<Map> map = MapSerializer::loadMap(filepath);
+    std::unique_ptr<Map> map = MapSerializer::loadMap(filepath, false); // 查看器需要遍历全部区块
 
     if (!map)
     {
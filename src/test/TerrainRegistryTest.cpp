@@ -0,0 +1,133 @@
+#include "../TerrainRegistry.h"
+#include "../Tile.h"
+#include "../Constants.h"
+#include "../Utils/Logger.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+
+using namespace TilelandWorld;
+
+// 内置地形：稠密表查询结果与预计算的光照颜色 / SGR 前缀
+bool testBuiltinTerrains() {
+    std::cout << "\n--- Testing Built-in Terrains ---" << std::endl;
+    const TerrainRegistry& registry = TerrainRegistry::getInstance();
+
+    assert(registry.size() >= 6);
+    assert(getTerrainProperties(TerrainType::GRASS).defaultMovementCost == 1);
+    assert(!getTerrainProperties(TerrainType::VOIDBLOCK).isVisible);
+    assert(registry.getName(TerrainType::WALL) == "WALL");
+
+    // 未注册的 ID 回退到 UNKNOWN
+    assert(&registry.get(static_cast<TerrainType>(999)) == &registry.get(TerrainType::UNKNOWN));
+
+    Tile tile(TerrainType::WATER);
+    tile.lightLevel = 0;
+    RGBColor fg = tile.getForegroundColor();
+    assert(fg.b == static_cast<uint8_t>(255 * 0.1f));
+    tile.lightLevel = MAX_LIGHT_LEVEL;
+    assert(tile.getForegroundColor().b == 255);
+
+    const std::string& prefix = registry.getSgrPrefix(TerrainType::GRASS, MAX_LIGHT_LEVEL);
+    std::cout << "GRASS prefix length: " << prefix.size() << std::endl;
+    assert(prefix == "\x1b[48;2;0;100;0m\x1b[38;2;0;180;0m");
+
+    std::cout << "Built-in terrain tests passed." << std::endl;
+    return true;
+}
+
+// 数据文件：新增地形、部分覆盖已有地形、跳过格式错误的分节
+bool testLoadFromFile() {
+    std::cout << "\n--- Testing Terrain Data File ---" << std::endl;
+    const std::string path = "terrain_registry_test.cfg";
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "# test terrains\n";
+        out << "[LAVA]\n";
+        out << "id=40\n";
+        out << "char=~\n";
+        out << "fg=255,120,0\n";
+        out << "bg=160,40,0\n";
+        out << "movementCost=50\n";
+        out << "\n[GRASS]\n";
+        out << "movementCost=2\n";
+        out << "\n[BROKEN]\n";
+        out << "id=41\n";
+        out << "fg=300,0,0\n";
+    }
+
+    TerrainRegistry& registry = TerrainRegistry::getInstance();
+    bool loaded = registry.loadFromFile(path);
+    assert(loaded);
+
+    TerrainType lava;
+    assert(registry.findByName("LAVA", lava));
+    assert(static_cast<int>(lava) == 40);
+    assert(registry.size() == 41);
+    assert(getTerrainProperties(lava).displayChar == "~");
+    assert(getTerrainProperties(lava).defaultMovementCost == 50);
+    assert(Tile(lava).movementCost() == 50);
+
+    // 中间的空洞 ID 解析为 UNKNOWN
+    assert(!registry.isRegistered(static_cast<TerrainType>(20)));
+    assert(registry.get(static_cast<TerrainType>(20)).displayChar == "?");
+    assert(!registry.isRegistered(static_cast<TerrainType>(41)));
+
+    // 仅覆盖给出的字段
+    assert(getTerrainProperties(TerrainType::GRASS).defaultMovementCost == 2);
+    assert(getTerrainProperties(TerrainType::GRASS).displayChar == "░");
+
+    // 写出后可重新加载
+    assert(registry.saveToFile(path));
+    assert(registry.loadFromFile(path));
+    assert(getTerrainProperties(lava).foregroundColor.r == 255);
+
+    std::filesystem::remove(path);
+    std::cout << "Terrain data file tests passed." << std::endl;
+    return true;
+}
+
+// 最大的 ID 也可注册；光照表只为已注册的 ID 分配，空洞 ID 使用 UNKNOWN 的颜色
+bool testSparseHighId() {
+    std::cout << "\n--- Testing Sparse High Id ---" << std::endl;
+    TerrainRegistry& registry = TerrainRegistry::getInstance();
+    const TerrainType far = static_cast<TerrainType>(0xFFFF);
+    const TerrainType hole = static_cast<TerrainType>(30000);
+    registry.registerTerrain(far, "FAR", {"#", {200, 40, 40}, {20, 0, 0}, true, false, true, 3});
+    assert(registry.size() == 0x10000 && registry.isRegistered(far) && !registry.isRegistered(hole));
+
+    assert(registry.getLitForeground(far, 255).r == 200 && registry.getLitBackground(far, 255).r == 20);
+    assert(registry.getSgrPrefix(far, 255) == "\x1b[48;2;20;0;0m\x1b[38;2;200;40;40m");
+    assert(registry.getSgrPrefix(hole, 7) == registry.getSgrPrefix(TerrainType::UNKNOWN, 7));
+    assert(registry.getGlyph(hole) == "?" && registry.getGlyph(far) == "#");
+
+    // 再次注册同一 ID 只更新它自己的行
+    registry.registerTerrain(far, "FAR", {"#", {10, 40, 40}, {20, 0, 0}, true, false, true, 3});
+    assert(registry.getLitForeground(far, 255).r == 10);
+    assert(registry.getLitForeground(TerrainType::GRASS, 255).g == 180);
+
+    // 空洞 ID 不保存 UNKNOWN 的副本：覆盖 UNKNOWN 后随之改变
+    const TerrainProperties unknown = registry.get(TerrainType::UNKNOWN);
+    registry.registerTerrain(TerrainType::UNKNOWN, "UNKNOWN", {"!", {1, 2, 3}, {4, 5, 6}, false, false, true, 77});
+    assert(!registry.isRegistered(hole));
+    assert(registry.get(hole).defaultMovementCost == 77 && registry.getGlyph(hole) == "!");
+    assert(registry.getName(hole) == "UNKNOWN");
+    assert(registry.getSgrPrefix(hole, 255) == "\x1b[48;2;4;5;6m\x1b[38;2;1;2;3m");
+    registry.registerTerrain(TerrainType::UNKNOWN, "UNKNOWN", unknown);
+    assert(registry.getGlyph(hole) == "?");
+    std::cout << "Sparse high id tests passed." << std::endl;
+    return true;
+}
+
+int main() {
+    if (!Logger::getInstance().initialize("terrain_registry_test.log")) {
+        return 1;
+    }
+
+    bool ok = testBuiltinTerrains() && testLoadFromFile() && testSparseHighId();
+
+    std::cout << (ok ? "\n--- Terrain Registry Tests Passed ---" : "\n--- Terrain Registry Tests Failed ---") << std::endl;
+    Logger::getInstance().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#ifndef TILELANDWORLD_TESTTILES_H
+#define TILELANDWORLD_TESTTILES_H
+
+#include "../Tile.h"
+#include <cstdint>
+
+namespace TilelandWorld {
+
+    // 测试用的可区分 Tile：不同的 i 得到不同的光照等级 (0-255)，并标记为已探索，确保区块被视为修改过
+    inline Tile markerTile(int i) {
+        Tile tile(TerrainType::WATER);
+        tile.lightLevel = static_cast<uint8_t>(i);
+        tile.isExplored = 1;
+        return tile;
+    }
+
+} // namespace TilelandWorld
+
+#endif // TILELANDWORLD_TESTTILES_H
@@ -1,6 +1,6 @@
 #include "Tile.h"
 #include "Constants.h" // <--- 包含 Constants.h 以获取 MAX_LIGHT_LEVEL
-#include "TerrainTypes.h" // 需要包含 TerrainTypes 以使用 getTerrainProperties
+#include "TerrainRegistry.h" // 需要包含 TerrainRegistry 以使用 getTerrainProperties
 #include "../Utils/Logger.h" // <-- 包含 Logger
 #include <iostream>
 #include <string>
@@ -49,9 +49,9 @@ void printTileInfo(const TilelandWorld::Tile& tile, const std::string& name) {
     std::cout << "  Background RGB: (" << (int)bg.r << "," << (int)bg.g << "," << (int)bg.b << ")\n";
     std::cout << "  Light Level: " << (int)tile.lightLevel << "/" << (int)TilelandWorld::MAX_LIGHT_LEVEL << "\n";
     std::cout << "  Is Explored: " << (tile.isExplored ? "Yes" : "No") << "\n";
-    std::cout << "  Can Enter Same Level: " << (tile.canEnterSameLevel ? "Yes" : "No") << "\n";
-    std::cout << "  Can Stand On Top: " << (tile.canStandOnTop ? "Yes" : "No") << "\n";
-    std::cout << "  Movement Cost: " << tile.movementCost << "\n";
+    std::cout << "  Can Enter Same Level: " << (tile.canEnterSameLevel() ? "Yes" : "No") << "\n";
+    std::cout << "  Can Stand On Top: " << (tile.canStandOnTop() ? "Yes" : "No") << "\n";
+    std::cout << "  Movement Cost: " << tile.movementCost() << "\n";
     std::cout << "  Terminal Output: " << formatTileForTerminal(tile) << "\n";
     std::cout << "-------------------------\n\n";
 }
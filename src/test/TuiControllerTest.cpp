@@ -1,6 +1,7 @@
 #include "../Map.h"
 #include "../Controllers/TuiCoreController.h"
 #include "../MapGenInfrastructure/TerrainGeneratorFactory.h"
+#include "../MapGenInfrastructure/FastNoiseTerrainGenerator.h"
 #include "../Utils/Logger.h"
 #include "../Utils/EnvConfig.h"
 #include "../UI/MainMenuScreen.h"
@@ -11,6 +12,7 @@
 #include "../UI/AboutScreen.h"
 #include "../BinaryFileInfrastructure/MapSerializer.h"
 #include "../Settings.h"
+#include "../TerrainRegistry.h"
 #include <iostream>
 #include <memory>
 #include <filesystem>
@@ -42,6 +44,23 @@ int main() {
         Settings settings = SettingsManager::load(cfgPath);
         Logger::getInstance().setLogLevel(settings.minLogLevel); // 应用日志等级设置
 
+        // 地形生成使用的 SIMD 级别：在创建任何生成器之前设置
+        FastSIMD::eLevel simdLevel = FastSIMD::Level_Null;
+        if (!FastNoiseTerrainGenerator::parseSimdLevel(settings.simdLevel, simdLevel)) {
+            LOG_WARNING("Unknown simdLevel '" + settings.simdLevel + "', using auto.");
+        }
+        FastNoiseTerrainGenerator::setSimdLevelOverride(simdLevel);
+
+        // 1.1 地形定义：在任何渲染/生成线程启动前加载；文件不存在时以内置表为模板写出
+        auto& terrainRegistry = TerrainRegistry::getInstance();
+        if (std::filesystem::exists(settings.terrainDataFile)) {
+            if (!terrainRegistry.loadFromFile(settings.terrainDataFile)) {
+                LOG_WARNING("No terrain definitions loaded from " + settings.terrainDataFile + ", using built-in terrains.");
+            }
+        } else if (!terrainRegistry.saveToFile(settings.terrainDataFile)) {
+            LOG_WARNING("Failed to write terrain template " + settings.terrainDataFile);
+        }
+
         while (true) {
             TilelandWorld::UI::MainMenuScreen mainMenu;
             auto action = mainMenu.show();
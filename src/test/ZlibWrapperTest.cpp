@@ -5,6 +5,8 @@
 #include <string>
 #include <cassert>
 #include <cstring> // For std::memcpy
+#include <algorithm> // For std::min
+#include <random>
 
 // Helper to convert string to vector<Bytef>
 std::vector<Bytef> stringToBytes(const std::string& str) {
@@ -124,6 +126,99 @@ bool runZlibWrapperTests() {
     std::cout << "Level 1 data verified successfully." << std::endl;
 
 
+    // --- Test Case 6: Streaming with Small Buffers ---
+    std::cout << "\n[Test Case 6: Streaming with Small Buffers]" << std::endl;
+    std::vector<Bytef> largeData;
+    for (int i = 0; i < 200000; ++i) largeData.push_back(static_cast<Bytef>((i * 7) % 251 ^ (i >> 9)));
+    std::vector<Bytef> oneShot;
+    assert(SimpZlib::compress(largeData, oneShot) == SimpZlib::Status::OK);
+
+    // Feed input in uneven pieces and drain output 100 bytes at a time
+    std::vector<Bytef> streamed;
+    {
+        SimpZlib::Deflater deflater;
+        Bytef outBuf[100];
+        size_t offset = 0;
+        while (!deflater.isFinished()) {
+            const size_t piece = std::min<size_t>(3333, largeData.size() - offset);
+            const bool finish = offset + piece == largeData.size();
+            size_t consumed = 0, produced = 0;
+            assert(deflater.push(largeData.data() + offset, piece, outBuf, sizeof(outBuf), consumed, produced, finish) == SimpZlib::Status::OK);
+            offset += consumed;
+            streamed.insert(streamed.end(), outBuf, outBuf + produced);
+        }
+        assert(offset == largeData.size());
+    }
+    assert(streamed == oneShot); // Same settings produce the same stream
+    std::cout << "Streamed compressed size: " << streamed.size() << " bytes" << std::endl;
+
+    std::vector<Bytef> inflated;
+    {
+        SimpZlib::Inflater inflater;
+        Bytef outBuf[4096];
+        size_t offset = 0;
+        while (!inflater.isFinished()) {
+            const size_t piece = std::min<size_t>(57, streamed.size() - offset);
+            size_t consumed = 0, produced = 0;
+            assert(inflater.pull(streamed.data() + offset, piece, outBuf, sizeof(outBuf), consumed, produced) == SimpZlib::Status::OK);
+            assert(consumed > 0 || produced > 0);
+            offset += consumed;
+            inflated.insert(inflated.end(), outBuf, outBuf + produced);
+        }
+        assert(offset == streamed.size());
+    }
+    assert(inflated == largeData);
+    std::cout << "Streaming round trip verified." << std::endl;
+
+    // --- Test Case 7: Context Reuse ---
+    std::cout << "\n[Test Case 7: Context Reuse]" << std::endl;
+    {
+        // One context for many payloads, and pooled contexts across calls, must not leak state between streams
+        SimpZlib::Deflater deflater(1);
+        SimpZlib::Inflater inflater;
+        std::vector<Bytef> packed;
+        for (int round = 0; round < 50; ++round) {
+            std::vector<Bytef> payload(originalData);
+            payload.push_back(static_cast<Bytef>(round));
+            assert(deflater.compressAll(payload.data(), payload.size(), packed) == SimpZlib::Status::OK);
+
+            std::vector<Bytef> viaPool;
+            assert(SimpZlib::compress(payload, viaPool, 1) == SimpZlib::Status::OK);
+            assert(viaPool == packed);
+
+            std::vector<Bytef> unpacked(payload.size());
+            assert(inflater.uncompressAll(packed.data(), packed.size(), unpacked.data(), unpacked.size()) == SimpZlib::Status::OK);
+            assert(unpacked == payload);
+        }
+
+        // Truncated stream and too small output are reported, and the context stays usable
+        std::vector<Bytef> unpacked(largeData.size());
+        assert(inflater.uncompressAll(oneShot.data(), oneShot.size() / 2, unpacked.data(), unpacked.size()) == SimpZlib::Status::DataError);
+        assert(inflater.uncompressAll(oneShot.data(), oneShot.size(), unpacked.data(), unpacked.size() / 2) == SimpZlib::Status::OutputBufferError);
+        assert(inflater.uncompressAll(oneShot.data(), oneShot.size(), unpacked.data(), unpacked.size()) == SimpZlib::Status::OK);
+        assert(unpacked == largeData);
+    }
+    std::cout << "Context reuse verified." << std::endl;
+
+    // --- Test Case 8: Incompressible Input With Dictionary ---
+    std::cout << "\n[Test Case 8: Incompressible Input With Dictionary]" << std::endl;
+    {
+        // Stored blocks plus the 4-byte DICTID must still fit in the bound the one-shot path reserves
+        const std::vector<Bytef> dictionary = stringToBytes(originalString);
+        std::mt19937 rng(20240517u);
+        for (size_t size : {size_t(1), size_t(29), size_t(300), size_t(4096), size_t(70000)}) {
+            std::vector<Bytef> payload(size);
+            for (Bytef& b : payload) b = static_cast<Bytef>(rng());
+
+            std::vector<Bytef> packed;
+            assert(SimpZlib::compress(payload, packed, Z_BEST_SPEED, &dictionary) == SimpZlib::Status::OK);
+            std::vector<Bytef> unpacked;
+            assert(SimpZlib::uncompress(packed, unpacked, payload.size(), &dictionary) == SimpZlib::Status::OK);
+            assert(unpacked == payload);
+        }
+    }
+    std::cout << "Incompressible dictionary round trip verified." << std::endl;
+
     std::cout << "\n--- Zlib Wrapper Tests " << (allTestsPassed ? "Passed" : "Failed") << " ---" << std::endl;
     return allTestsPassed;
 }